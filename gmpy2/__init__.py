@@ -8,3 +8,19 @@ try:
     from .gmpy2 import _C_API, _mpmath_normalize, _mpmath_create
 except ImportError:
     from .gmpy2 import _mpmath_normalize, _mpmath_create
+
+# Some rarely used types and the exceptions are only created on first use,
+# so they are not copied by the * import above.  __all__ lists them so that
+# "from gmpy2 import *" still exports them; the module's __dir__ includes
+# the names that are not created yet.
+from . import gmpy2 as _gmpy2
+
+__all__ = [name for name in dir(_gmpy2) if not name.startswith('_')]
+
+def __getattr__(name):
+    value = getattr(_gmpy2, name)
+    globals()[name] = value
+    return value
+
+def __dir__():
+    return sorted(set(globals()) | set(dir(_gmpy2)))
@@ -0,0 +1,76 @@
+"""
+Measure how long "import gmpy2" takes.
+
+Each run starts a new interpreter with "python -X importtime" and reads the
+time reported for the gmpy2 package and its extension module. The modules
+that gmpy2 pulls in are reported as well, so an accidental import of a
+heavy module shows up.
+
+    python scripts/import_time.py [--runs N] [--max-time US] [--allow MOD]
+
+Use PYTHONPATH to select the build to measure. With --max-time the script
+fails if the median cumulative time exceeds US microseconds, and with
+--allow (which can be repeated) it fails if gmpy2 imports a module that
+is not listed. CI runs it this way.
+"""
+
+import argparse
+import statistics
+import subprocess
+import sys
+
+
+def sample():
+    proc = subprocess.run([sys.executable, "-X", "importtime", "-c",
+                           "import gmpy2"],
+                          capture_output=True, text=True, check=True)
+    times = {}
+    for line in proc.stderr.splitlines():
+        if not line.startswith("import time:") or "|" not in line:
+            continue
+        fields = line[len("import time:"):].split("|")
+        if not fields[0].strip().isdigit():
+            continue
+        name = fields[2].strip()
+        times[name] = (int(fields[0]), int(fields[1]))
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--runs", type=int, default=20)
+    parser.add_argument("--max-time", type=int, metavar="US",
+                        help="fail if the cumulative time exceeds US")
+    parser.add_argument("--allow", action="append", metavar="MOD",
+                        help="module that gmpy2 may import")
+    args = parser.parse_args()
+
+    runs = [sample() for _ in range(args.runs)]
+    ext = statistics.median(r["gmpy2.gmpy2"][0] for r in runs)
+    total = statistics.median(r["gmpy2"][1] for r in runs)
+    print("gmpy2.gmpy2 (self):  {:8.0f} us".format(ext))
+    print("gmpy2 (cumulative):  {:8.0f} us".format(total))
+
+    # Modules imported while gmpy2 was being imported.
+    baseline = set(subprocess.run([sys.executable, "-X", "importtime", "-c",
+                                   "pass"], capture_output=True, text=True,
+                                  check=True).stderr.split())
+    extra = sorted(name for name in runs[0] if name not in baseline and
+                   not name.startswith("gmpy2"))
+    print("also imported:       {}".format(", ".join(extra) or "-"))
+
+    errors = []
+    if args.max_time is not None and total > args.max_time:
+        errors.append("import takes {:.0f} us, more than {} us"
+                      .format(total, args.max_time))
+    if args.allow is not None:
+        unexpected = [name for name in extra if name not in args.allow]
+        if unexpected:
+            errors.append("unexpected imports: {}"
+                          .format(", ".join(unexpected)))
+    if errors:
+        sys.exit("\n".join(errors))
+
+
+if __name__ == "__main__":
+    main()
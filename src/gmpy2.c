@@ -113,7 +113,7 @@
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Global data declarations begin here.                                    *
- * NOTE: Because of these global declarations, GMPY2 is not thread-safe!   *
+ * NOTE: The object caches are per thread in free-threaded builds.         *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 /* The following global strings are used by gmpy_misc.c. */
@@ -149,14 +149,33 @@ typedef struct {
 
     MPC_Object *gmpympccache[CACHE_SIZE];
     int in_gmpympccache;
+
+    CTXT_Object *gmpyctxtcache[CACHE_SIZE];
+    int in_gmpyctxtcache;
+
+    /* NumPy scalar types; npy_count is -1 until the first NumPy scalar is
+     * seen. */
+    gmpy_npy_scalar npy_types[GMPY_NPY_MAX];
+    int npy_count;
+
+    PyObject *str_as_tuple;  /* Interned "as_tuple" for Decimal conversions */
+
+#ifdef Py_GIL_DISABLED
+    /* 0 until the thread's caches are attached to its thread state, 1 when
+     * they are, -1 once they have been emptied at thread exit. */
+    int cache_state;
+#endif
 } gmpy_global;
 
-static gmpy_global global = {
+static GMPY_THREAD_LOCAL gmpy_global global = {
     .in_gmpympzcache = 0,
     .in_gmpyxmpzcache = 0,
     .in_gmpympqcache = 0,
     .in_gmpympfrcache = 0,
     .in_gmpympccache = 0,
+    .in_gmpyctxtcache = 0,
+    .npy_count = -1,
+    .str_as_tuple = NULL,
 };
 
 /* Support for context manager using context vars.
@@ -164,6 +183,7 @@ static gmpy_global global = {
  */
 
 static PyObject *current_context_var = NULL;
+static PyObject *context_frame_var = NULL;
 
 /* Define gmpy2 specific errors for mpfr and mpc data types. No change will
  * be made the exceptions raised by mpz, xmpz, and mpq.
@@ -177,6 +197,106 @@ static PyObject *GMPyExc_Overflow = NULL;
 static PyObject *GMPyExc_Underflow = NULL;
 static PyObject *GMPyExc_Erange = NULL;
 
+/* The exceptions are only needed when a trap is enabled or one of them is
+ * looked up in the module namespace, so they are created on first use.
+ * Returns -1 with an exception set on failure.
+ */
+
+static int
+GMPy_Init_Exceptions(void)
+{
+    PyObject *gmpy_error = NULL, *erange = NULL, *inexact = NULL;
+    PyObject *overflow = NULL, *underflow = NULL, *invalid = NULL;
+    PyObject *divzero = NULL, *temp = NULL;
+
+    if (GMPyExc_GmpyError)
+        return 0;
+
+    if (!(gmpy_error = PyErr_NewException("gmpy2.gmpy2Error", PyExc_ArithmeticError, NULL)) ||
+        !(erange = PyErr_NewException("gmpy2.RangeError", gmpy_error, NULL)) ||
+        !(inexact = PyErr_NewException("gmpy2.InexactResultError", gmpy_error, NULL)) ||
+        !(overflow = PyErr_NewException("gmpy2.OverflowResultError", inexact, NULL)) ||
+        !(underflow = PyErr_NewException("gmpy2.UnderflowResultError", inexact, NULL))) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (!(temp = PyTuple_Pack(2, gmpy_error, PyExc_ValueError))) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+    invalid = PyErr_NewException("gmpy2.InvalidOperationError", temp, NULL);
+    Py_DECREF(temp);
+    if (!invalid) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (!(temp = PyTuple_Pack(2, gmpy_error, PyExc_ZeroDivisionError))) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+    divzero = PyErr_NewException("gmpy2.DivisionByZeroError", temp, NULL);
+    Py_DECREF(temp);
+    if (!divzero) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+
+    GMPyExc_Erange = erange;
+    GMPyExc_Inexact = inexact;
+    GMPyExc_Overflow = overflow;
+    GMPyExc_Underflow = underflow;
+    GMPyExc_Invalid = invalid;
+    GMPyExc_DivZero = divzero;
+    GMPyExc_GmpyError = gmpy_error;
+    return 0;
+
+  error:
+    /* LCOV_EXCL_START */
+    Py_XDECREF(gmpy_error);
+    Py_XDECREF(erange);
+    Py_XDECREF(inexact);
+    Py_XDECREF(overflow);
+    Py_XDECREF(underflow);
+    Py_XDECREF(invalid);
+    return -1;
+    /* LCOV_EXCL_STOP */
+}
+
+/* Return the exception stored in *exc, creating the exceptions first if
+ * needed. Used by the GMPY_DIVZERO() family of macros.
+ */
+
+static PyObject *
+GMPy_Exception(PyObject **exc)
+{
+    if (GMPy_Init_Exceptions() < 0) {
+        /* LCOV_EXCL_START */
+        PyErr_Clear();
+        return PyExc_ArithmeticError;
+        /* LCOV_EXCL_STOP */
+    }
+    return *exc;
+}
+
+/* Rarely used types are readied when the first object is created or when
+ * the type is looked up in the module namespace.
+ */
+
+static int
+GMPy_Ready_Type(PyTypeObject *type)
+{
+    if (type->tp_flags & Py_TPFLAGS_READY)
+        return 0;
+    return PyType_Ready(type);
+}
+
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * End of global data declarations.                                        *
@@ -190,6 +310,10 @@ static PyObject *GMPyExc_Erange = NULL;
 
 #include "gmpy2_misc.c"
 
+/* Progress reporting for long-running kernels. */
+
+#include "gmpy2_progress.c"
+
 /* Support for conversion to/from binary representation. */
 
 #include "gmpy2_binary.c"
@@ -214,12 +338,59 @@ static PyObject *GMPyExc_Erange = NULL;
 
 #include "gmpy_mpz_prp.c"
 
+/* Support for primality proofs. */
+
+#include "gmpy2_mpz_prove.c"
+
+/* Support for discrete logarithms. */
+
+#include "gmpy2_mpz_dlog.c"
+
+/* Support for residue number system vectors. */
+
+#include "gmpy2_rns.c"
+
+/* Support for packed arrays of mpfr values. */
+
+#include "gmpy2_mpfr_array.c"
+
+/* Support for polynomial arithmetic using number-theoretic transforms. */
+
+#include "gmpy2_ntt.c"
+
+/* Support for modular exponentiation using several threads. */
+
+#include "gmpy2_powm_parallel.c"
+
+/* Support for verifiable delay functions. */
+
+#include "gmpy2_vdf.c"
+
+/* Support for binary quadratic forms. */
+
+#include "gmpy2_qform.c"
+
+/* Support for elliptic curves. */
+
+#include "gmpy2_ec.c"
+
+/* Support for lattice reduction and integer relations. */
+
+#include "gmpy2_lattice.c"
+
+/* Support for bulk conversion to and from NumPy arrays. */
+
+#include "gmpy2_numpy.c"
+
 /* Include helper functions for mpmath. */
 
 #include "gmpy2_mpmath.c"
 
 #include "gmpy2_mpz_divmod.c"
 #include "gmpy2_mpz_divmod2exp.c"
+#include "gmpy2_divisor.c"
+#include "gmpy2_checkpoint.c"
+#include "gmpy2_xmpz_mmap.c"
 #include "gmpy2_mpz_pack.c"
 #include "gmpy2_mpz_bitops.c"
 #include "gmpy2_xmpz_inplace.c"
@@ -269,8 +440,222 @@ static PyObject *GMPyExc_Erange = NULL;
 
 #include "gmpy2_context.c"
 
+/* Names in the module namespace that are created on first access through
+ * the module's __getattr__ (PEP 562). Each entry is either a type or one
+ * of the exceptions.
+ */
+
+static struct {
+    const char *name;
+    PyTypeObject *type;
+    PyObject **exc;
+} gmpy_lazy_names[] = {
+    { "DivisionByZeroError", NULL, &GMPyExc_DivZero },
+    { "InexactResultError", NULL, &GMPyExc_Inexact },
+    { "InvalidOperationError", NULL, &GMPyExc_Invalid },
+    { "OverflowResultError", NULL, &GMPyExc_Overflow },
+    { "RangeError", NULL, &GMPyExc_Erange },
+    { "UnderflowResultError", NULL, &GMPyExc_Underflow },
+    { "divisor", &Divisor_Type, NULL },
+    { "ec_curve", &EC_Curve_Type, NULL },
+    { "ec_point", &EC_Point_Type, NULL },
+    { "mmap_xmpz", &MmapXMPZ_Type, NULL },
+    { "mpfr_array", &MPFR_Array_Type, NULL },
+    { "powmod_state", &PowmodState_Type, NULL },
+    { "qform", &QForm_Type, NULL },
+    { "rns", &RNS_Type, NULL },
+};
+
+#define GMPY_LAZY_NAMES (sizeof(gmpy_lazy_names) / sizeof(gmpy_lazy_names[0]))
+
+static PyObject *
+GMPy_Module_GetAttr(PyObject *self, PyObject *name)
+{
+    const char *cname;
+    PyObject *result;
+    size_t i;
+
+    if (!(cname = PyUnicode_AsUTF8(name))) {
+        return NULL;
+    }
+
+    for (i = 0; i < GMPY_LAZY_NAMES; i++) {
+        if (strcmp(cname, gmpy_lazy_names[i].name))
+            continue;
+        if (gmpy_lazy_names[i].type) {
+            if (GMPy_Ready_Type(gmpy_lazy_names[i].type) < 0) {
+                /* LCOV_EXCL_START */
+                return NULL;
+                /* LCOV_EXCL_STOP */
+            }
+            result = (PyObject*)gmpy_lazy_names[i].type;
+        }
+        else {
+            if (GMPy_Init_Exceptions() < 0) {
+                /* LCOV_EXCL_START */
+                return NULL;
+                /* LCOV_EXCL_STOP */
+            }
+            result = *gmpy_lazy_names[i].exc;
+        }
+        /* Store the object so later lookups do not come back here. */
+        if (PyObject_SetAttr(self, name, result) < 0) {
+            /* LCOV_EXCL_START */
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        Py_INCREF(result);
+        return result;
+    }
+
+    PyErr_Format(PyExc_AttributeError,
+                 "module 'gmpy2' has no attribute '%U'", name);
+    return NULL;
+}
+
+static PyObject *
+GMPy_Module_Dir(PyObject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *result, *name;
+    size_t i;
+
+    if (!(result = PyDict_Keys(PyModule_GetDict(self)))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 0; i < GMPY_LAZY_NAMES; i++) {
+        if (!(name = PyUnicode_FromString(gmpy_lazy_names[i].name))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        if (!PySequence_Contains(result, name) && PyList_Append(result, name) < 0) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(name);
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        Py_DECREF(name);
+    }
+    if (PyList_Sort(result) < 0) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(result);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return result;
+}
+
+/* Pickle mpz, xmpz, mpq, mpfr and mpc objects as
+ * (gmpy2.from_binary, (gmpy2.to_binary(x),)).
+ */
+
+static PyObject *
+GMPy_Reducer(PyObject *self, PyObject *other)
+{
+    PyObject *from_binary, *binary;
+
+    if (!(from_binary = PyObject_GetAttrString(self, "from_binary"))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (!(binary = GMPy_MPANY_To_Binary(self, other))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(from_binary);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return Py_BuildValue("(N(N))", from_binary, binary);
+}
+
+static PyMethodDef gmpy_reducer_def = {
+    "gmpy2_reducer", GMPy_Reducer, METH_O, NULL
+};
+
+static int
+GMPy_Register_Pickle(PyObject *module)
+{
+    PyTypeObject *types[] = { &MPZ_Type, &XMPZ_Type, &MPQ_Type, &MPFR_Type, &MPC_Type };
+    PyObject *copyreg, *reducer, *temp;
+    size_t i;
+
+    if (!(copyreg = PyImport_ImportModule("copyreg"))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (!(reducer = PyCFunction_New(&gmpy_reducer_def, module))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(copyreg);
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+        temp = PyObject_CallMethod(copyreg, "pickle", "OO", types[i], reducer);
+        if (!temp) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(reducer);
+            Py_DECREF(copyreg);
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        Py_DECREF(temp);
+    }
+    Py_DECREF(reducer);
+    Py_DECREF(copyreg);
+    return 0;
+}
+
+static int
+GMPy_Register_Numbers(void)
+{
+    struct {
+        const char *abc;
+        PyTypeObject *type;
+    } tower[] = {
+        { "Integral", &MPZ_Type },
+        { "Rational", &MPQ_Type },
+        { "Real", &MPFR_Type },
+        { "Complex", &MPC_Type },
+    };
+    PyObject *numbers, *abc, *temp;
+    size_t i;
+
+    if (!(numbers = PyImport_ImportModule("numbers"))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < sizeof(tower) / sizeof(tower[0]); i++) {
+        if (!(abc = PyObject_GetAttrString(numbers, tower[i].abc))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(numbers);
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        temp = PyObject_CallMethod(abc, "register", "O", tower[i].type);
+        Py_DECREF(abc);
+        if (!temp) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(numbers);
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        Py_DECREF(temp);
+    }
+    Py_DECREF(numbers);
+    return 0;
+}
+
 static PyMethodDef Pygmpy_methods [] =
 {
+    { "__dir__", GMPy_Module_Dir, METH_NOARGS, NULL },
+    { "__getattr__", GMPy_Module_GetAttr, METH_O, NULL },
     { "add", GMPy_Context_Add, METH_VARARGS, GMPy_doc_function_add },
     { "bit_clear", GMPy_MPZ_bit_clear_function, METH_VARARGS, doc_bit_clear_function },
     { "bit_count", GMPy_MPZ_bit_count, METH_O, doc_bit_count },
@@ -282,34 +667,45 @@ static PyMethodDef Pygmpy_methods [] =
     { "bit_set", GMPy_MPZ_bit_set_function, METH_VARARGS, doc_bit_set_function },
     { "bit_test", (PyCFunction)GMPy_MPZ_bit_test_function, METH_FASTCALL, doc_bit_test_function },
     { "bincoef", (PyCFunction)GMPy_MPZ_Function_Bincoef, METH_FASTCALL, GMPy_doc_mpz_function_bincoef },
+    { "bkz", (PyCFunction)GMPy_Function_BKZ, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_bkz },
     { "cmp", GMPy_MPANY_cmp, METH_VARARGS, GMPy_doc_mpany_cmp },
     { "cmp_abs", GMPy_MPANY_cmp_abs, METH_VARARGS, GMPy_doc_mpany_cmp_abs },
     { "comb", (PyCFunction)GMPy_MPZ_Function_Bincoef, METH_FASTCALL, GMPy_doc_mpz_function_comb },
     { "c_div", GMPy_MPZ_c_div, METH_VARARGS, doc_c_div },
     { "c_div_2exp", GMPy_MPZ_c_div_2exp, METH_VARARGS, doc_c_div_2exp },
+    { "c_div_many", (PyCFunction)GMPy_MPZ_c_div_many, METH_FASTCALL, doc_c_div_many },
     { "c_divmod", GMPy_MPZ_c_divmod, METH_VARARGS, doc_c_divmod },
     { "c_divmod_2exp", GMPy_MPZ_c_divmod_2exp, METH_VARARGS, doc_c_divmod_2exp },
+    { "c_divmod_many", (PyCFunction)GMPy_MPZ_c_divmod_many, METH_FASTCALL, doc_c_divmod_many },
     { "c_mod", GMPy_MPZ_c_mod, METH_VARARGS, doc_c_mod },
     { "c_mod_2exp", GMPy_MPZ_c_mod_2exp, METH_VARARGS, doc_c_mod_2exp },
+    { "c_mod_many", (PyCFunction)GMPy_MPZ_c_mod_many, METH_FASTCALL, doc_c_mod_many },
     { "denom", GMPy_MPQ_Function_Denom, METH_O, GMPy_doc_mpq_function_denom },
     { "digits", GMPy_Context_Digits, METH_VARARGS, GMPy_doc_context_digits },
     { "div", GMPy_Context_TrueDiv, METH_VARARGS, GMPy_doc_truediv },
+    { "discrete_log", (PyCFunction)GMPy_MPZ_Function_DiscreteLog, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_discrete_log },
     { "divexact", (PyCFunction)GMPy_MPZ_Function_Divexact, METH_FASTCALL, GMPy_doc_mpz_function_divexact },
     { "divm", (PyCFunction)GMPy_MPZ_Function_Divm, METH_FASTCALL, GMPy_doc_mpz_function_divm },
+    { "divm_many", (PyCFunction)GMPy_MPZ_Function_Divm_Many, METH_FASTCALL, GMPy_doc_mpz_function_divm_many },
     { "double_fac", GMPy_MPZ_Function_DoubleFac, METH_O, GMPy_doc_mpz_function_double_fac },
     { "fac", GMPy_MPZ_Function_Fac, METH_O, GMPy_doc_mpz_function_fac },
     { "fib", GMPy_MPZ_Function_Fib, METH_O, GMPy_doc_mpz_function_fib },
     { "fib2", GMPy_MPZ_Function_Fib2, METH_O, GMPy_doc_mpz_function_fib2 },
     { "floor_div", GMPy_Context_FloorDiv, METH_VARARGS, GMPy_doc_floordiv },
     { "from_binary", GMPy_MPANY_From_Binary, METH_O, doc_from_binary },
+    { "from_numpy", (PyCFunction)GMPy_Function_From_NumPy, METH_FASTCALL, GMPy_doc_function_from_numpy },
     { "f_div", GMPy_MPZ_f_div, METH_VARARGS, doc_f_div },
     { "f_div_2exp", GMPy_MPZ_f_div_2exp, METH_VARARGS, doc_f_div_2exp },
+    { "f_div_many", (PyCFunction)GMPy_MPZ_f_div_many, METH_FASTCALL, doc_f_div_many },
     { "f_divmod", GMPy_MPZ_f_divmod, METH_VARARGS, doc_f_divmod },
     { "f_divmod_2exp", GMPy_MPZ_f_divmod_2exp, METH_VARARGS, doc_f_divmod_2exp },
+    { "f_divmod_many", (PyCFunction)GMPy_MPZ_f_divmod_many, METH_FASTCALL, doc_f_divmod_many },
     { "f_mod", GMPy_MPZ_f_mod, METH_VARARGS, doc_f_mod },
     { "f_mod_2exp", GMPy_MPZ_f_mod_2exp, METH_VARARGS, doc_f_mod_2exp },
+    { "f_mod_many", (PyCFunction)GMPy_MPZ_f_mod_many, METH_FASTCALL, doc_f_mod_many },
     { "gcd", (PyCFunction)GMPy_MPZ_Function_GCD, METH_FASTCALL, GMPy_doc_mpz_function_gcd },
     { "gcdext", (PyCFunction)GMPy_MPZ_Function_GCDext, METH_FASTCALL, GMPy_doc_mpz_function_gcdext },
+    { "gcdext_many", (PyCFunction)GMPy_MPZ_Function_GCDext_Many, METH_FASTCALL, GMPy_doc_mpz_function_gcdext_many },
     { "hamdist", GMPy_MPZ_hamdist, METH_VARARGS, doc_hamdist },
     { "invert", (PyCFunction)GMPy_MPZ_Function_Invert, METH_FASTCALL, GMPy_doc_mpz_function_invert },
     { "iroot", (PyCFunction)GMPy_MPZ_Function_Iroot, METH_FASTCALL, GMPy_doc_mpz_function_iroot },
@@ -324,6 +720,7 @@ static PyMethodDef Pygmpy_methods [] =
     { "is_extra_strong_lucas_prp", GMPY_mpz_is_extrastronglucas_prp, METH_VARARGS, doc_mpz_is_extrastronglucas_prp },
     { "is_fermat_prp", GMPY_mpz_is_fermat_prp, METH_VARARGS, doc_mpz_is_fermat_prp },
     { "is_fibonacci_prp", GMPY_mpz_is_fibonacci_prp, METH_VARARGS, doc_mpz_is_fibonacci_prp },
+    { "is_kn_prp", GMPY_mpz_is_kn_prp, METH_VARARGS, doc_mpz_is_kn_prp },
     { "is_lucas_prp", GMPY_mpz_is_lucas_prp, METH_VARARGS, doc_mpz_is_lucas_prp },
     { "is_odd", GMPy_MPZ_Function_IsOdd, METH_O, GMPy_doc_mpz_function_is_odd },
     { "is_power", GMPy_MPZ_Function_IsPower, METH_O, GMPy_doc_mpz_function_is_power },
@@ -340,6 +737,8 @@ static PyMethodDef Pygmpy_methods [] =
     { "lcm", (PyCFunction)GMPy_MPZ_Function_LCM, METH_FASTCALL, GMPy_doc_mpz_function_lcm },
     { "legendre", (PyCFunction)GMPy_MPZ_Function_Legendre, METH_FASTCALL, GMPy_doc_mpz_function_legendre },
     { "license", GMPy_get_license, METH_NOARGS, GMPy_doc_license },
+    { "lll", (PyCFunction)GMPy_Function_LLL, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_lll },
+    { "load_checkpoint", GMPy_Function_LoadCheckpoint, METH_O, GMPy_doc_function_load_checkpoint },
     { "lucas", GMPy_MPZ_Function_Lucas, METH_O, GMPy_doc_mpz_function_lucas },
     { "lucasu", GMPY_mpz_lucasu, METH_VARARGS, doc_mpz_lucasu },
     { "lucasu_mod", GMPY_mpz_lucasu_mod, METH_VARARGS, doc_mpz_lucasu_mod },
@@ -365,27 +764,43 @@ static PyMethodDef Pygmpy_methods [] =
     { "numer", GMPy_MPQ_Function_Numer, METH_O, GMPy_doc_mpq_function_numer },
     { "num_digits", (PyCFunction)GMPy_MPZ_Function_NumDigits, METH_FASTCALL, GMPy_doc_mpz_function_num_digits },
     { "pack", GMPy_MPZ_pack, METH_VARARGS, doc_pack },
+    { "poly_divmod", (PyCFunction)GMPy_MPZ_Function_PolyDivMod, METH_FASTCALL, GMPy_doc_mpz_function_poly_divmod },
+    { "poly_eval", (PyCFunction)GMPy_MPZ_Function_PolyEval, METH_FASTCALL, GMPy_doc_mpz_function_poly_eval },
+    { "poly_mul", (PyCFunction)GMPy_MPZ_Function_PolyMul, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_poly_mul },
+    { "poly_sqr", (PyCFunction)GMPy_MPZ_Function_PolySqr, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_poly_sqr },
     { "popcount", GMPy_MPZ_popcount, METH_O, doc_popcount },
     { "powmod", GMPy_Integer_PowMod, METH_VARARGS, GMPy_doc_integer_powmod },
     { "powmod_base_list", GMPy_Integer_PowMod_Base_List, METH_VARARGS, GMPy_doc_integer_powmod_base_list },
     { "powmod_exp_list", GMPy_Integer_PowMod_Exp_List, METH_VARARGS, GMPy_doc_integer_powmod_exp_list },
     { "powmod_sec", GMPy_Integer_PowMod_Sec, METH_VARARGS, GMPy_doc_integer_powmod_sec },
     { "primorial", GMPy_MPZ_Function_Primorial, METH_O, GMPy_doc_mpz_function_primorial },
+    { "progress", (PyCFunction)GMPy_get_progress, METH_FASTCALL, GMPy_doc_progress },
+    { "prime_certificate", GMPy_MPZ_Function_PrimeCertificate, METH_O, GMPy_doc_mpz_function_prime_certificate },
+    { "pslq", (PyCFunction)GMPy_Function_PSLQ, METH_VARARGS | METH_KEYWORDS, GMPy_doc_function_pslq },
     { "qdiv", GMPy_MPQ_Function_Qdiv, METH_VARARGS, GMPy_doc_function_qdiv },
     { "remove", (PyCFunction)GMPy_MPZ_Function_Remove, METH_FASTCALL, GMPy_doc_mpz_function_remove },
     { "random_state", GMPy_RandomState_Factory, METH_VARARGS, GMPy_doc_random_state_factory },
+    { "repeated_square", (PyCFunction)GMPy_MPZ_Function_RepeatedSquare, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mpz_function_repeated_square },
+    { "save_checkpoint", (PyCFunction)GMPy_Function_SaveCheckpoint, METH_FASTCALL, GMPy_doc_function_save_checkpoint },
     { "sign", GMPy_Context_Sign, METH_O, GMPy_doc_function_sign },
     { "square", GMPy_Context_Square, METH_O, GMPy_doc_function_square },
     { "sub", GMPy_Context_Sub, METH_VARARGS, GMPy_doc_sub },
     { "to_binary", GMPy_MPANY_To_Binary, METH_O, doc_to_binary },
+    { "to_numpy", (PyCFunction)GMPy_Function_To_NumPy, METH_FASTCALL, GMPy_doc_function_to_numpy },
     { "t_div", GMPy_MPZ_t_div, METH_VARARGS, doc_t_div },
     { "t_div_2exp", GMPy_MPZ_t_div_2exp, METH_VARARGS, doc_t_div_2exp },
+    { "t_div_many", (PyCFunction)GMPy_MPZ_t_div_many, METH_FASTCALL, doc_t_div_many },
     { "t_divmod", GMPy_MPZ_t_divmod, METH_VARARGS, doc_t_divmod },
     { "t_divmod_2exp", GMPy_MPZ_t_divmod_2exp, METH_VARARGS, doc_t_divmod_2exp },
+    { "t_divmod_many", (PyCFunction)GMPy_MPZ_t_divmod_many, METH_FASTCALL, doc_t_divmod_many },
     { "t_mod", GMPy_MPZ_t_mod, METH_VARARGS, doc_t_mod },
     { "t_mod_2exp", GMPy_MPZ_t_mod_2exp, METH_VARARGS, doc_t_mod_2exp },
+    { "t_mod_many", (PyCFunction)GMPy_MPZ_t_mod_many, METH_FASTCALL, doc_t_mod_many },
     { "unpack", GMPy_MPZ_unpack, METH_VARARGS, doc_unpack },
+    { "verify_prime_certificate", GMPy_MPZ_Function_VerifyPrimeCertificate, METH_O, GMPy_doc_mpz_function_verify_prime_certificate },
     { "version", GMPy_get_version, METH_NOARGS, GMPy_doc_version },
+    { "wesolowski_prove", (PyCFunction)GMPy_MPZ_Function_WesolowskiProve, METH_FASTCALL, GMPy_doc_mpz_function_wesolowski_prove },
+    { "wesolowski_verify", (PyCFunction)GMPy_MPZ_Function_WesolowskiVerify, METH_FASTCALL, GMPy_doc_mpz_function_wesolowski_verify },
     { "xbit_mask", GMPy_XMPZ_Function_XbitMask, METH_O, GMPy_doc_xmpz_function_xbit_mask },
     { "_mpmath_normalize", (PyCFunction)Pympz_mpmath_normalize_fast, METH_FASTCALL, doc_mpmath_normalizeg },
     { "_mpmath_create", (PyCFunction)Pympz_mpmath_create_fast, METH_FASTCALL, doc_mpmath_create },
@@ -491,6 +906,7 @@ static PyMethodDef Pygmpy_methods [] =
     { "root", GMPy_Context_Root, METH_VARARGS, GMPy_doc_function_root },
     { "rootn", GMPy_Context_Rootn, METH_VARARGS, GMPy_doc_function_rootn },
     { "round_away", GMPy_Context_RoundAway, METH_O, GMPy_doc_function_round_away },
+    { "rounding", GMPy_CTXT_Rounding, METH_O, GMPy_doc_context_rounding },
     { "round2", GMPy_Context_Round2, METH_VARARGS, GMPy_doc_function_round2 },
     { "sec", GMPy_Context_Sec, METH_O, GMPy_doc_function_sec },
     { "sech", GMPy_Context_Sech, METH_O, GMPy_doc_function_sech },
@@ -519,6 +935,7 @@ static PyMethodDef Pygmpy_methods [] =
     { "norm", GMPy_Context_Norm, METH_O, GMPy_doc_function_norm },
     { "polar", GMPy_Context_Polar, METH_O, GMPy_doc_function_polar },
     { "phase", GMPy_Context_Phase, METH_O, GMPy_doc_function_phase },
+    { "precision", GMPy_CTXT_Precision, METH_O, GMPy_doc_context_precision },
     { "proj", GMPy_Context_Proj, METH_O, GMPy_doc_function_proj },
     { "root_of_unity", GMPy_Context_Root_Of_Unity, METH_VARARGS, GMPy_doc_function_root_of_unity },
     { "rect", GMPy_Context_Rect, METH_VARARGS, GMPy_doc_function_rect },
@@ -551,17 +968,35 @@ static char _gmpy_docs[] =
 "MPFR and MPC libraries are available.\n\
 ";
 
-/* Notes on Python 3.x support: Full support for PEP-3121 has not been
- * implemented. No per-module state has been defined.
+/* The module uses multi-phase initialization (PEP 489), but it still keeps
+ * process-wide state: the types are static, and the object caches and the
+ * context variables are shared. A subinterpreter would hand its objects to
+ * the main interpreter through the caches, and the values CPython caches
+ * in a context variable are only valid in the interpreter that set them.
+ * So gmpy2 can only be imported by the main interpreter; see the check at
+ * the start of GMPy_Module_Exec().
  */
 
+static int GMPy_Module_Exec(PyObject *gmpy_module);
+
+static PyModuleDef_Slot gmpy_slots[] = {
+    {Py_mod_exec, GMPy_Module_Exec},
+#if PY_VERSION_HEX >= 0x030C0000
+    {Py_mod_multiple_interpreters, Py_MOD_MULTIPLE_INTERPRETERS_NOT_SUPPORTED},
+#endif
+    /* Py_mod_gil is not declared yet: the free-threaded code paths have
+     * not been run on a free-threaded interpreter, so importing gmpy2
+     * there enables the GIL unless PYTHON_GIL=0 is set. */
+    {0, NULL}
+};
+
 static struct PyModuleDef moduledef = {
         PyModuleDef_HEAD_INIT,
         "gmpy2",
         _gmpy_docs,
-        -1, /*sizeof(struct module_state) */
+        0,
         Pygmpy_methods,
-        NULL,
+        gmpy_slots,
         NULL, /* gmpy_traverse */
         NULL, /* gmpy_clear */
         NULL
@@ -569,12 +1004,12 @@ static struct PyModuleDef moduledef = {
 
 PyMODINIT_FUNC PyInit_gmpy2(void)
 {
-    PyObject *result = NULL;
-    PyObject *namespace = NULL;
-    PyObject *gmpy_module = NULL;
-    PyObject *copy_reg_module = NULL;
-    PyObject *temp = NULL;
-    PyObject *numbers_module = NULL;
+    return PyModuleDef_Init(&moduledef);
+}
+
+static int
+GMPy_Module_Exec(PyObject *gmpy_module)
+{
     PyObject* xmpz = NULL;
     PyObject* limb_size = NULL;
 
@@ -584,137 +1019,85 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
     PyObject *c_api_object;
 #endif
 
+    if (PyInterpreterState_Get() != PyInterpreterState_Main()) {
+        PyErr_SetString(PyExc_ImportError,
+                        "gmpy2 does not support loading in subinterpreters");
+        return -1;
+    }
+
     /* Validate the sizes of the various typedef'ed integer types. */
 
     if (sizeof(mpfr_prec_t) != sizeof(long)) {
         /* LCOV_EXCL_START */
         SYSTEM_ERROR("Size of mpfr_prec_t and long not compatible");
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
     if (sizeof(mpfr_exp_t) != sizeof(long)) {
         /* LCOV_EXCL_START */
         SYSTEM_ERROR("Size of mpfr_exp_t and long not compatible");
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
-    /* Initialize the types. */
+    /* Initialize the types. The rarely used types and the exceptions are
+     * created on first use, see GMPy_Module_GetAttr().
+     */
     if (PyType_Ready(&MPZ_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&MPQ_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&XMPZ_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    if (PyType_Ready(&GMPy_Iter_Type) < 0) {
-        /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&MPFR_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyType_Ready(&CTXT_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    if (PyType_Ready(&MPC_Type) < 0) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    if (PyType_Ready(&RandomState_Type) < 0) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-
-    /* Initialize exceptions. */
-    GMPyExc_GmpyError = PyErr_NewException("gmpy2.gmpy2Error", PyExc_ArithmeticError, NULL);
-    if (!GMPyExc_GmpyError) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-
-    GMPyExc_Erange = PyErr_NewException("gmpy2.RangeError", GMPyExc_GmpyError, NULL);
-    if (!GMPyExc_Erange) {
-        /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
-
-    GMPyExc_Inexact = PyErr_NewException("gmpy2.InexactResultError", GMPyExc_GmpyError, NULL);
-    if (!GMPyExc_Inexact) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-
-    GMPyExc_Overflow = PyErr_NewException("gmpy2.OverflowResultError", GMPyExc_Inexact, NULL);
-    if (!GMPyExc_Overflow) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-
-    GMPyExc_Underflow = PyErr_NewException("gmpy2.UnderflowResultError", GMPyExc_Inexact, NULL);
-    if (!GMPyExc_Underflow) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-
-    temp = PyTuple_Pack(2, GMPyExc_GmpyError, PyExc_ValueError);
-    if (!temp) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    GMPyExc_Invalid = PyErr_NewException("gmpy2.InvalidOperationError", temp, NULL);
-    Py_DECREF(temp);
-    if (!GMPyExc_Invalid) {
-        /* LCOV_EXCL_START */
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-
-    temp = PyTuple_Pack(2, GMPyExc_GmpyError, PyExc_ZeroDivisionError);
-    if (!temp) {
+    if (PyType_Ready(&CTXT_Manager_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
-    GMPyExc_DivZero = PyErr_NewException("gmpy2.DivisionByZeroError", temp, NULL);
-    Py_DECREF(temp);
-    if (!GMPyExc_DivZero) {
+    if (PyType_Ready(&MPC_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
-
-    gmpy_module = PyModule_Create(&moduledef);
-
-    if (gmpy_module == NULL) {
+#ifdef Py_GIL_DISABLED
+    /* Without the GIL two threads could race to create them on first use. */
+    if (GMPy_Init_Exceptions() < 0 ||
+        GMPy_Ready_Type(&GMPy_Iter_Type) < 0 ||
+        GMPy_Ready_Type(&RandomState_Type) < 0 ||
+        GMPy_Ready_Type(&RNS_Type) < 0 ||
+        GMPy_Ready_Type(&MPFR_Array_Type) < 0 ||
+        GMPy_Ready_Type(&Divisor_Type) < 0 ||
+        GMPy_Ready_Type(&PowmodState_Type) < 0 ||
+        GMPy_Ready_Type(&QForm_Type) < 0 ||
+        GMPy_Ready_Type(&EC_Curve_Type) < 0 ||
+        GMPy_Ready_Type(&EC_Point_Type) < 0 ||
+        GMPy_Ready_Type(&MmapXMPZ_Type) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
-
+#endif
 
     /* Add the context type to the module namespace. */
 
@@ -751,89 +1134,53 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
     Py_INCREF(&MPC_Type);
     PyModule_AddObject(gmpy_module, "mpc", (PyObject*)&MPC_Type);
 
-    /* Initialize context var. */
-    if (!(current_context_var = PyContextVar_New("gmpy2_context", NULL))) {
-        return NULL;
+    /* Initialize context var. Only the main interpreter imports gmpy2,
+     * but the module can be imported again after it has been removed from
+     * sys.modules, so it is only created by the first import.
+     */
+    if (!current_context_var &&
+        !(current_context_var = PyContextVar_New("gmpy2_context", NULL))) {
+        return -1;
+    }
+    if (!context_frame_var &&
+        !(context_frame_var = PyContextVar_New("gmpy2_context_frame", NULL))) {
+        return -1;
     }
 
     /* Add the constants for defining rounding modes. */
     if (PyModule_AddIntConstant(gmpy_module, "RoundToNearest", MPFR_RNDN) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundToZero", MPFR_RNDZ) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundUp", MPFR_RNDU) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundDown", MPFR_RNDD) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "RoundAwayZero", MPFR_RNDA) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddIntConstant(gmpy_module, "Default", GMPY_DEFAULT) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
     if (PyModule_AddStringConstant(gmpy_module, "__version__", gmpy_version) < 0) {
         /* LCOV_EXCL_START */
-        return NULL;
-        /* LCOV_EXCL_STOP */
-    }
-
-    /* Add the exceptions. */
-    Py_INCREF(GMPyExc_DivZero);
-    if (PyModule_AddObject(gmpy_module, "DivisionByZeroError", GMPyExc_DivZero) < 0) {
-        /* LCOV_EXCL_START */
-        Py_DECREF(GMPyExc_DivZero);
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    Py_INCREF(GMPyExc_Inexact);
-    if (PyModule_AddObject(gmpy_module, "InexactResultError", GMPyExc_Inexact) < 0) {
-        /* LCOV_EXCL_START */
-        Py_DECREF(GMPyExc_Inexact);
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    Py_INCREF(GMPyExc_Invalid);
-    if (PyModule_AddObject(gmpy_module, "InvalidOperationError", GMPyExc_Invalid) < 0 ) {
-        /* LCOV_EXCL_START */
-        Py_DECREF(GMPyExc_Invalid);
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    Py_INCREF(GMPyExc_Overflow);
-    if (PyModule_AddObject(gmpy_module, "OverflowResultError", GMPyExc_Overflow) < 0) {
-        /* LCOV_EXCL_START */
-        Py_DECREF(GMPyExc_Overflow);
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    Py_INCREF(GMPyExc_Underflow);
-    if (PyModule_AddObject(gmpy_module, "UnderflowResultError", GMPyExc_Underflow) < 0) {
-        /* LCOV_EXCL_START */
-        Py_DECREF(GMPyExc_Underflow);
-        return NULL;;
-        /* LCOV_EXCL_STOP */
-    }
-    Py_INCREF(GMPyExc_Erange);
-    if (PyModule_AddObject(gmpy_module, "RangeError", GMPyExc_Erange) < 0) {
-        /* LCOV_EXCL_START */
-        Py_DECREF(GMPyExc_Erange);
-        return NULL;;
+        return -1;
         /* LCOV_EXCL_STOP */
     }
 
@@ -883,69 +1230,18 @@ PyMODINIT_FUNC PyInit_gmpy2(void)
 #endif
 
     /* Add support for pickling. */
-    copy_reg_module = PyImport_ImportModule("copyreg");
-    if (copy_reg_module) {
-        char* enable_pickle =
-            "def gmpy2_reducer(x): return (gmpy2.from_binary, (gmpy2.to_binary(x),))\n"
-            "copyreg.pickle(gmpy2.mpz, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.xmpz, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.mpq, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.mpfr, gmpy2_reducer)\n"
-            "copyreg.pickle(gmpy2.mpc, gmpy2_reducer)\n";
-
-        namespace = PyDict_New();
-        result = NULL;
-
-        PyDict_SetItemString(namespace, "copyreg", copy_reg_module);
-        PyDict_SetItemString(namespace, "gmpy2", gmpy_module);
-        result = PyRun_String(enable_pickle, Py_file_input, namespace, namespace);
-        if (!result) {
-            /* LCOV_EXCL_START */
-            PyErr_Clear();
-            /* LCOV_EXCL_STOP */
-        }
-        Py_DECREF(namespace);
-        Py_DECREF(copy_reg_module);
-        Py_XDECREF(result);
-    }
-    else {
+    if (GMPy_Register_Pickle(gmpy_module) < 0) {
         /* LCOV_EXCL_START */
         PyErr_Clear();
         /* LCOV_EXCL_STOP */
     }
 
     /* Register the gmpy2 types with the numeric tower. */
-
-    numbers_module = PyImport_ImportModule("numbers");
-    if (numbers_module) {
-        char* register_numbers =
-            "numbers.Integral.register(gmpy2.mpz)\n"
-            "numbers.Rational.register(gmpy2.mpq)\n"
-            "numbers.Real.register(gmpy2.mpfr)\n"
-            "numbers.Complex.register(gmpy2.mpc)\n"
-        ;
-        namespace = PyDict_New();
-        result = NULL;
-
-        PyDict_SetItemString(namespace, "numbers", numbers_module);
-        PyDict_SetItemString(namespace, "gmpy2", gmpy_module);
-        result = PyRun_String(register_numbers, Py_file_input,
-                              namespace, namespace);
-        if (!result) {
-            /* LCOV_EXCL_START */
-            PyErr_Clear();
-            /* LCOV_EXCL_STOP */
-        }
-
-        Py_DECREF(namespace);
-        Py_DECREF(numbers_module);
-        Py_XDECREF(result);
-    }
-    else {
+    if (GMPy_Register_Numbers() < 0) {
         /* LCOV_EXCL_START */
         PyErr_Clear();
         /* LCOV_EXCL_STOP */
     }
 
-    return gmpy_module;
+    return 0;
 }
@@ -176,6 +176,7 @@ typedef struct {
     int allow_complex;       /* if 1, allow mpfr functions to return an mpc */
     int rational_division;   /* if 1, mpz/mpz returns an mpq result */
     int allow_release_gil;   /* if 1, allow mpz functions to release the GIL */
+    int threads;             /* maximum number of threads for one operation */
 } gmpy_context;
 
 typedef struct {
@@ -339,6 +340,38 @@ typedef struct {
 # endif
 #endif
 
+/* Free-threaded builds (PEP 703) have no GIL to serialize access to the
+ * object caches, mutable objects and lazily built tables. The caches are
+ * kept per thread, xmpz and context updates run inside critical sections
+ * and the tables are guarded by a mutex. With the GIL these are no-ops.
+ */
+
+#ifdef Py_GIL_DISABLED
+#  ifdef _MSC_VER
+#    define GMPY_THREAD_LOCAL __declspec(thread)
+#  else
+#    define GMPY_THREAD_LOCAL _Thread_local
+#  endif
+#  define GMPY_MUTEX(name) static PyMutex name = {0}
+#  define GMPY_LOCK(name) PyMutex_Lock(&(name))
+#  define GMPY_UNLOCK(name) PyMutex_Unlock(&(name))
+   /* Reset the reference count and owning thread of a cached object. */
+#  define GMPY_REVIVE(obj) PyObject_Init((PyObject*)(obj), Py_TYPE(obj))
+#else
+#  define GMPY_THREAD_LOCAL
+#  define GMPY_MUTEX(name) static int name = 0
+#  define GMPY_LOCK(name) (void)(name)
+#  define GMPY_UNLOCK(name) (void)(name)
+#  define GMPY_REVIVE(obj) Py_INCREF((PyObject*)(obj))
+#endif
+
+#ifndef Py_BEGIN_CRITICAL_SECTION
+#  define Py_BEGIN_CRITICAL_SECTION(op) {
+#  define Py_END_CRITICAL_SECTION() }
+#  define Py_BEGIN_CRITICAL_SECTION2(a, b) {
+#  define Py_END_CRITICAL_SECTION2() }
+#endif
+
 #define ALLOC_THRESHOLD 8192
 
 #define INDEX_ERROR(msg)    PyErr_SetString(PyExc_IndexError, msg)
@@ -414,6 +447,10 @@ typedef struct {
 
 #include "gmpy2_misc.h"
 
+/* Support for progress reporting. */
+
+#include "gmpy2_progress.h"
+
 /* Support conversion to/from binary format. */
 
 #include "gmpy2_binary.h"
@@ -428,6 +465,8 @@ typedef struct {
 
 #include "gmpy2_mpz_divmod.h"
 #include "gmpy2_mpz_divmod2exp.h"
+#include "gmpy2_divisor.h"
+#include "gmpy2_checkpoint.h"
 #include "gmpy2_mpz_pack.h"
 #include "gmpy2_mpz_bitops.h"
 #include "gmpy2_mpz_misc.h"
@@ -435,6 +474,7 @@ typedef struct {
 #include "gmpy2_xmpz_inplace.h"
 #include "gmpy2_xmpz_misc.h"
 #include "gmpy2_xmpz_limbs.h"
+#include "gmpy2_xmpz_mmap.h"
 
 /* Support for mpq specific functions. */
 
@@ -456,6 +496,26 @@ typedef struct {
 
 #include "gmpy_mpz_prp.h"
 
+/* Support primality proofs. */
+
+#include "gmpy2_mpz_prove.h"
+#include "gmpy2_mpz_dlog.h"
+
+/* Support residue number system vectors. */
+
+#include "gmpy2_rns.h"
+#include "gmpy2_mpfr_array.h"
+#include "gmpy2_ntt.h"
+#include "gmpy2_powm_parallel.h"
+#include "gmpy2_vdf.h"
+#include "gmpy2_qform.h"
+#include "gmpy2_ec.h"
+#include "gmpy2_lattice.h"
+
+/* Support bulk conversion to and from NumPy arrays. */
+
+#include "gmpy2_numpy.h"
+
 /* Support higher-level Python methods and functions; generally not
  * specific to a single type.
  */
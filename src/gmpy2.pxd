@@ -20,11 +20,119 @@ cdef extern from "gmp.h":
     ctypedef __mpq_struct *mpq_ptr
     ctypedef const __mpq_struct *mpq_srcptr
 
+    ctypedef unsigned long mp_bitcnt_t
+    ctypedef long mp_size_t
+
     void mpz_set(mpz_t rop, mpz_t op)
     void mpq_set(mpq_ptr rop, mpq_srcptr op)
     void mpq_set_num(mpq_t rational, mpz_t numerator)
     void mpq_set_den(mpq_t rational, mpz_t denominator)
 
+    # The functions below only touch the values passed to them and may be
+    # called without the GIL (see "Releasing the GIL" in the documentation).
+
+    # mpz initialization and assignment
+    void mpz_init(mpz_ptr rop) nogil
+    void mpz_init2(mpz_ptr rop, mp_bitcnt_t n) nogil
+    void mpz_clear(mpz_ptr rop) nogil
+    void mpz_swap(mpz_ptr rop1, mpz_ptr rop2) nogil
+    void mpz_set_si(mpz_ptr rop, long op) nogil
+    void mpz_set_ui(mpz_ptr rop, unsigned long op) nogil
+    void mpz_set_d(mpz_ptr rop, double op) nogil
+    int mpz_set_str(mpz_ptr rop, const char *str, int base) nogil
+    long mpz_get_si(mpz_srcptr op) nogil
+    unsigned long mpz_get_ui(mpz_srcptr op) nogil
+    double mpz_get_d(mpz_srcptr op) nogil
+    bint mpz_fits_slong_p(mpz_srcptr op) nogil
+    bint mpz_fits_ulong_p(mpz_srcptr op) nogil
+
+    # mpz arithmetic
+    void mpz_add(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_add_ui(mpz_ptr rop, mpz_srcptr op1, unsigned long op2) nogil
+    void mpz_sub(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_sub_ui(mpz_ptr rop, mpz_srcptr op1, unsigned long op2) nogil
+    void mpz_ui_sub(mpz_ptr rop, unsigned long op1, mpz_srcptr op2) nogil
+    void mpz_mul(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_mul_si(mpz_ptr rop, mpz_srcptr op1, long op2) nogil
+    void mpz_mul_ui(mpz_ptr rop, mpz_srcptr op1, unsigned long op2) nogil
+    void mpz_addmul(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_addmul_ui(mpz_ptr rop, mpz_srcptr op1, unsigned long op2) nogil
+    void mpz_submul(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_submul_ui(mpz_ptr rop, mpz_srcptr op1, unsigned long op2) nogil
+    void mpz_mul_2exp(mpz_ptr rop, mpz_srcptr op1, mp_bitcnt_t op2) nogil
+    void mpz_neg(mpz_ptr rop, mpz_srcptr op) nogil
+    void mpz_abs(mpz_ptr rop, mpz_srcptr op) nogil
+
+    # mpz division, the divisor must not be zero
+    void mpz_fdiv_q(mpz_ptr q, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_fdiv_r(mpz_ptr r, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_fdiv_qr(mpz_ptr q, mpz_ptr r, mpz_srcptr n, mpz_srcptr d) nogil
+    unsigned long mpz_fdiv_q_ui(mpz_ptr q, mpz_srcptr n, unsigned long d) nogil
+    unsigned long mpz_fdiv_r_ui(mpz_ptr r, mpz_srcptr n, unsigned long d) nogil
+    void mpz_fdiv_q_2exp(mpz_ptr q, mpz_srcptr n, mp_bitcnt_t b) nogil
+    void mpz_fdiv_r_2exp(mpz_ptr r, mpz_srcptr n, mp_bitcnt_t b) nogil
+    void mpz_tdiv_q(mpz_ptr q, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_tdiv_r(mpz_ptr r, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_tdiv_qr(mpz_ptr q, mpz_ptr r, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_tdiv_q_2exp(mpz_ptr q, mpz_srcptr n, mp_bitcnt_t b) nogil
+    void mpz_cdiv_q(mpz_ptr q, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_mod(mpz_ptr r, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_divexact(mpz_ptr q, mpz_srcptr n, mpz_srcptr d) nogil
+    void mpz_divexact_ui(mpz_ptr q, mpz_srcptr n, unsigned long d) nogil
+    bint mpz_divisible_p(mpz_srcptr n, mpz_srcptr d) nogil
+    bint mpz_congruent_p(mpz_srcptr n, mpz_srcptr c, mpz_srcptr d) nogil
+
+    # mpz exponentiation and roots
+    void mpz_pow_ui(mpz_ptr rop, mpz_srcptr base, unsigned long exp) nogil
+    void mpz_powm(mpz_ptr rop, mpz_srcptr base, mpz_srcptr exp, mpz_srcptr mod) nogil
+    void mpz_powm_ui(mpz_ptr rop, mpz_srcptr base, unsigned long exp, mpz_srcptr mod) nogil
+    void mpz_sqrt(mpz_ptr rop, mpz_srcptr op) nogil
+    bint mpz_root(mpz_ptr rop, mpz_srcptr op, unsigned long n) nogil
+    bint mpz_perfect_square_p(mpz_srcptr op) nogil
+
+    # mpz number theory
+    int mpz_probab_prime_p(mpz_srcptr n, int reps) nogil
+    void mpz_nextprime(mpz_ptr rop, mpz_srcptr op) nogil
+    void mpz_gcd(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_gcdext(mpz_ptr g, mpz_ptr s, mpz_ptr t, mpz_srcptr a, mpz_srcptr b) nogil
+    void mpz_lcm(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    bint mpz_invert(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    int mpz_jacobi(mpz_srcptr a, mpz_srcptr b) nogil
+
+    # mpz comparison
+    int mpz_cmp(mpz_srcptr op1, mpz_srcptr op2) nogil
+    int mpz_cmp_si(mpz_srcptr op1, long op2) nogil
+    int mpz_cmp_ui(mpz_srcptr op1, unsigned long op2) nogil
+    int mpz_cmpabs(mpz_srcptr op1, mpz_srcptr op2) nogil
+    int mpz_sgn(mpz_srcptr op) nogil
+
+    # mpz bit manipulation
+    void mpz_and(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_ior(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_xor(mpz_ptr rop, mpz_srcptr op1, mpz_srcptr op2) nogil
+    void mpz_com(mpz_ptr rop, mpz_srcptr op) nogil
+    mp_bitcnt_t mpz_popcount(mpz_srcptr op) nogil
+    mp_bitcnt_t mpz_scan0(mpz_srcptr op, mp_bitcnt_t starting_bit) nogil
+    mp_bitcnt_t mpz_scan1(mpz_srcptr op, mp_bitcnt_t starting_bit) nogil
+    void mpz_setbit(mpz_ptr rop, mp_bitcnt_t bit_index) nogil
+    void mpz_clrbit(mpz_ptr rop, mp_bitcnt_t bit_index) nogil
+    int mpz_tstbit(mpz_srcptr op, mp_bitcnt_t bit_index) nogil
+    size_t mpz_sizeinbase(mpz_srcptr op, int base) nogil
+    size_t mpz_size(mpz_srcptr op) nogil
+
+    # mpq
+    void mpq_init(mpq_ptr x) nogil
+    void mpq_clear(mpq_ptr x) nogil
+    void mpq_set_si(mpq_ptr rop, long op1, unsigned long op2) nogil
+    void mpq_canonicalize(mpq_ptr op) nogil
+    void mpq_add(mpq_ptr rop, mpq_srcptr op1, mpq_srcptr op2) nogil
+    void mpq_sub(mpq_ptr rop, mpq_srcptr op1, mpq_srcptr op2) nogil
+    void mpq_mul(mpq_ptr rop, mpq_srcptr op1, mpq_srcptr op2) nogil
+    void mpq_div(mpq_ptr rop, mpq_srcptr op1, mpq_srcptr op2) nogil
+    void mpq_neg(mpq_ptr rop, mpq_srcptr op) nogil
+    int mpq_cmp(mpq_srcptr op1, mpq_srcptr op2) nogil
+    int mpq_sgn(mpq_srcptr op) nogil
+
 
 cdef extern from "mpfr.h":
     # mpfr reals
@@ -54,6 +162,67 @@ cdef extern from "mpfr.h":
     mpfr_prec_t mpfr_get_prec(mpfr_t x)
     int mpfr_set(mpfr_t rop, mpfr_t op, mpfr_rnd_t rnd)
 
+    # The functions below only touch the values passed to them and may be
+    # called without the GIL. The exception flags and exponent range they
+    # use belong to MPFR, not to the gmpy2 context.
+
+    # mpfr initialization and assignment
+    void mpfr_init2(mpfr_ptr x, mpfr_prec_t prec) nogil
+    void mpfr_clear(mpfr_ptr x) nogil
+    void mpfr_set_prec(mpfr_ptr x, mpfr_prec_t prec) nogil
+    int mpfr_prec_round(mpfr_ptr x, mpfr_prec_t prec, mpfr_rnd_t rnd) nogil
+    int mpfr_set_si(mpfr_ptr rop, long op, mpfr_rnd_t rnd) nogil
+    int mpfr_set_ui(mpfr_ptr rop, unsigned long op, mpfr_rnd_t rnd) nogil
+    int mpfr_set_d(mpfr_ptr rop, double op, mpfr_rnd_t rnd) nogil
+    int mpfr_set_z(mpfr_ptr rop, mpz_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_set_q(mpfr_ptr rop, mpq_srcptr op, mpfr_rnd_t rnd) nogil
+    void mpfr_set_nan(mpfr_ptr x) nogil
+    void mpfr_set_inf(mpfr_ptr x, int sign) nogil
+    void mpfr_set_zero(mpfr_ptr x, int sign) nogil
+    double mpfr_get_d(mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    long mpfr_get_si(mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_get_z(mpz_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+
+    # mpfr arithmetic
+    int mpfr_add(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) nogil
+    int mpfr_add_si(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) nogil
+    int mpfr_add_d(mpfr_ptr rop, mpfr_srcptr op1, double op2, mpfr_rnd_t rnd) nogil
+    int mpfr_sub(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) nogil
+    int mpfr_sub_si(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) nogil
+    int mpfr_mul(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) nogil
+    int mpfr_mul_si(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) nogil
+    int mpfr_mul_d(mpfr_ptr rop, mpfr_srcptr op1, double op2, mpfr_rnd_t rnd) nogil
+    int mpfr_div(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) nogil
+    int mpfr_div_si(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) nogil
+    int mpfr_sqr(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_sqrt(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_fma(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_srcptr op3, mpfr_rnd_t rnd) nogil
+    int mpfr_fms(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_srcptr op3, mpfr_rnd_t rnd) nogil
+    int mpfr_neg(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_abs(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_pow(mpfr_ptr rop, mpfr_srcptr op1, mpfr_srcptr op2, mpfr_rnd_t rnd) nogil
+    int mpfr_pow_si(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) nogil
+    int mpfr_mul_2si(mpfr_ptr rop, mpfr_srcptr op1, long op2, mpfr_rnd_t rnd) nogil
+
+    # mpfr special functions
+    int mpfr_exp(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_log(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_sin(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_cos(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_tan(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_atan(mpfr_ptr rop, mpfr_srcptr op, mpfr_rnd_t rnd) nogil
+    int mpfr_atan2(mpfr_ptr rop, mpfr_srcptr y, mpfr_srcptr x, mpfr_rnd_t rnd) nogil
+    int mpfr_const_pi(mpfr_ptr rop, mpfr_rnd_t rnd) nogil
+
+    # mpfr comparison
+    int mpfr_cmp(mpfr_srcptr op1, mpfr_srcptr op2) nogil
+    int mpfr_cmp_si(mpfr_srcptr op1, long op2) nogil
+    int mpfr_sgn(mpfr_srcptr op) nogil
+    bint mpfr_nan_p(mpfr_srcptr op) nogil
+    bint mpfr_inf_p(mpfr_srcptr op) nogil
+    bint mpfr_zero_p(mpfr_srcptr op) nogil
+    bint mpfr_number_p(mpfr_srcptr op) nogil
+
 
 cdef extern from "mpc.h":
     # mpc complexes
@@ -97,6 +266,8 @@ cdef extern from "gmpy2.h":
     # Object types
     ctypedef class gmpy2.mpz [object MPZ_Object]:
         cdef mpz_t z
+    ctypedef class gmpy2.xmpz [object XMPZ_Object]:
+        cdef mpz_t z
     ctypedef class gmpy2.mpq [object MPQ_Object]:
         cdef mpq_t q
     ctypedef class gmpy2.mpfr [object MPFR_Object]:
@@ -108,6 +279,7 @@ cdef extern from "gmpy2.h":
 
     # Object creation
     cdef mpz GMPy_MPZ_New(void *)
+    cdef xmpz GMPy_XMPZ_New(void *)
     cdef mpq GMPy_MPQ_New(void *)
     cdef mpfr GMPy_MPFR_New(mpfr_prec_t prec, void *)
     cdef mpc GMPy_MPC_New(mpfr_prec_t rprec, mpfr_prec_t iprec, void *)
@@ -120,6 +292,7 @@ cdef extern from "gmpy2.h":
 
     # Type check
     cdef bint MPZ_Check(object)
+    cdef bint XMPZ_Check(object)
     cdef bint MPQ_Check(object)
     cdef bint MPFR_Check(object)
     cdef bint MPC_Check(object)
@@ -168,3 +341,96 @@ cdef inline mpc GMPy_MPC_From_mpfr(mpfr_srcptr re, mpfr_srcptr im):
     mpfr_set(res.c.re, re, MPFR_RNDN)
     mpfr_set(res.c.im, im, MPFR_RNDN)
     return res
+
+
+# Arithmetic without the Python number protocol. Each function creates the
+# result object and computes directly into its value, so no temporary is
+# copied. Arguments must not be None. The mpfr functions round to prec bits
+# (0 means the precision of the current context) with the rounding mode rnd
+# and store the ternary value in the rc field. They do not check or update
+# the flags of the gmpy2 context.
+
+cdef inline mpz GMPy_MPZ_Add(mpz x, mpz y):
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    mpz_add(res.z, x.z, y.z)
+    return res
+
+cdef inline mpz GMPy_MPZ_Sub(mpz x, mpz y):
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    mpz_sub(res.z, x.z, y.z)
+    return res
+
+cdef inline mpz GMPy_MPZ_Mul(mpz x, mpz y):
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    mpz_mul(res.z, x.z, y.z)
+    return res
+
+cdef inline mpz GMPy_MPZ_FloorDiv(mpz x, mpz y):
+    if mpz_sgn(y.z) == 0:
+        raise ZeroDivisionError("division or modulo by zero")
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    mpz_fdiv_q(res.z, x.z, y.z)
+    return res
+
+cdef inline mpz GMPy_MPZ_Mod(mpz x, mpz y):
+    if mpz_sgn(y.z) == 0:
+        raise ZeroDivisionError("division or modulo by zero")
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    mpz_fdiv_r(res.z, x.z, y.z)
+    return res
+
+cdef inline mpz GMPy_MPZ_Neg(mpz x):
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    mpz_neg(res.z, x.z)
+    return res
+
+cdef inline mpz GMPy_MPZ_Pow(mpz x, unsigned long e):
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    mpz_pow_ui(res.z, x.z, e)
+    return res
+
+cdef inline mpz GMPy_MPZ_PowMod(mpz x, mpz e, mpz m):
+    if mpz_sgn(m.z) == 0:
+        raise ValueError("pow() 3rd argument cannot be 0")
+    cdef mpz res = GMPy_MPZ_New(NULL)
+    cdef mpz_t t
+    if mpz_sgn(e.z) < 0:
+        if not mpz_invert(res.z, x.z, m.z):
+            raise ValueError("pow() base not invertible")
+        mpz_init(t)
+        mpz_neg(t, e.z)
+        mpz_powm(res.z, res.z, t, m.z)
+        mpz_clear(t)
+    else:
+        mpz_powm(res.z, x.z, e.z, m.z)
+    return res
+
+cdef inline mpfr GMPy_MPFR_Add(mpfr x, mpfr y, mpfr_prec_t prec=0, mpfr_rnd_t rnd=MPFR_RNDN):
+    cdef mpfr res = GMPy_MPFR_New(prec, NULL)
+    res.rc = mpfr_add(res.f, x.f, y.f, rnd)
+    return res
+
+cdef inline mpfr GMPy_MPFR_Sub(mpfr x, mpfr y, mpfr_prec_t prec=0, mpfr_rnd_t rnd=MPFR_RNDN):
+    cdef mpfr res = GMPy_MPFR_New(prec, NULL)
+    res.rc = mpfr_sub(res.f, x.f, y.f, rnd)
+    return res
+
+cdef inline mpfr GMPy_MPFR_Mul(mpfr x, mpfr y, mpfr_prec_t prec=0, mpfr_rnd_t rnd=MPFR_RNDN):
+    cdef mpfr res = GMPy_MPFR_New(prec, NULL)
+    res.rc = mpfr_mul(res.f, x.f, y.f, rnd)
+    return res
+
+cdef inline mpfr GMPy_MPFR_Div(mpfr x, mpfr y, mpfr_prec_t prec=0, mpfr_rnd_t rnd=MPFR_RNDN):
+    cdef mpfr res = GMPy_MPFR_New(prec, NULL)
+    res.rc = mpfr_div(res.f, x.f, y.f, rnd)
+    return res
+
+cdef inline mpfr GMPy_MPFR_Fma(mpfr x, mpfr y, mpfr z, mpfr_prec_t prec=0, mpfr_rnd_t rnd=MPFR_RNDN):
+    cdef mpfr res = GMPy_MPFR_New(prec, NULL)
+    res.rc = mpfr_fma(res.f, x.f, y.f, z.f, rnd)
+    return res
+
+cdef inline mpfr GMPy_MPFR_Sqrt(mpfr x, mpfr_prec_t prec=0, mpfr_rnd_t rnd=MPFR_RNDN):
+    cdef mpfr res = GMPy_MPFR_New(prec, NULL)
+    res.rc = mpfr_sqrt(res.f, x.f, rnd)
+    return res
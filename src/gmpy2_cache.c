@@ -29,6 +29,81 @@
  * memory allocation or object construction.
  */
 
+/* In free-threaded builds the caches are per thread. Before a thread caches
+ * its first object, a capsule is stored in its thread state dictionary. The
+ * dictionary is cleared when the thread exits, and the capsule's destructor
+ * then frees the cached objects. After that the thread no longer caches.
+ */
+
+#ifdef Py_GIL_DISABLED
+static void
+GMPy_Cache_Drain(PyObject *capsule)
+{
+    /* Only the owning thread can reach its caches. */
+    if (PyCapsule_GetPointer(capsule, "gmpy2._cache") != (void*)&global) {
+        return;
+    }
+
+    global.cache_state = -1;
+    while (global.in_gmpympzcache) {
+        MPZ_Object *obj = global.gmpympzcache[--(global.in_gmpympzcache)];
+        mpz_clear(obj->z);
+        PyObject_Free(obj);
+    }
+    while (global.in_gmpyxmpzcache) {
+        XMPZ_Object *obj = global.gmpyxmpzcache[--(global.in_gmpyxmpzcache)];
+        mpz_clear(obj->z);
+        PyObject_Free(obj);
+    }
+    while (global.in_gmpympqcache) {
+        MPQ_Object *obj = global.gmpympqcache[--(global.in_gmpympqcache)];
+        mpq_clear(obj->q);
+        PyObject_Free(obj);
+    }
+    while (global.in_gmpympfrcache) {
+        MPFR_Object *obj = global.gmpympfrcache[--(global.in_gmpympfrcache)];
+        mpfr_clear(obj->f);
+        PyObject_Free(obj);
+    }
+    while (global.in_gmpympccache) {
+        MPC_Object *obj = global.gmpympccache[--(global.in_gmpympccache)];
+        mpc_clear(obj->c);
+        PyObject_Free(obj);
+    }
+    while (global.in_gmpyctxtcache) {
+        PyObject_Free(global.gmpyctxtcache[--(global.in_gmpyctxtcache)]);
+    }
+}
+
+/* Called from the deallocators, so any pending exception is preserved. An
+ * object is only cached once the capsule is in place.
+ */
+
+static int
+GMPy_Cache_Attach(void)
+{
+    PyObject *exc, *dict, *capsule;
+    int ok = 0;
+
+    exc = PyErr_GetRaisedException();
+    if ((dict = PyThreadState_GetDict()) &&
+        (capsule = PyCapsule_New((void*)&global, "gmpy2._cache",
+                                 GMPy_Cache_Drain))) {
+        ok = PyDict_SetItemString(dict, "gmpy2._cache", capsule) == 0;
+        Py_DECREF(capsule);
+    }
+    PyErr_Clear();
+    PyErr_SetRaisedException(exc);
+    global.cache_state = ok ? 1 : -1;
+    return ok;
+}
+
+#  define GMPY_CACHE_ENABLED() \
+    (global.cache_state > 0 || (global.cache_state == 0 && GMPy_Cache_Attach()))
+#else
+#  define GMPY_CACHE_ENABLED() 1
+#endif
+
 /* Caching logic for Pympz. */
 
 /* GMPy_MPZ_New returns a reference to a new MPZ_Object. Its value
@@ -42,7 +117,7 @@ GMPy_MPZ_New(CTXT_Object *context)
 
     if (global.in_gmpympzcache) {
         result = global.gmpympzcache[--(global.in_gmpympzcache)];
-        Py_INCREF((PyObject*)result);
+        GMPY_REVIVE(result);
         mpz_set_ui(result->z, 0);
     }
     else {
@@ -127,6 +202,14 @@ GMPy_MPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
             return (PyObject*)GMPy_MPZ_From_PyStr(n, base, context);
         }
 
+        if (IS_DECIMAL(n)) {
+            return (PyObject*)GMPy_MPZ_From_Decimal(n, context);
+        }
+
+        if (IS_NUMPY_INTEGER(n)) {
+            return (PyObject*)GMPy_MPZ_From_NumPy(n, context);
+        }
+
         if (HAS_MPZ_CONVERSION(n)) {
             out = (PyObject *) PyObject_CallMethod(n, "__mpz__", NULL);
 
@@ -179,7 +262,8 @@ GMPy_MPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 static void
 GMPy_MPZ_Dealloc(MPZ_Object *self)
 {
-   if (global.in_gmpympzcache < CACHE_SIZE &&
+   if (GMPY_CACHE_ENABLED() &&
+       global.in_gmpympzcache < CACHE_SIZE &&
        self->z->_mp_alloc <= MAX_CACHE_MPZ_LIMBS) {
         
         global.gmpympzcache[(global.in_gmpympzcache)++] = self;
@@ -199,7 +283,7 @@ GMPy_XMPZ_New(CTXT_Object *context)
 
     if (global.in_gmpyxmpzcache) {
         result = global.gmpyxmpzcache[--(global.in_gmpyxmpzcache)];
-        Py_INCREF((PyObject*)result);
+        GMPY_REVIVE(result);
         mpz_set_ui(result->z, 0);
     }
     else {
@@ -315,7 +399,8 @@ GMPy_XMPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 static void
 GMPy_XMPZ_Dealloc(XMPZ_Object *self)
 {
-   if (global.in_gmpyxmpzcache < CACHE_SIZE &&
+   if (GMPY_CACHE_ENABLED() &&
+       global.in_gmpyxmpzcache < CACHE_SIZE &&
        self->z->_mp_alloc <= MAX_CACHE_MPZ_LIMBS) {
         
         global.gmpyxmpzcache[(global.in_gmpyxmpzcache)++] = self;
@@ -335,7 +420,7 @@ GMPy_MPQ_New(CTXT_Object *context)
 
     if (global.in_gmpympqcache) {
         result = global.gmpympqcache[--(global.in_gmpympqcache)];
-        Py_INCREF((PyObject*)result);
+        GMPY_REVIVE(result);
         mpq_set_ui(result->q, 0, 1);
     }
     else {
@@ -407,7 +492,7 @@ GMPy_MPQ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 
     /* Handle 1 argument. It must be non-complex number or an object with a __mpq__ method. */
     if (argc == 1) {
-        if (IS_REAL(n)) {
+        if (IS_REAL(n) || IS_DECIMAL(n)) {
             return (PyObject *) GMPy_MPQ_From_Number(n, context);
         }
     }
@@ -445,7 +530,8 @@ GMPy_MPQ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 static void
 GMPy_MPQ_Dealloc(MPQ_Object *self)
 {
-    if (global.in_gmpympqcache < CACHE_SIZE &&
+    if (GMPY_CACHE_ENABLED() &&
+        global.in_gmpympqcache < CACHE_SIZE &&
         mpq_numref(self->q)->_mp_alloc <= MAX_CACHE_MPZ_LIMBS &&
         mpq_denref(self->q)->_mp_alloc <= MAX_CACHE_MPZ_LIMBS) {
 
@@ -476,7 +562,7 @@ GMPy_MPFR_New(mpfr_prec_t bits, CTXT_Object *context)
 
     if (global.in_gmpympfrcache) {
         result = global.gmpympfrcache[--(global.in_gmpympfrcache)];
-        Py_INCREF((PyObject*)result);
+        GMPY_REVIVE(result);
     }
     else {
         result = PyObject_New(MPFR_Object, &MPFR_Type);
@@ -580,7 +666,7 @@ GMPy_MPFR_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
     }
 
     /* A number can only have precision and context as additional arguments. */
-    if (IS_REAL(arg0)) {
+    if (IS_REAL(arg0) || IS_DECIMAL(arg0)) {
         if (keywdc || argc > 1) {
             if (!(PyArg_ParseTupleAndKeywords(args, keywds, "O|lO", kwlist_n,
                                               &arg0, &prec, &context)))
@@ -607,7 +693,8 @@ GMPy_MPFR_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 static void
 GMPy_MPFR_Dealloc(MPFR_Object *self)
 {
-    if (global.in_gmpympfrcache < CACHE_SIZE &&
+    if (GMPY_CACHE_ENABLED() &&
+        global.in_gmpympfrcache < CACHE_SIZE &&
         self->f->_mpfr_prec <= MAX_CACHE_MPFR_BITS) {
 
         global.gmpympfrcache[(global.in_gmpympfrcache)++] = self;
@@ -640,7 +727,7 @@ GMPy_MPC_New(mpfr_prec_t rprec, mpfr_prec_t iprec, CTXT_Object *context)
     }
     if (global.in_gmpympccache) {
         result = global.gmpympccache[--(global.in_gmpympccache)];
-        Py_INCREF((PyObject*)result);
+        GMPY_REVIVE(result);
     }
     else {
         result = PyObject_New(MPC_Object, &MPC_Type);
@@ -766,7 +853,7 @@ GMPy_MPC_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 
     /* Should special case PyFLoat to avoid double rounding. */
 
-    if (IS_REAL(arg0)) {
+    if (IS_REAL(arg0) || IS_DECIMAL(arg0)) {
         if (keywdc || argc > 1) {
             if (!(PyArg_ParseTupleAndKeywords(args, keywds, "O|OOO", kwlist_r,
                                             &arg0, &arg1, &prec, &context)))
@@ -803,7 +890,7 @@ GMPy_MPC_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
             }
         }
 
-        if (arg1 && !IS_REAL(arg1)) {
+        if (arg1 && !IS_REAL(arg1) && !IS_DECIMAL(arg1)) {
             TYPE_ERROR("invalid type for imaginary component in mpc()");
             return NULL;
         }
@@ -881,7 +968,8 @@ GMPy_MPC_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
 static void
 GMPy_MPC_Dealloc(MPC_Object *self)
 {
-    if (global.in_gmpympccache < CACHE_SIZE &&
+    if (GMPY_CACHE_ENABLED() &&
+        global.in_gmpympccache < CACHE_SIZE &&
         mpc_realref(self->c)->_mpfr_prec <= MAX_CACHE_MPFR_BITS &&
         mpc_imagref(self->c)->_mpfr_prec <= MAX_CACHE_MPFR_BITS) {
 
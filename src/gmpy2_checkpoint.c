@@ -0,0 +1,671 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_checkpoint.c                                                      *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Checkpoints for long-running computations.
+ *
+ * save_checkpoint() and load_checkpoint() store a list of gmpy2 objects in
+ * the to_binary() format. The values are converted and written one at a
+ * time to a temporary file that is flushed to disk with fsync() and then
+ * renamed over the checkpoint, so an interrupted save leaves the previous
+ * checkpoint intact. File access goes through the io and os modules so any
+ * path-like object works on every platform.
+ *
+ * powmod_state is a left-to-right modular exponentiation that can be run a
+ * number of exponent bits at a time and saved between the steps.
+ */
+
+static void
+checkpoint_put_u64(char *buf, unsigned long long x)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        buf[i] = (char)(x & 0xff);
+        x >>= 8;
+    }
+}
+
+static unsigned long long
+checkpoint_get_u64(const char *buf)
+{
+    unsigned long long x = 0;
+    int i;
+
+    for (i = 7; i >= 0; i--) {
+        x = (x << 8) | (unsigned char)buf[i];
+    }
+    return x;
+}
+
+/* Call file.write() with a bytes object or with len bytes of data. */
+
+static int
+checkpoint_write(PyObject *file, PyObject *bytes, const char *data, Py_ssize_t len)
+{
+    PyObject *temp = NULL, *res;
+
+    if (!bytes && !(bytes = temp = PyBytes_FromStringAndSize(data, len))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    res = PyObject_CallMethod(file, "write", "O", bytes);
+    Py_XDECREF(temp);
+    if (!res) {
+        return -1;
+    }
+    Py_DECREF(res);
+    return 0;
+}
+
+/* Return exactly len bytes read from file. */
+
+static PyObject *
+checkpoint_read(PyObject *file, Py_ssize_t len)
+{
+    PyObject *result;
+
+    if (!(result = PyObject_CallMethod(file, "read", "n", len))) {
+        return NULL;
+    }
+    if (!PyBytes_Check(result) || PyBytes_GET_SIZE(result) != len) {
+        Py_DECREF(result);
+        VALUE_ERROR("truncated checkpoint file");
+        return NULL;
+    }
+    return result;
+}
+
+/* Flush the directory entry of path to disk. This is not possible on all
+ * platforms, so errors are ignored.
+ */
+
+static void
+checkpoint_sync_dir(PyObject *os, PyObject *path)
+{
+    PyObject *dir = NULL, *flags = NULL, *fd = NULL, *res;
+
+    if ((res = PyObject_GetAttrString(os, "path"))) {
+        dir = PyObject_CallMethod(res, "dirname", "O", path);
+        Py_DECREF(res);
+    }
+    if (dir && PyObject_Length(dir) == 0) {
+        Py_DECREF(dir);
+        dir = PyObject_GetAttrString(os, "curdir");
+    }
+    if (dir && (flags = PyObject_GetAttrString(os, "O_RDONLY")) &&
+        (fd = PyObject_CallMethod(os, "open", "OO", dir, flags))) {
+        res = PyObject_CallMethod(os, "fsync", "O", fd);
+        Py_XDECREF(res);
+        PyErr_Clear();
+        res = PyObject_CallMethod(os, "close", "O", fd);
+        Py_XDECREF(res);
+    }
+    Py_XDECREF(fd);
+    Py_XDECREF(flags);
+    Py_XDECREF(dir);
+    PyErr_Clear();
+}
+
+/* Save the gmpy2 objects and integers in values to path. Integers are
+ * saved as mpz. Returns 0 on success and -1 if an exception was raised.
+ */
+
+static int
+GMPy_Checkpoint_Write(PyObject *path, PyObject *values)
+{
+    PyObject *seq, *fspath = NULL, *tmp = NULL, *io = NULL, *os = NULL;
+    PyObject *file = NULL, *item, *temp, *res;
+    PyObject *exc_type, *exc_value, *exc_tb;
+    Py_ssize_t i, n;
+    char header[16];
+    int rc = -1;
+
+    if (!(seq = PySequence_Fast(values, "save_checkpoint() requires a sequence of values"))) {
+        return -1;
+    }
+    n = PySequence_Fast_GET_SIZE(seq);
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!(MPZ_Check(item) || XMPZ_Check(item) || MPQ_Check(item) ||
+              MPFR_Check(item) || MPC_Check(item) || IS_INTEGER(item))) {
+            TYPE_ERROR("save_checkpoint() requires gmpy2 objects or integers");
+            goto done;
+        }
+    }
+
+    if (!(fspath = PyOS_FSPath(path)) ||
+        !(temp = PyBytes_Check(fspath) ? PyBytes_FromString(".tmp")
+                                       : PyUnicode_FromString(".tmp"))) {
+        goto done;
+    }
+    tmp = PyNumber_Add(fspath, temp);
+    Py_DECREF(temp);
+    if (!tmp ||
+        !(io = PyImport_ImportModule("io")) ||
+        !(os = PyImport_ImportModule("os")) ||
+        !(file = PyObject_CallMethod(io, "open", "Os", tmp, "wb"))) {
+        goto done;
+    }
+
+    memcpy(header, GMPY_CHECKPOINT_MAGIC, 8);
+    checkpoint_put_u64(header + 8, (unsigned long long)n);
+    if (checkpoint_write(file, NULL, header, 16) < 0) {
+        goto error;
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (IS_INTEGER(item) && !MPZ_Check(item) && !XMPZ_Check(item)) {
+            if (!(item = (PyObject*)GMPy_MPZ_From_Integer(item, NULL))) {
+                goto error;
+            }
+            temp = GMPy_MPANY_To_Binary(NULL, item);
+            Py_DECREF(item);
+        }
+        else {
+            temp = GMPy_MPANY_To_Binary(NULL, item);
+        }
+        if (!temp) {
+            goto error;
+        }
+        checkpoint_put_u64(header, (unsigned long long)PyBytes_GET_SIZE(temp));
+        if (checkpoint_write(file, NULL, header, 8) < 0 ||
+            checkpoint_write(file, temp, NULL, 0) < 0) {
+            Py_DECREF(temp);
+            goto error;
+        }
+        Py_DECREF(temp);
+    }
+
+    if (!(res = PyObject_CallMethod(file, "flush", NULL))) {
+        goto error;
+    }
+    Py_DECREF(res);
+    if (!(temp = PyObject_CallMethod(file, "fileno", NULL))) {
+        goto error;
+    }
+    res = PyObject_CallMethod(os, "fsync", "O", temp);
+    Py_DECREF(temp);
+    if (!res) {
+        goto error;
+    }
+    Py_DECREF(res);
+    res = PyObject_CallMethod(file, "close", NULL);
+    Py_CLEAR(file);
+    if (!res) {
+        goto error;
+    }
+    Py_DECREF(res);
+    if (!(res = PyObject_CallMethod(os, "replace", "OO", tmp, fspath))) {
+        goto error;
+    }
+    Py_DECREF(res);
+    checkpoint_sync_dir(os, fspath);
+    rc = 0;
+    goto done;
+
+  error:
+    /* Remove the incomplete temporary file. */
+    PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+    if (file && (res = PyObject_CallMethod(file, "close", NULL))) {
+        Py_DECREF(res);
+    }
+    if ((res = PyObject_CallMethod(os, "remove", "O", tmp))) {
+        Py_DECREF(res);
+    }
+    PyErr_Restore(exc_type, exc_value, exc_tb);
+
+  done:
+    Py_XDECREF(file);
+    Py_XDECREF(os);
+    Py_XDECREF(io);
+    Py_XDECREF(tmp);
+    Py_XDECREF(fspath);
+    Py_DECREF(seq);
+    return rc;
+}
+
+/* Return the list of values saved in the checkpoint file path. */
+
+static PyObject *
+GMPy_Checkpoint_Read(PyObject *path)
+{
+    PyObject *io, *file, *result = NULL, *data = NULL, *item, *res;
+    PyObject *exc_type, *exc_value, *exc_tb;
+    unsigned long long i, n, len;
+
+    if (!(io = PyImport_ImportModule("io"))) {
+        return NULL;
+    }
+    file = PyObject_CallMethod(io, "open", "Os", path, "rb");
+    Py_DECREF(io);
+    if (!file) {
+        return NULL;
+    }
+
+    if (!(data = checkpoint_read(file, 16))) {
+        goto done;
+    }
+    if (memcmp(PyBytes_AS_STRING(data), GMPY_CHECKPOINT_MAGIC, 8)) {
+        VALUE_ERROR("not a gmpy2 checkpoint file");
+        goto done;
+    }
+    n = checkpoint_get_u64(PyBytes_AS_STRING(data) + 8);
+    if (!(result = PyList_New(0))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < n; i++) {
+        Py_CLEAR(data);
+        if (!(data = checkpoint_read(file, 8))) {
+            goto error;
+        }
+        len = checkpoint_get_u64(PyBytes_AS_STRING(data));
+        Py_CLEAR(data);
+        if (len > PY_SSIZE_T_MAX) {
+            VALUE_ERROR("invalid checkpoint file");
+            goto error;
+        }
+        if (!(data = checkpoint_read(file, (Py_ssize_t)len)) ||
+            !(item = GMPy_MPANY_From_Binary(NULL, data))) {
+            goto error;
+        }
+        if (PyList_Append(result, item) < 0) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(item);
+            goto error;
+            /* LCOV_EXCL_STOP */
+        }
+        Py_DECREF(item);
+    }
+    goto done;
+
+  error:
+    Py_CLEAR(result);
+
+  done:
+    Py_XDECREF(data);
+    PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+    if ((res = PyObject_CallMethod(file, "close", NULL))) {
+        Py_DECREF(res);
+    }
+    else if (!exc_type) {
+        Py_CLEAR(result);
+        PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+    }
+    else {
+        PyErr_Clear();
+    }
+    PyErr_Restore(exc_type, exc_value, exc_tb);
+    Py_DECREF(file);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_save_checkpoint,
+"save_checkpoint(path, values, /) -> None\n\n"
+"Save the sequence values of gmpy2 objects and integers to the file\n"
+"path using the `to_binary()` format. Integers are saved as mpz. The\n"
+"values are written one at a time to a temporary file, which is flushed\n"
+"to disk with fsync() and then renamed to path, so an interrupted save\n"
+"leaves an earlier checkpoint intact.");
+
+static PyObject *
+GMPy_Function_SaveCheckpoint(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    if (nargs != 2) {
+        TYPE_ERROR("save_checkpoint() requires 2 arguments");
+        return NULL;
+    }
+    if (GMPy_Checkpoint_Write(args[0], args[1]) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_load_checkpoint,
+"load_checkpoint(path, /) -> list\n\n"
+"Return the list of values saved in path by `save_checkpoint()`.");
+
+static PyObject *
+GMPy_Function_LoadCheckpoint(PyObject *self, PyObject *other)
+{
+    return GMPy_Checkpoint_Read(other);
+}
+
+/* Return a new powmod_state for base**exp mod m that hasn't processed any
+ * bits of the exponent.
+ */
+
+static PowmodState_Object *
+powmod_state_create(PyObject *b, PyObject *e, PyObject *m)
+{
+    PowmodState_Object *result;
+    MPZ_Object *base = NULL, *exp = NULL, *mod = NULL, *absmod = NULL;
+
+    if (!(base = GMPy_MPZ_From_Integer(b, NULL)) ||
+        !(exp = GMPy_MPZ_From_Integer(e, NULL)) ||
+        !(mod = GMPy_MPZ_From_Integer(m, NULL))) {
+        TYPE_ERROR("powmod_state() requires integer arguments");
+        goto error;
+    }
+    if (mpz_sgn(exp->z) < 0) {
+        VALUE_ERROR("powmod_state() exponent must be >= 0");
+        goto error;
+    }
+    if (mpz_sgn(mod->z) == 0) {
+        VALUE_ERROR("powmod_state() modulus must be non-zero");
+        goto error;
+    }
+    if (!(absmod = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_abs(absmod->z, mod->z);
+    if (GMPy_Ready_Type(&PowmodState_Type) < 0 ||
+        GMPy_Ready_Type(&Divisor_Type) < 0 ||
+        !(result = PyObject_New(PowmodState_Object, &PowmodState_Type))) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+    result->divisor = (Divisor_Object*)PyObject_CallFunctionObjArgs((PyObject*)&Divisor_Type,
+                                                                  (PyObject*)absmod, NULL);
+    result->base = base;
+    result->exp = exp;
+    result->mod = mod;
+    mpz_init(result->value);
+    result->remaining = 0;
+    result->running = 0;
+    Py_DECREF((PyObject*)absmod);
+    if (!result->divisor) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)result);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    /* Reduce the base so it is in the range [0, |mod|). */
+    if (!(result->base = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        result->base = base;
+        Py_DECREF((PyObject*)result);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_mod(result->base->z, base->z, mod->z);
+    Py_DECREF((PyObject*)base);
+
+    mpz_set_ui(result->value, 1);
+    mpz_mod(result->value, result->value, mod->z);
+    if (mpz_sgn(exp->z) > 0) {
+        result->remaining = mpz_sizeinbase(exp->z, 2);
+    }
+    return result;
+
+  error:
+    Py_XDECREF((PyObject*)base);
+    Py_XDECREF((PyObject*)exp);
+    Py_XDECREF((PyObject*)mod);
+    Py_XDECREF((PyObject*)absmod);
+    return NULL;
+}
+
+static PyObject *
+GMPy_PowmodState_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    PyObject *b, *e, *m;
+    static char *kwlist[] = {"", "", "", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OOO", kwlist, &b, &e, &m)) {
+        return NULL;
+    }
+    return (PyObject*)powmod_state_create(b, e, m);
+}
+
+static void
+GMPy_PowmodState_Dealloc(PowmodState_Object *self)
+{
+    mpz_clear(self->value);
+    Py_XDECREF((PyObject*)self->base);
+    Py_XDECREF((PyObject*)self->exp);
+    Py_XDECREF((PyObject*)self->mod);
+    Py_XDECREF((PyObject*)self->divisor);
+    PyObject_Free(self);
+}
+
+PyDoc_STRVAR(GMPy_doc_powmod_state_method_run,
+"s.run(steps=0, /) -> bool\n\n"
+"Process the next steps bits of the exponent, or all the remaining bits\n"
+"if steps is 0. Returns True once the exponentiation is complete. The\n"
+"number of bits processed is reported by `progress()`. Will always\n"
+"release the GIL.");
+
+static PyObject *
+GMPy_PowmodState_Method_Run(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PowmodState_Object *s = (PowmodState_Object*)self;
+    mp_bitcnt_t stop = 0, total;
+    Py_ssize_t steps = 0;
+    unsigned long serial, small = 0;
+    mpz_t temp;
+
+    if (nargs > 1) {
+        TYPE_ERROR("run() takes at most 1 argument");
+        return NULL;
+    }
+    if (nargs == 1) {
+        if ((steps = PyNumber_AsSsize_t(args[0], PyExc_OverflowError)) == -1 &&
+            PyErr_Occurred()) {
+            return NULL;
+        }
+        if (steps < 0) {
+            VALUE_ERROR("run() steps must be >= 0");
+            return NULL;
+        }
+    }
+    if (s->running) {
+        RUNTIME_ERROR("powmod_state is already running");
+        return NULL;
+    }
+    if (steps > 0 && (mp_bitcnt_t)steps < s->remaining) {
+        stop = s->remaining - (mp_bitcnt_t)steps;
+    }
+    if (mpz_fits_ulong_p(s->base->z)) {
+        small = mpz_get_ui(s->base->z);
+    }
+
+    total = mpz_sgn(s->exp->z) ? mpz_sizeinbase(s->exp->z, 2) : 0;
+    s->running = 1;
+    serial = gmpy_progress_begin("powmod_state", (Py_ssize_t)total);
+    gmpy_progress_update(serial, (Py_ssize_t)(total - s->remaining));
+    Py_BEGIN_ALLOW_THREADS;
+    mpz_init(temp);
+    while (s->remaining > stop) {
+        s->remaining--;
+        mpz_mul(temp, s->value, s->value);
+        divisor_divmod(NULL, s->value, temp, s->divisor, 'f');
+        if (mpz_tstbit(s->exp->z, s->remaining)) {
+            if (small)
+                mpz_mul_ui(temp, s->value, small);
+            else
+                mpz_mul(temp, s->value, s->base->z);
+            divisor_divmod(NULL, s->value, temp, s->divisor, 'f');
+        }
+        gmpy_progress_update(serial, (Py_ssize_t)(total - s->remaining));
+    }
+    mpz_clear(temp);
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+    s->running = 0;
+
+    return PyBool_FromLong(s->remaining == 0);
+}
+
+PyDoc_STRVAR(GMPy_doc_powmod_state_method_save,
+"s.save(path, /) -> None\n\n"
+"Save the state to the file path with `save_checkpoint()`. The\n"
+"computation can be continued from the file with `powmod_state.load()`.");
+
+static PyObject *
+GMPy_PowmodState_Method_Save(PyObject *self, PyObject *other)
+{
+    PowmodState_Object *s = (PowmodState_Object*)self;
+    MPZ_Object *value = NULL, *remaining = NULL;
+    PyObject *values = NULL;
+    int rc = -1;
+
+    if (s->running) {
+        RUNTIME_ERROR("powmod_state is already running");
+        return NULL;
+    }
+    if ((value = GMPy_MPZ_New(NULL)) && (remaining = GMPy_MPZ_New(NULL))) {
+        mpz_set(value->z, s->value);
+        mpz_set_ui(remaining->z, s->remaining);
+        if ((values = PyTuple_Pack(5, s->base, s->exp, s->mod, value, remaining))) {
+            rc = GMPy_Checkpoint_Write(other, values);
+        }
+    }
+    Py_XDECREF(values);
+    Py_XDECREF((PyObject*)value);
+    Py_XDECREF((PyObject*)remaining);
+    if (rc < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_powmod_state_method_load,
+"powmod_state.load(path, /) -> powmod_state\n\n"
+"Return the powmod_state saved in the file path by `save()`.");
+
+static PyObject *
+GMPy_PowmodState_Method_Load(PyObject *type, PyObject *other)
+{
+    PowmodState_Object *result = NULL;
+    PyObject *values;
+    MPZ_Object *value, *remaining;
+    Py_ssize_t i;
+
+    if (!(values = GMPy_Checkpoint_Read(other))) {
+        return NULL;
+    }
+    if (PyList_GET_SIZE(values) != 5) {
+        goto invalid;
+    }
+    for (i = 0; i < 5; i++) {
+        if (!MPZ_Check(PyList_GET_ITEM(values, i))) {
+            goto invalid;
+        }
+    }
+    if (!(result = powmod_state_create(PyList_GET_ITEM(values, 0),
+                                       PyList_GET_ITEM(values, 1),
+                                       PyList_GET_ITEM(values, 2)))) {
+        Py_DECREF(values);
+        return NULL;
+    }
+    value = (MPZ_Object*)PyList_GET_ITEM(values, 3);
+    remaining = (MPZ_Object*)PyList_GET_ITEM(values, 4);
+    if (mpz_sgn(value->z) < 0 || mpz_cmpabs(value->z, result->mod->z) >= 0 ||
+        mpz_sgn(remaining->z) < 0 || mpz_cmp_ui(remaining->z, result->remaining) > 0) {
+        Py_CLEAR(result);
+        goto invalid;
+    }
+    mpz_set(result->value, value->z);
+    result->remaining = mpz_get_ui(remaining->z);
+    Py_DECREF(values);
+    return (PyObject*)result;
+
+  invalid:
+    VALUE_ERROR("invalid powmod_state checkpoint");
+    Py_DECREF(values);
+    return NULL;
+}
+
+static PyObject *
+GMPy_PowmodState_Attrib_GetValue(PowmodState_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    /* run() updates the value without holding the GIL. */
+    if (self->running) {
+        RUNTIME_ERROR("powmod_state is running");
+        return NULL;
+    }
+    if ((result = GMPy_MPZ_New(NULL))) {
+        /* Like powmod(), use the sign of the modulus. */
+        if (mpz_sgn(self->mod->z) < 0 && mpz_sgn(self->value))
+            mpz_add(result->z, self->value, self->mod->z);
+        else
+            mpz_set(result->z, self->value);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_PowmodState_Attrib_GetRemaining(PowmodState_Object *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(self->remaining);
+}
+
+PyDoc_STRVAR(GMPy_doc_powmod_state,
+"powmod_state(base, exp, mod, /)\n\n"
+"Return an object that computes powmod(base, exp, mod) in steps that\n"
+"can be saved to disk, for exponentiations that take hours, e.g. a\n"
+"Fermat test of a huge n with powmod_state(3, n-1, n). exp must be >= 0\n"
+"and mod must be non-zero.\n\n"
+"run(steps) processes the next steps bits of exp from the most\n"
+"significant bit down; save() and powmod_state.load() write and read a\n"
+"checkpoint between calls. value is always\n"
+"powmod(base, exp >> remaining, mod), so it is the final result once\n"
+"remaining is 0.");
+
+static PyGetSetDef GMPy_PowmodState_getseters[] = {
+    { "value", (getter)GMPy_PowmodState_Attrib_GetValue, NULL,
+        "the current value as an mpz, not available during run()", NULL },
+    { "remaining", (getter)GMPy_PowmodState_Attrib_GetRemaining, NULL,
+        "the number of exponent bits still to process", NULL },
+    {NULL}
+};
+
+static PyMethodDef GMPy_PowmodState_methods[] = {
+    { "load", GMPy_PowmodState_Method_Load, METH_O | METH_CLASS, GMPy_doc_powmod_state_method_load },
+    { "run", (PyCFunction)GMPy_PowmodState_Method_Run, METH_FASTCALL, GMPy_doc_powmod_state_method_run },
+    { "save", GMPy_PowmodState_Method_Save, METH_O, GMPy_doc_powmod_state_method_save },
+    { NULL }
+};
+
+static PyTypeObject PowmodState_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.powmod_state",
+    .tp_basicsize = sizeof(PowmodState_Object),
+    .tp_dealloc = (destructor) GMPy_PowmodState_Dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_powmod_state,
+    .tp_methods = GMPy_PowmodState_methods,
+    .tp_getset = GMPy_PowmodState_getseters,
+    .tp_new = GMPy_PowmodState_NewInit,
+};
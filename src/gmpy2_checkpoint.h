@@ -0,0 +1,69 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_checkpoint.h                                                      *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_CHECKPOINT_H
+#define GMPY_CHECKPOINT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A checkpoint file starts with an 8 byte magic string and the number of
+ * values as an 8 byte little-endian integer. Each value follows as its
+ * length (8 bytes, little-endian) and its to_binary() representation.
+ */
+
+#define GMPY_CHECKPOINT_MAGIC "GMPY2CKP"
+
+/* A modular exponentiation that can be run in steps and saved to disk.
+ * value is base**(exp >> remaining) mod |mod|.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    MPZ_Object *base;        /* reduced mod |mod| */
+    MPZ_Object *exp;
+    MPZ_Object *mod;
+    Divisor_Object *divisor; /* divisor for |mod| */
+    mpz_t value;
+    mp_bitcnt_t remaining;   /* exponent bits still to process */
+    int running;             /* run() is active in some thread */
+} PowmodState_Object;
+
+static PyTypeObject PowmodState_Type;
+#define PowmodState_Check(v) (((PyObject*)v)->ob_type == &PowmodState_Type)
+
+static int GMPy_Checkpoint_Write(PyObject *path, PyObject *values);
+static PyObject * GMPy_Checkpoint_Read(PyObject *path);
+
+static PyObject * GMPy_Function_SaveCheckpoint(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_Function_LoadCheckpoint(PyObject *self, PyObject *other);
+
+static PyObject * GMPy_PowmodState_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static void GMPy_PowmodState_Dealloc(PowmodState_Object *self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -24,6 +24,19 @@
  * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+/* Compute a constant with the GIL released if the context allows it. MPFR
+ * computes it in a single call, so it does not report progress().
+ */
+
+static void
+_GMPy_MPFR_Const(MPFR_Object *result, int (*func)(mpfr_ptr, mpfr_rnd_t),
+                 CTXT_Object *context)
+{
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    result->rc = func(result->f, GET_MPFR_ROUND(context));
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+}
+
 PyDoc_STRVAR(GMPy_doc_function_const_pi,
 "const_pi(precision=0) -> mpfr\n\n"
 "Return the constant pi using the specified precision. If no\n"
@@ -45,7 +58,7 @@ GMPy_Function_Const_Pi(PyObject *self, PyObject *args, PyObject *keywds)
 
     if ((result = GMPy_MPFR_New(bits, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_pi(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_pi, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -64,7 +77,7 @@ GMPy_Context_Const_Pi(PyObject *self, PyObject *args)
 
     if ((result = GMPy_MPFR_New(0, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_pi(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_pi, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -92,7 +105,7 @@ GMPy_Function_Const_Euler(PyObject *self, PyObject *args, PyObject *keywds)
 
     if ((result = GMPy_MPFR_New(bits, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_euler(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_euler, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -111,7 +124,7 @@ GMPy_Context_Const_Euler(PyObject *self, PyObject *args)
 
     if ((result = GMPy_MPFR_New(0, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_euler(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_euler, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -139,7 +152,7 @@ GMPy_Function_Const_Log2(PyObject *self, PyObject *args, PyObject *keywds)
 
     if ((result = GMPy_MPFR_New(bits, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_log2(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_log2, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -158,7 +171,7 @@ GMPy_Context_Const_Log2(PyObject *self, PyObject *args)
 
     if ((result = GMPy_MPFR_New(0, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_log2(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_log2, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -186,7 +199,7 @@ GMPy_Function_Const_Catalan(PyObject *self, PyObject *args, PyObject *keywds)
 
     if ((result = GMPy_MPFR_New(bits, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_catalan(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_catalan, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -205,7 +218,7 @@ GMPy_Context_Const_Catalan(PyObject *self, PyObject *args)
 
     if ((result = GMPy_MPFR_New(0, context))) {
         mpfr_clear_flags();
-        result->rc = mpfr_const_catalan(result->f, GET_MPFR_ROUND(context));
+        _GMPy_MPFR_Const(result, mpfr_const_catalan, context);
         _GMPy_MPFR_Cleanup(&result, context);
     }
 
@@ -60,7 +60,15 @@ GMPy_CTXT_New(void)
 {
     CTXT_Object *result;
 
-    if ((result = PyObject_New(CTXT_Object, &CTXT_Type))) {
+    if (global.in_gmpyctxtcache) {
+        result = global.gmpyctxtcache[--(global.in_gmpyctxtcache)];
+        GMPY_REVIVE(result);
+    }
+    else {
+        result = PyObject_New(CTXT_Object, &CTXT_Type);
+    }
+
+    if (result) {
         result->ctx.mpfr_prec = DBL_MANT_DIG;
         result->ctx.mpfr_round = MPFR_RNDN;
         result->ctx.emax = MPFR_EMAX_DEFAULT;
@@ -80,15 +88,26 @@ GMPy_CTXT_New(void)
         result->ctx.allow_complex = 0;
         result->ctx.rational_division = 0;
         result->ctx.allow_release_gil = 0;
+        result->ctx.threads = 1;
         result->token = NULL;
     }
     return (PyObject*)result;
 };
 
+/* Contexts are cached like numbers so the frames used by with statements
+ * don't need a new memory allocation.
+ */
+
 static void
 GMPy_CTXT_Dealloc(CTXT_Object *self)
 {
-    PyObject_Free(self);
+    Py_CLEAR(self->token);
+    if (GMPY_CACHE_ENABLED() && global.in_gmpyctxtcache < CACHE_SIZE) {
+        global.gmpyctxtcache[(global.in_gmpyctxtcache)++] = self;
+    }
+    else {
+        PyObject_Free(self);
+    }
 };
 
 /* Begin support for context vars. */
@@ -157,26 +176,52 @@ GMPy_CTXT_Set(PyObject *self, PyObject *v)
 }
 
 #if 1
+/* The tokens of the active 'with ctx:' blocks are kept in a second context
+ * variable, as a linked list of (context, token, previous) tuples. Like the
+ * current context it is per thread and per asyncio task, so the same
+ * context object can be entered from several threads, or entered again
+ * before it is exited.
+ */
+
 static PyObject *
 GMPy_CTXT_Enter(PyObject *self, PyObject *args)
 {
-    PyObject *tok = NULL;
+    PyObject *tok = NULL, *prev = NULL, *frame = NULL;
     PyObject *result = NULL;
 
+    if (PyContextVar_Get(context_frame_var, Py_None, &prev) < 0) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
     result = GMPy_CTXT_Copy(self, NULL);
     if (!result) {
+        Py_DECREF(prev);
         return NULL;
     }
 
-    Py_INCREF(result);
     tok = PyContextVar_Set(current_context_var, result);
-    Py_DECREF(result);
-
     if (tok == NULL) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(prev);
+        Py_DECREF(result);
         return NULL;
+        /* LCOV_EXCL_STOP */
     }
 
-    ((CTXT_Object*)self)->token = tok;
+    frame = PyTuple_Pack(3, self, tok, prev);
+    Py_DECREF(tok);
+    Py_DECREF(prev);
+    if (!frame || !(tok = PyContextVar_Set(context_frame_var, frame))) {
+        /* LCOV_EXCL_START */
+        Py_XDECREF(frame);
+        Py_DECREF(result);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    Py_DECREF(tok);
+    Py_DECREF(frame);
 
     return result;
 }
@@ -184,15 +229,200 @@ GMPy_CTXT_Enter(PyObject *self, PyObject *args)
 static PyObject *
 GMPy_CTXT_Exit(PyObject *self, PyObject *args)
 {
-    int res = PyContextVar_Reset(current_context_var, ((CTXT_Object*)self)->token);
-    if (res == -1) {
+    PyObject *frame = NULL, *tok;
+
+    if (PyContextVar_Get(context_frame_var, Py_None, &frame) < 0) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (!PyTuple_Check(frame) || PyTuple_GET_ITEM(frame, 0) != self) {
+        Py_DECREF(frame);
+        RUNTIME_ERROR("context is not active");
+        return NULL;
+    }
+
+    if (PyContextVar_Reset(current_context_var,
+                           PyTuple_GET_ITEM(frame, 1)) == -1) {
+        Py_DECREF(frame);
         SYSTEM_ERROR("Unexpected failure in restoring context.");
         return NULL;
     }
+    tok = PyContextVar_Set(context_frame_var, PyTuple_GET_ITEM(frame, 2));
+    Py_DECREF(frame);
+    if (!tok) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    Py_DECREF(tok);
     Py_RETURN_NONE;
 }
 #endif
 
+/* Lightweight context managers.
+ *
+ * precision(bits) and rounding(mode) return a manager that, on entry,
+ * takes a context from the cache, copies the current context into it,
+ * changes a single setting, and makes it the current context. On exit the
+ * previous context is restored. This has the same semantics as
+ * "with context(get_context(), precision=bits):" but avoids creating and
+ * parsing keyword arguments and, usually, any memory allocation.
+ */
+
+#define CTXT_MANAGER_PRECISION 0
+#define CTXT_MANAGER_ROUNDING  1
+
+static PyObject *
+GMPy_CTXT_Manager_New(int kind, long value)
+{
+    CTXT_Manager_Object *result;
+
+    if ((result = PyObject_New(CTXT_Manager_Object, &CTXT_Manager_Type))) {
+        result->kind = kind;
+        result->value = value;
+        result->token = NULL;
+    }
+    return (PyObject*)result;
+}
+
+static void
+GMPy_CTXT_Manager_Dealloc(CTXT_Manager_Object *self)
+{
+    Py_XDECREF(self->token);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_CTXT_Manager_Enter(PyObject *self, PyObject *args)
+{
+    CTXT_Manager_Object *manager = (CTXT_Manager_Object*)self;
+    CTXT_Object *result, *current;
+    PyObject *tok;
+
+    if (manager->token) {
+        RUNTIME_ERROR("context manager is already active");
+        return NULL;
+    }
+
+    if (!(current = (CTXT_Object*)GMPy_CTXT_Get(NULL, NULL))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (!(result = (CTXT_Object*)GMPy_CTXT_New())) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)current);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    result->ctx = current->ctx;
+    Py_DECREF((PyObject*)current);
+
+    if (manager->kind == CTXT_MANAGER_PRECISION) {
+        result->ctx.mpfr_prec = (mpfr_prec_t)manager->value;
+    }
+    else {
+        result->ctx.mpfr_round = (mpfr_rnd_t)manager->value;
+        if (manager->value == MPFR_RNDA) {
+            result->ctx.real_round = MPFR_RNDN;
+            result->ctx.imag_round = MPFR_RNDN;
+        }
+    }
+
+    if (!(tok = PyContextVar_Set(current_context_var, (PyObject*)result))) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    manager->token = tok;
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_CTXT_Manager_Exit(PyObject *self, PyObject *args)
+{
+    CTXT_Manager_Object *manager = (CTXT_Manager_Object*)self;
+
+    if (!manager->token) {
+        RUNTIME_ERROR("context manager is not active");
+        return NULL;
+    }
+    if (PyContextVar_Reset(current_context_var, manager->token) == -1) {
+        SYSTEM_ERROR("Unexpected failure in restoring context.");
+        return NULL;
+    }
+    Py_CLEAR(manager->token);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_context_precision,
+"precision(bits, /) -> context manager\n\n"
+"Return a context manager that runs its block with a copy of the current\n"
+"context whose precision is bits. It is a faster replacement for\n"
+"context(get_context(), precision=bits).");
+
+static PyObject *
+GMPy_CTXT_Precision(PyObject *self, PyObject *other)
+{
+    Py_ssize_t bits;
+
+    if (!PyLong_Check(other)) {
+        TYPE_ERROR("precision must be Python integer");
+        return NULL;
+    }
+    bits = PyLong_AsSsize_t(other);
+    if (bits < MPFR_PREC_MIN || bits > MPFR_PREC_MAX) {
+        PyErr_Clear();
+        VALUE_ERROR("invalid value for precision");
+        return NULL;
+    }
+    return GMPy_CTXT_Manager_New(CTXT_MANAGER_PRECISION, (long)bits);
+}
+
+PyDoc_STRVAR(GMPy_doc_context_rounding,
+"rounding(mode, /) -> context manager\n\n"
+"Return a context manager that runs its block with a copy of the current\n"
+"context whose rounding mode is mode. It is a faster replacement for\n"
+"context(get_context(), round=mode).");
+
+static PyObject *
+GMPy_CTXT_Rounding(PyObject *self, PyObject *other)
+{
+    long mode;
+
+    if (!PyLong_Check(other)) {
+        TYPE_ERROR("round mode must be Python integer");
+        return NULL;
+    }
+    mode = PyLong_AsLong(other);
+    if (mode != MPFR_RNDN && mode != MPFR_RNDZ && mode != MPFR_RNDU &&
+        mode != MPFR_RNDD && mode != MPFR_RNDA) {
+        PyErr_Clear();
+        VALUE_ERROR("invalid value for round mode");
+        return NULL;
+    }
+    return GMPy_CTXT_Manager_New(CTXT_MANAGER_ROUNDING, mode);
+}
+
+static PyMethodDef GMPy_CTXT_Manager_methods[] =
+{
+    { "__enter__", GMPy_CTXT_Manager_Enter, METH_NOARGS, NULL },
+    { "__exit__", GMPy_CTXT_Manager_Exit, METH_VARARGS, NULL },
+    { NULL, NULL, 1 }
+};
+
+static PyTypeObject CTXT_Manager_Type =
+{
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.context_manager",
+    .tp_basicsize = sizeof(CTXT_Manager_Object),
+    .tp_dealloc = (destructor) GMPy_CTXT_Manager_Dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "lightweight context manager returned by precision() and rounding()",
+    .tp_methods = GMPy_CTXT_Manager_methods,
+};
+
 PyDoc_STRVAR(GMPy_doc_context_ieee,
 "ieee(size, /, subnormalize=True) -> context\n\n"
 "Return a new context corresponding to a standard IEEE floating point\n"
@@ -300,7 +530,7 @@ GMPy_CTXT_Repr_Slot(CTXT_Object *self)
     PyObject *result = NULL;
     int i = 0;
 
-    tuple = PyTuple_New(24);
+    tuple = PyTuple_New(25);
     if (!tuple)
         return NULL;
 
@@ -317,7 +547,8 @@ GMPy_CTXT_Repr_Slot(CTXT_Object *self)
             "        trap_divzero=%s, divzero=%s,\n"
             "        allow_complex=%s,\n"
             "        rational_division=%s,\n"
-            "        allow_release_gil=%s)"
+            "        allow_release_gil=%s,\n"
+            "        threads=%s)"
             );
     if (!format) {
         Py_DECREF(tuple);
@@ -355,6 +586,7 @@ GMPy_CTXT_Repr_Slot(CTXT_Object *self)
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.allow_complex));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.rational_division));
     PyTuple_SET_ITEM(tuple, i++, PyBool_FromLong(self->ctx.allow_release_gil));
+    PyTuple_SET_ITEM(tuple, i++, PyLong_FromLong(self->ctx.threads));
 
     if (!PyErr_Occurred())
         result = PyUnicode_Format(format, tuple);
@@ -399,7 +631,7 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
         "real_round", "imag_round", "emax", "emin", "subnormalize",
         "trap_underflow", "trap_overflow", "trap_inexact",
         "trap_invalid", "trap_erange", "trap_divzero", "allow_complex",
-        "rational_division", "allow_release_gil", NULL };
+        "rational_division", "allow_release_gil", "threads", NULL };
 
     /* Create an empty dummy tuple to use for args. */
 
@@ -418,7 +650,7 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
     x_trap_divzero = ctxt->ctx.traps & TRAP_DIVZERO;
 
     if (!(PyArg_ParseTupleAndKeywords(args, kwargs,
-            "|llliiilliiiiiiiiii", kwlist,
+            "|llliiilliiiiiiiiiii", kwlist,
             &ctxt->ctx.mpfr_prec,
             &ctxt->ctx.real_prec,
             &ctxt->ctx.imag_prec,
@@ -436,7 +668,8 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
             &x_trap_divzero,
             &ctxt->ctx.allow_complex,
             &ctxt->ctx.rational_division,
-            &ctxt->ctx.allow_release_gil))) {
+            &ctxt->ctx.allow_release_gil,
+            &ctxt->ctx.threads))) {
         VALUE_ERROR("invalid keyword arguments for context");
         Py_DECREF(args);
         return 0;
@@ -528,6 +761,11 @@ _parse_context_args(CTXT_Object *ctxt, PyObject *kwargs)
         return 0;
     }
 
+    if (ctxt->ctx.threads < 1 || ctxt->ctx.threads > GMPY_MAX_THREADS) {
+        VALUE_ERROR("invalid value for threads");
+        return 0;
+    }
+
     return 1;
 }
 
@@ -681,10 +919,12 @@ GMPy_CTXT_Set_##NAME(CTXT_Object *self, PyObject *value, void *closure) \
         TYPE_ERROR(#NAME " must be True or False"); \
         return -1; \
     } \
+    Py_BEGIN_CRITICAL_SECTION(self); \
     if (Py_IsTrue(value)) \
         self->ctx.traps |= TRAP; \
     else \
         self->ctx.traps &= ~(TRAP); \
+    Py_END_CRITICAL_SECTION(); \
     return 0; \
 }
 
@@ -908,25 +1148,20 @@ GMPy_CTXT_Set_round(CTXT_Object *self, PyObject *value, void *closure)
         VALUE_ERROR("invalid value for round mode");
         return -1;
     }
-    if (temp == MPFR_RNDN)
-        self->ctx.mpfr_round = MPFR_RNDN;
-    else if (temp == MPFR_RNDZ)
-        self->ctx.mpfr_round = MPFR_RNDZ;
-    else if (temp == MPFR_RNDU)
-        self->ctx.mpfr_round = MPFR_RNDU;
-    else if (temp == MPFR_RNDD)
-        self->ctx.mpfr_round = MPFR_RNDD;
-    else if (temp == MPFR_RNDA) {
-        self->ctx.mpfr_round = MPFR_RNDA;
+    if (temp != MPFR_RNDN && temp != MPFR_RNDZ && temp != MPFR_RNDU &&
+        temp != MPFR_RNDD && temp != MPFR_RNDA) {
+        VALUE_ERROR("invalid value for round mode");
+        return -1;
+    }
+    Py_BEGIN_CRITICAL_SECTION(self);
+    self->ctx.mpfr_round = (mpfr_rnd_t)temp;
+    if (temp == MPFR_RNDA) {
         /* Since RNDA is not supported for MPC, set the MPC rounding modes
            to MPFR_RNDN. */
         self->ctx.real_round = MPFR_RNDN;
         self->ctx.imag_round = MPFR_RNDN;
     }
-    else {
-        VALUE_ERROR("invalid value for round mode");
-        return -1;
-    }
+    Py_END_CRITICAL_SECTION();
     return 0;
 }
 
@@ -1068,6 +1303,39 @@ GMPy_CTXT_Set_emax(CTXT_Object *self, PyObject *value, void *closure)
     return 0;
 }
 
+PyDoc_STRVAR(GMPy_doc_CTXT_threads,
+"This attribute controls the maximum number of threads that a single\n"
+"operation may use. It defaults to 1. `powmod()` and three argument\n"
+"`pow()` use several threads only if threads is at least 4 and the\n"
+"modulus is odd with at least 262144 bits. Their parallel algorithm does about\n"
+"twice the work of the single-threaded one, so it is slower with fewer\n"
+"threads or smaller moduli. The maximum value is 64.");
+
+static PyObject *
+GMPy_CTXT_Get_threads(CTXT_Object *self, void *closure)
+{
+    return PyLong_FromLong(self->ctx.threads);
+}
+
+static int
+GMPy_CTXT_Set_threads(CTXT_Object *self, PyObject *value, void *closure)
+{
+    long temp;
+
+    if (!(PyLong_Check(value))) {
+        TYPE_ERROR("threads must be Python integer");
+        return -1;
+    }
+    temp = PyLong_AsLong(value);
+    if (temp < 1 || temp > GMPY_MAX_THREADS) {
+        PyErr_Clear();
+        VALUE_ERROR("invalid value for threads");
+        return -1;
+    }
+    self->ctx.threads = (int)temp;
+    return 0;
+}
+
 #define ADD_GETSET(NAME) \
     {#NAME, \
         (getter)GMPy_CTXT_Get_##NAME, \
@@ -1098,6 +1366,7 @@ static PyGetSetDef GMPyContext_getseters[] = {
     ADD_GETSET(allow_complex),
     ADD_GETSET(rational_division),
     ADD_GETSET(allow_release_gil),
+    ADD_GETSET(threads),
     {NULL}
 };
 
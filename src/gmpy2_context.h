@@ -42,6 +42,14 @@ extern "C" {
 /* The actual typedefs have been moved to gmpy2_types.h. */
 
 static PyTypeObject CTXT_Type;
+static PyTypeObject CTXT_Manager_Type;
+
+typedef struct {
+    PyObject_HEAD
+    int kind;              /* setting changed by the manager */
+    long value;            /* new value of the setting */
+    PyObject *token;       /* token to restore the previous context */
+} CTXT_Manager_Object;
 
 /* CHECK_CONTEXT returns a borrowed reference. */
 #define CHECK_CONTEXT(context)                          \
@@ -62,12 +70,16 @@ static PyTypeObject CTXT_Type;
         Py_DECREF(context);                                \
     }
 
+/* In free-threaded builds there is no GIL, but detaching the thread state
+ * still lets the garbage collector and other stop-the-world events proceed
+ * during a long computation.
+ */
 #define GMPY_MAYBE_BEGIN_ALLOW_THREADS(context) { \
         PyThreadState *_save; \
         _save = GET_THREAD_MODE(context) ? PyEval_SaveThread() : NULL;
 #define GMPY_MAYBE_END_ALLOW_THREADS(context) \
         if (_save) PyEval_RestoreThread(_save); \
-    } \
+    }
 
 #define CTXT_Check(v) (((PyObject*)v)->ob_type == &CTXT_Type)
 
@@ -82,6 +94,9 @@ static PyTypeObject CTXT_Type;
 #define GET_DIV_MODE(c) (c->ctx.rational_division)
 
 #define GET_THREAD_MODE(c) (c->ctx.allow_release_gil)
+#define GET_THREADS(c) (c->ctx.threads)
+
+#define GMPY_MAX_THREADS 64
 
 
 static PyObject *    GMPy_CTXT_New(void);
@@ -96,6 +111,8 @@ static PyObject *    GMPy_CTXT_Copy(PyObject *self, PyObject *other);
 static PyObject *    GMPy_CTXT_ieee(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *    GMPy_CTXT_Enter(PyObject *self, PyObject *args);
 static PyObject *    GMPy_CTXT_Exit(PyObject *self, PyObject *args);
+static PyObject *    GMPy_CTXT_Precision(PyObject *self, PyObject *other);
+static PyObject *    GMPy_CTXT_Rounding(PyObject *self, PyObject *other);
 
 #ifdef __cplusplus
 }
@@ -70,6 +70,282 @@ static int GMPy_isComplex(PyObject *obj)
 }
 #endif
 
+/* GMPy_Decimal_Parts() splits a decimal.Decimal instance into its signed
+ * coefficient and exponent using as_tuple(). On success, *digits is set to
+ * a NUL-terminated string of decimal digits, with a leading '-' for negative
+ * values, that must be released with PyMem_Free(). *special is set to 0 for
+ * finite values, 1 for infinities, and 2 for NaNs. Returns -1 on error.
+ */
+
+static int
+GMPy_Decimal_Parts(PyObject *obj, char **digits, Py_ssize_t *exp, int *special)
+{
+    PyObject *tup = NULL, *sign, *coeff, *expo;
+    Py_ssize_t i, n;
+    char *cp;
+    long d;
+
+    *digits = NULL;
+    *exp = 0;
+    *special = 0;
+
+    if (!global.str_as_tuple &&
+        !(global.str_as_tuple = PyUnicode_InternFromString("as_tuple"))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (!(tup = PyObject_CallMethodObjArgs(obj, global.str_as_tuple, NULL)))
+        return -1;
+
+    if (!PyTuple_Check(tup) || PyTuple_GET_SIZE(tup) != 3 ||
+        !PyTuple_Check(PyTuple_GET_ITEM(tup, 1))) {
+        SYSTEM_ERROR("Object does not appear to be Decimal");
+        goto error;
+    }
+
+    sign = PyTuple_GET_ITEM(tup, 0);
+    coeff = PyTuple_GET_ITEM(tup, 1);
+    expo = PyTuple_GET_ITEM(tup, 2);
+
+    if (PyUnicode_Check(expo)) {
+        *special = PyUnicode_CompareWithASCIIString(expo, "F") ? 2 : 1;
+    }
+    else {
+        *exp = PyLong_AsSsize_t(expo);
+        if (*exp == -1 && PyErr_Occurred())
+            goto error;
+    }
+
+    n = PyTuple_GET_SIZE(coeff);
+    if (!(*digits = cp = PyMem_Malloc(n + 3))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (PyObject_IsTrue(sign) == 1)
+        *cp++ = '-';
+
+    for (i = 0; i < n; i++) {
+        d = PyLong_AsLong(PyTuple_GET_ITEM(coeff, i));
+        if (d < 0 || d > 9) {
+            if (!PyErr_Occurred()) {
+                SYSTEM_ERROR("Object does not appear to be Decimal");
+            }
+            goto error;
+        }
+        *cp++ = (char)('0' + d);
+    }
+    if (n == 0)
+        *cp++ = '0';
+    *cp = '\0';
+
+    Py_DECREF(tup);
+    return 0;
+
+  error:
+    PyMem_Free(*digits);
+    *digits = NULL;
+    Py_XDECREF(tup);
+    return -1;
+}
+
+/* NumPy scalars store their value directly after the object header. The
+ * structures below mirror the layouts declared in numpy/arrayscalars.h so
+ * the value can be read without calling back into NumPy.
+ */
+
+#define GMPY_NPY_SCALAR(name, ctype) \
+    typedef struct { PyObject_HEAD ctype obval; } name
+
+GMPY_NPY_SCALAR(gmpy_npy_int8, int8_t);
+GMPY_NPY_SCALAR(gmpy_npy_int16, int16_t);
+GMPY_NPY_SCALAR(gmpy_npy_int32, int32_t);
+GMPY_NPY_SCALAR(gmpy_npy_int64, int64_t);
+GMPY_NPY_SCALAR(gmpy_npy_uint8, uint8_t);
+GMPY_NPY_SCALAR(gmpy_npy_uint16, uint16_t);
+GMPY_NPY_SCALAR(gmpy_npy_uint32, uint32_t);
+GMPY_NPY_SCALAR(gmpy_npy_uint64, uint64_t);
+GMPY_NPY_SCALAR(gmpy_npy_float, float);
+GMPY_NPY_SCALAR(gmpy_npy_longdouble, long double);
+
+/* Record the NumPy scalar types that can be converted directly. NumPy must
+ * already be imported since an instance of one of its types exists. The
+ * float64 type is a subclass of float and is handled as a PyFloat.
+ */
+
+static void
+GMPy_NumPy_LoadTypes(void)
+{
+    static const char *names[] = {
+        "int8", "int16", "int32", "int64", "intc", "longlong",
+        "uint8", "uint16", "uint32", "uint64", "uintc", "ulonglong",
+        "float16", "float32", "longdouble", NULL };
+    PyObject *numpy, *name, *type, *dtype, *kind, *itemsize;
+    int i, j, count = 0, k, size;
+
+    if (!(name = PyUnicode_FromString("numpy"))) {
+        /* LCOV_EXCL_START */
+        PyErr_Clear();
+        return;
+        /* LCOV_EXCL_STOP */
+    }
+    numpy = PyImport_GetModule(name);
+    Py_DECREF(name);
+    if (!numpy) {
+        PyErr_Clear();
+        return;
+    }
+
+    for (i = 0; names[i] && count < GMPY_NPY_MAX; i++) {
+        type = PyObject_GetAttrString(numpy, names[i]);
+        if (!type || !PyType_Check(type)) {
+            Py_XDECREF(type);
+            PyErr_Clear();
+            continue;
+        }
+
+        k = GMPY_NPY_NONE;
+        size = 0;
+        if ((dtype = PyObject_CallMethod(numpy, "dtype", "O", type))) {
+            kind = PyObject_GetAttrString(dtype, "kind");
+            itemsize = PyObject_GetAttrString(dtype, "itemsize");
+            if (kind && itemsize && PyUnicode_Check(kind)) {
+                size = (int)PyLong_AsLong(itemsize);
+                if (!PyUnicode_CompareWithASCIIString(kind, "i"))
+                    k = GMPY_NPY_SIGNED;
+                else if (!PyUnicode_CompareWithASCIIString(kind, "u"))
+                    k = GMPY_NPY_UNSIGNED;
+                else if (!PyUnicode_CompareWithASCIIString(kind, "f"))
+                    k = GMPY_NPY_FLOAT;
+            }
+            Py_XDECREF(kind);
+            Py_XDECREF(itemsize);
+            Py_DECREF(dtype);
+        }
+        PyErr_Clear();
+
+        /* Only accept the sizes that can be read from the value layouts. */
+        if (k == GMPY_NPY_FLOAT) {
+            if (size != 2 && size != (int)sizeof(float) &&
+                size != (int)sizeof(long double))
+                k = GMPY_NPY_NONE;
+            if (PyType_IsSubtype((PyTypeObject*)type, &PyFloat_Type))
+                k = GMPY_NPY_NONE;
+        }
+        else if (size != 1 && size != 2 && size != 4 && size != 8) {
+            k = GMPY_NPY_NONE;
+        }
+
+        for (j = 0; j < count; j++) {
+            if (global.npy_types[j].type == (PyTypeObject*)type)
+                k = GMPY_NPY_NONE;
+        }
+
+        if (k != GMPY_NPY_NONE) {
+            /* The reference is kept for the lifetime of the module. */
+            global.npy_types[count].type = (PyTypeObject*)type;
+            global.npy_types[count].kind = k;
+            global.npy_types[count].size = size;
+            count++;
+        }
+        else {
+            Py_DECREF(type);
+        }
+    }
+
+    Py_DECREF(numpy);
+    global.npy_count = count;
+}
+
+/* Return the cached entry for a NumPy scalar, or NULL if obj is not an
+ * instance of a supported NumPy scalar type. Exceptions are never raised.
+ */
+
+static gmpy_npy_scalar *
+GMPy_NumPy_Lookup(PyObject *obj)
+{
+    PyTypeObject *type = Py_TYPE(obj);
+    int i;
+
+    if (strncmp(type->tp_name, "numpy.", 6))
+        return NULL;
+
+    if (global.npy_count < 0) {
+        PyObject *etype, *evalue, *etb;
+
+        PyErr_Fetch(&etype, &evalue, &etb);
+        GMPy_NumPy_LoadTypes();
+        PyErr_Restore(etype, evalue, etb);
+    }
+
+    for (i = 0; i < global.npy_count; i++) {
+        if (global.npy_types[i].type == type)
+            return &global.npy_types[i];
+    }
+    return NULL;
+}
+
+static int
+GMPy_NumPy_Kind(PyObject *obj)
+{
+    gmpy_npy_scalar *entry = GMPy_NumPy_Lookup(obj);
+
+    return entry ? entry->kind : GMPY_NPY_NONE;
+}
+
+/* Set z to a 64-bit signed or unsigned value. */
+
+static void
+mpz_set_int64(mpz_t z, int64_t s)
+{
+    uint64_t u;
+
+    if (s >= LONG_MIN && s <= LONG_MAX) {
+        mpz_set_si(z, (long)s);
+        return;
+    }
+    u = s < 0 ? (uint64_t)0 - (uint64_t)s : (uint64_t)s;
+    mpz_import(z, 1, 1, sizeof(u), 0, 0, &u);
+    if (s < 0)
+        mpz_neg(z, z);
+}
+
+static void
+mpz_set_uint64(mpz_t z, uint64_t u)
+{
+    if (u <= ULONG_MAX)
+        mpz_set_ui(z, (unsigned long)u);
+    else
+        mpz_import(z, 1, 1, sizeof(u), 0, 0, &u);
+}
+
+/* Set z to the value of a NumPy integer scalar. */
+
+static void
+mpz_set_NumPy(mpz_t z, PyObject *obj, const gmpy_npy_scalar *entry)
+{
+    if (entry->kind == GMPY_NPY_SIGNED) {
+        switch (entry->size) {
+            case 1: mpz_set_int64(z, ((gmpy_npy_int8*)obj)->obval); break;
+            case 2: mpz_set_int64(z, ((gmpy_npy_int16*)obj)->obval); break;
+            case 4: mpz_set_int64(z, ((gmpy_npy_int32*)obj)->obval); break;
+            default: mpz_set_int64(z, ((gmpy_npy_int64*)obj)->obval); break;
+        }
+    }
+    else {
+        switch (entry->size) {
+            case 1: mpz_set_uint64(z, ((gmpy_npy_uint8*)obj)->obval); break;
+            case 2: mpz_set_uint64(z, ((gmpy_npy_uint16*)obj)->obval); break;
+            case 4: mpz_set_uint64(z, ((gmpy_npy_uint32*)obj)->obval); break;
+            default: mpz_set_uint64(z, ((gmpy_npy_uint64*)obj)->obval); break;
+        }
+    }
+}
+
 /* GMPy_ObjectType(PyObject *obj) returns an integer that identifies the
  * object's type. See gmpy2_convert.h for details.
  * 
@@ -100,6 +376,16 @@ static inline int GMPy_ObjectType(PyObject *obj)
 
     if (IS_FRACTION(obj)) return OBJ_TYPE_PyFraction;
 
+    if (IS_DECIMAL(obj)) return OBJ_TYPE_PyDecimal;
+
+    switch (GMPy_NumPy_Kind(obj)) {
+        case GMPY_NPY_SIGNED:
+        case GMPY_NPY_UNSIGNED:
+            return OBJ_TYPE_NumPyInteger;
+        case GMPY_NPY_FLOAT:
+            return OBJ_TYPE_NumPyFloat;
+    }
+
     /* Now we look for the presence of __mpz__, __mpq__, __mpfr__, and __mpc__.
      * Since a type may define more than one of the special methods, we perform
      * the checks in reverse order.
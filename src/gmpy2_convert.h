@@ -46,19 +46,41 @@ extern "C" {
 
 #define IS_FRACTION(x) (!strcmp(Py_TYPE(x)->tp_name, "Fraction"))
 
+/* NumPy scalar types are recognized by comparing against the type objects
+ * that are cached the first time a NumPy scalar is seen. See
+ * GMPy_NumPy_Lookup() in gmpy2_convert.c.
+ */
+
+#define GMPY_NPY_NONE       0
+#define GMPY_NPY_SIGNED     1
+#define GMPY_NPY_UNSIGNED   2
+#define GMPY_NPY_FLOAT      4
+#define GMPY_NPY_MAX       16
+
+typedef struct {
+    PyTypeObject *type;
+    int kind;
+    int size;
+} gmpy_npy_scalar;
+
+#define IS_NUMPY_INTEGER(x) (GMPy_NumPy_Kind(x) & \
+                             (GMPY_NPY_SIGNED | GMPY_NPY_UNSIGNED))
+#define IS_NUMPY_FLOAT(x) (GMPy_NumPy_Kind(x) == GMPY_NPY_FLOAT)
+
 #define IS_RATIONAL_ONLY(x) (MPQ_Check(x) || IS_FRACTION(x) || \
                              HAS_MPQ_CONVERSION(x))
 
 #define IS_INTEGER(x) (MPZ_Check(x) || PyLong_Check(x) || \
-                       XMPZ_Check(x) || HAS_STRICT_MPZ_CONVERSION(x))
+                       XMPZ_Check(x) || IS_NUMPY_INTEGER(x) || \
+                       HAS_STRICT_MPZ_CONVERSION(x))
 #define IS_RATIONAL(x) (MPQ_Check(x) || IS_FRACTION(x) || \
                         MPZ_Check(x) || PyLong_Check(x) || \
-                        XMPZ_Check(x) || HAS_MPQ_CONVERSION(x) || \
-                        HAS_MPZ_CONVERSION(x))
+                        XMPZ_Check(x) || IS_NUMPY_INTEGER(x) || \
+                        HAS_MPQ_CONVERSION(x) || HAS_MPZ_CONVERSION(x))
 #define IS_DECIMAL(x) (!strcmp(Py_TYPE(x)->tp_name, "decimal.Decimal") || \
                        !strcmp(Py_TYPE(x)->tp_name, "Decimal"))
 #define IS_REAL_ONLY(x) (MPFR_Check(x) || PyFloat_Check(x) || \
-                         HAS_STRICT_MPFR_CONVERSION(x) || IS_DECIMAL(x))
+                         IS_NUMPY_FLOAT(x) || HAS_STRICT_MPFR_CONVERSION(x))
 #define IS_REAL(x) (IS_RATIONAL(x) || IS_REAL_ONLY(x))
 
 #define IS_COMPLEX_ONLY(x) (MPC_Check(x) || PyComplex_Check(x) || \
@@ -72,7 +94,8 @@ extern "C" {
 #define OBJ_TYPE_XMPZ           2
 #define OBJ_TYPE_PyInteger      3
 #define OBJ_TYPE_HAS_MPZ        4
-/* 5 TO 14 reserved for additional integer types. */
+#define OBJ_TYPE_NumPyInteger   5
+/* 6 TO 14 reserved for additional integer types. */
 #define OBJ_TYPE_INTEGER        15
 
 #define OBJ_TYPE_MPQ            16
@@ -84,7 +107,9 @@ extern "C" {
 #define OBJ_TYPE_MPFR           32
 #define OBJ_TYPE_PyFloat        33
 #define OBJ_TYPE_HAS_MPFR       34
-/* 35 to 46 reserved for additional real types. */
+/* 35 reserved for additional real types. */
+#define OBJ_TYPE_NumPyFloat     36
+/* 37 to 46 reserved for additional real types. */
 #define OBJ_TYPE_REAL           47
 
 #define OBJ_TYPE_MPC            48
@@ -93,7 +118,14 @@ extern "C" {
 /* 50 to 62 reserved for additional complex types. */
 #define OBJ_TYPE_COMPLEX        63
 
-#define OBJ_TYPE_MAX            64
+/* A Decimal is only converted by the mpz(), mpq(), mpfr() and mpc()
+ * constructors. It is outside the numeric ranges, so it is not accepted as
+ * an operand of mixed arithmetic, where it would be rounded to the context
+ * precision.
+ */
+#define OBJ_TYPE_PyDecimal      64
+
+#define OBJ_TYPE_MAX            65
 
 /* The following macros are the recommended method to check the result of the
  * object type check.
@@ -106,6 +138,7 @@ extern "C" {
                                      (x == OBJ_TYPE_XMPZ))
 #define IS_TYPE_PyInteger(x)        (x == OBJ_TYPE_PyInteger)
 #define IS_TYPE_HAS_MPZ(x)          (x == OBJ_TYPE_HAS_MPZ)
+#define IS_TYPE_NumPyInteger(x)     (x == OBJ_TYPE_NumPyInteger)
 #define IS_TYPE_INTEGER(x)          ((x > OBJ_TYPE_UNKNOWN) &&  \
                                      (x < OBJ_TYPE_INTEGER))
 
@@ -120,6 +153,8 @@ extern "C" {
 #define IS_TYPE_MPFR(x)             (x == OBJ_TYPE_MPFR)
 #define IS_TYPE_PyFloat(x)          (x == OBJ_TYPE_PyFloat)
 #define IS_TYPE_HAS_MPFR(x)         (x == OBJ_TYPE_HAS_MPFR)
+#define IS_TYPE_PyDecimal(x)        (x == OBJ_TYPE_PyDecimal)
+#define IS_TYPE_NumPyFloat(x)       (x == OBJ_TYPE_NumPyFloat)
 #define IS_TYPE_REAL(x)             ((x > OBJ_TYPE_UNKNOWN) && \
                                      (x < OBJ_TYPE_REAL))
 #define IS_TYPE_REAL_ONLY(x)        ((x > OBJ_TYPE_RATIONAL) && \
@@ -176,6 +211,12 @@ static int GMPy_isComplex(PyObject *obj);
 
 /* ======== C helper routines ======== */
 static int             mpz_set_PyStr(mpz_t z, PyObject *s, int base);
+static int             GMPy_Decimal_Parts(PyObject *obj, char **digits, Py_ssize_t *exp, int *special);
+static gmpy_npy_scalar * GMPy_NumPy_Lookup(PyObject *obj);
+static int             GMPy_NumPy_Kind(PyObject *obj);
+static void            mpz_set_int64(mpz_t z, int64_t s);
+static void            mpz_set_uint64(mpz_t z, uint64_t u);
+static void            mpz_set_NumPy(mpz_t z, PyObject *obj, const gmpy_npy_scalar *entry);
 static PyObject *      mpz_ascii(mpz_t z, int base, int option, int which);
 
 #ifdef __cplusplus
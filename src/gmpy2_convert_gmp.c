@@ -204,6 +204,9 @@ GMPy_MPZ_From_Integer(PyObject *obj, CTXT_Object *context)
     if (XMPZ_Check(obj))
         return GMPy_MPZ_From_XMPZ((XMPZ_Object*)obj, context);
 
+    if (IS_NUMPY_INTEGER(obj))
+        return GMPy_MPZ_From_NumPy(obj, context);
+
     if (HAS_STRICT_MPZ_CONVERSION(obj)) {
         result = (MPZ_Object *) PyObject_CallMethod(obj, "__mpz__", NULL);
 
@@ -242,6 +245,9 @@ GMPy_MPZ_From_IntegerAndCopy(PyObject *obj, CTXT_Object *context)
     if (XMPZ_Check(obj))
         return GMPy_MPZ_From_XMPZ((XMPZ_Object*)obj, context);
 
+    if (IS_NUMPY_INTEGER(obj))
+        return GMPy_MPZ_From_NumPy(obj, context);
+
     if (HAS_STRICT_MPZ_CONVERSION(obj)) {
         result = (MPZ_Object *) PyObject_CallMethod(obj, "__mpz__", NULL);
 
@@ -275,6 +281,9 @@ GMPy_MPZ_From_IntegerWithType(PyObject *obj, int xtype, CTXT_Object *context)
     if (IS_TYPE_XMPZ(xtype))
         return GMPy_MPZ_From_XMPZ((XMPZ_Object*)obj, context);
 
+    if (IS_TYPE_NumPyInteger(xtype))
+        return GMPy_MPZ_From_NumPy(obj, context);
+
     if (IS_TYPE_HAS_MPZ(xtype)) {
         result = (MPZ_Object *) PyObject_CallMethod(obj, "__mpz__", NULL);
 
@@ -836,6 +845,174 @@ GMPy_MPQ_From_Fraction(PyObject* obj, CTXT_Object *context)
     return result;
 }
 
+/* Convert a decimal.Decimal to an mpz, truncating toward zero like int().
+ * The coefficient is converted with a single mpz_set_str() and scaled by a
+ * power of 10.
+ */
+
+static MPZ_Object *
+GMPy_MPZ_From_Decimal(PyObject *obj, CTXT_Object *context)
+{
+    MPZ_Object *result;
+    char *digits;
+    Py_ssize_t exp;
+    size_t ndigits;
+    int special;
+    mpz_t scale;
+
+    if (GMPy_Decimal_Parts(obj, &digits, &exp, &special) < 0)
+        return NULL;
+
+    if (special) {
+        PyMem_Free(digits);
+        if (special == 2) {
+            VALUE_ERROR("'mpz' does not support NaN");
+        }
+        else {
+            OVERFLOW_ERROR("'mpz' does not support Infinity");
+        }
+        return NULL;
+    }
+
+    if (exp > 0 && (size_t)exp > ULONG_MAX) {
+        PyMem_Free(digits);
+        OVERFLOW_ERROR("Decimal exponent too large to convert to 'mpz'");
+        return NULL;
+    }
+
+    if (!(result = GMPy_MPZ_New(context))) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(digits);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    ndigits = strlen(digits) - (digits[0] == '-');
+    mpz_set_str(result->z, digits, 10);
+    PyMem_Free(digits);
+
+    if (exp > 0) {
+        mpz_init(scale);
+        mpz_ui_pow_ui(scale, 10, (unsigned long)exp);
+        mpz_mul(result->z, result->z, scale);
+        mpz_clear(scale);
+    }
+    else if (exp < 0) {
+        if ((size_t)(-exp) >= ndigits) {
+            mpz_set_ui(result->z, 0);
+        }
+        else {
+            mpz_init(scale);
+            mpz_ui_pow_ui(scale, 10, (unsigned long)(-exp));
+            mpz_tdiv_q(result->z, result->z, scale);
+            mpz_clear(scale);
+        }
+    }
+    return result;
+}
+
+/* Convert a decimal.Decimal to an mpq, exactly. */
+
+static MPQ_Object *
+GMPy_MPQ_From_Decimal(PyObject *obj, CTXT_Object *context)
+{
+    MPQ_Object *result;
+    char *digits;
+    Py_ssize_t exp;
+    int special;
+
+    if (GMPy_Decimal_Parts(obj, &digits, &exp, &special) < 0)
+        return NULL;
+
+    if (special) {
+        PyMem_Free(digits);
+        if (special == 2) {
+            VALUE_ERROR("'mpq' does not support NaN");
+        }
+        else {
+            OVERFLOW_ERROR("'mpq' does not support Infinity");
+        }
+        return NULL;
+    }
+
+    if ((exp > 0 && (size_t)exp > ULONG_MAX) ||
+        (exp < 0 && (size_t)(-exp) > ULONG_MAX)) {
+        PyMem_Free(digits);
+        OVERFLOW_ERROR("Decimal exponent too large to convert to 'mpq'");
+        return NULL;
+    }
+
+    if (!(result = GMPy_MPQ_New(context))) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(digits);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    mpz_set_str(mpq_numref(result->q), digits, 10);
+    PyMem_Free(digits);
+
+    if (exp >= 0) {
+        mpz_ui_pow_ui(mpq_denref(result->q), 10, (unsigned long)exp);
+        mpz_mul(mpq_numref(result->q), mpq_numref(result->q),
+                mpq_denref(result->q));
+        mpz_set_ui(mpq_denref(result->q), 1);
+    }
+    else {
+        mpz_ui_pow_ui(mpq_denref(result->q), 10, (unsigned long)(-exp));
+        mpq_canonicalize(result->q);
+    }
+    return result;
+}
+
+/* Convert a NumPy integer scalar by reading its value directly. */
+
+static MPZ_Object *
+GMPy_MPZ_From_NumPy(PyObject *obj, CTXT_Object *context)
+{
+    MPZ_Object *result;
+    gmpy_npy_scalar *entry;
+
+    if (!(entry = GMPy_NumPy_Lookup(obj)) || entry->kind == GMPY_NPY_FLOAT) {
+        TYPE_ERROR("cannot convert object to mpz");
+        return NULL;
+    }
+
+    if ((result = GMPy_MPZ_New(context)))
+        mpz_set_NumPy(result->z, obj, entry);
+
+    return result;
+}
+
+/* Convert a NumPy integer or floating-point scalar to an mpq, exactly. */
+
+static MPQ_Object *
+GMPy_MPQ_From_NumPy(PyObject *obj, CTXT_Object *context)
+{
+    MPQ_Object *result = NULL;
+    MPFR_Object *tempf;
+    gmpy_npy_scalar *entry;
+
+    if (!(entry = GMPy_NumPy_Lookup(obj))) {
+        TYPE_ERROR("cannot convert object to mpq");
+        return NULL;
+    }
+
+    if (entry->kind != GMPY_NPY_FLOAT) {
+        if ((result = GMPy_MPQ_New(context))) {
+            mpz_set_NumPy(mpq_numref(result->q), obj, entry);
+            mpz_set_ui(mpq_denref(result->q), 1);
+        }
+        return result;
+    }
+
+    if ((tempf = GMPy_MPFR_From_NumPy(obj, 1, context))) {
+        result = GMPy_MPQ_From_MPFR(tempf, context);
+        Py_DECREF((PyObject*)tempf);
+    }
+    return result;
+}
+
 static MPQ_Object*
 GMPy_MPQ_From_Number(PyObject *obj, CTXT_Object *context)
 {
@@ -862,6 +1039,12 @@ GMPy_MPQ_From_Number(PyObject *obj, CTXT_Object *context)
     if (IS_FRACTION(obj))
         return GMPy_MPQ_From_Fraction(obj, context);
 
+    if (IS_DECIMAL(obj))
+        return GMPy_MPQ_From_Decimal(obj, context);
+
+    if (GMPy_NumPy_Kind(obj))
+        return GMPy_MPQ_From_NumPy(obj, context);
+
     PyObject *pair = PyObject_CallMethod(obj, "as_integer_ratio", NULL);
     if (pair != NULL) {
          MPQ_Object *res = (MPQ_Object*)GMPy_MPQ_NewInit(&MPQ_Type, pair, NULL);
@@ -927,6 +1110,12 @@ GMPy_MPQ_From_NumberWithType(PyObject *obj, int xtype, CTXT_Object *context)
     if (IS_TYPE_PyFraction(xtype))
         return GMPy_MPQ_From_Fraction(obj, context);
 
+    if (IS_TYPE_PyDecimal(xtype))
+        return GMPy_MPQ_From_Decimal(obj, context);
+
+    if (IS_TYPE_NumPyInteger(xtype) || IS_TYPE_NumPyFloat(xtype))
+        return GMPy_MPQ_From_NumPy(obj, context);
+
     if (IS_TYPE_HAS_MPQ(xtype)) {
         MPQ_Object * res = (MPQ_Object *) PyObject_CallMethod(obj, "__mpq__", NULL);
 
@@ -1002,6 +1191,9 @@ GMPy_MPQ_From_Rational(PyObject *obj, CTXT_Object *context)
     if (IS_FRACTION(obj))
         return GMPy_MPQ_From_Fraction(obj, context);
 
+    if (IS_NUMPY_INTEGER(obj))
+        return GMPy_MPQ_From_NumPy(obj, context);
+
     if (HAS_MPQ_CONVERSION(obj)) {
         MPQ_Object * res = (MPQ_Object *) PyObject_CallMethod(obj, "__mpq__", NULL);
 
@@ -1078,6 +1270,9 @@ GMPy_MPQ_From_RationalWithType(PyObject *obj, int xtype, CTXT_Object *context)
     if (IS_TYPE_PyFraction(xtype))
         return GMPy_MPQ_From_Fraction(obj, context);
 
+    if (IS_TYPE_NumPyInteger(xtype))
+        return GMPy_MPQ_From_NumPy(obj, context);
+
     if (IS_TYPE_HAS_MPQ(xtype)) {
         MPQ_Object * res = (MPQ_Object *) PyObject_CallMethod(obj, "__mpq__", NULL);
 
@@ -38,6 +38,8 @@ extern "C" {
 static MPZ_Object *    GMPy_MPZ_From_PyLong(PyObject *obj, CTXT_Object *context);
 static MPZ_Object *    GMPy_MPZ_From_PyStr(PyObject *s, int base, CTXT_Object *context);
 static MPZ_Object *    GMPy_MPZ_From_PyFloat(PyObject *obj, CTXT_Object *context);
+static MPZ_Object *    GMPy_MPZ_From_Decimal(PyObject *obj, CTXT_Object *context);
+static MPZ_Object *    GMPy_MPZ_From_NumPy(PyObject *obj, CTXT_Object *context);
 
 static MPZ_Object *    GMPy_MPZ_From_Integer(PyObject *obj, CTXT_Object *context);
 static MPZ_Object *    GMPy_MPZ_From_IntegerAndCopy(PyObject *obj, CTXT_Object *context);
@@ -81,6 +83,8 @@ static MPQ_Object *    GMPy_MPQ_From_PyLong(PyObject *obj, CTXT_Object *context)
 static MPQ_Object *    GMPy_MPQ_From_PyStr(PyObject *s, int base, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_PyFloat(PyObject *obj, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_Fraction(PyObject *obj, CTXT_Object *context);
+static MPQ_Object *    GMPy_MPQ_From_Decimal(PyObject *obj, CTXT_Object *context);
+static MPQ_Object *    GMPy_MPQ_From_NumPy(PyObject *obj, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_MPZ(MPZ_Object *obj, CTXT_Object *context);
 static MPQ_Object *    GMPy_MPQ_From_XMPZ(XMPZ_Object *obj, CTXT_Object *context);
 
@@ -241,6 +241,42 @@ GMPy_MPC_From_Fraction(PyObject *obj, mpfr_prec_t rprec, mpfr_prec_t iprec,
     return result;
 }
 
+static MPC_Object *
+GMPy_MPC_From_Decimal(PyObject *obj, mpfr_prec_t rprec, mpfr_prec_t iprec,
+                      CTXT_Object *context)
+{
+    MPC_Object *result = NULL;
+    MPFR_Object *tempf;
+
+    CHECK_CONTEXT(context);
+
+    if (rprec < 2) {
+        rprec = GET_REAL_PREC(context);
+    }
+
+    if ((tempf = GMPy_MPFR_From_Decimal(obj, rprec, context))) {
+        result = GMPy_MPC_From_MPFR(tempf, rprec, iprec, context);
+        Py_DECREF((PyObject*)tempf);
+    }
+    return result;
+}
+
+static MPC_Object *
+GMPy_MPC_From_NumPy(PyObject *obj, mpfr_prec_t rprec, mpfr_prec_t iprec,
+                    CTXT_Object *context)
+{
+    MPC_Object *result = NULL;
+    MPFR_Object *tempf;
+
+    CHECK_CONTEXT(context);
+
+    if ((tempf = GMPy_MPFR_From_NumPy(obj, 1, context))) {
+        result = GMPy_MPC_From_MPFR(tempf, rprec, iprec, context);
+        Py_DECREF((PyObject*)tempf);
+    }
+    return result;
+}
+
 static MPC_Object *
 GMPy_MPC_From_PyLong(PyObject *obj, mpfr_prec_t rprec, mpfr_prec_t iprec,
                           CTXT_Object *context)
@@ -405,6 +441,12 @@ GMPy_MPC_From_ComplexWithType(PyObject* obj, int xtype, mp_prec_t rprec,
     if (IS_TYPE_PyFraction(xtype))
         return GMPy_MPC_From_Fraction(obj, rprec, iprec, context);
 
+    if (IS_TYPE_PyDecimal(xtype))
+        return GMPy_MPC_From_Decimal(obj, rprec, iprec, context);
+
+    if (IS_TYPE_NumPyInteger(xtype) || IS_TYPE_NumPyFloat(xtype))
+        return GMPy_MPC_From_NumPy(obj, rprec, iprec, context);
+
     if (IS_TYPE_HAS_MPC(xtype)) {
         MPC_Object * res = (MPC_Object *) PyObject_CallMethod(obj, "__mpc__", NULL);
 
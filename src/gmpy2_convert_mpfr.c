@@ -286,6 +286,142 @@ GMPy_MPFR_From_Fraction(PyObject *obj, mpfr_prec_t prec, CTXT_Object *context)
     return result;
 }
 
+/* Convert a decimal.Decimal to an mpfr. The coefficient and exponent are
+ * passed to MPFR as a single string so the result is correctly rounded even
+ * for very large exponents. If prec<2, the context precision is used.
+ */
+
+static MPFR_Object *
+GMPy_MPFR_From_Decimal(PyObject *obj, mpfr_prec_t prec, CTXT_Object *context)
+{
+    MPFR_Object *result;
+    MPQ_Object *tempq;
+    char *digits, *buffer;
+    Py_ssize_t exp;
+    size_t len;
+    int special;
+
+    CHECK_CONTEXT(context);
+
+    if (prec < 2)
+        prec = GET_MPFR_PREC(context);
+
+    if (GMPy_Decimal_Parts(obj, &digits, &exp, &special) < 0)
+        return NULL;
+
+    if (!(result = GMPy_MPFR_New(prec, context))) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(digits);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    mpfr_clear_flags();
+
+    if (special == 2) {
+        mpfr_set_nan(result->f);
+        PyMem_Free(digits);
+    }
+    else if (special == 1) {
+        mpfr_set_inf(result->f, digits[0] == '-' ? -1 : 1);
+        PyMem_Free(digits);
+    }
+    else {
+        len = strlen(digits);
+        if (!(buffer = PyMem_Malloc(len + 32))) {
+            /* LCOV_EXCL_START */
+            PyMem_Free(digits);
+            Py_DECREF((PyObject*)result);
+            return (MPFR_Object*)PyErr_NoMemory();
+            /* LCOV_EXCL_STOP */
+        }
+        PyOS_snprintf(buffer, len + 32, "%se%zd", digits, exp);
+        PyMem_Free(digits);
+        result->rc = mpfr_strtofr(result->f, buffer, NULL, 10, GET_MPFR_ROUND(context));
+        PyMem_Free(buffer);
+
+        /* See GMPy_MPFR_From_PyStr for why subnormals use an exact mpq. */
+        if (mpfr_regular_p(result->f) &&
+            context->ctx.subnormalize &&
+            result->f->_mpfr_exp <= context->ctx.emin + mpfr_get_prec(result->f) - 1) {
+
+            if (!(tempq = GMPy_MPQ_From_Decimal(obj, context))) {
+                Py_DECREF((PyObject*)result);
+                return NULL;
+            }
+
+            mpfr_clear_flags();
+            result->rc = mpfr_set_q(result->f, tempq->q, GET_MPFR_ROUND(context));
+            Py_DECREF((PyObject*)tempq);
+        }
+    }
+
+    GMPY_MPFR_CHECK_RANGE(result, context);
+    GMPY_MPFR_SUBNORMALIZE(result, context);
+    GMPY_MPFR_EXCEPTIONS(result, context);
+
+    return result;
+}
+
+/* Convert a NumPy scalar to an mpfr by reading its value directly. If
+ * prec==1, the precision of the NumPy type is used.
+ */
+
+static MPFR_Object *
+GMPy_MPFR_From_NumPy(PyObject *obj, mpfr_prec_t prec, CTXT_Object *context)
+{
+    MPFR_Object *result = NULL;
+    MPZ_Object *tempz;
+    gmpy_npy_scalar *entry;
+    double d = 0.0;
+
+    CHECK_CONTEXT(context);
+
+    if (!(entry = GMPy_NumPy_Lookup(obj))) {
+        TYPE_ERROR("object could not be converted to 'mpfr'");
+        return NULL;
+    }
+
+    if (entry->kind != GMPY_NPY_FLOAT) {
+        if ((tempz = GMPy_MPZ_From_NumPy(obj, context))) {
+            result = GMPy_MPFR_From_MPZ(tempz, prec, context);
+            Py_DECREF((PyObject*)tempz);
+        }
+        return result;
+    }
+
+    /* float16 values are read through float(), which is exact. */
+    if (entry->size != (int)sizeof(float) &&
+        entry->size != (int)sizeof(long double)) {
+        d = PyFloat_AsDouble(obj);
+        if (d == -1.0 && PyErr_Occurred())
+            return NULL;
+    }
+
+    if (prec == 0)
+        prec = GET_MPFR_PREC(context);
+    else if (prec == 1)
+        prec = entry->size == (int)sizeof(float) ? FLT_MANT_DIG :
+               entry->size == (int)sizeof(long double) ? LDBL_MANT_DIG :
+               DBL_MANT_DIG;
+
+    if ((result = GMPy_MPFR_New(prec, context))) {
+        mpfr_clear_flags();
+        if (entry->size == (int)sizeof(float))
+            result->rc = mpfr_set_flt(result->f, ((gmpy_npy_float*)obj)->obval,
+                                      GET_MPFR_ROUND(context));
+        else if (entry->size == (int)sizeof(long double))
+            result->rc = mpfr_set_ld(result->f, ((gmpy_npy_longdouble*)obj)->obval,
+                                     GET_MPFR_ROUND(context));
+        else
+            result->rc = mpfr_set_d(result->f, d, GET_MPFR_ROUND(context));
+        GMPY_MPFR_CHECK_RANGE(result, context);
+        GMPY_MPFR_SUBNORMALIZE(result, context);
+        GMPY_MPFR_EXCEPTIONS(result, context);
+    }
+    return result;
+}
+
 static MPFR_Object *
 GMPy_MPFR_From_PyStr(PyObject *s, int base, mpfr_prec_t prec, CTXT_Object *context)
 {
@@ -412,6 +548,12 @@ GMPy_MPFR_From_RealWithType(PyObject *obj, int xtype, mp_prec_t prec, CTXT_Objec
     if (IS_TYPE_PyFraction(xtype))
         return GMPy_MPFR_From_Fraction(obj, prec, context);
 
+    if (IS_TYPE_PyDecimal(xtype))
+        return GMPy_MPFR_From_Decimal(obj, prec, context);
+
+    if (IS_TYPE_NumPyInteger(xtype) || IS_TYPE_NumPyFloat(xtype))
+        return GMPy_MPFR_From_NumPy(obj, prec, context);
+
     if (IS_TYPE_HAS_MPFR(xtype)) {
         MPFR_Object *res = (MPFR_Object *) PyObject_CallMethod(obj, "__mpfr__", NULL);
 
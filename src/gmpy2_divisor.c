@@ -0,0 +1,357 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_divisor.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Division by a fixed divisor.
+ *
+ * A divisor object does the work that depends only on the divisor once.
+ * Powers of two and divisors less than 2**64 use the gmpy_divisor kernels
+ * that are shared with the *_many functions. Larger divisors keep a
+ * Barrett reciprocal. The numerator is processed from the top one chunk
+ * at a time, where a chunk is as many limbs as the divisor has. Each chunk
+ * costs two multiplications and at most two corrections, so GMP doesn't
+ * have to normalize the divisor and compute an inverse on every call.
+ */
+
+/* Below this size (in limbs) GMP's own division is as fast, because it
+ * only computes an inverse for very large divisors.
+ */
+
+#define DIVISOR_BARRETT_LIMBS 1024
+
+/* Set q and r such that t == q*|d| + r and 0 <= r < |d|. Requires
+ * 0 <= t < |d| * 2**B. The estimate of q is low by at most two.
+ */
+
+static void
+divisor_barrett_step(mpz_ptr q, mpz_ptr r, mpz_srcptr t, const Divisor_Object *self,
+                     mpz_ptr temp)
+{
+    mpz_tdiv_q_2exp(temp, t, self->nbits - 1);
+    mpz_mul(temp, temp, self->inv);
+    mpz_tdiv_q_2exp(q, temp, self->chunk + 1);
+    mpz_mul(temp, q, self->d.abs);
+    mpz_sub(r, t, temp);
+    while (mpz_cmp(r, self->d.abs) >= 0) {
+        mpz_sub(r, r, self->d.abs);
+        mpz_add_ui(q, q, 1);
+    }
+}
+
+/* Set q and r to the quotient and remainder of |x| divided by |d|. q and r
+ * must be distinct from x.
+ */
+
+static void
+divisor_barrett_divmod(mpz_ptr q, mpz_ptr r, mpz_srcptr x, const Divisor_Object *self)
+{
+    const mp_limb_t *xp;
+    mp_limb_t *qp;
+    mp_size_t xn, dn, k, i, n;
+    mpz_t t, qi, temp, chunk;
+
+    if (mpz_cmpabs(x, self->d.abs) < 0) {
+        mpz_abs(r, x);
+        mpz_set_ui(q, 0);
+        return;
+    }
+
+    mpz_init(t);
+    mpz_init(qi);
+    mpz_init(temp);
+
+    xn = mpz_size(x);
+    dn = mpz_size(self->d.abs);
+    k = (xn + dn - 1) / dn;
+    xp = mpz_limbs_read(x);
+    qp = mpz_limbs_write(q, k * dn);
+    mpz_set_ui(r, 0);
+
+    for (i = k - 1; i >= 0; i--) {
+        mpz_roinit_n(chunk, xp + i * dn, (i == k - 1) ? xn - i * dn : dn);
+        mpz_mul_2exp(t, r, self->chunk);
+        mpz_add(t, t, chunk);
+        divisor_barrett_step(qi, r, t, self, temp);
+        n = mpz_size(qi);
+        memcpy(qp + i * dn, mpz_limbs_read(qi), n * sizeof(mp_limb_t));
+        memset(qp + i * dn + n, 0, (dn - n) * sizeof(mp_limb_t));
+    }
+    mpz_limbs_finish(q, k * dn);
+
+    mpz_clear(t);
+    mpz_clear(qi);
+    mpz_clear(temp);
+}
+
+/* Set q and/or r (either may be NULL) to the quotient and remainder of x
+ * divided by the divisor. mode is 'c', 'f', or 't'.
+ */
+
+static void
+divisor_divmod(mpz_ptr q, mpz_ptr r, mpz_srcptr x, const Divisor_Object *self, int mode)
+{
+    mpz_t qm, rm;
+    int qneg, rneg;
+
+    if (!self->barrett) {
+        gmpy_divisor_divmod(q, r, x, &self->d, mode);
+        return;
+    }
+
+    mpz_init(qm);
+    mpz_init(rm);
+    divisor_barrett_divmod(qm, rm, x, self);
+
+    rneg = mpz_sgn(x) < 0;
+    qneg = rneg ^ self->d.negative;
+    if (mpz_sgn(rm) && ((mode == 'f' && qneg) || (mode == 'c' && !qneg))) {
+        mpz_add_ui(qm, qm, 1);
+        mpz_sub(rm, self->d.abs, rm);
+        rneg = !rneg;
+    }
+    if (q) {
+        if (qneg)
+            mpz_neg(q, qm);
+        else
+            mpz_set(q, qm);
+    }
+    if (r) {
+        if (rneg)
+            mpz_neg(r, rm);
+        else
+            mpz_set(r, rm);
+    }
+    mpz_clear(qm);
+    mpz_clear(rm);
+}
+
+/* Compute the quotient and/or remainder of other divided by self with
+ * floor rounding.
+ */
+
+static PyObject *
+divisor_apply(Divisor_Object *self, PyObject *other, int want_q, int want_r,
+              const char *name)
+{
+    MPZ_Object *x, *q = NULL, *r = NULL;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(x = GMPy_MPZ_From_Integer(other, context))) {
+        PyErr_Format(PyExc_TypeError, "%s() requires an integer argument", name);
+        return NULL;
+    }
+    if ((want_q && !(q = GMPy_MPZ_New(context))) ||
+        (want_r && !(r = GMPy_MPZ_New(context)))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    divisor_divmod(q ? q->z : NULL, r ? r->z : NULL, x->z, self, 'f');
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+    if (q && r) {
+        result = PyTuple_Pack(2, (PyObject*)q, (PyObject*)r);
+    }
+    else {
+        result = q ? (PyObject*)q : (PyObject*)r;
+        Py_INCREF(result);
+    }
+
+  done:
+    Py_XDECREF((PyObject*)q);
+    Py_XDECREF((PyObject*)r);
+    Py_DECREF((PyObject*)x);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_divisor_method_divmod,
+"d.divmod(x, /) -> tuple[mpz, mpz]\n\n"
+"Return the quotient and remainder of x divided by d. The quotient is\n"
+"rounded towards -Inf and the remainder has the same sign as d, just\n"
+"like divmod(x, d).");
+
+static PyObject *
+GMPy_Divisor_Method_DivMod(PyObject *self, PyObject *other)
+{
+    return divisor_apply((Divisor_Object*)self, other, 1, 1, "divmod");
+}
+
+PyDoc_STRVAR(GMPy_doc_divisor_method_div,
+"d.div(x, /) -> mpz\n\n"
+"Return x // d.");
+
+static PyObject *
+GMPy_Divisor_Method_Div(PyObject *self, PyObject *other)
+{
+    return divisor_apply((Divisor_Object*)self, other, 1, 0, "div");
+}
+
+PyDoc_STRVAR(GMPy_doc_divisor_method_mod,
+"d.mod(x, /) -> mpz\n\n"
+"Return x % d.");
+
+static PyObject *
+GMPy_Divisor_Method_Mod(PyObject *self, PyObject *other)
+{
+    return divisor_apply((Divisor_Object*)self, other, 0, 1, "mod");
+}
+
+PyDoc_STRVAR(GMPy_doc_divisor_method_divexact,
+"d.divexact(x, /) -> mpz\n\n"
+"Return the quotient of x divided by d. Faster than d.div(x) but the\n"
+"result is undefined if x is not a multiple of d.");
+
+static PyObject *
+GMPy_Divisor_Method_DivExact(PyObject *self, PyObject *other)
+{
+    Divisor_Object *d = (Divisor_Object*)self;
+    MPZ_Object *x, *result;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(x = GMPy_MPZ_From_Integer(other, context))) {
+        TYPE_ERROR("divexact() requires an integer argument");
+        return NULL;
+    }
+    if ((result = GMPy_MPZ_New(context))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        if (d->d.kind == GMPY_DIVISOR_POW2) {
+            mpz_tdiv_q_2exp(result->z, x->z, d->d.shift);
+            if (d->d.negative)
+                mpz_neg(result->z, result->z);
+        }
+        else {
+            mpz_divexact(result->z, x->z, d->value->z);
+        }
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+    }
+    Py_DECREF((PyObject*)x);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_Divisor_Attrib_GetValue(Divisor_Object *self, void *closure)
+{
+    Py_INCREF((PyObject*)self->value);
+    return (PyObject*)self->value;
+}
+
+static PyObject *
+GMPy_Divisor_Repr_Slot(Divisor_Object *self)
+{
+    return PyUnicode_FromFormat("divisor(%R)", (PyObject*)self->value);
+}
+
+static void
+GMPy_Divisor_Dealloc(Divisor_Object *self)
+{
+    if (self->value) {
+        gmpy_divisor_clear(&self->d);
+        mpz_clear(self->inv);
+        Py_DECREF((PyObject*)self->value);
+    }
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_Divisor_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    Divisor_Object *result;
+    MPZ_Object *value;
+    PyObject *arg;
+    static char *kwlist[] = {"", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O", kwlist, &arg)) {
+        return NULL;
+    }
+    if (!(value = GMPy_MPZ_From_Integer(arg, NULL))) {
+        TYPE_ERROR("divisor() requires an integer argument");
+        return NULL;
+    }
+    if (mpz_sgn(value->z) == 0) {
+        ZERO_ERROR("divisor() division by 0");
+        Py_DECREF((PyObject*)value);
+        return NULL;
+    }
+    if (GMPy_Ready_Type(&Divisor_Type) < 0 ||
+        !(result = PyObject_New(Divisor_Object, &Divisor_Type))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)value);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    result->value = value;
+    gmpy_divisor_init(&result->d, value->z);
+    result->nbits = mpz_sizeinbase(result->d.abs, 2);
+    result->chunk = mpz_size(result->d.abs) * GMP_NUMB_BITS;
+    result->barrett = result->d.kind == GMPY_DIVISOR_MPZ &&
+                      mpz_size(result->d.abs) >= DIVISOR_BARRETT_LIMBS;
+    mpz_init(result->inv);
+    if (result->barrett) {
+        mpz_setbit(result->inv, result->nbits + result->chunk);
+        mpz_tdiv_q(result->inv, result->inv, result->d.abs);
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_divisor,
+"divisor(d, /)\n\n"
+"Return an object for repeated division by the non-zero integer d. The\n"
+"work that depends only on d is done once: powers of two are applied\n"
+"with shifts, divisors less than 2**64 use a precomputed multiplier, and\n"
+"large divisors keep a Barrett reciprocal. This is faster than calling\n"
+"divmod() with the same large divisor many times, e.g. for base\n"
+"conversion or modular reduction.");
+
+static PyGetSetDef GMPy_Divisor_getseters[] = {
+    { "value", (getter)GMPy_Divisor_Attrib_GetValue, NULL,
+        "the divisor as an mpz", NULL },
+    {NULL}
+};
+
+static PyMethodDef GMPy_Divisor_methods[] = {
+    { "div", GMPy_Divisor_Method_Div, METH_O, GMPy_doc_divisor_method_div },
+    { "divexact", GMPy_Divisor_Method_DivExact, METH_O, GMPy_doc_divisor_method_divexact },
+    { "divmod", GMPy_Divisor_Method_DivMod, METH_O, GMPy_doc_divisor_method_divmod },
+    { "mod", GMPy_Divisor_Method_Mod, METH_O, GMPy_doc_divisor_method_mod },
+    { NULL }
+};
+
+static PyTypeObject Divisor_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.divisor",
+    .tp_basicsize = sizeof(Divisor_Object),
+    .tp_dealloc = (destructor) GMPy_Divisor_Dealloc,
+    .tp_repr = (reprfunc) GMPy_Divisor_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_divisor,
+    .tp_methods = GMPy_Divisor_methods,
+    .tp_getset = GMPy_Divisor_getseters,
+    .tp_new = GMPy_Divisor_NewInit,
+};
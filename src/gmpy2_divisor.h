@@ -0,0 +1,56 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_divisor.h                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_DIVISOR_H
+#define GMPY_DIVISOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A divisor that is prepared once for many divisions. Large divisors keep
+ * a Barrett reciprocal: with n the bit length of |d| and B the number of
+ * bits in the limbs of |d|, inv = floor(2**(n+B) / |d|).
+ */
+
+typedef struct {
+    PyObject_HEAD
+    gmpy_divisor d;
+    MPZ_Object *value;
+    mp_bitcnt_t nbits;     /* n */
+    mp_bitcnt_t chunk;     /* B */
+    int barrett;           /* inv is valid */
+    mpz_t inv;
+} Divisor_Object;
+
+static PyTypeObject Divisor_Type;
+#define Divisor_Check(v) (((PyObject*)v)->ob_type == &Divisor_Type)
+
+static PyObject * GMPy_Divisor_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static void GMPy_Divisor_Dealloc(Divisor_Object *self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
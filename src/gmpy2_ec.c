@@ -0,0 +1,1821 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_ec.c                                                              *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Elliptic curves over Z/pZ.
+ *
+ * An ec_curve holds the modulus and the coefficients of a curve in short
+ * Weierstrass, Montgomery, or twisted Edwards form, and ec_point objects
+ * are points on a curve in projective coordinates. p does not have to be a
+ * prime, so the curves can be used for the elliptic curve method of
+ * factorization: if a point cannot be normalized, its Z coordinate shares
+ * a factor with p.
+ *
+ * The formulas are those of the Explicit-Formulas Database: dbl-2007-bl
+ * and add-2007-bl for Jacobian coordinates, the x-only doubling and
+ * differential addition of Montgomery, and dbl-2008-hwcd and add-2008-hwcd
+ * for extended Edwards coordinates. Montgomery curves only have x-only
+ * arithmetic, so they support scalar multiplication (with the Montgomery
+ * ladder) but not addition of arbitrary points.
+ *
+ * ec_point.mul_sec() is a Montgomery ladder computed with the side-channel
+ * silent mpn_sec_* functions of GMP that are also used by mpz_powm_sec().
+ */
+
+/* Scalar bits processed between checks for pending signals. */
+
+#define EC_MUL_CHUNK 1024
+
+/* Window width of ec_curve.multi_mul(). */
+
+#define EC_STRAUS_BITS 4
+
+#define EC_WORK 12
+
+typedef struct {
+    mpz_t t[EC_WORK];
+} ec_work;
+
+static void
+ec_work_init(ec_work *w)
+{
+    int i;
+
+    for (i = 0; i < EC_WORK; i++) {
+        mpz_init(w->t[i]);
+    }
+}
+
+static void
+ec_work_clear(ec_work *w)
+{
+    int i;
+
+    for (i = 0; i < EC_WORK; i++) {
+        mpz_clear(w->t[i]);
+    }
+}
+
+static void
+ec_coords_init(ec_coords *P)
+{
+    mpz_init(P->X);
+    mpz_init(P->Y);
+    mpz_init(P->Z);
+    mpz_init(P->T);
+}
+
+static void
+ec_coords_clear(ec_coords *P)
+{
+    mpz_clear(P->X);
+    mpz_clear(P->Y);
+    mpz_clear(P->Z);
+    mpz_clear(P->T);
+}
+
+static void
+ec_coords_set(ec_coords *R, const ec_coords *P)
+{
+    mpz_set(R->X, P->X);
+    mpz_set(R->Y, P->Y);
+    mpz_set(R->Z, P->Z);
+    mpz_set(R->T, P->T);
+}
+
+/* Arithmetic in Z/pZ on values in [0, p). */
+
+static void
+ec_fmul(mpz_ptr r, mpz_srcptr x, mpz_srcptr y, mpz_srcptr p)
+{
+    mpz_mul(r, x, y);
+    mpz_tdiv_r(r, r, p);
+}
+
+static void
+ec_fsqr(mpz_ptr r, mpz_srcptr x, mpz_srcptr p)
+{
+    mpz_mul(r, x, x);
+    mpz_tdiv_r(r, r, p);
+}
+
+static void
+ec_fmul_ui(mpz_ptr r, mpz_srcptr x, unsigned long y, mpz_srcptr p)
+{
+    mpz_mul_ui(r, x, y);
+    mpz_tdiv_r(r, r, p);
+}
+
+static void
+ec_fadd(mpz_ptr r, mpz_srcptr x, mpz_srcptr y, mpz_srcptr p)
+{
+    mpz_add(r, x, y);
+    if (mpz_cmp(r, p) >= 0) {
+        mpz_sub(r, r, p);
+    }
+}
+
+static void
+ec_fsub(mpz_ptr r, mpz_srcptr x, mpz_srcptr y, mpz_srcptr p)
+{
+    mpz_sub(r, x, y);
+    if (mpz_sgn(r) < 0) {
+        mpz_add(r, r, p);
+    }
+}
+
+static void
+ec_set_identity(const EC_Curve_Object *c, ec_coords *R)
+{
+    mpz_set_ui(R->X, c->model == EC_EDWARDS ? 0 : 1);
+    mpz_set_ui(R->Y, 1);
+    mpz_set_ui(R->Z, c->model == EC_EDWARDS ? 1 : 0);
+    mpz_set_ui(R->T, 0);
+}
+
+static int
+ec_is_identity(const EC_Curve_Object *c, const ec_coords *P)
+{
+    if (c->model == EC_EDWARDS) {
+        return mpz_sgn(P->X) == 0 && mpz_cmp(P->Y, P->Z) == 0;
+    }
+    return mpz_sgn(P->Z) == 0;
+}
+
+static void
+ec_neg(const EC_Curve_Object *c, ec_coords *R, const ec_coords *P)
+{
+    ec_coords_set(R, P);
+    if (c->model == EC_EDWARDS) {
+        ec_fsub(R->X, c->p, R->X, c->p);
+        ec_fsub(R->T, c->p, R->T, c->p);
+    }
+    else if (c->model == EC_WEIERSTRASS) {
+        ec_fsub(R->Y, c->p, R->Y, c->p);
+    }
+}
+
+/* R = 2*P. R may be the same as P. */
+
+static void
+ec_double(ec_work *w, const EC_Curve_Object *c, ec_coords *R, const ec_coords *P)
+{
+    mpz_srcptr p = c->p;
+
+    if (c->model == EC_WEIERSTRASS) {
+        mpz_ptr XX = w->t[0], YY = w->t[1], YYYY = w->t[2], ZZ = w->t[3];
+        mpz_ptr S = w->t[4], M = w->t[5], T = w->t[6], Z3 = w->t[7];
+
+        ec_fsqr(XX, P->X, p);
+        ec_fsqr(YY, P->Y, p);
+        ec_fsqr(YYYY, YY, p);
+        ec_fsqr(ZZ, P->Z, p);
+        /* S = 2*((X1 + YY)**2 - XX - YYYY) */
+        ec_fadd(S, P->X, YY, p);
+        ec_fsqr(S, S, p);
+        ec_fsub(S, S, XX, p);
+        ec_fsub(S, S, YYYY, p);
+        ec_fadd(S, S, S, p);
+        /* M = 3*XX + a*ZZ**2 */
+        ec_fsqr(M, ZZ, p);
+        ec_fmul(M, M, c->a, p);
+        ec_fadd(T, XX, XX, p);
+        ec_fadd(T, T, XX, p);
+        ec_fadd(M, M, T, p);
+        /* Z3 = (Y1 + Z1)**2 - YY - ZZ */
+        ec_fadd(Z3, P->Y, P->Z, p);
+        ec_fsqr(Z3, Z3, p);
+        ec_fsub(Z3, Z3, YY, p);
+        ec_fsub(Z3, Z3, ZZ, p);
+        /* X3 = M**2 - 2*S, Y3 = M*(S - X3) - 8*YYYY */
+        ec_fsqr(T, M, p);
+        ec_fsub(T, T, S, p);
+        ec_fsub(T, T, S, p);
+        ec_fsub(S, S, T, p);
+        ec_fmul(S, S, M, p);
+        ec_fmul_ui(YYYY, YYYY, 8, p);
+        ec_fsub(R->Y, S, YYYY, p);
+        mpz_swap(R->X, T);
+        mpz_swap(R->Z, Z3);
+    }
+    else if (c->model == EC_MONTGOMERY) {
+        mpz_ptr t1 = w->t[0], t2 = w->t[1], t3 = w->t[2];
+
+        ec_fadd(t1, P->X, P->Z, p);
+        ec_fsqr(t1, t1, p);
+        ec_fsub(t2, P->X, P->Z, p);
+        ec_fsqr(t2, t2, p);
+        ec_fsub(t3, t1, t2, p);
+        ec_fmul(R->X, t1, t2, p);
+        ec_fmul(t1, c->a24, t3, p);
+        ec_fadd(t1, t1, t2, p);
+        ec_fmul(R->Z, t1, t3, p);
+    }
+    else {
+        mpz_ptr A = w->t[0], B = w->t[1], C = w->t[2], D = w->t[3];
+        mpz_ptr E = w->t[4], F = w->t[5], G = w->t[6], H = w->t[7];
+
+        ec_fsqr(A, P->X, p);
+        ec_fsqr(B, P->Y, p);
+        ec_fsqr(C, P->Z, p);
+        ec_fadd(C, C, C, p);
+        ec_fmul(D, c->a, A, p);
+        ec_fadd(E, P->X, P->Y, p);
+        ec_fsqr(E, E, p);
+        ec_fsub(E, E, A, p);
+        ec_fsub(E, E, B, p);
+        ec_fadd(G, D, B, p);
+        ec_fsub(F, G, C, p);
+        ec_fsub(H, D, B, p);
+        ec_fmul(R->X, E, F, p);
+        ec_fmul(R->Y, G, H, p);
+        ec_fmul(R->T, E, H, p);
+        ec_fmul(R->Z, F, G, p);
+    }
+}
+
+/* R = P + Q on a Weierstrass or Edwards curve. R may be the same as P or
+ * Q.
+ */
+
+static void
+ec_add(ec_work *w, const EC_Curve_Object *c, ec_coords *R,
+       const ec_coords *P, const ec_coords *Q)
+{
+    mpz_srcptr p = c->p;
+
+    if (c->model == EC_WEIERSTRASS) {
+        mpz_ptr Z1Z1 = w->t[0], Z2Z2 = w->t[1], U1 = w->t[2], U2 = w->t[3];
+        mpz_ptr S1 = w->t[4], S2 = w->t[5], H = w->t[6], r = w->t[7];
+        mpz_ptr I = w->t[8], J = w->t[9], V = w->t[10], Z3 = w->t[11];
+
+        if (mpz_sgn(P->Z) == 0) {
+            if (R != Q) {
+                ec_coords_set(R, Q);
+            }
+            return;
+        }
+        if (mpz_sgn(Q->Z) == 0) {
+            if (R != P) {
+                ec_coords_set(R, P);
+            }
+            return;
+        }
+        ec_fsqr(Z1Z1, P->Z, p);
+        ec_fsqr(Z2Z2, Q->Z, p);
+        ec_fmul(U1, P->X, Z2Z2, p);
+        ec_fmul(U2, Q->X, Z1Z1, p);
+        ec_fmul(S1, P->Y, Q->Z, p);
+        ec_fmul(S1, S1, Z2Z2, p);
+        ec_fmul(S2, Q->Y, P->Z, p);
+        ec_fmul(S2, S2, Z1Z1, p);
+        ec_fsub(H, U2, U1, p);
+        ec_fsub(r, S2, S1, p);
+        ec_fadd(r, r, r, p);
+        if (mpz_sgn(H) == 0) {
+            if (mpz_sgn(r) == 0) {
+                ec_double(w, c, R, P);
+            }
+            else {
+                ec_set_identity(c, R);
+            }
+            return;
+        }
+        ec_fadd(I, H, H, p);
+        ec_fsqr(I, I, p);
+        ec_fmul(J, H, I, p);
+        ec_fmul(V, U1, I, p);
+        /* Z3 = ((Z1 + Z2)**2 - Z1Z1 - Z2Z2)*H */
+        ec_fadd(Z3, P->Z, Q->Z, p);
+        ec_fsqr(Z3, Z3, p);
+        ec_fsub(Z3, Z3, Z1Z1, p);
+        ec_fsub(Z3, Z3, Z2Z2, p);
+        ec_fmul(Z3, Z3, H, p);
+        /* X3 = r**2 - J - 2*V, Y3 = r*(V - X3) - 2*S1*J */
+        ec_fsqr(Z1Z1, r, p);
+        ec_fsub(Z1Z1, Z1Z1, J, p);
+        ec_fsub(Z1Z1, Z1Z1, V, p);
+        ec_fsub(Z1Z1, Z1Z1, V, p);
+        ec_fsub(V, V, Z1Z1, p);
+        ec_fmul(V, V, r, p);
+        ec_fmul(S1, S1, J, p);
+        ec_fadd(S1, S1, S1, p);
+        ec_fsub(R->Y, V, S1, p);
+        mpz_swap(R->X, Z1Z1);
+        mpz_swap(R->Z, Z3);
+    }
+    else {
+        mpz_ptr A = w->t[0], B = w->t[1], C = w->t[2], D = w->t[3];
+        mpz_ptr E = w->t[4], F = w->t[5], G = w->t[6], H = w->t[7];
+
+        ec_fmul(A, P->X, Q->X, p);
+        ec_fmul(B, P->Y, Q->Y, p);
+        ec_fmul(C, P->T, Q->T, p);
+        ec_fmul(C, C, c->b, p);
+        ec_fmul(D, P->Z, Q->Z, p);
+        ec_fadd(E, P->X, P->Y, p);
+        ec_fadd(F, Q->X, Q->Y, p);
+        ec_fmul(E, E, F, p);
+        ec_fsub(E, E, A, p);
+        ec_fsub(E, E, B, p);
+        ec_fsub(F, D, C, p);
+        ec_fadd(G, D, C, p);
+        ec_fmul(H, c->a, A, p);
+        ec_fsub(H, B, H, p);
+        ec_fmul(R->X, E, F, p);
+        ec_fmul(R->Y, G, H, p);
+        ec_fmul(R->T, E, H, p);
+        ec_fmul(R->Z, F, G, p);
+    }
+}
+
+/* R = P + Q on a Montgomery curve, where D = P - Q. R may be the same as P
+ * or Q but not D.
+ */
+
+static void
+ec_xadd(ec_work *w, const EC_Curve_Object *c, ec_coords *R,
+        const ec_coords *P, const ec_coords *Q, const ec_coords *D)
+{
+    mpz_srcptr p = c->p;
+    mpz_ptr u = w->t[0], v = w->t[1], t = w->t[2];
+
+    ec_fsub(u, P->X, P->Z, p);
+    ec_fadd(t, Q->X, Q->Z, p);
+    ec_fmul(u, u, t, p);
+    ec_fadd(v, P->X, P->Z, p);
+    ec_fsub(t, Q->X, Q->Z, p);
+    ec_fmul(v, v, t, p);
+    ec_fadd(t, u, v, p);
+    ec_fsqr(t, t, p);
+    ec_fsub(v, u, v, p);
+    ec_fsqr(v, v, p);
+    ec_fmul(R->X, D->Z, t, p);
+    ec_fmul(R->Z, D->X, v, p);
+}
+
+/* R = k*P for k > 0. On Montgomery curves the ladder is used, otherwise a
+ * sliding window of odd multiples of P. The GIL is released and pending
+ * signals are checked every EC_MUL_CHUNK bits. Returns -1 if an exception
+ * was raised.
+ */
+
+static int
+ec_mul(const EC_Curve_Object *c, ec_coords *R, const ec_coords *P,
+       mpz_srcptr k, CTXT_Object *context)
+{
+    ec_work w;
+    ec_coords table[16], R1;    /* table[i] = (2*i + 1)*P */
+    Py_ssize_t i, j, l, stop;
+    size_t nbits = mpz_sizeinbase(k, 2), val, n = 1;
+    int win = 1, started = 0, result = 0;
+
+    ec_work_init(&w);
+    ec_coords_init(&R1);
+    if (c->model == EC_MONTGOMERY && mpz_sgn(P->X) == 0) {
+        /* P = (0, 0) has order 2. The ladder can't be used since every
+         * differential addition with it as the difference gives (0 : 0).
+         */
+        if (mpz_odd_p(k)) {
+            ec_coords_set(R, P);
+        }
+        else {
+            ec_set_identity(c, R);
+        }
+        ec_coords_clear(&R1);
+        ec_work_clear(&w);
+        return 0;
+    }
+    if (c->model == EC_MONTGOMERY) {
+        /* (R, R1) = (m*P, (m + 1)*P) for the leading bits m of k. */
+        ec_coords_set(R, P);
+        ec_double(&w, c, &R1, P);
+        i = (Py_ssize_t)nbits - 2;
+        while (i >= 0) {
+            stop = i - EC_MUL_CHUNK;
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            for (; i >= 0 && i > stop; i--) {
+                if (mpz_tstbit(k, i)) {
+                    ec_xadd(&w, c, R, &R1, R, P);
+                    ec_double(&w, c, &R1, &R1);
+                }
+                else {
+                    ec_xadd(&w, c, &R1, R, &R1, P);
+                    ec_double(&w, c, R, R);
+                }
+            }
+            GMPY_MAYBE_END_ALLOW_THREADS(context);
+            if (PyErr_CheckSignals() < 0) {
+                result = -1;
+                break;
+            }
+        }
+        ec_coords_clear(&R1);
+        ec_work_clear(&w);
+        return result;
+    }
+
+    win = nbits < 16 ? 1 : nbits < 96 ? 3 : nbits < 512 ? 4 : 5;
+    n = (size_t)1 << (win - 1);
+    for (val = 0; val < n; val++) {
+        ec_coords_init(&table[val]);
+    }
+    ec_coords_set(&table[0], P);
+    if (n > 1) {
+        ec_double(&w, c, &R1, P);
+        for (val = 1; val < n; val++) {
+            ec_add(&w, c, &table[val], &table[val - 1], &R1);
+        }
+    }
+
+    i = (Py_ssize_t)nbits - 1;
+    while (i >= 0) {
+        stop = i - EC_MUL_CHUNK;
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        while (i >= 0 && i > stop) {
+            if (!mpz_tstbit(k, i)) {
+                ec_double(&w, c, R, R);
+                i--;
+                continue;
+            }
+            /* The longest window k[i..j] of at most win bits ending in a 1. */
+            j = i - win + 1 < 0 ? 0 : i - win + 1;
+            while (!mpz_tstbit(k, j)) {
+                j++;
+            }
+            for (val = 0, l = i; l >= j; l--) {
+                val = 2 * val + mpz_tstbit(k, l);
+            }
+            if (started) {
+                for (l = j; l <= i; l++) {
+                    ec_double(&w, c, R, R);
+                }
+                ec_add(&w, c, R, R, &table[val >> 1]);
+            }
+            else {
+                ec_coords_set(R, &table[val >> 1]);
+                started = 1;
+            }
+            i = j - 1;
+        }
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (PyErr_CheckSignals() < 0) {
+            result = -1;
+            break;
+        }
+    }
+
+    for (val = 0; val < n; val++) {
+        ec_coords_clear(&table[val]);
+    }
+    ec_coords_clear(&R1);
+    ec_work_clear(&w);
+    return result;
+}
+
+/* R = sum(k[i]*P[i]) for k[i] >= 0 on a Weierstrass or Edwards curve,
+ * using Straus' method with windows of EC_STRAUS_BITS bits. table must
+ * have room for m*(2**EC_STRAUS_BITS - 1) initialized points.
+ */
+
+static void
+ec_multi_mul(const EC_Curve_Object *c, ec_coords *R, ec_coords *table,
+             ec_coords *const *P, mpz_t *k, Py_ssize_t m)
+{
+    const int size = (1 << EC_STRAUS_BITS) - 1;
+    ec_work w;
+    Py_ssize_t i, win;
+    size_t nbits = 0;
+    int j, d;
+
+    ec_work_init(&w);
+    for (i = 0; i < m; i++) {
+        if (mpz_sizeinbase(k[i], 2) > nbits) {
+            nbits = mpz_sizeinbase(k[i], 2);
+        }
+        /* table[i*size + j] = (j + 1)*P[i] */
+        ec_coords_set(&table[i * size], P[i]);
+        for (j = 1; j < size; j++) {
+            ec_add(&w, c, &table[i * size + j], &table[i * size + j - 1], P[i]);
+        }
+    }
+
+    ec_set_identity(c, R);
+    win = nbits ? (Py_ssize_t)(nbits - 1) / EC_STRAUS_BITS : -1;
+    for (; win >= 0; win--) {
+        for (j = 0; j < EC_STRAUS_BITS; j++) {
+            ec_double(&w, c, R, R);
+        }
+        for (i = 0; i < m; i++) {
+            for (d = 0, j = EC_STRAUS_BITS - 1; j >= 0; j--) {
+                d = 2 * d + mpz_tstbit(k[i], win * EC_STRAUS_BITS + j);
+            }
+            if (d) {
+                ec_add(&w, c, R, R, &table[i * size + d - 1]);
+            }
+        }
+    }
+    ec_work_clear(&w);
+}
+
+/* Scale P to Z = 1 given zi = 1/Z. */
+
+static void
+ec_scale(ec_work *w, const EC_Curve_Object *c, ec_coords *P, mpz_srcptr zi)
+{
+    mpz_srcptr p = c->p;
+
+    if (c->model == EC_WEIERSTRASS) {
+        ec_fsqr(w->t[0], zi, p);
+        ec_fmul(P->X, P->X, w->t[0], p);
+        ec_fmul(w->t[0], w->t[0], zi, p);
+        ec_fmul(P->Y, P->Y, w->t[0], p);
+    }
+    else {
+        ec_fmul(P->X, P->X, zi, p);
+        if (c->model == EC_EDWARDS) {
+            ec_fmul(P->Y, P->Y, zi, p);
+            ec_fmul(P->T, P->X, P->Y, p);
+        }
+    }
+    mpz_set_ui(P->Z, 1);
+}
+
+/* Scale the points to Z = 1 with a single inversion (Montgomery's trick).
+ * The point at infinity is left unchanged. prod must have room for m
+ * initialized values. Returns 0 if the product of the Z coordinates is not
+ * invertible, and then the points are unchanged.
+ */
+
+static int
+ec_normalize(const EC_Curve_Object *c, ec_coords *const *P, mpz_t *prod,
+             Py_ssize_t m)
+{
+    ec_work w;
+    Py_ssize_t i;
+    int result = 1;
+
+    /* prod[i] is the product of the Z coordinates before P[i]. */
+    ec_work_init(&w);
+    mpz_set_ui(w.t[1], 1);
+    for (i = 0; i < m; i++) {
+        mpz_set(prod[i], w.t[1]);
+        if (c->model == EC_EDWARDS || mpz_sgn(P[i]->Z)) {
+            ec_fmul(w.t[1], w.t[1], P[i]->Z, c->p);
+        }
+    }
+    if (!mpz_invert(w.t[1], w.t[1], c->p)) {
+        result = 0;
+    }
+    else {
+        for (i = m - 1; i >= 0; i--) {
+            if (c->model == EC_EDWARDS || mpz_sgn(P[i]->Z)) {
+                ec_fmul(w.t[2], w.t[1], prod[i], c->p);
+                ec_fmul(w.t[1], w.t[1], P[i]->Z, c->p);
+                ec_scale(&w, c, P[i], w.t[2]);
+            }
+        }
+    }
+    ec_work_clear(&w);
+    return result;
+}
+
+/* Arithmetic modulo the n-limb odd modulus m with the mpn_sec functions:
+ * the sequence of instructions and memory accesses does not depend on the
+ * values. tp has 2*n limbs.
+ */
+
+typedef struct {
+    mp_srcptr m;
+    mp_size_t n;
+    mp_ptr tp;
+    mp_ptr scratch;
+} ec_sec_field;
+
+static void
+ec_sec_mul(const ec_sec_field *F, mp_ptr r, mp_srcptr x, mp_srcptr y)
+{
+    mpn_sec_mul(F->tp, x, F->n, y, F->n, F->scratch);
+    mpn_sec_div_r(F->tp, 2 * F->n, F->m, F->n, F->scratch);
+    mpn_copyi(r, F->tp, F->n);
+}
+
+static void
+ec_sec_add(const ec_sec_field *F, mp_ptr r, mp_srcptr x, mp_srcptr y)
+{
+    mp_limb_t cy, bw;
+
+    cy = mpn_add_n(r, x, y, F->n);
+    bw = mpn_sub_n(F->tp, r, F->m, F->n);
+    mpn_cnd_swap(cy | (bw ^ 1), r, F->tp, F->n);
+}
+
+static void
+ec_sec_sub(const ec_sec_field *F, mp_ptr r, mp_srcptr x, mp_srcptr y)
+{
+    mp_limb_t bw;
+
+    bw = mpn_sub_n(r, x, y, F->n);
+    mpn_cnd_add_n(bw, r, r, F->m, F->n);
+}
+
+static void
+ec_sec_get(mp_ptr r, mpz_srcptr x, mp_size_t n)
+{
+    mp_size_t size = (mp_size_t)mpz_size(x);
+
+    if (size) {
+        mpn_copyi(r, mpz_limbs_read(x), size);
+    }
+    mpn_zero(r + size, n - size);
+}
+
+/* R = k*P on a Montgomery curve with the ladder of RFC 7748. x1 is the
+ * affine x-coordinate of P and the ladder runs for nbits steps. Returns -1
+ * if memory could not be allocated.
+ */
+
+static int
+ec_mul_sec(const EC_Curve_Object *c, ec_coords *R, mpz_srcptr x1,
+           mpz_srcptr k, size_t nbits)
+{
+    ec_sec_field F;
+    mp_size_t n = (mp_size_t)mpz_size(c->p), nk, itch, t;
+    mp_ptr mem, x, x2, z2, x3, z3, a24, A, AA, B, BB, E, C, D, kp;
+    mp_limb_t swap = 0, bit;
+    size_t i;
+
+    nk = (mp_size_t)((nbits + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+    itch = mpn_sec_mul_itch(n, n);
+    if ((t = mpn_sec_div_r_itch(2 * n, n)) > itch) {
+        itch = t;
+    }
+    if ((t = mpn_sec_invert_itch(n)) > itch) {
+        itch = t;
+    }
+    if (!(mem = PyMem_RawMalloc((15 * n + nk + itch) * sizeof(mp_limb_t)))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    x = mem; x2 = x + n; z2 = x2 + n; x3 = z2 + n; z3 = x3 + n;
+    a24 = z3 + n; A = a24 + n; AA = A + n; B = AA + n; BB = B + n;
+    E = BB + n; C = E + n; F.tp = C + n; D = F.tp + 2 * n;
+    kp = D + n; F.scratch = kp + nk;
+    F.m = mpz_limbs_read(c->p);
+    F.n = n;
+
+    ec_sec_get(x, x1, n);
+    ec_sec_get(a24, c->a24, n);
+    ec_sec_get(kp, k, nk);
+    mpn_zero(x2, n);
+    x2[0] = 1;
+    mpn_zero(z2, n);
+    mpn_copyi(x3, x, n);
+    mpn_zero(z3, n);
+    z3[0] = 1;
+
+    if (mpn_zero_p(x, n)) {
+        /* P = (0, 0) has order 2 and the ladder degenerates, see ec_mul().
+         * k*P is P for odd k and the identity for even k; (x3 : z3) is
+         * already (0 : 1), so select it without branching on k.
+         */
+        swap = kp[0] & 1;
+    }
+    else {
+        for (i = nbits; i-- > 0; ) {
+            bit = (kp[i / GMP_NUMB_BITS] >> (i % GMP_NUMB_BITS)) & 1;
+            swap ^= bit;
+            mpn_cnd_swap(swap, x2, x3, n);
+            mpn_cnd_swap(swap, z2, z3, n);
+            swap = bit;
+
+            ec_sec_add(&F, A, x2, z2);
+            ec_sec_mul(&F, AA, A, A);
+            ec_sec_sub(&F, B, x2, z2);
+            ec_sec_mul(&F, BB, B, B);
+            ec_sec_sub(&F, E, AA, BB);
+            ec_sec_add(&F, C, x3, z3);
+            ec_sec_sub(&F, D, x3, z3);
+            ec_sec_mul(&F, D, D, A);           /* DA */
+            ec_sec_mul(&F, C, C, B);           /* CB */
+            ec_sec_add(&F, x3, D, C);
+            ec_sec_mul(&F, x3, x3, x3);
+            ec_sec_sub(&F, z3, D, C);
+            ec_sec_mul(&F, z3, z3, z3);
+            ec_sec_mul(&F, z3, z3, x);
+            ec_sec_mul(&F, x2, AA, BB);
+            ec_sec_mul(&F, z2, a24, E);
+            ec_sec_add(&F, z2, z2, BB);
+            ec_sec_mul(&F, z2, z2, E);
+        }
+    }
+    mpn_cnd_swap(swap, x2, x3, n);
+    mpn_cnd_swap(swap, z2, z3, n);
+
+    /* x = x2/z2. If z2 is not invertible, R is left as (x2 : z2). */
+    mpn_copyi(A, z2, n);
+    if (mpn_sec_invert(B, A, F.m, n, 2 * mpz_sizeinbase(c->p, 2), F.scratch)) {
+        ec_sec_mul(&F, x2, x2, B);
+        mpn_zero(z2, n);
+        z2[0] = 1;
+    }
+    mpn_copyi(mpz_limbs_write(R->X, n), x2, n);
+    mpz_limbs_finish(R->X, n);
+    mpn_copyi(mpz_limbs_write(R->Z, n), z2, n);
+    mpz_limbs_finish(R->Z, n);
+
+    mpn_zero(mem, 15 * n + nk);
+    PyMem_RawFree(mem);
+    return 0;
+}
+
+static const char *ec_model_names[] = {"weierstrass", "montgomery", "edwards"};
+
+static EC_Point_Object *
+GMPy_EC_Point_New(EC_Curve_Object *curve)
+{
+    EC_Point_Object *result;
+
+    if (GMPy_Ready_Type(&EC_Point_Type) < 0 ||
+        !(result = PyObject_New(EC_Point_Object, &EC_Point_Type))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    ec_coords_init(&result->P);
+    Py_INCREF((PyObject*)curve);
+    result->curve = curve;
+    return result;
+}
+
+static void
+GMPy_EC_Point_Dealloc(EC_Point_Object *self)
+{
+    ec_coords_clear(&self->P);
+    Py_DECREF((PyObject*)self->curve);
+    PyObject_Free(self);
+}
+
+static void
+GMPy_EC_Curve_Dealloc(EC_Curve_Object *self)
+{
+    mpz_clear(self->p);
+    mpz_clear(self->a);
+    mpz_clear(self->b);
+    mpz_clear(self->a24);
+    PyObject_Free(self);
+}
+
+static int
+ec_same_curve(const EC_Curve_Object *c, const EC_Curve_Object *d)
+{
+    return c == d || (c->model == d->model && !mpz_cmp(c->p, d->p) &&
+                      !mpz_cmp(c->a, d->a) && !mpz_cmp(c->b, d->b));
+}
+
+/* Set r to the integer obj reduced mod p. Returns -1 and raises TypeError
+ * if obj is not an integer.
+ */
+
+static int
+ec_get_residue(mpz_ptr r, PyObject *obj, mpz_srcptr p, const char *msg)
+{
+    MPZ_Object *temp;
+
+    if (!IS_INTEGER(obj) || !(temp = GMPy_MPZ_From_Integer(obj, NULL))) {
+        TYPE_ERROR(msg);
+        return -1;
+    }
+    mpz_fdiv_r(r, temp->z, p);
+    Py_DECREF((PyObject*)temp);
+    return 0;
+}
+
+/* Set x and y to the affine coordinates of P. Returns 0 if the Z
+ * coordinate of P is not invertible mod p.
+ */
+
+static int
+ec_affine(const EC_Curve_Object *c, const ec_coords *P, mpz_ptr x, mpz_ptr y)
+{
+    ec_work w;
+    int result;
+
+    ec_work_init(&w);
+    if ((result = mpz_invert(w.t[1], P->Z, c->p))) {
+        if (c->model == EC_WEIERSTRASS) {
+            ec_fsqr(w.t[2], w.t[1], c->p);
+            ec_fmul(x, P->X, w.t[2], c->p);
+            ec_fmul(w.t[2], w.t[2], w.t[1], c->p);
+            ec_fmul(y, P->Y, w.t[2], c->p);
+        }
+        else {
+            ec_fmul(x, P->X, w.t[1], c->p);
+            ec_fmul(y, P->Y, w.t[1], c->p);
+        }
+    }
+    ec_work_clear(&w);
+    return result;
+}
+
+static PyObject *
+GMPy_EC_Point_Add_Slot(PyObject *x, PyObject *y)
+{
+    EC_Point_Object *P = (EC_Point_Object*)x, *Q = (EC_Point_Object*)y, *result;
+    ec_work w;
+
+    if (!EC_Point_Check(x) || !EC_Point_Check(y)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (!ec_same_curve(P->curve, Q->curve)) {
+        VALUE_ERROR("ec_point addition requires points on the same curve");
+        return NULL;
+    }
+    if (P->curve->model == EC_MONTGOMERY) {
+        VALUE_ERROR("points on a Montgomery curve can only be added with diff_add()");
+        return NULL;
+    }
+    if ((result = GMPy_EC_Point_New(P->curve))) {
+        ec_work_init(&w);
+        ec_add(&w, P->curve, &result->P, &P->P, &Q->P);
+        ec_work_clear(&w);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_EC_Point_Neg_Slot(EC_Point_Object *self)
+{
+    EC_Point_Object *result;
+
+    if ((result = GMPy_EC_Point_New(self->curve))) {
+        ec_neg(self->curve, &result->P, &self->P);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_EC_Point_Sub_Slot(PyObject *x, PyObject *y)
+{
+    PyObject *temp, *result;
+
+    if (!EC_Point_Check(x) || !EC_Point_Check(y)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (!(temp = GMPy_EC_Point_Neg_Slot((EC_Point_Object*)y))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    result = GMPy_EC_Point_Add_Slot(x, temp);
+    Py_DECREF(temp);
+    return result;
+}
+
+static PyObject *
+GMPy_EC_Point_Mul_Slot(PyObject *x, PyObject *y)
+{
+    EC_Point_Object *P, *result;
+    PyObject *other;
+    MPZ_Object *temp;
+    ec_coords B;
+    mpz_t k;
+    CTXT_Object *context = NULL;
+    int rc;
+
+    if (EC_Point_Check(x) && IS_INTEGER(y)) {
+        P = (EC_Point_Object*)x;
+        other = y;
+    }
+    else if (EC_Point_Check(y) && IS_INTEGER(x)) {
+        P = (EC_Point_Object*)y;
+        other = x;
+    }
+    else {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(temp = GMPy_MPZ_From_Integer(other, context))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (!(result = GMPy_EC_Point_New(P->curve))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)temp);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (mpz_sgn(temp->z) == 0 || ec_is_identity(P->curve, &P->P)) {
+        ec_set_identity(P->curve, &result->P);
+        Py_DECREF((PyObject*)temp);
+        return (PyObject*)result;
+    }
+
+    /* k*P = |k|*(-P) for k < 0. */
+    mpz_init(k);
+    mpz_abs(k, temp->z);
+    ec_coords_init(&B);
+    if (mpz_sgn(temp->z) < 0) {
+        ec_neg(P->curve, &B, &P->P);
+    }
+    else {
+        ec_coords_set(&B, &P->P);
+    }
+    Py_DECREF((PyObject*)temp);
+    rc = ec_mul(P->curve, &result->P, &B, k, context);
+    ec_coords_clear(&B);
+    mpz_clear(k);
+    if (rc < 0) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_EC_Point_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    EC_Point_Object *P = (EC_Point_Object*)a, *Q = (EC_Point_Object*)b;
+    const EC_Curve_Object *c = P->curve;
+    ec_work w;
+    int eq;
+
+    if (!EC_Point_Check(a) || !EC_Point_Check(b) || (op != Py_EQ && op != Py_NE)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (!ec_same_curve(P->curve, Q->curve)) {
+        eq = 0;
+    }
+    else if (c->model != EC_EDWARDS &&
+             (!mpz_sgn(P->P.Z) || !mpz_sgn(Q->P.Z))) {
+        eq = !mpz_sgn(P->P.Z) && !mpz_sgn(Q->P.Z);
+    }
+    else {
+        /* Compare the coordinates scaled to a common denominator. */
+        ec_work_init(&w);
+        if (c->model == EC_WEIERSTRASS) {
+            ec_fsqr(w.t[0], P->P.Z, c->p);
+            ec_fsqr(w.t[1], Q->P.Z, c->p);
+            ec_fmul(w.t[2], P->P.X, w.t[1], c->p);
+            ec_fmul(w.t[3], Q->P.X, w.t[0], c->p);
+            ec_fmul(w.t[0], w.t[0], P->P.Z, c->p);
+            ec_fmul(w.t[1], w.t[1], Q->P.Z, c->p);
+            ec_fmul(w.t[4], P->P.Y, w.t[1], c->p);
+            ec_fmul(w.t[5], Q->P.Y, w.t[0], c->p);
+        }
+        else {
+            ec_fmul(w.t[2], P->P.X, Q->P.Z, c->p);
+            ec_fmul(w.t[3], Q->P.X, P->P.Z, c->p);
+            ec_fmul(w.t[4], P->P.Y, Q->P.Z, c->p);
+            ec_fmul(w.t[5], Q->P.Y, P->P.Z, c->p);
+        }
+        eq = !mpz_cmp(w.t[2], w.t[3]) &&
+             (c->model == EC_MONTGOMERY || !mpz_cmp(w.t[4], w.t[5]));
+        ec_work_clear(&w);
+    }
+    return PyBool_FromLong(op == Py_EQ ? eq : !eq);
+}
+
+static PyObject *
+GMPy_EC_Point_Attrib_Get(EC_Point_Object *self, void *closure)
+{
+    const EC_Curve_Object *c = self->curve;
+    MPZ_Object *x = NULL, *y = NULL;
+    PyObject *result = NULL;
+
+    if ((Py_intptr_t)closure == 1 && c->model == EC_MONTGOMERY) {
+        VALUE_ERROR("points on a Montgomery curve only have an x-coordinate");
+        return NULL;
+    }
+    if (ec_is_identity(c, &self->P) && c->model != EC_EDWARDS) {
+        VALUE_ERROR("the point at infinity has no affine coordinates");
+        return NULL;
+    }
+    if (!(x = GMPy_MPZ_New(NULL)) || !(y = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        Py_XDECREF((PyObject*)x);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (!ec_affine(c, &self->P, x->z, y->z)) {
+        ZERO_ERROR("ec_point has a Z coordinate that is not invertible");
+    }
+    else {
+        result = (PyObject*)((Py_intptr_t)closure ? y : x);
+        Py_INCREF(result);
+    }
+    Py_DECREF((PyObject*)x);
+    Py_DECREF((PyObject*)y);
+    return result;
+}
+
+static PyObject *
+GMPy_EC_Point_Get_Coords(EC_Point_Object *self, void *closure)
+{
+    MPZ_Object *X, *Y, *Z, *T;
+
+    X = GMPy_MPZ_New(NULL);
+    Y = GMPy_MPZ_New(NULL);
+    Z = GMPy_MPZ_New(NULL);
+    T = GMPy_MPZ_New(NULL);
+    if (!X || !Y || !Z || !T) {
+        /* LCOV_EXCL_START */
+        Py_XDECREF((PyObject*)X);
+        Py_XDECREF((PyObject*)Y);
+        Py_XDECREF((PyObject*)Z);
+        Py_XDECREF((PyObject*)T);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_set(X->z, self->P.X);
+    mpz_set(Y->z, self->P.Y);
+    mpz_set(Z->z, self->P.Z);
+    mpz_set(T->z, self->P.T);
+    switch (self->curve->model) {
+        case EC_WEIERSTRASS:
+            Py_DECREF((PyObject*)T);
+            return Py_BuildValue("(NNN)", X, Y, Z);
+        case EC_MONTGOMERY:
+            Py_DECREF((PyObject*)Y);
+            Py_DECREF((PyObject*)T);
+            return Py_BuildValue("(NN)", X, Z);
+        default:
+            return Py_BuildValue("(NNNN)", X, Y, Z, T);
+    }
+}
+
+static PyObject *
+GMPy_EC_Point_Get_Curve(EC_Point_Object *self, void *closure)
+{
+    Py_INCREF((PyObject*)self->curve);
+    return (PyObject*)self->curve;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_point_method_double,
+"P.double() -> ec_point\n\n"
+"Return 2*P.");
+
+static PyObject *
+GMPy_EC_Point_Method_Double(PyObject *self, PyObject *other)
+{
+    EC_Point_Object *P = (EC_Point_Object*)self, *result;
+    ec_work w;
+
+    if ((result = GMPy_EC_Point_New(P->curve))) {
+        ec_work_init(&w);
+        ec_double(&w, P->curve, &result->P, &P->P);
+        ec_work_clear(&w);
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_point_method_is_identity,
+"P.is_identity() -> bool\n\n"
+"Return True if P is the neutral element of the group: the point at\n"
+"infinity of a Weierstrass or Montgomery curve, or (0, 1) on an Edwards\n"
+"curve.");
+
+static PyObject *
+GMPy_EC_Point_Method_IsIdentity(PyObject *self, PyObject *other)
+{
+    EC_Point_Object *P = (EC_Point_Object*)self;
+
+    return PyBool_FromLong(ec_is_identity(P->curve, &P->P));
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_point_method_normalize,
+"P.normalize() -> ec_point\n\n"
+"Return P with the Z coordinate scaled to 1. Raises ZeroDivisionError if\n"
+"Z is not invertible modulo the modulus of the curve. To normalize many\n"
+"points, use ec_curve.normalize().");
+
+static PyObject *
+GMPy_EC_Point_Method_Normalize(PyObject *self, PyObject *other)
+{
+    EC_Point_Object *P = (EC_Point_Object*)self, *result;
+    ec_coords *temp;
+    mpz_t prod;
+
+    if (!(result = GMPy_EC_Point_New(P->curve))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    ec_coords_set(&result->P, &P->P);
+    temp = &result->P;
+    mpz_init(prod);
+    if (!ec_normalize(P->curve, &temp, &prod, 1)) {
+        ZERO_ERROR("ec_point has a Z coordinate that is not invertible");
+        Py_DECREF((PyObject*)result);
+        result = NULL;
+    }
+    mpz_clear(prod);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_point_method_diff_add,
+"P.diff_add(Q, D, /) -> ec_point\n\n"
+"Return P + Q on a Montgomery curve, given the difference D = P - Q.\n"
+"Only x-coordinates are known on a Montgomery curve, so this is the only\n"
+"way to add two different points.");
+
+static PyObject *
+GMPy_EC_Point_Method_DiffAdd(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    EC_Point_Object *P = (EC_Point_Object*)self, *Q, *D, *result;
+    ec_work w;
+
+    if (nargs != 2 || !EC_Point_Check(args[0]) || !EC_Point_Check(args[1])) {
+        TYPE_ERROR("diff_add() requires 2 ec_point arguments");
+        return NULL;
+    }
+    Q = (EC_Point_Object*)args[0];
+    D = (EC_Point_Object*)args[1];
+    if (P->curve->model != EC_MONTGOMERY) {
+        VALUE_ERROR("diff_add() requires points on a Montgomery curve");
+        return NULL;
+    }
+    if (!ec_same_curve(P->curve, Q->curve) || !ec_same_curve(P->curve, D->curve)) {
+        VALUE_ERROR("diff_add() requires points on the same curve");
+        return NULL;
+    }
+    if ((result = GMPy_EC_Point_New(P->curve))) {
+        ec_work_init(&w);
+        ec_xadd(&w, P->curve, &result->P, &P->P, &Q->P, &D->P);
+        ec_work_clear(&w);
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_point_method_mul_sec,
+"P.mul_sec(k, /) -> ec_point\n\n"
+"Return k*P on a Montgomery curve using a Montgomery ladder that is\n"
+"resistant to timing attacks: the sequence of operations and memory\n"
+"accesses only depends on the sizes of k and the modulus, not on their\n"
+"values. The ladder always runs for max(k.bit_length(),\n"
+"p.bit_length()) steps. This is the computation used by X25519 and X448\n"
+"(RFC 7748). The x-coordinate of P is not protected.");
+
+static PyObject *
+GMPy_EC_Point_Method_MulSec(PyObject *self, PyObject *other)
+{
+    EC_Point_Object *P = (EC_Point_Object*)self, *result;
+    const EC_Curve_Object *c = P->curve;
+    MPZ_Object *temp;
+    mpz_t k, x1;
+    size_t nbits;
+    CTXT_Object *context = NULL;
+    int rc;
+
+    if (c->model != EC_MONTGOMERY) {
+        VALUE_ERROR("mul_sec() requires a point on a Montgomery curve");
+        return NULL;
+    }
+    if (!IS_INTEGER(other) || !(temp = GMPy_MPZ_From_Integer(other, NULL))) {
+        TYPE_ERROR("mul_sec() requires an integer argument");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    mpz_init(k);
+    mpz_abs(k, temp->z);
+    Py_DECREF((PyObject*)temp);
+    mpz_init(x1);
+    if (!ec_is_identity(c, &P->P) && !mpz_invert(x1, P->P.Z, c->p)) {
+        ZERO_ERROR("ec_point has a Z coordinate that is not invertible");
+        mpz_clear(k);
+        mpz_clear(x1);
+        return NULL;
+    }
+    if (!(result = GMPy_EC_Point_New(P->curve))) {
+        /* LCOV_EXCL_START */
+        mpz_clear(k);
+        mpz_clear(x1);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (ec_is_identity(c, &P->P)) {
+        ec_set_identity(c, &result->P);
+        mpz_clear(k);
+        mpz_clear(x1);
+        return (PyObject*)result;
+    }
+    ec_fmul(x1, x1, P->P.X, c->p);
+    nbits = mpz_sizeinbase(c->p, 2);
+    if (mpz_sizeinbase(k, 2) > nbits) {
+        nbits = mpz_sizeinbase(k, 2);
+    }
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    rc = ec_mul_sec(c, &result->P, x1, k, nbits);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    mpz_clear(k);
+    mpz_clear(x1);
+    if (rc < 0) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)result);
+        return PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_EC_Point_Repr_Slot(EC_Point_Object *self)
+{
+    const EC_Curve_Object *c = self->curve;
+    MPZ_Object *x, *y;
+    PyObject *result = NULL;
+
+    if (ec_is_identity(c, &self->P) && c->model != EC_EDWARDS) {
+        return PyUnicode_FromString("ec_point(infinity)");
+    }
+    if (!(x = GMPy_MPZ_New(NULL)) || !(y = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        Py_XDECREF((PyObject*)x);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (ec_affine(c, &self->P, x->z, y->z)) {
+        if (c->model == EC_MONTGOMERY) {
+            result = PyUnicode_FromFormat("ec_point(%S)", x);
+        }
+        else {
+            result = PyUnicode_FromFormat("ec_point(%S, %S)", x, y);
+        }
+    }
+    else {
+        /* Show the projective coordinates if Z is not invertible. */
+        PyObject *coords = GMPy_EC_Point_Get_Coords(self, NULL);
+
+        if (coords) {
+            result = PyUnicode_FromFormat("ec_point%S", coords);
+            Py_DECREF(coords);
+        }
+    }
+    Py_DECREF((PyObject*)x);
+    Py_DECREF((PyObject*)y);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_point,
+"Point on an ec_curve. Points are created with ec_curve.point() and\n"
+"ec_curve.identity(), and are stored in projective coordinates.\n\n"
+"P + Q, P - Q, -P and k*P follow the group law of the curve. On a\n"
+"Montgomery curve only the x-coordinate is known, so -P is P, and P + Q\n"
+"must be computed with P.diff_add(Q, P - Q). P == Q compares the points\n"
+"and not their coordinates.");
+
+static PyNumberMethods GMPy_EC_Point_number_methods = {
+    .nb_add = (binaryfunc) GMPy_EC_Point_Add_Slot,
+    .nb_subtract = (binaryfunc) GMPy_EC_Point_Sub_Slot,
+    .nb_multiply = (binaryfunc) GMPy_EC_Point_Mul_Slot,
+    .nb_negative = (unaryfunc) GMPy_EC_Point_Neg_Slot,
+};
+
+static PyGetSetDef GMPy_EC_Point_getseters[] = {
+    { "x", (getter)GMPy_EC_Point_Attrib_Get, NULL,
+        "the affine x-coordinate", (void*)0 },
+    { "y", (getter)GMPy_EC_Point_Attrib_Get, NULL,
+        "the affine y-coordinate", (void*)1 },
+    { "coords", (getter)GMPy_EC_Point_Get_Coords, NULL,
+        "the projective coordinates", NULL },
+    { "curve", (getter)GMPy_EC_Point_Get_Curve, NULL,
+        "the curve of the point", NULL },
+    {NULL}
+};
+
+static PyMethodDef GMPy_EC_Point_methods[] = {
+    { "diff_add", (PyCFunction)GMPy_EC_Point_Method_DiffAdd, METH_FASTCALL, GMPy_doc_ec_point_method_diff_add },
+    { "double", GMPy_EC_Point_Method_Double, METH_NOARGS, GMPy_doc_ec_point_method_double },
+    { "is_identity", GMPy_EC_Point_Method_IsIdentity, METH_NOARGS, GMPy_doc_ec_point_method_is_identity },
+    { "mul_sec", GMPy_EC_Point_Method_MulSec, METH_O, GMPy_doc_ec_point_method_mul_sec },
+    { "normalize", GMPy_EC_Point_Method_Normalize, METH_NOARGS, GMPy_doc_ec_point_method_normalize },
+    { NULL }
+};
+
+static PyTypeObject EC_Point_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.ec_point",
+    .tp_basicsize = sizeof(EC_Point_Object),
+    .tp_dealloc = (destructor) GMPy_EC_Point_Dealloc,
+    .tp_repr = (reprfunc) GMPy_EC_Point_Repr_Slot,
+    .tp_as_number = &GMPy_EC_Point_number_methods,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_ec_point,
+    .tp_richcompare = (richcmpfunc) GMPy_EC_Point_RichCompare_Slot,
+    .tp_methods = GMPy_EC_Point_methods,
+    .tp_getset = GMPy_EC_Point_getseters,
+};
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_method_point,
+"E.point(x, y=None, /) -> ec_point\n\n"
+"Return the point (x, y) of the curve. Raises ValueError if the point is\n"
+"not on the curve. On a Montgomery curve y may be omitted.");
+
+static PyObject *
+GMPy_EC_Curve_Method_Point(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    EC_Curve_Object *c = (EC_Curve_Object*)self;
+    EC_Point_Object *result;
+    ec_work w;
+    int ok = 1;
+
+    if (nargs < 1 || nargs > 2 ||
+        (c->model != EC_MONTGOMERY && (nargs == 1 || args[1] == Py_None))) {
+        TYPE_ERROR("point() requires 2 integer arguments");
+        return NULL;
+    }
+    if (!(result = GMPy_EC_Point_New(c))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (ec_get_residue(result->P.X, args[0], c->p, "point() requires integer arguments") < 0 ||
+        (nargs == 2 && args[1] != Py_None &&
+         ec_get_residue(result->P.Y, args[1], c->p, "point() requires integer arguments") < 0)) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    mpz_set_ui(result->P.Z, 1);
+
+    ec_work_init(&w);
+    if (c->model == EC_WEIERSTRASS) {
+        /* y**2 == x**3 + a*x + b */
+        ec_fsqr(w.t[0], result->P.X, c->p);
+        ec_fadd(w.t[0], w.t[0], c->a, c->p);
+        ec_fmul(w.t[0], w.t[0], result->P.X, c->p);
+        ec_fadd(w.t[0], w.t[0], c->b, c->p);
+        ec_fsqr(w.t[1], result->P.Y, c->p);
+        ok = !mpz_cmp(w.t[0], w.t[1]);
+    }
+    else if (c->model == EC_MONTGOMERY) {
+        /* b*y**2 == x**3 + a*x**2 + x */
+        if (nargs == 2 && args[1] != Py_None) {
+            ec_fadd(w.t[0], result->P.X, c->a, c->p);
+            ec_fmul(w.t[0], w.t[0], result->P.X, c->p);
+            mpz_add_ui(w.t[0], w.t[0], 1);
+            ec_fmul(w.t[0], w.t[0], result->P.X, c->p);
+            ec_fsqr(w.t[1], result->P.Y, c->p);
+            ec_fmul(w.t[1], w.t[1], c->b, c->p);
+            ok = !mpz_cmp(w.t[0], w.t[1]);
+        }
+        mpz_set_ui(result->P.Y, 0);
+    }
+    else {
+        /* a*x**2 + y**2 == 1 + d*x**2*y**2 */
+        ec_fsqr(w.t[0], result->P.X, c->p);
+        ec_fsqr(w.t[1], result->P.Y, c->p);
+        ec_fmul(w.t[2], w.t[0], w.t[1], c->p);
+        ec_fmul(w.t[2], w.t[2], c->b, c->p);
+        mpz_add_ui(w.t[2], w.t[2], 1);
+        mpz_tdiv_r(w.t[2], w.t[2], c->p);
+        ec_fmul(w.t[0], w.t[0], c->a, c->p);
+        ec_fadd(w.t[0], w.t[0], w.t[1], c->p);
+        ok = !mpz_cmp(w.t[0], w.t[2]);
+        ec_fmul(result->P.T, result->P.X, result->P.Y, c->p);
+    }
+    ec_work_clear(&w);
+    if (!ok) {
+        VALUE_ERROR("point is not on the curve");
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_method_identity,
+"E.identity() -> ec_point\n\n"
+"Return the neutral element of the group of points of the curve.");
+
+static PyObject *
+GMPy_EC_Curve_Method_Identity(PyObject *self, PyObject *other)
+{
+    EC_Point_Object *result;
+
+    if ((result = GMPy_EC_Point_New((EC_Curve_Object*)self))) {
+        ec_set_identity((EC_Curve_Object*)self, &result->P);
+    }
+    return (PyObject*)result;
+}
+
+/* Return a new reference to a sequence of the points of c in points, or
+ * NULL with an exception set.
+ */
+
+static PyObject *
+ec_point_sequence(EC_Curve_Object *c, PyObject *points, const char *name)
+{
+    PyObject *seq;
+    Py_ssize_t i;
+
+    if (!(seq = PySequence_Fast(points, ""))) {
+        PyErr_Format(PyExc_TypeError, "%s() requires a sequence of ec_point", name);
+        return NULL;
+    }
+    for (i = 0; i < PySequence_Fast_GET_SIZE(seq); i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+
+        if (!EC_Point_Check(item)) {
+            PyErr_Format(PyExc_TypeError, "%s() requires a sequence of ec_point", name);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        if (!ec_same_curve(c, ((EC_Point_Object*)item)->curve)) {
+            PyErr_Format(PyExc_ValueError, "%s() requires points on the curve", name);
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    return seq;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_method_multi_mul,
+"E.multi_mul(points, scalars, /) -> ec_point\n\n"
+"Return the sum of k*P for the points P and the integers k, computed with\n"
+"shared doublings (Straus' method). Not available for Montgomery curves.");
+
+static PyObject *
+GMPy_EC_Curve_Method_MultiMul(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    EC_Curve_Object *c = (EC_Curve_Object*)self;
+    EC_Point_Object *result = NULL;
+    PyObject *pseq = NULL, *kseq = NULL;
+    ec_coords *base = NULL, *table = NULL, **P = NULL;
+    mpz_t *k = NULL;
+    Py_ssize_t i, m = 0, size = (1 << EC_STRAUS_BITS) - 1;
+    CTXT_Object *context = NULL;
+
+    if (nargs != 2) {
+        TYPE_ERROR("multi_mul() requires 2 arguments");
+        return NULL;
+    }
+    if (c->model == EC_MONTGOMERY) {
+        VALUE_ERROR("multi_mul() is not available for Montgomery curves");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(pseq = ec_point_sequence(c, args[0], "multi_mul")) ||
+        !(kseq = PySequence_Fast(args[1], "multi_mul() requires a sequence of integers"))) {
+        Py_XDECREF(pseq);
+        return NULL;
+    }
+    m = PySequence_Fast_GET_SIZE(pseq);
+    if (PySequence_Fast_GET_SIZE(kseq) != m) {
+        VALUE_ERROR("multi_mul() requires sequences of the same length");
+        goto done;
+    }
+    base = PyMem_New(ec_coords, m);
+    table = PyMem_New(ec_coords, m * size);
+    P = PyMem_New(ec_coords*, m);
+    k = PyMem_New(mpz_t, m);
+    if (!base || !table || !P || !k) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(base);
+        PyMem_Free(table);
+        PyMem_Free(P);
+        PyMem_Free(k);
+        Py_DECREF(pseq);
+        Py_DECREF(kseq);
+        return PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < m; i++) {
+        ec_coords_init(&base[i]);
+        mpz_init(k[i]);
+        P[i] = &base[i];
+    }
+    for (i = 0; i < m * size; i++) {
+        ec_coords_init(&table[i]);
+    }
+
+    /* k*P = |k|*(-P) for k < 0. */
+    for (i = 0; i < m; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(kseq, i);
+        MPZ_Object *temp;
+
+        if (!IS_INTEGER(item) || !(temp = GMPy_MPZ_From_Integer(item, NULL))) {
+            TYPE_ERROR("multi_mul() requires a sequence of integers");
+            goto done;
+        }
+        if (mpz_sgn(temp->z) < 0) {
+            ec_neg(c, &base[i], &((EC_Point_Object*)PySequence_Fast_GET_ITEM(pseq, i))->P);
+        }
+        else {
+            ec_coords_set(&base[i], &((EC_Point_Object*)PySequence_Fast_GET_ITEM(pseq, i))->P);
+        }
+        mpz_abs(k[i], temp->z);
+        Py_DECREF((PyObject*)temp);
+    }
+
+    if ((result = GMPy_EC_Point_New(c))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        ec_multi_mul(c, &result->P, table, P, k, m);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+    }
+
+  done:
+    if (base) {
+        for (i = 0; i < m; i++) {
+            ec_coords_clear(&base[i]);
+            mpz_clear(k[i]);
+        }
+        for (i = 0; i < m * size; i++) {
+            ec_coords_clear(&table[i]);
+        }
+        PyMem_Free(base);
+        PyMem_Free(table);
+        PyMem_Free(P);
+        PyMem_Free(k);
+    }
+    Py_DECREF(pseq);
+    Py_DECREF(kseq);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve_method_normalize,
+"E.normalize(points, /) -> list\n\n"
+"Return a list of the points with their Z coordinates scaled to 1, using\n"
+"a single modular inversion for all the points. Raises ZeroDivisionError\n"
+"if the product of the Z coordinates is not invertible modulo the\n"
+"modulus of the curve.");
+
+static PyObject *
+GMPy_EC_Curve_Method_Normalize(PyObject *self, PyObject *other)
+{
+    EC_Curve_Object *c = (EC_Curve_Object*)self;
+    PyObject *seq, *result;
+    ec_coords **P;
+    mpz_t *prod;
+    Py_ssize_t i, m;
+    CTXT_Object *context = NULL;
+    int ok;
+
+    CHECK_CONTEXT(context);
+
+    if (!(seq = ec_point_sequence(c, other, "normalize"))) {
+        return NULL;
+    }
+    m = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyList_New(m))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    P = PyMem_New(ec_coords*, m);
+    prod = PyMem_New(mpz_t, m);
+    if (!P || !prod) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(P);
+        PyMem_Free(prod);
+        Py_DECREF(seq);
+        Py_DECREF(result);
+        return PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < m; i++) {
+        EC_Point_Object *temp;
+
+        if (!(temp = GMPy_EC_Point_New(c))) {
+            /* LCOV_EXCL_START */
+            PyMem_Free(P);
+            PyMem_Free(prod);
+            Py_DECREF(seq);
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        ec_coords_set(&temp->P, &((EC_Point_Object*)PySequence_Fast_GET_ITEM(seq, i))->P);
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+        P[i] = &temp->P;
+        mpz_init(prod[i]);
+    }
+    Py_DECREF(seq);
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    ok = ec_normalize(c, P, prod, m);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+    for (i = 0; i < m; i++) {
+        mpz_clear(prod[i]);
+    }
+    PyMem_Free(P);
+    PyMem_Free(prod);
+    if (!ok) {
+        ZERO_ERROR("normalize() found a Z coordinate that is not invertible");
+        Py_DECREF(result);
+        return NULL;
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_EC_Curve_Attrib_Get(EC_Curve_Object *self, void *closure)
+{
+    MPZ_Object *result;
+    mpz_srcptr src;
+
+    switch ((Py_intptr_t)closure) {
+        case 0: src = self->a; break;
+        case 1: src = self->b; break;
+        case 2: src = self->p; break;
+        default: return PyUnicode_FromString(ec_model_names[self->model]);
+    }
+    if ((result = GMPy_MPZ_New(NULL))) {
+        mpz_set(result->z, src);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_EC_Curve_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    int eq;
+
+    if (!EC_Curve_Check(a) || !EC_Curve_Check(b) || (op != Py_EQ && op != Py_NE)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    eq = ec_same_curve((EC_Curve_Object*)a, (EC_Curve_Object*)b);
+    return PyBool_FromLong(op == Py_EQ ? eq : !eq);
+}
+
+static PyObject *
+GMPy_EC_Curve_Repr_Slot(EC_Curve_Object *self)
+{
+    PyObject *a, *b = NULL, *p = NULL, *result = NULL;
+
+    if ((a = GMPy_EC_Curve_Attrib_Get(self, (void*)0)) &&
+        (b = GMPy_EC_Curve_Attrib_Get(self, (void*)1)) &&
+        (p = GMPy_EC_Curve_Attrib_Get(self, (void*)2))) {
+        result = PyUnicode_FromFormat("ec_curve(%S, %S, %S, model='%s')",
+                                      a, b, p, ec_model_names[self->model]);
+    }
+    Py_XDECREF(a);
+    Py_XDECREF(b);
+    Py_XDECREF(p);
+    return result;
+}
+
+static PyObject *
+GMPy_EC_Curve_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    EC_Curve_Object *result;
+    PyObject *x, *y, *z;
+    MPZ_Object *p;
+    const char *model = "weierstrass";
+    mpz_t t, u;
+    int i, ok;
+    static char *kwlist[] = {"", "", "", "model", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OOO|s", kwlist, &x, &y, &z, &model)) {
+        return NULL;
+    }
+    if (!IS_INTEGER(x) || !IS_INTEGER(y) || !IS_INTEGER(z)) {
+        TYPE_ERROR("ec_curve() requires integer arguments");
+        return NULL;
+    }
+    for (i = 0; i < 3 && strcmp(model, ec_model_names[i]); i++);
+    if (i == 3) {
+        VALUE_ERROR("ec_curve() model must be 'weierstrass', 'montgomery', or 'edwards'");
+        return NULL;
+    }
+    if (!(p = GMPy_MPZ_From_Integer(z, NULL))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (mpz_cmp_ui(p->z, 3) <= 0 || mpz_even_p(p->z)) {
+        VALUE_ERROR("ec_curve() requires an odd modulus p > 3");
+        Py_DECREF((PyObject*)p);
+        return NULL;
+    }
+    if (GMPy_Ready_Type(&EC_Curve_Type) < 0 ||
+        !(result = PyObject_New(EC_Curve_Object, &EC_Curve_Type))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)p);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    result->model = i;
+    mpz_init_set(result->p, p->z);
+    mpz_init(result->a);
+    mpz_init(result->b);
+    mpz_init(result->a24);
+    Py_DECREF((PyObject*)p);
+    if (ec_get_residue(result->a, x, result->p, "ec_curve() requires integer arguments") < 0 ||
+        ec_get_residue(result->b, y, result->p, "ec_curve() requires integer arguments") < 0) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)result);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    /* Check that the curve is not singular. */
+    mpz_init(t);
+    mpz_init(u);
+    if (result->model == EC_WEIERSTRASS) {
+        /* 4*a**3 + 27*b**2 != 0 */
+        mpz_pow_ui(t, result->a, 3);
+        mpz_mul_ui(t, t, 4);
+        mpz_mul(u, result->b, result->b);
+        mpz_addmul_ui(t, u, 27);
+    }
+    else if (result->model == EC_MONTGOMERY) {
+        /* b*(a**2 - 4) != 0 */
+        mpz_mul(t, result->a, result->a);
+        mpz_sub_ui(t, t, 4);
+        mpz_mul(t, t, result->b);
+        /* a24 = (a + 2)/4 */
+        mpz_add_ui(result->a24, result->a, 2);
+        mpz_set_ui(u, 4);
+        mpz_invert(u, u, result->p);
+        ec_fmul(result->a24, result->a24, u, result->p);
+    }
+    else {
+        /* a*d*(a - d) != 0 */
+        mpz_sub(t, result->a, result->b);
+        mpz_mul(t, t, result->a);
+        mpz_mul(t, t, result->b);
+    }
+    ok = !mpz_divisible_p(t, result->p);
+    mpz_clear(t);
+    mpz_clear(u);
+    if (!ok) {
+        VALUE_ERROR("ec_curve() requires a non-singular curve");
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_ec_curve,
+"ec_curve(a, b, p, /, model='weierstrass')\n\n"
+"Return the elliptic curve over Z/pZ given by\n\n"
+"    'weierstrass':  y**2 = x**3 + a*x + b\n"
+"    'montgomery':   b*y**2 = x**3 + a*x**2 + x\n"
+"    'edwards':      a*x**2 + y**2 = 1 + b*x**2*y**2\n\n"
+"where p is odd and greater than 3. p does not have to be a prime: on a\n"
+"curve modulo a composite number, a point that cannot be normalized has a\n"
+"Z coordinate that shares a factor with p, as used in the elliptic curve\n"
+"method of factorization.");
+
+static PyGetSetDef GMPy_EC_Curve_getseters[] = {
+    { "a", (getter)GMPy_EC_Curve_Attrib_Get, NULL,
+        "the coefficient a", (void*)0 },
+    { "b", (getter)GMPy_EC_Curve_Attrib_Get, NULL,
+        "the coefficient b", (void*)1 },
+    { "modulus", (getter)GMPy_EC_Curve_Attrib_Get, NULL,
+        "the modulus p", (void*)2 },
+    { "model", (getter)GMPy_EC_Curve_Attrib_Get, NULL,
+        "the form of the curve equation", (void*)3 },
+    {NULL}
+};
+
+static PyMethodDef GMPy_EC_Curve_methods[] = {
+    { "identity", GMPy_EC_Curve_Method_Identity, METH_NOARGS, GMPy_doc_ec_curve_method_identity },
+    { "multi_mul", (PyCFunction)GMPy_EC_Curve_Method_MultiMul, METH_FASTCALL, GMPy_doc_ec_curve_method_multi_mul },
+    { "normalize", GMPy_EC_Curve_Method_Normalize, METH_O, GMPy_doc_ec_curve_method_normalize },
+    { "point", (PyCFunction)GMPy_EC_Curve_Method_Point, METH_FASTCALL, GMPy_doc_ec_curve_method_point },
+    { NULL }
+};
+
+static PyTypeObject EC_Curve_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.ec_curve",
+    .tp_basicsize = sizeof(EC_Curve_Object),
+    .tp_dealloc = (destructor) GMPy_EC_Curve_Dealloc,
+    .tp_repr = (reprfunc) GMPy_EC_Curve_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_ec_curve,
+    .tp_richcompare = (richcmpfunc) GMPy_EC_Curve_RichCompare_Slot,
+    .tp_methods = GMPy_EC_Curve_methods,
+    .tp_getset = GMPy_EC_Curve_getseters,
+    .tp_new = GMPy_EC_Curve_NewInit,
+};
@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_ec.h                                                              *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_EC_H
+#define GMPY_EC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EC_WEIERSTRASS 0   /* y**2 = x**3 + a*x + b */
+#define EC_MONTGOMERY  1   /* b*y**2 = x**3 + a*x**2 + x */
+#define EC_EDWARDS     2   /* a*x**2 + y**2 = 1 + b*x**2*y**2 */
+
+typedef struct {
+    PyObject_HEAD
+    int model;
+    mpz_t p;               /* the modulus */
+    mpz_t a, b;            /* the coefficients, reduced mod p */
+    mpz_t a24;             /* (a + 2)/4 mod p for Montgomery curves */
+} EC_Curve_Object;
+
+/* Projective coordinates of a point. Weierstrass curves use Jacobian
+ * coordinates (X : Y : Z) for (X/Z**2, Y/Z**3), Montgomery curves use
+ * (X : Z) for x = X/Z, and twisted Edwards curves use extended coordinates
+ * (X : Y : Z : T) for (X/Z, Y/Z) with T = X*Y/Z.
+ */
+
+typedef struct {
+    mpz_t X, Y, Z, T;
+} ec_coords;
+
+typedef struct {
+    PyObject_HEAD
+    EC_Curve_Object *curve;
+    ec_coords P;
+} EC_Point_Object;
+
+static PyTypeObject EC_Curve_Type;
+static PyTypeObject EC_Point_Type;
+#define EC_Curve_Check(v) (((PyObject*)v)->ob_type == &EC_Curve_Type)
+#define EC_Point_Check(v) (((PyObject*)v)->ob_type == &EC_Point_Type)
+
+static PyObject * GMPy_EC_Curve_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static void GMPy_EC_Curve_Dealloc(EC_Curve_Object *self);
+static void GMPy_EC_Point_Dealloc(EC_Point_Object *self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,1143 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_lattice.c                                                         *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Lattice basis reduction and integer relations.
+ *
+ * lll() is the integral LLL algorithm of de Weger (Cohen, Algorithm 2.6.7).
+ * Instead of the rational Gram-Schmidt coefficients mu[k][j] and squared
+ * norms B[i], it keeps the integers d[i], the Gram determinant of the
+ * first i vectors, and lam[k][j] = d[j + 1]*mu[k][j]. Every division is
+ * exact, so the result does not depend on rounding. Size reduction of a
+ * vector first derives all the multipliers from lam and then updates the
+ * vector in one pass. For long vectors that pass, and the inner products
+ * of a new vector with the previous ones, are split by columns between
+ * context.threads threads. The GIL is released and pending signals are
+ * checked every LLL_CHECK iterations.
+ *
+ * bkz() is the block Korkine-Zolotarev reduction of Schnorr and Euchner.
+ * The shortest vector of each projected block is found by enumeration
+ * with double precision Gram-Schmidt data, scaled relative to the first
+ * vector of the block, that are derived from the exact lam and d. A
+ * shorter vector is inserted with unimodular row operations, so the basis
+ * never becomes linearly dependent, and the prefix is then LLL-reduced.
+ *
+ * pslq() is the PSLQ algorithm of Ferguson and Bailey in mpfr arithmetic at
+ * the precision of the context.
+ */
+
+#define LLL_CHECK          64     /* iterations between checks for signals */
+#define LLL_PARALLEL_LIMBS 4096   /* smallest row for the worker threads */
+
+#define LLL_TASK_DOT    0
+#define LLL_TASK_UPDATE 1
+
+typedef struct lll_state lll_state;
+
+typedef struct {
+    lll_state *L;
+    int id;
+    PyThread_type_lock start;
+    PyThread_type_lock done;
+} lll_worker;
+
+struct lll_state {
+    Py_ssize_t n, m;     /* the number and the length of the vectors */
+    mpz_t *b;            /* b[i*m + c] is column c of vector i */
+    mpz_t *lam;          /* lam[k*n + j] for j < k */
+    mpz_t *d;            /* d[0] = 1, d[i + 1] for the vectors 0..i */
+    mpz_t *q;            /* size-reduction multipliers */
+    mpz_t *g;            /* inner products of vector k with vectors 0..k */
+    mpz_t t, u, v;
+    mpz_t dnum, dden;    /* delta = dnum/dden */
+    Py_ssize_t k, qlo, qhi;
+    int task, stop, nthreads;
+    lll_worker workers[GMPY_MAX_THREADS];
+};
+
+#define LLL_B(L, i, c) ((L)->b[(i) * (L)->m + (c)])
+#define LLL_LAM(L, k, j) ((L)->lam[(k) * (L)->n + (j)])
+#define LLL_D(L, i) ((L)->d[(i) + 1])
+
+/* Run the share of the current task of thread id. */
+
+static void
+lll_task(lll_state *L, int id)
+{
+    Py_ssize_t j, c, l, lo, hi;
+
+    if (L->task == LLL_TASK_DOT) {
+        for (j = id; j <= L->k; j += L->nthreads) {
+            mpz_set_ui(L->g[j], 0);
+            for (c = 0; c < L->m; c++) {
+                mpz_addmul(L->g[j], LLL_B(L, L->k, c), LLL_B(L, j, c));
+            }
+        }
+    }
+    else {
+        lo = L->m * id / L->nthreads;
+        hi = L->m * (id + 1) / L->nthreads;
+        for (l = L->qlo; l < L->qhi; l++) {
+            if (mpz_sgn(L->q[l])) {
+                for (c = lo; c < hi; c++) {
+                    mpz_submul(LLL_B(L, L->k, c), L->q[l], LLL_B(L, l, c));
+                }
+            }
+        }
+    }
+}
+
+static void
+lll_worker_main(void *arg)
+{
+    lll_worker *w = (lll_worker*)arg;
+
+    for (;;) {
+        PyThread_acquire_lock(w->start, WAIT_LOCK);
+        if (w->L->stop) {
+            PyThread_release_lock(w->done);
+            return;
+        }
+        lll_task(w->L, w->id);
+        PyThread_release_lock(w->done);
+    }
+}
+
+static void
+lll_run_task(lll_state *L, int task)
+{
+    int t;
+
+    L->task = task;
+    for (t = 1; t < L->nthreads; t++) {
+        PyThread_release_lock(L->workers[t].start);
+    }
+    lll_task(L, 0);
+    for (t = 1; t < L->nthreads; t++) {
+        PyThread_acquire_lock(L->workers[t].done, WAIT_LOCK);
+    }
+}
+
+/* Start up to nthreads - 1 workers if the vectors are long enough to
+ * benefit from them.
+ */
+
+static void
+lll_pool_start(lll_state *L, int nthreads)
+{
+    size_t limbs = 0;
+    Py_ssize_t i;
+    int t;
+    lll_worker *w;
+
+    L->nthreads = 1;
+    L->stop = 0;
+    for (i = 0; i < L->n * L->m; i++) {
+        limbs += mpz_size(L->b[i]);
+    }
+    if (L->n == 0 || limbs / (size_t)L->n < LLL_PARALLEL_LIMBS) {
+        return;
+    }
+    for (t = 1; t < nthreads; t++) {
+        w = &L->workers[t];
+        w->L = L;
+        w->id = t;
+        if (!(w->start = PyThread_allocate_lock())) {
+            break;
+        }
+        if (!(w->done = PyThread_allocate_lock())) {
+            PyThread_free_lock(w->start);
+            break;
+        }
+        PyThread_acquire_lock(w->start, WAIT_LOCK);
+        PyThread_acquire_lock(w->done, WAIT_LOCK);
+        if (PyThread_start_new_thread(lll_worker_main, w) == PYTHREAD_INVALID_THREAD_ID) {
+            PyThread_free_lock(w->start);
+            PyThread_free_lock(w->done);
+            break;
+        }
+        L->nthreads = t + 1;
+    }
+}
+
+static void
+lll_pool_stop(lll_state *L)
+{
+    int t;
+
+    L->stop = 1;
+    for (t = 1; t < L->nthreads; t++) {
+        PyThread_release_lock(L->workers[t].start);
+    }
+    for (t = 1; t < L->nthreads; t++) {
+        PyThread_acquire_lock(L->workers[t].done, WAIT_LOCK);
+        PyThread_free_lock(L->workers[t].start);
+        PyThread_free_lock(L->workers[t].done);
+    }
+    L->nthreads = 1;
+}
+
+/* Size-reduce vector k against the vectors hi - 1 down to lo. */
+
+static void
+lll_size_reduce(lll_state *L, Py_ssize_t k, Py_ssize_t lo, Py_ssize_t hi)
+{
+    Py_ssize_t l, i;
+    int any = 0;
+
+    for (l = hi - 1; l >= lo; l--) {
+        mpz_set_ui(L->q[l], 0);
+        mpz_mul_2exp(L->t, LLL_LAM(L, k, l), 1);
+        if (mpz_cmpabs(L->t, LLL_D(L, l)) <= 0) {
+            continue;
+        }
+        /* q = round(lam[k][l]/d[l + 1]) */
+        mpz_add(L->t, L->t, LLL_D(L, l));
+        mpz_mul_2exp(L->u, LLL_D(L, l), 1);
+        mpz_fdiv_q(L->q[l], L->t, L->u);
+        mpz_submul(LLL_LAM(L, k, l), L->q[l], LLL_D(L, l));
+        for (i = 0; i < l; i++) {
+            mpz_submul(LLL_LAM(L, k, i), L->q[l], LLL_LAM(L, l, i));
+        }
+        any = 1;
+    }
+    if (any) {
+        L->k = k;
+        L->qlo = lo;
+        L->qhi = hi;
+        lll_run_task(L, LLL_TASK_UPDATE);
+    }
+}
+
+/* Exchange the vectors k - 1 and k and update lam and d. */
+
+static void
+lll_swap(lll_state *L, Py_ssize_t k, Py_ssize_t kmax)
+{
+    Py_ssize_t c, i;
+    mpz_ptr lam = LLL_LAM(L, k, k - 1);
+
+    for (c = 0; c < L->m; c++) {
+        mpz_swap(LLL_B(L, k, c), LLL_B(L, k - 1, c));
+    }
+    for (i = 0; i < k - 1; i++) {
+        mpz_swap(LLL_LAM(L, k, i), LLL_LAM(L, k - 1, i));
+    }
+    /* v = (d[k - 1]*d[k + 1] + lam**2)/d[k] is the new d[k]. */
+    mpz_mul(L->v, LLL_D(L, k - 2), LLL_D(L, k));
+    mpz_addmul(L->v, lam, lam);
+    mpz_divexact(L->v, L->v, LLL_D(L, k - 1));
+    for (i = k + 1; i <= kmax; i++) {
+        mpz_set(L->t, LLL_LAM(L, i, k));
+        mpz_mul(LLL_LAM(L, i, k), LLL_D(L, k), LLL_LAM(L, i, k - 1));
+        mpz_submul(LLL_LAM(L, i, k), lam, L->t);
+        mpz_divexact(LLL_LAM(L, i, k), LLL_LAM(L, i, k), LLL_D(L, k - 1));
+        mpz_mul(LLL_LAM(L, i, k - 1), L->v, L->t);
+        mpz_addmul(LLL_LAM(L, i, k - 1), lam, LLL_LAM(L, i, k));
+        mpz_divexact(LLL_LAM(L, i, k - 1), LLL_LAM(L, i, k - 1), LLL_D(L, k));
+    }
+    mpz_swap(LLL_D(L, k - 1), L->v);
+}
+
+/* Compute lam[k][j] and d[k + 1] from the inner products of vector k.
+ * Returns 0 if vector k depends on the previous ones.
+ */
+
+static int
+lll_gram(lll_state *L, Py_ssize_t k)
+{
+    Py_ssize_t i, j;
+
+    L->k = k;
+    lll_run_task(L, LLL_TASK_DOT);
+    for (j = 0; j <= k; j++) {
+        mpz_ptr u = j < k ? LLL_LAM(L, k, j) : LLL_D(L, k);
+
+        mpz_set(u, L->g[j]);
+        for (i = 0; i < j; i++) {
+            mpz_mul(u, u, LLL_D(L, i));
+            mpz_submul(u, LLL_LAM(L, k, i), LLL_LAM(L, j, i));
+            mpz_divexact(u, u, LLL_D(L, i - 1));
+        }
+    }
+    return mpz_sgn(LLL_D(L, k)) != 0;
+}
+
+/* LLL-reduce the vectors 0..rows - 1. Returns 0 on success, -1 if the
+ * vectors are linearly dependent, and -2 if an exception was raised.
+ */
+
+static int
+lll_reduce(lll_state *L, Py_ssize_t rows, CTXT_Object *context)
+{
+    Py_ssize_t k = 1, kmax = 0, iter;
+    int result = 0;
+
+    mpz_set_ui(L->d[0], 1);
+    if (rows == 0) {
+        return 0;
+    }
+    if (!lll_gram(L, 0)) {
+        return -1;
+    }
+    while (k < rows && result == 0) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        for (iter = 0; iter < LLL_CHECK && k < rows; iter++) {
+            if (k > kmax) {
+                kmax = k;
+                if (!lll_gram(L, k)) {
+                    result = -1;
+                    break;
+                }
+            }
+            lll_size_reduce(L, k, k - 1, k);
+            /* Lovasz condition: d[k + 1]*d[k - 1] + lam**2 >= delta*d[k]**2 */
+            mpz_mul(L->t, LLL_D(L, k), LLL_D(L, k - 2));
+            mpz_addmul(L->t, LLL_LAM(L, k, k - 1), LLL_LAM(L, k, k - 1));
+            mpz_mul(L->t, L->t, L->dden);
+            mpz_mul(L->u, LLL_D(L, k - 1), LLL_D(L, k - 1));
+            mpz_mul(L->u, L->u, L->dnum);
+            if (mpz_cmp(L->t, L->u) < 0) {
+                lll_swap(L, k, kmax);
+                if (k > 1) {
+                    k--;
+                }
+            }
+            else {
+                lll_size_reduce(L, k, 0, k - 1);
+                k++;
+            }
+        }
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (result == 0 && PyErr_CheckSignals() < 0) {
+            result = -2;
+        }
+    }
+    return result;
+}
+
+/* Return y*2**e as a double, or 0.0 if it would underflow. */
+
+static double
+lattice_ldexp(double y, long e)
+{
+    return e < -2000 ? 0.0 : ldexp(y, e > 2000 ? 2000 : (int)e);
+}
+
+/* Find the coefficients x of the shortest nonzero vector of the block j..k
+ * projected orthogonally to the vectors before j, if its squared norm is
+ * less than R2 times that of vector j. mu and Bl hold the Gram-Schmidt
+ * coefficients and the squared norms of the block, relative to vector j.
+ * Returns 1 if such a vector was found. The vectors with the coefficients
+ * of the lowest nonzero index positive are enumerated in order of
+ * increasing distance from the projected center (Schnorr-Euchner).
+ */
+
+static int
+bkz_enum(const double *mu, const double *Bl, Py_ssize_t s, double R2,
+         long *x, long *best, long *base, long *cnt, double *ctr, double *rho)
+{
+    Py_ssize_t l, t;
+    double diff, r;
+    int found = 0;
+
+    rho[s] = 0.0;
+    l = s - 1;
+    ctr[l] = 0.0;
+    base[l] = x[l] = 0;
+    cnt[l] = 0;
+    for (;;) {
+        diff = (double)x[l] - ctr[l];
+        r = rho[l + 1] + diff * diff * Bl[l];
+        if (r < R2) {
+            if (l > 0) {
+                rho[l--] = r;
+                for (ctr[l] = 0.0, t = l + 1; t < s; t++) {
+                    ctr[l] -= (double)x[t] * mu[t * s + l];
+                }
+                base[l] = x[l] = lround(ctr[l]);
+                cnt[l] = 0;
+                continue;
+            }
+            if (r > 0.0) {
+                R2 = r;
+                memcpy(best, x, s * sizeof(long));
+                found = 1;
+            }
+        }
+        else if (++l == s) {
+            break;
+        }
+        /* The next candidate at level l, zigzagging around the center. */
+        if (rho[l + 1] == 0.0) {
+            x[l]++;
+        }
+        else {
+            cnt[l]++;
+            t = (cnt[l] + 1) / 2;
+            if ((cnt[l] & 1) == (ctr[l] >= (double)base[l])) {
+                x[l] = base[l] + t;
+            }
+            else {
+                x[l] = base[l] - t;
+            }
+        }
+    }
+    return found;
+}
+
+/* b[dst] += c*b[src] */
+
+static void
+bkz_row_addmul(lll_state *L, Py_ssize_t dst, Py_ssize_t src, long c)
+{
+    Py_ssize_t col;
+
+    for (col = 0; col < L->m; col++) {
+        if (c >= 0) {
+            mpz_addmul_ui(LLL_B(L, dst, col), LLL_B(L, src, col), (unsigned long)c);
+        }
+        else {
+            mpz_submul_ui(LLL_B(L, dst, col), LLL_B(L, src, col), -(unsigned long)c);
+        }
+    }
+}
+
+/* Make the vector sum(x[i]*b[j + i]) a basis vector at position j by
+ * unimodular operations on the vectors j..j + s - 1.
+ */
+
+static void
+bkz_insert(lll_state *L, Py_ssize_t j, Py_ssize_t s, long *x)
+{
+    Py_ssize_t i, p, col;
+    long c;
+    int more = 1;
+
+    /* Euclid's algorithm on the coefficients: for c = x[i]/x[p],
+     * x[i]*b[i] + x[p]*b[p] = (x[i] - c*x[p])*b[i] + x[p]*(b[p] + c*b[i]).
+     */
+    while (more) {
+        for (p = -1, i = 0; i < s; i++) {
+            if (x[i] && (p < 0 || labs(x[i]) < labs(x[p]))) {
+                p = i;
+            }
+        }
+        more = 0;
+        for (i = 0; i < s; i++) {
+            if (i != p && x[i]) {
+                c = x[i] / x[p];
+                x[i] -= c * x[p];
+                bkz_row_addmul(L, j + p, j + i, c);
+                more |= x[i] != 0;
+            }
+        }
+    }
+    for (i = p; i > 0; i--) {
+        for (col = 0; col < L->m; col++) {
+            mpz_swap(LLL_B(L, j + i, col), LLL_B(L, j + i - 1, col));
+        }
+    }
+}
+
+/* Return d[i + 1]*d[j]/(d[i]*d[j + 1]), the squared norm of the i-th
+ * Gram-Schmidt vector relative to the j-th.
+ */
+
+static double
+bkz_relative_norm(lll_state *L, Py_ssize_t i, Py_ssize_t j)
+{
+    signed long e1, e2, e3, e4;
+    double y;
+
+    y = mpz_get_d_2exp(&e1, LLL_D(L, i)) * mpz_get_d_2exp(&e2, LLL_D(L, j - 1)) /
+        (mpz_get_d_2exp(&e3, LLL_D(L, i - 1)) * mpz_get_d_2exp(&e4, LLL_D(L, j)));
+    return lattice_ldexp(y, e1 + e2 - e3 - e4);
+}
+
+/* BKZ-reduce the basis with blocks of size beta. Returns like lll_reduce(). */
+
+static int
+bkz_reduce(lll_state *L, Py_ssize_t beta, CTXT_Object *context)
+{
+    Py_ssize_t n = L->n, j = -1, k, h, s, z = 0, a, i;
+    signed long e1, e2;
+    double *mu, *Bl, *ctr, *rho, R2;
+    long *x, *best, *base, *cnt;
+    int result, found;
+
+    if ((result = lll_reduce(L, n, context)) < 0 || n < 2) {
+        return result;
+    }
+    s = beta < n ? beta : n;
+    mu = PyMem_New(double, s * s + 3 * s + 1);
+    x = PyMem_New(long, 4 * s);
+    if (!mu || !x) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(mu);
+        PyMem_Free(x);
+        PyErr_NoMemory();
+        return -2;
+        /* LCOV_EXCL_STOP */
+    }
+    Bl = mu + s * s;
+    ctr = Bl + s;
+    rho = ctr + s;
+    best = x + s;
+    base = best + s;
+    cnt = base + s;
+    R2 = mpz_get_d(L->dnum) / mpz_get_d(L->dden) * (1 - 1e-9);
+
+    while (z < n - 1) {
+        j = (j + 1) % (n - 1);
+        k = j + beta - 1 < n - 1 ? j + beta - 1 : n - 1;
+        h = k + 1 < n - 1 ? k + 1 : n - 1;
+        s = k - j + 1;
+        if ((result = lll_reduce(L, h + 1, context)) < 0) {
+            break;
+        }
+        for (a = 0; a < s; a++) {
+            Bl[a] = bkz_relative_norm(L, j + a, j);
+            for (i = 0; i < a; i++) {
+                mu[a * s + i] = mpz_get_d_2exp(&e1, LLL_LAM(L, j + a, j + i)) /
+                                mpz_get_d_2exp(&e2, LLL_D(L, j + i));
+                mu[a * s + i] = lattice_ldexp(mu[a * s + i], e1 - e2);
+            }
+        }
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        found = bkz_enum(mu, Bl, s, R2, x, best, base, cnt, ctr, rho);
+        if (found) {
+            bkz_insert(L, j, s, best);
+        }
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (PyErr_CheckSignals() < 0) {
+            result = -2;
+            break;
+        }
+        if (found) {
+            if ((result = lll_reduce(L, h + 1, context)) < 0) {
+                break;
+            }
+            z = 0;
+        }
+        else {
+            z++;
+        }
+    }
+    if (result == 0) {
+        result = lll_reduce(L, n, context);
+    }
+    PyMem_Free(mu);
+    PyMem_Free(x);
+    return result;
+}
+
+static void
+lll_state_clear(lll_state *L)
+{
+    Py_ssize_t i;
+
+    if (L->b) {
+        for (i = 0; i < L->n * L->m; i++) {
+            mpz_clear(L->b[i]);
+        }
+        for (i = 0; i < L->n * L->n; i++) {
+            mpz_clear(L->lam[i]);
+        }
+        for (i = 0; i < L->n; i++) {
+            mpz_clear(L->q[i]);
+            mpz_clear(L->g[i]);
+        }
+        for (i = 0; i <= L->n; i++) {
+            mpz_clear(L->d[i]);
+        }
+        mpz_clear(L->t);
+        mpz_clear(L->u);
+        mpz_clear(L->v);
+        mpz_clear(L->dnum);
+        mpz_clear(L->dden);
+    }
+    PyMem_Free(L->b);
+    PyMem_Free(L->lam);
+    PyMem_Free(L->d);
+    PyMem_Free(L->q);
+    PyMem_Free(L->g);
+}
+
+/* Read the basis, a sequence of integer sequences of the same length, and
+ * delta, a number with 1/4 < delta <= 1. Returns -1 and sets an exception
+ * on failure; the state must be cleared in either case.
+ */
+
+static int
+lll_state_init(lll_state *L, PyObject *basis, PyObject *delta, const char *name,
+               CTXT_Object *context)
+{
+    PyObject *seq, *row;
+    MPQ_Object *dq;
+    MPZ_Object *temp;
+    Py_ssize_t i, c;
+
+    memset(L, 0, offsetof(lll_state, workers));
+    if (!(seq = PySequence_Fast(basis, ""))) {
+        PyErr_Format(PyExc_TypeError, "%s() requires a sequence of integer sequences", name);
+        return -1;
+    }
+    L->n = PySequence_Fast_GET_SIZE(seq);
+    for (i = 0; i < L->n; i++) {
+        c = PySequence_Size(PySequence_Fast_GET_ITEM(seq, i));
+        if (c < 0) {
+            PyErr_Format(PyExc_TypeError, "%s() requires a sequence of integer sequences", name);
+            Py_DECREF(seq);
+            return -1;
+        }
+        if (i > 0 && c != L->m) {
+            PyErr_Format(PyExc_ValueError, "%s() requires vectors of the same length", name);
+            Py_DECREF(seq);
+            return -1;
+        }
+        L->m = c;
+    }
+    L->b = PyMem_New(mpz_t, L->n * L->m);
+    L->lam = PyMem_New(mpz_t, L->n * L->n);
+    L->d = PyMem_New(mpz_t, L->n + 1);
+    L->q = PyMem_New(mpz_t, L->n);
+    L->g = PyMem_New(mpz_t, L->n);
+    if (!L->b || !L->lam || !L->d || !L->q || !L->g) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(L->b);
+        L->b = NULL;
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < L->n * L->m; i++) {
+        mpz_init(L->b[i]);
+    }
+    for (i = 0; i < L->n * L->n; i++) {
+        mpz_init(L->lam[i]);
+    }
+    for (i = 0; i < L->n; i++) {
+        mpz_init(L->q[i]);
+        mpz_init(L->g[i]);
+    }
+    for (i = 0; i <= L->n; i++) {
+        mpz_init(L->d[i]);
+    }
+    mpz_init(L->t);
+    mpz_init(L->u);
+    mpz_init(L->v);
+    mpz_init_set_ui(L->dnum, 99);
+    mpz_init_set_ui(L->dden, 100);
+    L->nthreads = 1;
+
+    for (i = 0; i < L->n; i++) {
+        if (!(row = PySequence_Fast(PySequence_Fast_GET_ITEM(seq, i), ""))) {
+            break;
+        }
+        for (c = 0; c < L->m; c++) {
+            PyObject *item = PySequence_Fast_GET_ITEM(row, c);
+
+            if (!IS_INTEGER(item) || !(temp = GMPy_MPZ_From_Integer(item, NULL))) {
+                break;
+            }
+            mpz_set(LLL_B(L, i, c), temp->z);
+            Py_DECREF((PyObject*)temp);
+        }
+        Py_DECREF(row);
+        if (c < L->m) {
+            break;
+        }
+    }
+    Py_DECREF(seq);
+    if (i < L->n) {
+        PyErr_Format(PyExc_TypeError, "%s() requires a sequence of integer sequences", name);
+        return -1;
+    }
+
+    if (delta) {
+        if (!IS_REAL(delta) || !(dq = GMPy_MPQ_From_Number(delta, context))) {
+            PyErr_Format(PyExc_TypeError, "%s() requires a real delta", name);
+            return -1;
+        }
+        mpz_set(L->dnum, mpq_numref(dq->q));
+        mpz_set(L->dden, mpq_denref(dq->q));
+        Py_DECREF((PyObject*)dq);
+        mpz_mul_2exp(L->t, L->dnum, 2);
+        if (mpz_cmp(L->t, L->dden) <= 0 || mpz_cmp(L->dnum, L->dden) > 0) {
+            PyErr_Format(PyExc_ValueError, "%s() requires 1/4 < delta <= 1", name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Return the basis as a list of lists of mpz. */
+
+static PyObject *
+lll_state_result(lll_state *L)
+{
+    PyObject *result, *row;
+    MPZ_Object *temp;
+    Py_ssize_t i, c;
+
+    if (!(result = PyList_New(L->n))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < L->n; i++) {
+        if (!(row = PyList_New(L->m))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        PyList_SET_ITEM(result, i, row);
+        for (c = 0; c < L->m; c++) {
+            if (!(temp = GMPy_MPZ_New(NULL))) {
+                /* LCOV_EXCL_START */
+                Py_DECREF(result);
+                return NULL;
+                /* LCOV_EXCL_STOP */
+            }
+            mpz_swap(temp->z, LLL_B(L, i, c));
+            PyList_SET_ITEM(row, c, (PyObject*)temp);
+        }
+    }
+    return result;
+}
+
+static PyObject *
+lll_finish(lll_state *L, int rc, const char *name)
+{
+    PyObject *result = NULL;
+
+    lll_pool_stop(L);
+    if (rc == -1) {
+        PyErr_Format(PyExc_ValueError, "%s() requires linearly independent vectors", name);
+    }
+    else if (rc == 0) {
+        result = lll_state_result(L);
+    }
+    lll_state_clear(L);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_lll,
+"lll(basis, /, delta=0.99) -> list[list[mpz]]\n\n"
+"Return an LLL-reduced basis of the lattice spanned by the rows of\n"
+"basis, a sequence of linearly independent integer vectors. delta is the\n"
+"parameter of the Lovasz condition, 1/4 < delta <= 1; it is used exactly,\n"
+"so a float is converted to the rational number it represents. All the\n"
+"arithmetic is exact. Long vectors are processed with context.threads\n"
+"threads, and the GIL is released.");
+
+static PyObject *
+GMPy_Function_LLL(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *basis, *delta = NULL;
+    lll_state L;
+    CTXT_Object *context = NULL;
+    int rc;
+    static char *kwlist[] = {"", "delta", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist, &basis, &delta)) {
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (lll_state_init(&L, basis, delta, "lll", context) < 0) {
+        lll_state_clear(&L);
+        return NULL;
+    }
+    lll_pool_start(&L, GET_THREADS(context));
+    rc = lll_reduce(&L, L.n, context);
+    return lll_finish(&L, rc, "lll");
+}
+
+PyDoc_STRVAR(GMPy_doc_function_bkz,
+"bkz(basis, block_size, /, delta=0.99) -> list[list[mpz]]\n\n"
+"Return a BKZ-reduced basis of the lattice spanned by the rows of basis,\n"
+"a sequence of linearly independent integer vectors. In the result, each\n"
+"vector is nearly the shortest vector of the lattice spanned by it and\n"
+"the next block_size - 1 vectors, projected orthogonally to the previous\n"
+"vectors. block_size = 2 gives an LLL-reduced basis, and larger blocks\n"
+"give shorter vectors at a cost that grows exponentially with the block\n"
+"size. See lll() for delta.");
+
+static PyObject *
+GMPy_Function_BKZ(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *basis, *delta = NULL;
+    Py_ssize_t beta;
+    lll_state L;
+    CTXT_Object *context = NULL;
+    int rc;
+    static char *kwlist[] = {"", "", "delta", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "On|O", kwlist, &basis, &beta, &delta)) {
+        return NULL;
+    }
+    if (beta < 2) {
+        VALUE_ERROR("bkz() requires block_size >= 2");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (lll_state_init(&L, basis, delta, "bkz", context) < 0) {
+        lll_state_clear(&L);
+        return NULL;
+    }
+    lll_pool_start(&L, GET_THREADS(context));
+    rc = bkz_reduce(&L, beta, context);
+    return lll_finish(&L, rc, "bkz");
+}
+
+typedef struct {
+    Py_ssize_t n;
+    mpfr_t *y;           /* the current vector */
+    mpfr_t *H;           /* H[i*(n - 1) + j], lower trapezoidal */
+    mpfr_t *t;           /* temporaries */
+    mpz_t *A, *B;        /* A[i*n + j], B = A**-1 */
+    mpz_ptr q;
+} pslq_state;
+
+#define PSLQ_H(S, i, j) ((S)->H[(i) * ((S)->n - 1) + (j)])
+#define PSLQ_A(S, i, j) ((S)->A[(i) * (S)->n + (j)])
+#define PSLQ_B(S, i, j) ((S)->B[(i) * (S)->n + (j)])
+
+/* Reduce row i of H by row j. */
+
+static void
+pslq_reduce(pslq_state *S, Py_ssize_t i, Py_ssize_t j)
+{
+    Py_ssize_t k;
+
+    if (mpfr_zero_p(PSLQ_H(S, j, j))) {
+        return;
+    }
+    mpfr_div(S->t[0], PSLQ_H(S, i, j), PSLQ_H(S, j, j), MPFR_RNDN);
+    mpfr_rint(S->t[0], S->t[0], MPFR_RNDN);
+    if (mpfr_zero_p(S->t[0])) {
+        return;
+    }
+    mpfr_get_z(S->q, S->t[0], MPFR_RNDN);
+    mpfr_mul_z(S->t[0], S->y[i], S->q, MPFR_RNDN);
+    mpfr_add(S->y[j], S->y[j], S->t[0], MPFR_RNDN);
+    for (k = 0; k <= j; k++) {
+        mpfr_mul_z(S->t[0], PSLQ_H(S, j, k), S->q, MPFR_RNDN);
+        mpfr_sub(PSLQ_H(S, i, k), PSLQ_H(S, i, k), S->t[0], MPFR_RNDN);
+    }
+    for (k = 0; k < S->n; k++) {
+        mpz_submul(PSLQ_A(S, i, k), S->q, PSLQ_A(S, j, k));
+        mpz_addmul(PSLQ_B(S, k, j), S->q, PSLQ_B(S, k, i));
+    }
+}
+
+/* Run the PSLQ iteration. Returns the index of the column of B that is a
+ * relation, -1 if there is no relation of norm at most maxcoeff or none
+ * was found in maxsteps iterations, and -2 if an exception was raised.
+ */
+
+static Py_ssize_t
+pslq_run(pslq_state *S, mpfr_srcptr tol, mpz_srcptr maxcoeff, Py_ssize_t maxsteps)
+{
+    Py_ssize_t n = S->n, step, i, j, k, m;
+    mpfr_ptr t0 = S->t[0], t1 = S->t[1], t2 = S->t[2], t3 = S->t[3], t4 = S->t[4];
+    mpfr_ptr gamma = S->t[5], best = S->t[6];
+
+    /* gamma = sqrt(4/3) */
+    mpfr_set_ui(gamma, 4, MPFR_RNDN);
+    mpfr_div_ui(gamma, gamma, 3, MPFR_RNDN);
+    mpfr_sqrt(gamma, gamma, MPFR_RNDN);
+
+    for (i = 1; i < n; i++) {
+        for (j = i - 1; j >= 0; j--) {
+            pslq_reduce(S, i, j);
+        }
+    }
+
+    for (step = 0; step < maxsteps; step++) {
+        /* Choose m with gamma**(m + 1)*|H[m][m]| largest. */
+        m = 0;
+        mpfr_set_si(best, -1, MPFR_RNDN);
+        mpfr_set_ui(t1, 1, MPFR_RNDN);
+        for (i = 0; i < n - 1; i++) {
+            mpfr_mul(t1, t1, gamma, MPFR_RNDN);
+            mpfr_abs(t0, PSLQ_H(S, i, i), MPFR_RNDN);
+            mpfr_mul(t0, t0, t1, MPFR_RNDN);
+            if (mpfr_greater_p(t0, best)) {
+                mpfr_swap(best, t0);
+                m = i;
+            }
+        }
+
+        /* Exchange the entries m and m + 1. */
+        mpfr_swap(S->y[m], S->y[m + 1]);
+        for (k = 0; k < n - 1; k++) {
+            mpfr_swap(PSLQ_H(S, m, k), PSLQ_H(S, m + 1, k));
+        }
+        for (k = 0; k < n; k++) {
+            mpz_swap(PSLQ_A(S, m, k), PSLQ_A(S, m + 1, k));
+            mpz_swap(PSLQ_B(S, k, m), PSLQ_B(S, k, m + 1));
+        }
+
+        /* Restore the lower trapezoidal form of H. */
+        if (m < n - 2) {
+            mpfr_hypot(t0, PSLQ_H(S, m, m), PSLQ_H(S, m, m + 1), MPFR_RNDN);
+            if (mpfr_zero_p(t0)) {
+                return -1;
+            }
+            mpfr_div(t1, PSLQ_H(S, m, m), t0, MPFR_RNDN);
+            mpfr_div(t2, PSLQ_H(S, m, m + 1), t0, MPFR_RNDN);
+            for (i = m; i < n; i++) {
+                mpfr_set(t3, PSLQ_H(S, i, m), MPFR_RNDN);
+                mpfr_set(t4, PSLQ_H(S, i, m + 1), MPFR_RNDN);
+                mpfr_mul(t0, t2, t4, MPFR_RNDN);
+                mpfr_fma(PSLQ_H(S, i, m), t1, t3, t0, MPFR_RNDN);
+                mpfr_mul(t0, t2, t3, MPFR_RNDN);
+                mpfr_fms(PSLQ_H(S, i, m + 1), t1, t4, t0, MPFR_RNDN);
+            }
+        }
+
+        for (i = m + 1; i < n; i++) {
+            for (j = i - 1 < m + 1 ? i - 1 : m + 1; j >= 0; j--) {
+                pslq_reduce(S, i, j);
+            }
+        }
+
+        /* A small entry of y gives a relation in the matching column of B. */
+        for (i = 0; i < n; i++) {
+            if (mpfr_cmpabs(S->y[i], tol) < 0) {
+                return i;
+            }
+        }
+
+        /* 1/max(|H[j][j]|) is a lower bound for the norm of a relation. */
+        mpfr_set_ui(t0, 0, MPFR_RNDN);
+        for (j = 0; j < n - 1; j++) {
+            if (mpfr_cmpabs(PSLQ_H(S, j, j), t0) > 0) {
+                mpfr_abs(t0, PSLQ_H(S, j, j), MPFR_RNDN);
+            }
+        }
+        if (!mpfr_zero_p(t0)) {
+            mpfr_ui_div(t0, 1, t0, MPFR_RNDN);
+            if (mpfr_cmp_z(t0, maxcoeff) > 0) {
+                return -1;
+            }
+        }
+        if (PyErr_CheckSignals() < 0) {
+            return -2;
+        }
+    }
+    return -1;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_pslq,
+"pslq(x, /, tol=None, maxcoeff=1000, maxsteps=1000) -> list[mpz] | None\n\n"
+"Return a list of integers c, not all zero, such that sum(c[i]*x[i]) is\n"
+"close to zero. The PSLQ algorithm runs in mpfr arithmetic at the\n"
+"precision of the context, and a relation is accepted when the scaled\n"
+"residual is less than tol, which defaults to 2**(-3*precision//4).\n"
+"Returns None if there is no relation with a Euclidean norm of at most\n"
+"maxcoeff, or if none was found in maxsteps iterations.");
+
+static PyObject *
+GMPy_Function_PSLQ(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *xs, *seq, *tolobj = Py_None, *maxobj = NULL, *result = NULL;
+    MPFR_Object *temp;
+    MPZ_Object *maxcoeff = NULL, *c;
+    pslq_state S;
+    mpfr_t *f = NULL, *sv;
+    mpz_t *z = NULL;
+    Py_ssize_t n, nf = 0, nz = 0, maxsteps = 1000, i, j, rel = -1;
+    mpfr_prec_t prec;
+    CTXT_Object *context = NULL;
+    static char *kwlist[] = {"", "tol", "maxcoeff", "maxsteps", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|OOn", kwlist,
+                                     &xs, &tolobj, &maxobj, &maxsteps)) {
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (maxobj) {
+        if (!IS_INTEGER(maxobj) || !(maxcoeff = GMPy_MPZ_From_Integer(maxobj, context))) {
+            TYPE_ERROR("pslq() requires an integer maxcoeff");
+            return NULL;
+        }
+    }
+    else if ((maxcoeff = GMPy_MPZ_New(context))) {
+        mpz_set_ui(maxcoeff->z, 1000);
+    }
+    else {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (!(seq = PySequence_Fast(xs, ""))) {
+        TYPE_ERROR("pslq() requires a sequence of real numbers");
+        Py_DECREF((PyObject*)maxcoeff);
+        return NULL;
+    }
+    if ((n = PySequence_Fast_GET_SIZE(seq)) < 2) {
+        VALUE_ERROR("pslq() requires at least 2 numbers");
+        goto done;
+    }
+
+    prec = GET_MPFR_PREC(context);
+    nf = n * (n + 1) + 8;
+    nz = 2 * n * n + 1;
+    if (!(f = PyMem_New(mpfr_t, nf)) || !(z = PyMem_New(mpz_t, nz))) {
+        /* LCOV_EXCL_START */
+        nf = nz = 0;
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < nf; i++) {
+        mpfr_init2(f[i], prec);
+    }
+    for (i = 0; i < nz; i++) {
+        mpz_init(z[i]);
+    }
+    S.n = n;
+    S.y = f;
+    sv = f + n;
+    S.H = sv + n;
+    S.t = S.H + n * (n - 1);
+    S.A = z;
+    S.B = z + n * n;
+    S.q = z[nz - 1];
+
+    for (i = 0; i < n; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+
+        if (!IS_REAL(item) || !(temp = GMPy_MPFR_From_Real(item, 0, context))) {
+            TYPE_ERROR("pslq() requires a sequence of real numbers");
+            goto done;
+        }
+        mpfr_set(S.y[i], temp->f, MPFR_RNDN);
+        Py_DECREF((PyObject*)temp);
+        if (!mpfr_number_p(S.y[i])) {
+            VALUE_ERROR("pslq() requires finite numbers");
+            goto done;
+        }
+    }
+    /* The tolerance is kept in S.t[7]. */
+    if (tolobj == Py_None) {
+        mpfr_set_ui_2exp(S.t[7], 1, -(3 * prec / 4), MPFR_RNDN);
+    }
+    else {
+        if (!IS_REAL(tolobj) || !(temp = GMPy_MPFR_From_Real(tolobj, 0, context))) {
+            TYPE_ERROR("pslq() requires a real tol");
+            goto done;
+        }
+        mpfr_abs(S.t[7], temp->f, MPFR_RNDN);
+        Py_DECREF((PyObject*)temp);
+    }
+    for (i = 0; i < n; i++) {
+        mpz_set_ui(PSLQ_A(&S, i, i), 1);
+        mpz_set_ui(PSLQ_B(&S, i, i), 1);
+    }
+
+    /* A number that is already small is a relation by itself. */
+    for (i = 0; i < n && rel < 0; i++) {
+        if (mpfr_cmpabs(S.y[i], S.t[7]) < 0) {
+            rel = i;
+        }
+    }
+    if (rel < 0) {
+        /* s[k] = sqrt(sum(x[j]**2 for j >= k)), y = x/s[0], s = s/s[0] */
+        mpfr_abs(sv[n - 1], S.y[n - 1], MPFR_RNDN);
+        for (i = n - 2; i >= 0; i--) {
+            mpfr_sqr(S.t[0], sv[i + 1], MPFR_RNDN);
+            mpfr_fma(S.t[0], S.y[i], S.y[i], S.t[0], MPFR_RNDN);
+            mpfr_sqrt(sv[i], S.t[0], MPFR_RNDN);
+        }
+        mpfr_set(S.t[1], sv[0], MPFR_RNDN);
+        for (i = 0; i < n; i++) {
+            mpfr_div(S.y[i], S.y[i], S.t[1], MPFR_RNDN);
+            mpfr_div(sv[i], sv[i], S.t[1], MPFR_RNDN);
+        }
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < n - 1; j++) {
+                if (j > i) {
+                    mpfr_set_ui(PSLQ_H(&S, i, j), 0, MPFR_RNDN);
+                }
+                else if (j == i) {
+                    mpfr_div(PSLQ_H(&S, i, j), sv[i + 1], sv[i], MPFR_RNDN);
+                }
+                else {
+                    mpfr_mul(S.t[0], S.y[i], S.y[j], MPFR_RNDN);
+                    mpfr_mul(S.t[1], sv[j], sv[j + 1], MPFR_RNDN);
+                    mpfr_div(S.t[0], S.t[0], S.t[1], MPFR_RNDN);
+                    mpfr_neg(PSLQ_H(&S, i, j), S.t[0], MPFR_RNDN);
+                }
+            }
+        }
+        if ((rel = pslq_run(&S, S.t[7], maxcoeff->z, maxsteps)) == -2) {
+            goto done;
+        }
+    }
+
+    if (rel < 0) {
+        Py_INCREF(Py_None);
+        result = Py_None;
+        goto done;
+    }
+    if (!(result = PyList_New(n))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < n; i++) {
+        if (!(c = GMPy_MPZ_New(context))) {
+            /* LCOV_EXCL_START */
+            Py_CLEAR(result);
+            goto done;
+            /* LCOV_EXCL_STOP */
+        }
+        mpz_set(c->z, PSLQ_B(&S, i, rel));
+        PyList_SET_ITEM(result, i, (PyObject*)c);
+    }
+
+  done:
+    for (i = 0; i < nf; i++) {
+        mpfr_clear(f[i]);
+    }
+    for (i = 0; i < nz; i++) {
+        mpz_clear(z[i]);
+    }
+    PyMem_Free(f);
+    PyMem_Free(z);
+    Py_DECREF(seq);
+    Py_DECREF((PyObject*)maxcoeff);
+    return result;
+}
@@ -68,27 +68,27 @@ _GMPy_MPFR_Cleanup(MPFR_Object **v, CTXT_Object *ctext)
     ctext->ctx.divzero |= mpfr_divby0_p();
     if (ctext->ctx.traps) {
         if ((ctext->ctx.traps & TRAP_UNDERFLOW) && mpfr_underflow_p()) {
-            PyErr_SetString(GMPyExc_Underflow, "underflow");
+            GMPY_UNDERFLOW("underflow");
             Py_XDECREF((PyObject*)(*v));
             (*v) = NULL;
         }
         if ((ctext->ctx.traps & TRAP_OVERFLOW) && mpfr_overflow_p()) {
-            PyErr_SetString(GMPyExc_Overflow, "overflow");
+            GMPY_OVERFLOW("overflow");
             Py_XDECREF((PyObject*)(*v));
             (*v) = NULL;
         }
         if ((ctext->ctx.traps & TRAP_INEXACT) && mpfr_inexflag_p()) {
-            PyErr_SetString(GMPyExc_Inexact, "inexact result");
+            GMPY_INEXACT("inexact result");
             Py_XDECREF((PyObject*)(*v));
             (*v) = NULL;
         }
         if ((ctext->ctx.traps & TRAP_INVALID) && mpfr_nanflag_p()) {
-            PyErr_SetString(GMPyExc_Invalid, "invalid operation");
+            GMPY_INVALID("invalid operation");
             Py_XDECREF((PyObject*)(*v));
             (*v) = NULL;
         }
         if ((ctext->ctx.traps & TRAP_DIVZERO) && mpfr_divby0_p()) {
-            PyErr_SetString(GMPyExc_DivZero, "division by zero");
+            GMPY_DIVZERO("division by zero");
             Py_XDECREF((PyObject*)(*v));
             (*v) = NULL;
         }
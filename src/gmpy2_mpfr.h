@@ -106,12 +106,12 @@ __MPFR_DECLSPEC extern MPFR_THREAD_ATTR mpfr_exp_t   __gmpfr_emax;
 static PyTypeObject MPFR_Type;
 #define MPFR_Check(v) (((PyObject*)v)->ob_type == &MPFR_Type)
 
-#define GMPY_DIVZERO(msg) PyErr_SetString(GMPyExc_DivZero, msg)
-#define GMPY_INEXACT(msg) PyErr_SetString(GMPyExc_Inexact, msg)
-#define GMPY_INVALID(msg) PyErr_SetString(GMPyExc_Invalid, msg)
-#define GMPY_OVERFLOW(msg) PyErr_SetString(GMPyExc_Overflow, msg)
-#define GMPY_UNDERFLOW(msg) PyErr_SetString(GMPyExc_Underflow, msg)
-#define GMPY_ERANGE(msg) PyErr_SetString(GMPyExc_Erange, msg)
+#define GMPY_DIVZERO(msg) PyErr_SetString(GMPy_Exception(&GMPyExc_DivZero), msg)
+#define GMPY_INEXACT(msg) PyErr_SetString(GMPy_Exception(&GMPyExc_Inexact), msg)
+#define GMPY_INVALID(msg) PyErr_SetString(GMPy_Exception(&GMPyExc_Invalid), msg)
+#define GMPY_OVERFLOW(msg) PyErr_SetString(GMPy_Exception(&GMPyExc_Overflow), msg)
+#define GMPY_UNDERFLOW(msg) PyErr_SetString(GMPy_Exception(&GMPyExc_Underflow), msg)
+#define GMPY_ERANGE(msg) PyErr_SetString(GMPy_Exception(&GMPyExc_Erange), msg)
 
 #define GMPY_MPFR_CHECK_RANGE(V, CTX) \
     if (mpfr_regular_p(V->f) && \
@@ -0,0 +1,1052 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpfr_array.c                                                      *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Packed arrays of mpfr values.
+ *
+ * Every element of an mpfr_array has the same precision, so the
+ * significands are allocated as one contiguous block and attached to the
+ * mpfr structures with MPFR's custom interface (mpfr_custom_init_set).
+ * Slicing returns a view that shares the storage of its base array.
+ *
+ * Element-wise arithmetic and the unary functions are whole-array kernels
+ * that run without the GIL. Each element is checked against the exponent
+ * range of the context and subnormalized just like a scalar mpfr result;
+ * the MPFR flags are accumulated over the whole array and merged into the
+ * context once when the kernel is finished.
+ */
+
+#define MPFR_ARRAY_ITEM(a, i) ((a)->data + (i) * (a)->step)
+#define MPFR_ARRAY_OWNER(a) ((a)->base ? (a)->base : (PyObject*)(a))
+
+typedef int (*mpfr_array_unop)(mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+typedef int (*mpfr_array_binop)(mpfr_ptr, mpfr_srcptr, mpfr_srcptr, mpfr_rnd_t);
+
+/* The settings of the context that are needed by a kernel. They are copied
+ * so that the context isn't accessed while the GIL is released.
+ */
+
+typedef struct {
+    mpfr_rnd_t round;
+    mpfr_exp_t emin;
+    mpfr_exp_t emax;
+    int subnormalize;
+    unsigned long serial;  /* progress record of the running kernel */
+} mpfr_array_env;
+
+static void
+mpfr_array_env_init(mpfr_array_env *env, CTXT_Object *context)
+{
+    env->round = GET_MPFR_ROUND(context);
+    env->emin = context->ctx.emin;
+    env->emax = context->ctx.emax;
+    env->subnormalize = context->ctx.subnormalize;
+}
+
+/* Apply the exponent range and subnormalization of env to x; rc is the
+ * ternary value of the operation that computed x. This is the per element
+ * equivalent of GMPY_MPFR_CHECK_RANGE and GMPY_MPFR_SUBNORMALIZE.
+ */
+
+static inline void
+mpfr_array_round(mpfr_ptr x, int rc, const mpfr_array_env *env)
+{
+    mpfr_exp_t oldemin, oldemax;
+
+    if (mpfr_regular_p(x) &&
+        (x->_mpfr_exp < env->emin || x->_mpfr_exp > env->emax)) {
+        oldemin = mpfr_get_emin();
+        oldemax = mpfr_get_emax();
+        mpfr_set_emin(env->emin);
+        mpfr_set_emax(env->emax);
+        rc = mpfr_check_range(x, rc, env->round);
+        mpfr_set_emin(oldemin);
+        mpfr_set_emax(oldemax);
+    }
+    if (env->subnormalize &&
+        x->_mpfr_exp >= env->emin &&
+        x->_mpfr_exp <= env->emin + mpfr_get_prec(x) - 2) {
+        oldemin = mpfr_get_emin();
+        oldemax = mpfr_get_emax();
+        mpfr_set_emin(env->emin);
+        mpfr_set_emax(env->emax);
+        mpfr_subnormalize(x, rc, env->round);
+        mpfr_set_emin(oldemin);
+        mpfr_set_emax(oldemax);
+    }
+}
+
+static MPFR_Array_Object *
+GMPy_MPFR_Array_New(mpfr_prec_t prec, Py_ssize_t size)
+{
+    MPFR_Array_Object *result;
+    size_t bytes;
+    Py_ssize_t i, nlimbs;
+
+    if (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX) {
+        VALUE_ERROR("invalid value for precision");
+        return NULL;
+    }
+    bytes = mpfr_custom_get_size(prec);
+    nlimbs = (Py_ssize_t)(bytes / sizeof(mp_limb_t));
+    if (size > PY_SSIZE_T_MAX / (Py_ssize_t)bytes ||
+        size > PY_SSIZE_T_MAX / (Py_ssize_t)sizeof(__mpfr_struct)) {
+        return (MPFR_Array_Object*)PyErr_NoMemory();
+    }
+    if (GMPy_Ready_Type(&MPFR_Array_Type) < 0 ||
+        !(result = PyObject_New(MPFR_Array_Object, &MPFR_Array_Type))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    result->base = NULL;
+    result->prec = prec;
+    result->size = size;
+    result->step = 1;
+    result->elems = PyMem_Malloc((size ? size : 1) * sizeof(__mpfr_struct));
+    result->limbs = PyMem_Malloc((size ? size : 1) * bytes);
+    result->data = result->elems;
+    if (!result->elems || !result->limbs) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)result);
+        return (MPFR_Array_Object*)PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < size; i++) {
+        mp_limb_t *p = result->limbs + i * nlimbs;
+
+        mpfr_custom_init(p, prec);
+        mpfr_custom_init_set(&result->elems[i], MPFR_ZERO_KIND, 0, prec, p);
+    }
+    return result;
+}
+
+/* Return a view of size elements of self starting at index start. */
+
+static MPFR_Array_Object *
+GMPy_MPFR_Array_View(MPFR_Array_Object *self, Py_ssize_t start,
+                     Py_ssize_t step, Py_ssize_t size)
+{
+    MPFR_Array_Object *result;
+
+    if (GMPy_Ready_Type(&MPFR_Array_Type) < 0 ||
+        !(result = PyObject_New(MPFR_Array_Object, &MPFR_Array_Type))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    result->base = MPFR_ARRAY_OWNER(self);
+    Py_INCREF(result->base);
+    result->prec = self->prec;
+    result->size = size;
+    result->step = self->step * step;
+    result->data = size ? MPFR_ARRAY_ITEM(self, start) : self->data;
+    result->elems = NULL;
+    result->limbs = NULL;
+    return result;
+}
+
+static void
+GMPy_MPFR_Array_Dealloc(MPFR_Array_Object *self)
+{
+    PyMem_Free(self->elems);
+    PyMem_Free(self->limbs);
+    Py_XDECREF(self->base);
+    PyObject_Free(self);
+}
+
+static MPFR_Array_Object *
+mpfr_array_copy(MPFR_Array_Object *self)
+{
+    MPFR_Array_Object *result;
+    Py_ssize_t i;
+
+    if ((result = GMPy_MPFR_Array_New(self->prec, self->size))) {
+        for (i = 0; i < self->size; i++) {
+            mpfr_set(MPFR_ARRAY_ITEM(result, i), MPFR_ARRAY_ITEM(self, i), MPFR_RNDN);
+        }
+    }
+    return result;
+}
+
+/* Return a new array with the given precision holding the values in the
+ * sequence obj. Each value is rounded directly to the precision.
+ */
+
+static MPFR_Array_Object *
+mpfr_array_from_sequence(PyObject *obj, mpfr_prec_t prec, CTXT_Object *context)
+{
+    MPFR_Array_Object *result;
+    MPFR_Object *temp;
+    PyObject *seq, *item;
+    Py_ssize_t i, size;
+
+    if (!(seq = PySequence_Fast(obj, "mpfr_array() requires a length or an iterable"))) {
+        return NULL;
+    }
+    size = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = GMPy_MPFR_Array_New(prec, size))) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+    for (i = 0; i < size; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!IS_REAL(item)) {
+            TYPE_ERROR("mpfr_array() requires real numbers");
+            goto error;
+        }
+        if (!(temp = GMPy_MPFR_From_Real(item, prec, context))) {
+            goto error;
+        }
+        mpfr_set(MPFR_ARRAY_ITEM(result, i), temp->f, MPFR_RNDN);
+        Py_DECREF((PyObject*)temp);
+    }
+    Py_DECREF(seq);
+    return result;
+
+  error:
+    Py_DECREF(seq);
+    Py_DECREF((PyObject*)result);
+    return NULL;
+}
+
+/* An operand of a kernel is either an array or a scalar that is broadcast
+ * to every element (step == 0).
+ */
+
+typedef struct {
+    mpfr_ptr data;
+    Py_ssize_t step;
+    PyObject *temp;        /* reference owned by the operand */
+} mpfr_array_operand;
+
+/* Set up obj as an operand for an operation that stores its result in
+ * dest. An array that shares storage with dest is copied first unless it
+ * refers to exactly the same elements. Returns 1 on success, 0 if obj is
+ * not a supported type, and -1 if an exception was raised.
+ */
+
+static int
+mpfr_array_operand_init(mpfr_array_operand *op, PyObject *obj,
+                        MPFR_Array_Object *dest, CTXT_Object *context)
+{
+    MPFR_Object *temp;
+
+    op->temp = NULL;
+    if (MPFR_Array_Check(obj)) {
+        MPFR_Array_Object *a = (MPFR_Array_Object*)obj;
+
+        if (a->size != dest->size) {
+            VALUE_ERROR("mpfr_array operands must have the same length");
+            return -1;
+        }
+        if (MPFR_ARRAY_OWNER(a) == MPFR_ARRAY_OWNER(dest) &&
+            (a->data != dest->data || a->step != dest->step)) {
+            if (!(a = mpfr_array_copy(a))) {
+                /* LCOV_EXCL_START */
+                return -1;
+                /* LCOV_EXCL_STOP */
+            }
+            op->temp = (PyObject*)a;
+        }
+        op->data = a->data;
+        op->step = a->step;
+        return 1;
+    }
+    if (IS_REAL(obj)) {
+        if (!(temp = GMPy_MPFR_From_Real(obj, 1, context))) {
+            return -1;
+        }
+        op->temp = (PyObject*)temp;
+        op->data = temp->f;
+        op->step = 0;
+        return 1;
+    }
+    return 0;
+}
+
+static void
+mpfr_array_kernel(MPFR_Array_Object *r, const mpfr_array_operand *x,
+                  const mpfr_array_operand *y, mpfr_array_unop f1,
+                  mpfr_array_binop f2, const mpfr_array_env *env)
+{
+    Py_ssize_t i;
+    mpfr_ptr out;
+    int rc;
+
+    for (i = 0; i < r->size; i++) {
+        out = MPFR_ARRAY_ITEM(r, i);
+        if (f2) {
+            rc = f2(out, x->data + i * x->step, y->data + i * y->step, env->round);
+        }
+        else {
+            rc = f1(out, x->data + i * x->step, env->round);
+        }
+        mpfr_array_round(out, rc, env);
+        gmpy_progress_update(env->serial, i + 1);
+    }
+}
+
+/* Store f1(x) or f2(x, y) in result. Steals the reference to result and
+ * returns it, or NULL if a trap was raised.
+ */
+
+static PyObject *
+mpfr_array_run(MPFR_Array_Object *result, const mpfr_array_operand *x,
+               const mpfr_array_operand *y, mpfr_array_unop f1,
+               mpfr_array_binop f2, CTXT_Object *context)
+{
+    mpfr_array_env env;
+
+    mpfr_array_env_init(&env, context);
+    env.serial = gmpy_progress_begin("mpfr_array", result->size);
+    mpfr_clear_flags();
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    mpfr_array_kernel(result, x, y, f1, f2, &env);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    gmpy_progress_end(env.serial);
+    GMPY_MPFR_EXCEPTIONS(result, context);
+    return (PyObject*)result;
+}
+
+/* Apply func to the operands x and y. The result has the larger of the
+ * precisions of the array operands. If inplace is set, the result is
+ * stored in x. Returns Py_NotImplemented if an operand is not an
+ * mpfr_array or a real number.
+ */
+
+static PyObject *
+mpfr_array_binary(PyObject *x, PyObject *y, mpfr_array_binop func, int inplace)
+{
+    MPFR_Array_Object *result, *a, *b;
+    mpfr_array_operand ox, oy;
+    CTXT_Object *context = NULL;
+    PyObject *out = NULL;
+    int rc;
+
+    CHECK_CONTEXT(context);
+
+    a = MPFR_Array_Check(x) ? (MPFR_Array_Object*)x : NULL;
+    b = MPFR_Array_Check(y) ? (MPFR_Array_Object*)y : NULL;
+
+    if (inplace && a) {
+        result = a;
+        Py_INCREF((PyObject*)result);
+    }
+    else if (!(result = GMPy_MPFR_Array_New(a ? (b && b->prec > a->prec ? b->prec : a->prec) : b->prec,
+                                            a ? a->size : b->size))) {
+        return NULL;
+    }
+
+    ox.temp = oy.temp = NULL;
+    if ((rc = mpfr_array_operand_init(&ox, x, result, context)) == 1 &&
+        (rc = mpfr_array_operand_init(&oy, y, result, context)) == 1) {
+        out = mpfr_array_run(result, &ox, &oy, NULL, func, context);
+    }
+    else {
+        Py_DECREF((PyObject*)result);
+    }
+    Py_XDECREF(ox.temp);
+    Py_XDECREF(oy.temp);
+    if (rc == 0) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    return out;
+}
+
+static PyObject *
+mpfr_array_unary(MPFR_Array_Object *x, mpfr_array_unop func)
+{
+    MPFR_Array_Object *result;
+    mpfr_array_operand ox;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = GMPy_MPFR_Array_New(x->prec, x->size))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    ox.data = x->data;
+    ox.step = x->step;
+    ox.temp = NULL;
+    return mpfr_array_run(result, &ox, NULL, func, NULL, context);
+}
+
+/* Store value in the elements of dest. value may be a real number, an
+ * mpfr_array, or a sequence of real numbers with the same length as dest.
+ * Returns 0 on success and -1 if an exception was raised.
+ */
+
+static int
+mpfr_array_assign(MPFR_Array_Object *dest, PyObject *value)
+{
+    PyObject *temp = NULL, *out;
+    mpfr_array_operand op;
+    CTXT_Object *context = NULL;
+    int rc;
+
+    CHECK_CONTEXT_M1(context);
+
+    /* Round real numbers directly to the precision of dest. */
+    if (!MPFR_Array_Check(value)) {
+        if (IS_REAL(value))
+            temp = (PyObject*)GMPy_MPFR_From_Real(value, dest->prec, context);
+        else
+            temp = (PyObject*)mpfr_array_from_sequence(value, dest->prec, context);
+        if (!temp) {
+            return -1;
+        }
+        value = temp;
+    }
+    if ((rc = mpfr_array_operand_init(&op, value, dest, context)) == 1) {
+        Py_INCREF((PyObject*)dest);
+        if ((out = mpfr_array_run(dest, &op, NULL, mpfr_set, NULL, context))) {
+            Py_DECREF(out);
+        }
+        else {
+            rc = -1;
+        }
+        Py_XDECREF(op.temp);
+    }
+    Py_XDECREF(temp);
+    return rc == 1 ? 0 : -1;
+}
+
+static PyObject *
+GMPy_MPFR_Array_Add_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_add, 0);
+}
+
+static PyObject *
+GMPy_MPFR_Array_Sub_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_sub, 0);
+}
+
+static PyObject *
+GMPy_MPFR_Array_Mul_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_mul, 0);
+}
+
+static PyObject *
+GMPy_MPFR_Array_TrueDiv_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_div, 0);
+}
+
+static PyObject *
+GMPy_MPFR_Array_InplaceAdd_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_add, 1);
+}
+
+static PyObject *
+GMPy_MPFR_Array_InplaceSub_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_sub, 1);
+}
+
+static PyObject *
+GMPy_MPFR_Array_InplaceMul_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_mul, 1);
+}
+
+static PyObject *
+GMPy_MPFR_Array_InplaceTrueDiv_Slot(PyObject *x, PyObject *y)
+{
+    return mpfr_array_binary(x, y, mpfr_div, 1);
+}
+
+static PyObject *
+GMPy_MPFR_Array_Minus_Slot(MPFR_Array_Object *x)
+{
+    return mpfr_array_unary(x, mpfr_neg);
+}
+
+static PyObject *
+GMPy_MPFR_Array_Abs_Slot(MPFR_Array_Object *x)
+{
+    return mpfr_array_unary(x, mpfr_abs);
+}
+
+/* mpfr_ceil() and friends don't take a rounding mode and may be macros. */
+
+static int
+mpfr_array_ceil(mpfr_ptr r, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+    return mpfr_ceil(r, x);
+}
+
+static int
+mpfr_array_floor(mpfr_ptr r, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+    return mpfr_floor(r, x);
+}
+
+static int
+mpfr_array_trunc(mpfr_ptr r, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+    return mpfr_trunc(r, x);
+}
+
+static int
+mpfr_array_round_away(mpfr_ptr r, mpfr_srcptr x, mpfr_rnd_t rnd)
+{
+    return mpfr_round(r, x);
+}
+
+/* The functions supported by apply(), sorted by name. */
+
+static const struct {
+    const char *name;
+    mpfr_array_unop func;
+} mpfr_array_functions[] = {
+    {"acos", mpfr_acos},
+    {"acosh", mpfr_acosh},
+    {"ai", mpfr_ai},
+    {"asin", mpfr_asin},
+    {"asinh", mpfr_asinh},
+    {"atan", mpfr_atan},
+    {"atanh", mpfr_atanh},
+    {"cbrt", mpfr_cbrt},
+    {"ceil", mpfr_array_ceil},
+    {"cos", mpfr_cos},
+    {"cosh", mpfr_cosh},
+    {"cot", mpfr_cot},
+    {"coth", mpfr_coth},
+    {"csc", mpfr_csc},
+    {"csch", mpfr_csch},
+    {"digamma", mpfr_digamma},
+    {"eint", mpfr_eint},
+    {"erf", mpfr_erf},
+    {"erfc", mpfr_erfc},
+    {"exp", mpfr_exp},
+    {"exp10", mpfr_exp10},
+    {"exp2", mpfr_exp2},
+    {"expm1", mpfr_expm1},
+    {"floor", mpfr_array_floor},
+    {"frac", mpfr_frac},
+    {"gamma", mpfr_gamma},
+    {"j0", mpfr_j0},
+    {"j1", mpfr_j1},
+    {"li2", mpfr_li2},
+    {"lngamma", mpfr_lngamma},
+    {"log", mpfr_log},
+    {"log10", mpfr_log10},
+    {"log1p", mpfr_log1p},
+    {"log2", mpfr_log2},
+    {"rec_sqrt", mpfr_rec_sqrt},
+    {"rint", mpfr_rint},
+    {"rint_ceil", mpfr_rint_ceil},
+    {"rint_floor", mpfr_rint_floor},
+    {"rint_round", mpfr_rint_round},
+    {"rint_trunc", mpfr_rint_trunc},
+    {"round_away", mpfr_array_round_away},
+    {"sec", mpfr_sec},
+    {"sech", mpfr_sech},
+    {"sin", mpfr_sin},
+    {"sinh", mpfr_sinh},
+    {"sqrt", mpfr_sqrt},
+    {"square", mpfr_sqr},
+    {"tan", mpfr_tan},
+    {"tanh", mpfr_tanh},
+    {"trunc", mpfr_array_trunc},
+    {"y0", mpfr_y0},
+    {"y1", mpfr_y1},
+    {"zeta", mpfr_zeta},
+};
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_apply,
+"x.apply(func, /) -> mpfr_array\n\n"
+"Return a new mpfr_array with func applied to each element of x. func is\n"
+"the name of a gmpy2 function, e.g. 'sin', or the function itself. The\n"
+"supported functions are the single-valued real functions of one argument:\n"
+"acos, acosh, ai, asin, asinh, atan, atanh, cbrt, ceil, cos, cosh, cot,\n"
+"coth, csc, csch, digamma, eint, erf, erfc, exp, exp10, exp2, expm1, floor,\n"
+"frac, gamma, j0, j1, li2, lngamma, log, log10, log1p, log2, rec_sqrt,\n"
+"rint, rint_ceil, rint_floor, rint_round, rint_trunc, round_away, sec,\n"
+"sech, sin, sinh, sqrt, square, tan, tanh, trunc, y0, y1, and zeta.\n\n"
+"The results are always real; an argument outside the domain of func\n"
+"produces NaN.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Apply(PyObject *self, PyObject *func)
+{
+    PyObject *name;
+    const char *s;
+    size_t i;
+
+    if (PyUnicode_Check(func)) {
+        Py_INCREF(func);
+        name = func;
+    }
+    else if (!(name = PyObject_GetAttrString(func, "__name__")) ||
+             !PyUnicode_Check(name)) {
+        Py_XDECREF(name);
+        PyErr_Clear();
+        TYPE_ERROR("apply() requires a function or the name of a function");
+        return NULL;
+    }
+    if (!(s = PyUnicode_AsUTF8(name))) {
+        Py_DECREF(name);
+        return NULL;
+    }
+    for (i = 0; i < sizeof(mpfr_array_functions) / sizeof(mpfr_array_functions[0]); i++) {
+        if (!strcmp(s, mpfr_array_functions[i].name)) {
+            Py_DECREF(name);
+            return mpfr_array_unary((MPFR_Array_Object*)self,
+                                    mpfr_array_functions[i].func);
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "apply() does not support '%s'", s);
+    Py_DECREF(name);
+    return NULL;
+}
+
+/* Return an array of pointers to the elements of x. */
+
+static mpfr_ptr *
+mpfr_array_pointers(MPFR_Array_Object *x)
+{
+    mpfr_ptr *result;
+    Py_ssize_t i;
+
+    if (!(result = PyMem_Malloc((x->size ? x->size : 1) * sizeof(mpfr_ptr)))) {
+        /* LCOV_EXCL_START */
+        return (mpfr_ptr*)PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < x->size; i++) {
+        result[i] = MPFR_ARRAY_ITEM(x, i);
+    }
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_sum,
+"x.sum() -> mpfr\n\n"
+"Return the correctly rounded sum of the elements of x using the\n"
+"precision of the current context.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Sum(PyObject *self, PyObject *other)
+{
+    MPFR_Array_Object *x = (MPFR_Array_Object*)self;
+    MPFR_Object *result;
+    CTXT_Object *context = NULL;
+    mpfr_ptr *p;
+
+    CHECK_CONTEXT(context);
+
+    if (!(p = mpfr_array_pointers(x))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if ((result = GMPy_MPFR_New(0, context))) {
+        mpfr_clear_flags();
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        result->rc = mpfr_sum(result->f, p, (unsigned long)x->size,
+                              GET_MPFR_ROUND(context));
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        GMPY_MPFR_CLEANUP(result, context);
+    }
+    PyMem_Free(p);
+    return (PyObject*)result;
+}
+
+/* Set rop to the dot product of x and y with a single rounding. */
+
+static int
+mpfr_array_dot(mpfr_ptr rop, MPFR_Array_Object *x, MPFR_Array_Object *y,
+               mpfr_rnd_t rnd, CTXT_Object *context)
+{
+    mpfr_ptr *p, *q = NULL;
+    int rc = 0;
+
+    if (!(p = mpfr_array_pointers(x)) || !(q = mpfr_array_pointers(y))) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(p);
+        return -2;
+        /* LCOV_EXCL_STOP */
+    }
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    rc = mpfr_dot(rop, p, q, (unsigned long)x->size, rnd);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    PyMem_Free(p);
+    PyMem_Free(q);
+    return rc;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_dot,
+"x.dot(y, /) -> mpfr\n\n"
+"Return the correctly rounded dot product of x and y, which must be\n"
+"mpfr_array objects with the same length, using the precision of the\n"
+"current context.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Dot(PyObject *self, PyObject *other)
+{
+    MPFR_Array_Object *x = (MPFR_Array_Object*)self;
+    MPFR_Object *result;
+    CTXT_Object *context = NULL;
+    int rc;
+
+    CHECK_CONTEXT(context);
+
+    if (!MPFR_Array_Check(other)) {
+        TYPE_ERROR("dot() requires an mpfr_array argument");
+        return NULL;
+    }
+    if (x->size != ((MPFR_Array_Object*)other)->size) {
+        VALUE_ERROR("mpfr_array operands must have the same length");
+        return NULL;
+    }
+    if ((result = GMPy_MPFR_New(0, context))) {
+        mpfr_clear_flags();
+        rc = mpfr_array_dot(result->f, x, (MPFR_Array_Object*)other,
+                            GET_MPFR_ROUND(context), context);
+        if (rc == -2) {
+            /* LCOV_EXCL_START */
+            Py_DECREF((PyObject*)result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        result->rc = rc;
+        GMPY_MPFR_CLEANUP(result, context);
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_norm,
+"x.norm() -> mpfr\n\n"
+"Return the Euclidean norm sqrt(x.dot(x)) using the precision of the\n"
+"current context. The sum of squares is computed with twice the\n"
+"precision so the result is accurate to within one ulp.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Norm(PyObject *self, PyObject *other)
+{
+    MPFR_Array_Object *x = (MPFR_Array_Object*)self;
+    MPFR_Object *result;
+    CTXT_Object *context = NULL;
+    mpfr_t temp;
+    mpfr_prec_t prec;
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = GMPy_MPFR_New(0, context))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    prec = 2 * mpfr_get_prec(result->f) + 32;
+    if (prec > MPFR_PREC_MAX) {
+        prec = MPFR_PREC_MAX;
+    }
+    mpfr_init2(temp, prec);
+    mpfr_clear_flags();
+    if (mpfr_array_dot(temp, x, x, MPFR_RNDN, context) == -2) {
+        /* LCOV_EXCL_START */
+        mpfr_clear(temp);
+        Py_DECREF((PyObject*)result);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    result->rc = mpfr_sqrt(result->f, temp, GET_MPFR_ROUND(context));
+    mpfr_clear(temp);
+    GMPY_MPFR_CLEANUP(result, context);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_copy,
+"x.copy() -> mpfr_array\n\n"
+"Return a new mpfr_array with a copy of the elements of x.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_Copy(PyObject *self, PyObject *other)
+{
+    return (PyObject*)mpfr_array_copy((MPFR_Array_Object*)self);
+}
+
+static PyObject *
+mpfr_array_getitem(MPFR_Array_Object *self, Py_ssize_t i)
+{
+    MPFR_Object *result;
+
+    if ((result = GMPy_MPFR_New(self->prec, NULL))) {
+        mpfr_set(result->f, MPFR_ARRAY_ITEM(self, i), MPFR_RNDN);
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array_method_tolist,
+"x.tolist() -> list[mpfr]\n\n"
+"Return the elements of x as a list of mpfr.");
+
+static PyObject *
+GMPy_MPFR_Array_Method_ToList(PyObject *self, PyObject *other)
+{
+    MPFR_Array_Object *x = (MPFR_Array_Object*)self;
+    PyObject *result, *temp;
+    Py_ssize_t i;
+
+    if (!(result = PyList_New(x->size))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < x->size; i++) {
+        if (!(temp = mpfr_array_getitem(x, i))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        PyList_SET_ITEM(result, i, temp);
+    }
+    return result;
+}
+
+static Py_ssize_t
+GMPy_MPFR_Array_Length_Slot(MPFR_Array_Object *self)
+{
+    return self->size;
+}
+
+static PyObject *
+GMPy_MPFR_Array_Item_Slot(MPFR_Array_Object *self, Py_ssize_t i)
+{
+    if (i < 0 || i >= self->size) {
+        PyErr_SetString(PyExc_IndexError, "mpfr_array index out of range");
+        return NULL;
+    }
+    return mpfr_array_getitem(self, i);
+}
+
+static PyObject *
+GMPy_MPFR_Array_Subscript_Slot(MPFR_Array_Object *self, PyObject *item)
+{
+    Py_ssize_t i, start, stop, step, size;
+
+    if (PyIndex_Check(item)) {
+        if ((i = PyNumber_AsSsize_t(item, PyExc_IndexError)) == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (i < 0) {
+            i += self->size;
+        }
+        return GMPy_MPFR_Array_Item_Slot(self, i);
+    }
+    if (PySlice_Check(item)) {
+        if (PySlice_GetIndicesEx(item, self->size, &start, &stop, &step, &size) < 0) {
+            return NULL;
+        }
+        return (PyObject*)GMPy_MPFR_Array_View(self, start, step, size);
+    }
+    TYPE_ERROR("mpfr_array indices must be integers or slices");
+    return NULL;
+}
+
+static int
+GMPy_MPFR_Array_AssignSubscript_Slot(MPFR_Array_Object *self, PyObject *item,
+                                     PyObject *value)
+{
+    MPFR_Array_Object *view;
+    Py_ssize_t i, start, stop, step, size;
+    int rc;
+
+    if (!value) {
+        TYPE_ERROR("mpfr_array doesn't support item deletion");
+        return -1;
+    }
+    if (PyIndex_Check(item)) {
+        if ((i = PyNumber_AsSsize_t(item, PyExc_IndexError)) == -1 && PyErr_Occurred()) {
+            return -1;
+        }
+        if (i < 0) {
+            i += self->size;
+        }
+        if (i < 0 || i >= self->size) {
+            PyErr_SetString(PyExc_IndexError, "mpfr_array index out of range");
+            return -1;
+        }
+        if (!IS_REAL(value)) {
+            TYPE_ERROR("mpfr_array elements must be real numbers");
+            return -1;
+        }
+        start = i;
+        step = 1;
+        size = 1;
+    }
+    else if (PySlice_Check(item)) {
+        if (PySlice_GetIndicesEx(item, self->size, &start, &stop, &step, &size) < 0) {
+            return -1;
+        }
+    }
+    else {
+        TYPE_ERROR("mpfr_array indices must be integers or slices");
+        return -1;
+    }
+    if (!(view = GMPy_MPFR_Array_View(self, start, step, size))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    rc = mpfr_array_assign(view, value);
+    Py_DECREF((PyObject*)view);
+    return rc;
+}
+
+static PyObject *
+GMPy_MPFR_Array_GetPrec_Attrib(MPFR_Array_Object *self, void *closure)
+{
+    return PyLong_FromSsize_t((Py_ssize_t)self->prec);
+}
+
+static PyObject *
+GMPy_MPFR_Array_Repr_Slot(MPFR_Array_Object *self)
+{
+    PyObject *values, *result;
+
+    if (!(values = GMPy_MPFR_Array_Method_ToList((PyObject*)self, NULL))) {
+        return NULL;
+    }
+    result = PyUnicode_FromFormat("mpfr_array(%R, %ld)", values, (long)self->prec);
+    Py_DECREF(values);
+    return result;
+}
+
+static PyObject *
+GMPy_MPFR_Array_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    PyObject *arg;
+    CTXT_Object *context = NULL;
+    Py_ssize_t size;
+    long prec = 0;
+    static char *kwlist[] = {"", "precision", NULL};
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|l", kwlist, &arg, &prec)) {
+        return NULL;
+    }
+    if (prec == 0) {
+        prec = GET_MPFR_PREC(context);
+    }
+    if (prec < MPFR_PREC_MIN || prec > MPFR_PREC_MAX) {
+        VALUE_ERROR("invalid value for precision");
+        return NULL;
+    }
+
+    if (PyIndex_Check(arg)) {
+        if ((size = PyNumber_AsSsize_t(arg, PyExc_OverflowError)) == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (size < 0) {
+            VALUE_ERROR("mpfr_array() length must be >= 0");
+            return NULL;
+        }
+        return (PyObject*)GMPy_MPFR_Array_New((mpfr_prec_t)prec, size);
+    }
+    return (PyObject*)mpfr_array_from_sequence(arg, (mpfr_prec_t)prec, context);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpfr_array,
+"mpfr_array(n, /, precision=0)\n"
+"mpfr_array(iterable, /, precision=0)\n\n"
+"Return a fixed length array of mpfr values that all have the same\n"
+"precision. The first form creates n zeros; the second form rounds each\n"
+"real number in iterable to the precision. If precision is 0, the\n"
+"precision of the current context is used.\n\n"
+"The significands are stored in one contiguous block of memory. Indexing\n"
+"returns an mpfr and slicing returns a view that shares the storage of\n"
+"the array. Elements and slices may be assigned real numbers, sequences\n"
+"of real numbers, or other arrays.\n\n"
+"The operators +, -, *, and / (with another mpfr_array of the same length\n"
+"or a real number) and the functions applied by apply() work element-wise\n"
+"without holding the GIL. Results are rounded to the largest precision\n"
+"of the array operands using the rounding mode, exponent range, and\n"
+"subnormalization of the current context, and the context flags and\n"
+"traps are updated once for the whole array.");
+
+static PyNumberMethods GMPy_MPFR_Array_number_methods = {
+    .nb_add = (binaryfunc) GMPy_MPFR_Array_Add_Slot,
+    .nb_subtract = (binaryfunc) GMPy_MPFR_Array_Sub_Slot,
+    .nb_multiply = (binaryfunc) GMPy_MPFR_Array_Mul_Slot,
+    .nb_negative = (unaryfunc) GMPy_MPFR_Array_Minus_Slot,
+    .nb_absolute = (unaryfunc) GMPy_MPFR_Array_Abs_Slot,
+    .nb_inplace_add = (binaryfunc) GMPy_MPFR_Array_InplaceAdd_Slot,
+    .nb_inplace_subtract = (binaryfunc) GMPy_MPFR_Array_InplaceSub_Slot,
+    .nb_inplace_multiply = (binaryfunc) GMPy_MPFR_Array_InplaceMul_Slot,
+    .nb_true_divide = (binaryfunc) GMPy_MPFR_Array_TrueDiv_Slot,
+    .nb_inplace_true_divide = (binaryfunc) GMPy_MPFR_Array_InplaceTrueDiv_Slot,
+};
+
+static PySequenceMethods GMPy_MPFR_Array_sequence_methods = {
+    .sq_length = (lenfunc) GMPy_MPFR_Array_Length_Slot,
+    .sq_item = (ssizeargfunc) GMPy_MPFR_Array_Item_Slot,
+};
+
+static PyMappingMethods GMPy_MPFR_Array_mapping_methods = {
+    .mp_length = (lenfunc) GMPy_MPFR_Array_Length_Slot,
+    .mp_subscript = (binaryfunc) GMPy_MPFR_Array_Subscript_Slot,
+    .mp_ass_subscript = (objobjargproc) GMPy_MPFR_Array_AssignSubscript_Slot,
+};
+
+static PyGetSetDef GMPy_MPFR_Array_getseters[] = {
+    { "precision", (getter)GMPy_MPFR_Array_GetPrec_Attrib, NULL,
+        "precision in bits of the elements", NULL },
+    {NULL}
+};
+
+static PyMethodDef GMPy_MPFR_Array_methods[] = {
+    { "apply", GMPy_MPFR_Array_Method_Apply, METH_O, GMPy_doc_mpfr_array_method_apply },
+    { "copy", GMPy_MPFR_Array_Method_Copy, METH_NOARGS, GMPy_doc_mpfr_array_method_copy },
+    { "dot", GMPy_MPFR_Array_Method_Dot, METH_O, GMPy_doc_mpfr_array_method_dot },
+    { "norm", GMPy_MPFR_Array_Method_Norm, METH_NOARGS, GMPy_doc_mpfr_array_method_norm },
+    { "sum", GMPy_MPFR_Array_Method_Sum, METH_NOARGS, GMPy_doc_mpfr_array_method_sum },
+    { "tolist", GMPy_MPFR_Array_Method_ToList, METH_NOARGS, GMPy_doc_mpfr_array_method_tolist },
+    { NULL }
+};
+
+static PyTypeObject MPFR_Array_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mpfr_array",
+    .tp_basicsize = sizeof(MPFR_Array_Object),
+    .tp_dealloc = (destructor) GMPy_MPFR_Array_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MPFR_Array_Repr_Slot,
+    .tp_as_number = &GMPy_MPFR_Array_number_methods,
+    .tp_as_sequence = &GMPy_MPFR_Array_sequence_methods,
+    .tp_as_mapping = &GMPy_MPFR_Array_mapping_methods,
+    .tp_hash = PyObject_HashNotImplemented,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mpfr_array,
+    .tp_methods = GMPy_MPFR_Array_methods,
+    .tp_getset = GMPy_MPFR_Array_getseters,
+    .tp_new = GMPy_MPFR_Array_NewInit,
+};
@@ -0,0 +1,59 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpfr_array.h                                                      *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_MPFR_ARRAY_H
+#define GMPY_MPFR_ARRAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A fixed length array of mpfr values that all have the same precision.
+ * The significands are stored in a single block of limbs and the mpfr
+ * structures in a second block, both owned by the array that allocated
+ * them. A view created by slicing refers to the storage of its base array
+ * using its own start and step.
+ */
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *base;        /* array that owns the storage, or NULL */
+    mpfr_prec_t prec;
+    Py_ssize_t size;       /* number of elements */
+    Py_ssize_t step;       /* distance between elements, may be negative */
+    __mpfr_struct *data;   /* first element */
+    __mpfr_struct *elems;  /* owned storage, NULL for a view */
+    mp_limb_t *limbs;
+} MPFR_Array_Object;
+
+static PyTypeObject MPFR_Array_Type;
+#define MPFR_Array_Check(v) (((PyObject*)v)->ob_type == &MPFR_Array_Type)
+
+static PyObject * GMPy_MPFR_Array_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static void GMPy_MPFR_Array_Dealloc(MPFR_Array_Object *self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
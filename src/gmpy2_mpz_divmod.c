@@ -431,3 +431,365 @@ GMPy_MPZ_t_mod(PyObject *self, PyObject *args)
     Py_XDECREF((PyObject*)r);
     return NULL;
 }
+
+/*
+ **************************************************************************
+ * Division of many integers by a common divisor.
+ **************************************************************************
+ */
+
+#define DIV_WANT_Q 1
+#define DIV_WANT_R 2
+
+static void
+gmpy_divisor_init(gmpy_divisor *d, mpz_srcptr z)
+{
+    size_t bits;
+
+    mpz_init(d->abs);
+    mpz_abs(d->abs, z);
+    d->negative = mpz_sgn(z) < 0;
+    d->shift = mpz_scan1(d->abs, 0);
+    d->word = 0;
+    d->mul = 0;
+    d->bits = 0;
+
+    bits = mpz_sizeinbase(d->abs, 2);
+    if (bits <= 64) {
+        mpz_export(&d->word, NULL, -1, sizeof(uint64_t), 0, 0, d->abs);
+    }
+    if (bits - 1 == d->shift) {
+        d->kind = GMPY_DIVISOR_POW2;
+    }
+    else if (bits <= 64) {
+        d->kind = GMPY_DIVISOR_WORD;
+        /* With l = ceil(log2(d)), mul = floor(2**64 * (2**l - d) / d) + 1
+         * and n // d == (t + ((n - t) >> 1)) >> (l - 1) where t is the high
+         * word of mul * n.
+         */
+        d->bits = (int)mpz_sizeinbase(d->abs, 2);
+#if defined(__SIZEOF_INT128__)
+        d->mul = (uint64_t)(((unsigned __int128)((d->bits == 64 ? 0 : (uint64_t)1 << d->bits) - d->word) << 64) / d->word) + 1;
+#endif
+    }
+    else {
+        d->kind = GMPY_DIVISOR_MPZ;
+    }
+}
+
+static void
+gmpy_divisor_clear(gmpy_divisor *d)
+{
+    mpz_clear(d->abs);
+}
+
+/* Return n // d for a divisor of kind GMPY_DIVISOR_WORD. */
+
+static inline uint64_t
+gmpy_divisor_word_div(uint64_t n, const gmpy_divisor *d)
+{
+#if defined(__SIZEOF_INT128__)
+    uint64_t t = (uint64_t)(((unsigned __int128)d->mul * n) >> 64);
+
+    return (t + ((n - t) >> 1)) >> (d->bits - 1);
+#else
+    return n / d->word;
+#endif
+}
+
+/* Division by a negative divisor is division by its absolute value with
+ * ceiling and floor rounding exchanged, followed by negating the quotient.
+ */
+
+static int
+gmpy_divisor_mode(const gmpy_divisor *d, int mode)
+{
+    if (d->negative && mode != 't')
+        return mode == 'c' ? 'f' : 'c';
+    return mode;
+}
+
+/* Set q and/or r (either may be NULL) to the quotient and remainder of x
+ * divided by d. mode is 'c', 'f', or 't' for ceiling, floor, or truncating
+ * division.
+ */
+
+static void
+gmpy_divisor_divmod(mpz_ptr q, mpz_ptr r, mpz_srcptr x, const gmpy_divisor *d,
+                    int mode)
+{
+    mode = gmpy_divisor_mode(d, mode);
+
+    if (d->kind == GMPY_DIVISOR_POW2) {
+        switch (mode) {
+        case 'c':
+            if (r) mpz_cdiv_r_2exp(r, x, d->shift);
+            if (q) mpz_cdiv_q_2exp(q, x, d->shift);
+            break;
+        case 'f':
+            if (r) mpz_fdiv_r_2exp(r, x, d->shift);
+            if (q) mpz_fdiv_q_2exp(q, x, d->shift);
+            break;
+        default:
+            if (r) mpz_tdiv_r_2exp(r, x, d->shift);
+            if (q) mpz_tdiv_q_2exp(q, x, d->shift);
+            break;
+        }
+    }
+    else if (q && r) {
+        switch (mode) {
+        case 'c': mpz_cdiv_qr(q, r, x, d->abs); break;
+        case 'f': mpz_fdiv_qr(q, r, x, d->abs); break;
+        default: mpz_tdiv_qr(q, r, x, d->abs); break;
+        }
+    }
+    else if (q) {
+        switch (mode) {
+        case 'c': mpz_cdiv_q(q, x, d->abs); break;
+        case 'f': mpz_fdiv_q(q, x, d->abs); break;
+        default: mpz_tdiv_q(q, x, d->abs); break;
+        }
+    }
+    else {
+        switch (mode) {
+        case 'c': mpz_cdiv_r(r, x, d->abs); break;
+        case 'f': mpz_fdiv_r(r, x, d->abs); break;
+        default: mpz_tdiv_r(r, x, d->abs); break;
+        }
+    }
+    if (q && d->negative) {
+        mpz_neg(q, q);
+    }
+}
+
+/* As gmpy_divisor_divmod() for the word-size numerator (-1)**xneg * xm.
+ * The divisor must be less than 2**64.
+ */
+
+static void
+gmpy_divisor_divmod_word(mpz_ptr q, mpz_ptr r, uint64_t xm, int xneg,
+                         const gmpy_divisor *d, int mode)
+{
+    uint64_t qm, rm;
+    int qneg = xneg ^ d->negative, rneg = xneg;
+
+    if (d->kind == GMPY_DIVISOR_POW2) {
+        qm = xm >> d->shift;
+        rm = xm & (d->word - 1);
+    }
+    else {
+        qm = gmpy_divisor_word_div(xm, d);
+        rm = xm - qm * d->word;
+    }
+    if (rm && ((mode == 'f' && qneg) || (mode == 'c' && !qneg))) {
+        qm++;
+        rm = d->word - rm;
+        rneg = !xneg;
+    }
+    if (q) {
+        mpz_set_uint64(q, qm);
+        if (qneg)
+            mpz_neg(q, q);
+    }
+    if (r) {
+        mpz_set_uint64(r, rm);
+        if (rneg)
+            mpz_neg(r, r);
+    }
+}
+
+/* Divide each integer in args[0] by args[1]. args[0] may be a sequence of
+ * integers or a one-dimensional buffer of native integers, such as a NumPy
+ * array. Returns a list of quotients, a list of remainders, or a tuple of
+ * both, depending on want.
+ */
+
+static PyObject *
+mpz_divmod_many(PyObject *const *args, Py_ssize_t nargs, int mode, int want,
+                const char *name)
+{
+    PyObject *q = NULL, *r = NULL, *result = NULL;
+    MPZ_Object *y, **x = NULL;
+    Py_buffer view;
+    gmpy_divisor d;
+    Py_ssize_t i, n = 0;
+    unsigned long serial;
+    char code = 0;
+    char msg[80];
+
+    if (nargs != 2) {
+        PyErr_Format(PyExc_TypeError, "%s() requires 2 arguments", name);
+        return NULL;
+    }
+    if (!(y = GMPy_MPZ_From_Integer(args[1], NULL))) {
+        PyErr_Format(PyExc_TypeError, "%s() requires an integer divisor", name);
+        return NULL;
+    }
+    if (mpz_sgn(y->z) == 0) {
+        PyErr_Format(PyExc_ZeroDivisionError, "%s() division by 0", name);
+        Py_DECREF((PyObject*)y);
+        return NULL;
+    }
+
+    /* Use a buffer of native integers directly. */
+    view.obj = NULL;
+    if (PyObject_CheckBuffer(args[0])) {
+        if (PyObject_GetBuffer(args[0], &view, PyBUF_RECORDS_RO) < 0) {
+            Py_DECREF((PyObject*)y);
+            return NULL;
+        }
+        code = np_buffer_code(view.format, view.itemsize);
+        if (view.ndim != 1 || !code || NP_IS_FLOAT(code) || code == 'O') {
+            PyBuffer_Release(&view);
+            view.obj = NULL;
+        }
+        else {
+            n = view.shape[0];
+        }
+    }
+    if (!view.obj) {
+        PyOS_snprintf(msg, sizeof(msg), "%s() requires a sequence of integers", name);
+        if (!(x = GMPy_MPZ_Many_From_Seq(args[0], &n, msg))) {
+            Py_DECREF((PyObject*)y);
+            return NULL;
+        }
+    }
+
+    if (((want & DIV_WANT_Q) && !(q = GMPy_MPZ_Many_New(n))) ||
+        ((want & DIV_WANT_R) && !(r = GMPy_MPZ_Many_New(n)))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    gmpy_divisor_init(&d, y->z);
+    serial = gmpy_progress_begin(name, n);
+    Py_BEGIN_ALLOW_THREADS;
+    if (view.obj && d.kind != GMPY_DIVISOR_MPZ && d.shift < 64) {
+        for (i = 0; i < n; i++) {
+            uint64_t xm;
+            int xneg;
+
+            xneg = np_get_word((const char*)view.buf + i * view.strides[0],
+                               code, view.itemsize, &xm);
+            gmpy_divisor_divmod_word(q ? MPZ(PyList_GET_ITEM(q, i)) : NULL,
+                                     r ? MPZ(PyList_GET_ITEM(r, i)) : NULL,
+                                     xm, xneg, &d, mode);
+            if (!(i & GMPY_PROGRESS_MASK))
+                gmpy_progress_update(serial, i);
+        }
+    }
+    else if (view.obj) {
+        mpz_t temp;
+
+        mpz_init(temp);
+        for (i = 0; i < n; i++) {
+            np_get_integer(temp, (const char*)view.buf + i * view.strides[0],
+                           code, view.itemsize);
+            gmpy_divisor_divmod(q ? MPZ(PyList_GET_ITEM(q, i)) : NULL,
+                                r ? MPZ(PyList_GET_ITEM(r, i)) : NULL,
+                                temp, &d, mode);
+            if (!(i & GMPY_PROGRESS_MASK))
+                gmpy_progress_update(serial, i);
+        }
+        mpz_clear(temp);
+    }
+    else {
+        for (i = 0; i < n; i++) {
+            gmpy_divisor_divmod(q ? MPZ(PyList_GET_ITEM(q, i)) : NULL,
+                                r ? MPZ(PyList_GET_ITEM(r, i)) : NULL,
+                                x[i]->z, &d, mode);
+            if (!(i & GMPY_PROGRESS_MASK))
+                gmpy_progress_update(serial, i);
+        }
+    }
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+    gmpy_divisor_clear(&d);
+
+    if (q && r) {
+        result = PyTuple_Pack(2, q, r);
+    }
+    else {
+        result = q ? q : r;
+        Py_INCREF(result);
+    }
+
+  done:
+    Py_XDECREF(q);
+    Py_XDECREF(r);
+    if (view.obj) {
+        PyBuffer_Release(&view);
+    }
+    GMPy_MPZ_Many_Free(x, n);
+    Py_DECREF((PyObject*)y);
+    return result;
+}
+
+#define GMPY_MPZ_DIVMOD_MANY(NAME, MODE, WANT) \
+static PyObject * \
+GMPy_MPZ_##NAME##_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs) \
+{ \
+    return mpz_divmod_many(args, nargs, MODE, WANT, #NAME "_many"); \
+}
+
+PyDoc_STRVAR(doc_c_div_many,
+"c_div_many(x_lst, y, /) -> list[mpz]\n\n"
+"Return the list of c_div(x, y) for each x in x_lst. x_lst may be a\n"
+"sequence of integers or a one-dimensional buffer of native integers,\n"
+"e.g. a NumPy array. The divisor y is prepared once: a power of two is\n"
+"applied with shifts and a divisor less than 2**64 uses a precomputed\n"
+"reciprocal for word-size values. Will always release the GIL.");
+
+GMPY_MPZ_DIVMOD_MANY(c_div, 'c', DIV_WANT_Q)
+
+PyDoc_STRVAR(doc_c_mod_many,
+"c_mod_many(x_lst, y, /) -> list[mpz]\n\n"
+"Return the list of c_mod(x, y) for each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(c_mod, 'c', DIV_WANT_R)
+
+PyDoc_STRVAR(doc_c_divmod_many,
+"c_divmod_many(x_lst, y, /) -> tuple[list[mpz], list[mpz]]\n\n"
+"Return the lists of quotients and remainders of c_divmod(x, y) for\n"
+"each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(c_divmod, 'c', DIV_WANT_Q | DIV_WANT_R)
+
+PyDoc_STRVAR(doc_f_div_many,
+"f_div_many(x_lst, y, /) -> list[mpz]\n\n"
+"Return the list of f_div(x, y) for each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(f_div, 'f', DIV_WANT_Q)
+
+PyDoc_STRVAR(doc_f_mod_many,
+"f_mod_many(x_lst, y, /) -> list[mpz]\n\n"
+"Return the list of f_mod(x, y) for each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(f_mod, 'f', DIV_WANT_R)
+
+PyDoc_STRVAR(doc_f_divmod_many,
+"f_divmod_many(x_lst, y, /) -> tuple[list[mpz], list[mpz]]\n\n"
+"Return the lists of quotients and remainders of f_divmod(x, y) for\n"
+"each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(f_divmod, 'f', DIV_WANT_Q | DIV_WANT_R)
+
+PyDoc_STRVAR(doc_t_div_many,
+"t_div_many(x_lst, y, /) -> list[mpz]\n\n"
+"Return the list of t_div(x, y) for each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(t_div, 't', DIV_WANT_Q)
+
+PyDoc_STRVAR(doc_t_mod_many,
+"t_mod_many(x_lst, y, /) -> list[mpz]\n\n"
+"Return the list of t_mod(x, y) for each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(t_mod, 't', DIV_WANT_R)
+
+PyDoc_STRVAR(doc_t_divmod_many,
+"t_divmod_many(x_lst, y, /) -> tuple[list[mpz], list[mpz]]\n\n"
+"Return the lists of quotients and remainders of t_divmod(x, y) for\n"
+"each x in x_lst. See c_div_many().");
+
+GMPY_MPZ_DIVMOD_MANY(t_divmod, 't', DIV_WANT_Q | DIV_WANT_R)
@@ -41,6 +41,41 @@ static PyObject * GMPy_MPZ_t_divmod(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_t_div(PyObject *self, PyObject *args);
 static PyObject * GMPy_MPZ_t_mod(PyObject *self, PyObject *args);
 
+/* A divisor shared by many divisions. The work that only depends on the
+ * divisor is done once by gmpy_divisor_init(). A power of two is handled
+ * with shifts and a divisor less than 2**64 has a precomputed multiplier
+ * (Granlund and Montgomery) so that word-size numerators are divided
+ * without a division instruction.
+ */
+
+#define GMPY_DIVISOR_POW2  1    /* |d| == 2**shift */
+#define GMPY_DIVISOR_WORD  2    /* |d| < 2**64 and not a power of two */
+#define GMPY_DIVISOR_MPZ   3
+
+typedef struct {
+    int kind;
+    int negative;
+    mp_bitcnt_t shift;
+    uint64_t word;          /* |d| if it is less than 2**64 */
+    uint64_t mul;           /* multiplier for GMPY_DIVISOR_WORD */
+    int bits;               /* ceil(log2(word)) for GMPY_DIVISOR_WORD */
+    mpz_t abs;              /* |d| */
+} gmpy_divisor;
+
+static void gmpy_divisor_init(gmpy_divisor *d, mpz_srcptr z);
+static void gmpy_divisor_clear(gmpy_divisor *d);
+static void gmpy_divisor_divmod(mpz_ptr q, mpz_ptr r, mpz_srcptr x, const gmpy_divisor *d, int mode);
+
+static PyObject * GMPy_MPZ_c_div_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_c_mod_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_c_divmod_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_f_div_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_f_mod_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_f_divmod_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_t_div_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_t_mod_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_t_divmod_many(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,535 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpz_dlog.c                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Discrete logarithms modulo p.
+ *
+ * discrete_log(g, h, p) finds x such that g**x == h (mod p). The order of
+ * the group (p-1 for prime p, or the value given by 'order') is factored
+ * and the problem is split into subgroups of prime order q using the
+ * Pohlig-Hellman method. Each prime order subproblem is solved with:
+ *
+ *   - baby-step giant-step if q < 2**DLOG_BSGS_BITS. The baby steps are
+ *     stored in an open addressing hash table keyed by the least
+ *     significant limb of the group element.
+ *
+ *   - Pollard's rho method with an r-adding walk and Brent's cycle
+ *     detection for larger q. It uses constant memory.
+ *
+ * All the work is done on mpz_t values so the GIL can be released for the
+ * entire computation.
+ */
+
+#define DLOG_BSGS_BITS 36
+#define DLOG_RHO_R     20
+#define DLOG_RHO_TRIES 16
+
+/* Rho steps between checks for pending signals. */
+
+#define DLOG_RHO_CHUNK 65536
+
+/* Results of dlog_solve() besides 1 (found) and 0 (no solution). */
+
+#define DLOG_NOMEM      -1
+#define DLOG_NOFACTOR   -2
+#define DLOG_RHO_FAILED -3
+#define DLOG_INTERRUPT  -4
+
+typedef struct {
+    mp_limb_t key;
+    unsigned long index;   /* baby step index + 1, 0 if the slot is empty */
+} dlog_entry;
+
+/* Solve g**x == h (mod p) where g has prime order q using baby-step
+ * giant-step. Returns 1 if x was found, 0 if h is not a power of g, and
+ * -1 if memory could not be allocated.
+ */
+
+static int
+dlog_bsgs(mpz_t x, const mpz_t g, const mpz_t h, const mpz_t q, const mpz_t p)
+{
+    dlog_entry *table;
+    unsigned long m, i, j, size, mask, slot;
+    mpz_t e, y, t;
+    int result = 0;
+
+    mpz_init(e);
+    mpz_init(y);
+    mpz_init(t);
+
+    mpz_sqrt(e, q);
+    m = mpz_get_ui(e) + 1;
+    for (size = 1; size < 2 * m; size <<= 1);
+    mask = size - 1;
+
+    if (!(table = calloc(size, sizeof(dlog_entry)))) {
+        /* LCOV_EXCL_START */
+        result = -1;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+
+    /* Baby steps: store g**j for 0 <= j < m. */
+    mpz_set_ui(e, 1);
+    for (j = 0; j < m; j++) {
+        slot = (unsigned long)(mpz_getlimbn(e, 0) & mask);
+        while (table[slot].index) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot].key = mpz_getlimbn(e, 0);
+        table[slot].index = j + 1;
+        mpz_mul(e, e, g);
+        mpz_mod(e, e, p);
+    }
+
+    /* Giant steps: compare h*g**(-i*m) with the baby steps. */
+    if (!mpz_invert(e, e, p)) {
+        /* LCOV_EXCL_START */
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_set(y, h);
+    for (i = 0; i < m; i++) {
+        slot = (unsigned long)(mpz_getlimbn(y, 0) & mask);
+        while (table[slot].index) {
+            if (table[slot].key == mpz_getlimbn(y, 0)) {
+                j = table[slot].index - 1;
+                mpz_powm_ui(t, g, j, p);
+                if (mpz_cmp(t, y) == 0) {
+                    mpz_set_ui(x, i);
+                    mpz_mul_ui(x, x, m);
+                    mpz_add_ui(x, x, j);
+                    mpz_mod(x, x, q);
+                    result = 1;
+                    goto cleanup;
+                }
+            }
+            slot = (slot + 1) & mask;
+        }
+        mpz_mul(y, y, e);
+        mpz_mod(y, y, p);
+    }
+
+  cleanup:
+    free(table);
+    mpz_clear(e);
+    mpz_clear(y);
+    mpz_clear(t);
+    return result;
+}
+
+static unsigned long
+dlog_rho_partition(const mpz_t y)
+{
+    mp_limb_t k = mpz_getlimbn(y, 0);
+
+    return (unsigned long)((k ^ (k >> 17)) % DLOG_RHO_R);
+}
+
+/* Solve g**x == h (mod p) where g has prime order q using Pollard's rho
+ * method with an r-adding walk. Returns 1 if x was found, DLOG_RHO_FAILED
+ * if every attempt failed, or DLOG_INTERRUPT if a signal handler raised an
+ * exception. Must be called with the GIL held; it is released and pending
+ * signals are checked every DLOG_RHO_CHUNK steps.
+ */
+
+static int
+dlog_rho(mpz_t x, const mpz_t g, const mpz_t h, const mpz_t q, const mpz_t p,
+         CTXT_Object *context)
+{
+    gmp_randstate_t state;
+    mpz_t ma[DLOG_RHO_R], mb[DLOG_RHO_R], mul[DLOG_RHO_R];
+    mpz_t y, a, b, ty, ta, tb, t;
+    unsigned long power, lam, k, steps;
+    int tries, i, found, result = DLOG_RHO_FAILED;
+
+    gmp_randinit_default(state);
+    gmp_randseed_ui(state, 42);
+    for (i = 0; i < DLOG_RHO_R; i++) {
+        mpz_init(ma[i]);
+        mpz_init(mb[i]);
+        mpz_init(mul[i]);
+    }
+    mpz_init(y);
+    mpz_init(a);
+    mpz_init(b);
+    mpz_init(ty);
+    mpz_init(ta);
+    mpz_init(tb);
+    mpz_init(t);
+
+    for (tries = 0; tries < DLOG_RHO_TRIES && result != 1; tries++) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        /* Each multiplier is g**ma[i] * h**mb[i]. */
+        for (i = 0; i < DLOG_RHO_R; i++) {
+            mpz_urandomm(ma[i], state, q);
+            mpz_urandomm(mb[i], state, q);
+            mpz_powm(mul[i], g, ma[i], p);
+            mpz_powm(t, h, mb[i], p);
+            mpz_mul(mul[i], mul[i], t);
+            mpz_mod(mul[i], mul[i], p);
+        }
+        mpz_urandomm(a, state, q);
+        mpz_urandomm(b, state, q);
+        mpz_powm(y, g, a, p);
+        mpz_powm(t, h, b, p);
+        mpz_mul(y, y, t);
+        mpz_mod(y, y, p);
+
+        mpz_set(ty, y);
+        mpz_set(ta, a);
+        mpz_set(tb, b);
+        power = lam = 1;
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+        for (found = 0; !found; ) {
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            for (steps = 0; steps < DLOG_RHO_CHUNK; steps++) {
+                k = dlog_rho_partition(y);
+                mpz_mul(y, y, mul[k]);
+                mpz_mod(y, y, p);
+                mpz_add(a, a, ma[k]);
+                if (mpz_cmp(a, q) >= 0) {
+                    mpz_sub(a, a, q);
+                }
+                mpz_add(b, b, mb[k]);
+                if (mpz_cmp(b, q) >= 0) {
+                    mpz_sub(b, b, q);
+                }
+                if (mpz_cmp(y, ty) == 0) {
+                    found = 1;
+                    break;
+                }
+                if (lam == power) {
+                    mpz_set(ty, y);
+                    mpz_set(ta, a);
+                    mpz_set(tb, b);
+                    power <<= 1;
+                    lam = 0;
+                }
+                lam++;
+            }
+            GMPY_MAYBE_END_ALLOW_THREADS(context);
+            if (!found && PyErr_CheckSignals() < 0) {
+                result = DLOG_INTERRUPT;
+                goto cleanup;
+            }
+        }
+
+        /* g**a * h**b == g**ta * h**tb so (b - tb)*x == ta - a (mod q). */
+        mpz_sub(t, b, tb);
+        if (!mpz_invert(t, t, q)) {
+            continue;
+        }
+        mpz_sub(x, ta, a);
+        mpz_mul(x, x, t);
+        mpz_mod(x, x, q);
+        mpz_powm(t, g, x, p);
+        if (mpz_cmp(t, h) == 0) {
+            result = 1;
+        }
+    }
+
+  cleanup:
+    for (i = 0; i < DLOG_RHO_R; i++) {
+        mpz_clear(ma[i]);
+        mpz_clear(mb[i]);
+        mpz_clear(mul[i]);
+    }
+    mpz_clear(y);
+    mpz_clear(a);
+    mpz_clear(b);
+    mpz_clear(ty);
+    mpz_clear(ta);
+    mpz_clear(tb);
+    mpz_clear(t);
+    gmp_randclear(state);
+    return result;
+}
+
+/* Solve g**x == h (mod p) where the order of g divides n and the distinct
+ * prime factors of n are in f. Returns 1 if x was found, 0 if no solution
+ * exists, or the result of dlog_rho() if it failed. Must be called with
+ * the GIL held; it is released during the computation.
+ */
+
+static int
+dlog_solve(mpz_t x, const mpz_t g, const mpz_t h, const mpz_t p,
+           const mpz_t n, prove_factors *f, CTXT_Object *context)
+{
+    mpz_t ord, qe, c, gq, hq, gamma, t, u, xq, qk, m;
+    Py_ssize_t i;
+    unsigned long e, k;
+    int result = 1, small;
+
+    mpz_init_set(ord, n);
+    mpz_init(qe);
+    mpz_init(c);
+    mpz_init(gq);
+    mpz_init(hq);
+    mpz_init(gamma);
+    mpz_init(t);
+    mpz_init(u);
+    mpz_init(xq);
+    mpz_init(qk);
+    mpz_init_set_ui(m, 1);
+    mpz_set_ui(x, 0);
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    /* Reduce n to the exact order of g. */
+    for (i = 0; i < f->count; i++) {
+        while (mpz_divisible_p(ord, f->q[i])) {
+            mpz_divexact(t, ord, f->q[i]);
+            mpz_powm(u, g, t, p);
+            if (mpz_cmp_ui(u, 1) != 0) {
+                break;
+            }
+            mpz_set(ord, t);
+        }
+    }
+
+    mpz_powm(t, h, ord, p);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (mpz_cmp_ui(t, 1) != 0) {
+        result = 0;
+        goto cleanup;
+    }
+
+    for (i = 0; i < f->count && result == 1; i++) {
+        mpz_set(c, ord);
+        e = (unsigned long)mpz_remove(c, c, f->q[i]);
+        if (e == 0) {
+            continue;
+        }
+        mpz_pow_ui(qe, f->q[i], e);
+        small = mpz_sizeinbase(f->q[i], 2) < DLOG_BSGS_BITS;
+
+        /* gq has order q**e and gamma has order q. */
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        mpz_powm(gq, g, c, p);
+        mpz_powm(hq, h, c, p);
+        mpz_pow_ui(t, f->q[i], e - 1);
+        mpz_powm(gamma, gq, t, p);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+        /* Find the base q digits of x mod q**e one at a time. g and p are
+         * coprime, so gq**xq is always invertible.
+         */
+        mpz_set_ui(xq, 0);
+        mpz_set_ui(qk, 1);
+        for (k = 0; k < e; k++) {
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            mpz_powm(t, gq, xq, p);
+            mpz_invert(t, t, p);
+            mpz_mul(t, t, hq);
+            mpz_mod(t, t, p);
+            mpz_pow_ui(u, f->q[i], e - 1 - k);
+            mpz_powm(t, t, u, p);
+            if (small) {
+                result = dlog_bsgs(u, gamma, t, f->q[i], p);
+            }
+            GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+            if (!small) {
+                result = dlog_rho(u, gamma, t, f->q[i], p, context);
+            }
+            if (result != 1) {
+                break;
+            }
+            mpz_addmul(xq, u, qk);
+            mpz_mul(qk, qk, f->q[i]);
+        }
+        if (result != 1) {
+            break;
+        }
+
+        /* Combine with the previous results using the CRT. */
+        mpz_invert(t, m, qe);
+        mpz_sub(u, xq, x);
+        mpz_mul(u, u, t);
+        mpz_mod(u, u, qe);
+        mpz_addmul(x, u, m);
+        mpz_mul(m, m, qe);
+    }
+
+    if (result == 1) {
+        mpz_mod(x, x, ord);
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        mpz_powm(t, g, x, p);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        result = (mpz_cmp(t, h) == 0);
+    }
+
+  cleanup:
+    mpz_clear(ord);
+    mpz_clear(qe);
+    mpz_clear(c);
+    mpz_clear(gq);
+    mpz_clear(hq);
+    mpz_clear(gamma);
+    mpz_clear(t);
+    mpz_clear(u);
+    mpz_clear(xq);
+    mpz_clear(qk);
+    mpz_clear(m);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_discrete_log,
+"discrete_log(g, h, p, /, order=None) -> mpz\n\n"
+"Return the smallest x >= 0 such that g**x == h (mod p). If order is\n"
+"not given, p must be prime and the group order is p-1. Otherwise\n"
+"order must be a multiple of the order of g. The group order is\n"
+"factored and the logarithm is computed using the Pohlig-Hellman\n"
+"method with baby-step giant-step or Pollard's rho method for each\n"
+"prime factor. Raises `ValueError` if no solution exists, and\n"
+"`RuntimeError` if Pollard's rho method fails for a prime factor, which\n"
+"can also happen when h is not a power of g in a non-cyclic group.");
+
+static PyObject *
+GMPy_MPZ_Function_DiscreteLog(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    MPZ_Object *result = NULL, *tempg = NULL, *temph = NULL, *tempp = NULL;
+    MPZ_Object *tempn = NULL;
+    PyObject *g, *h, *p, *order = Py_None;
+    static char *kwlist[] = {"", "", "", "order", NULL};
+    CTXT_Object *context = NULL;
+    prove_factors f;
+    mpz_t t;
+    Py_ssize_t i;
+    int rc = 0;
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OOO|O", kwlist,
+                                     &g, &h, &p, &order)) {
+        return NULL;
+    }
+
+    if (!(tempg = GMPy_MPZ_From_IntegerAndCopy(g, NULL)) ||
+        !(temph = GMPy_MPZ_From_IntegerAndCopy(h, NULL)) ||
+        !(tempp = GMPy_MPZ_From_Integer(p, NULL)) ||
+        (order != Py_None && !(tempn = GMPy_MPZ_From_IntegerAndCopy(order, NULL)))) {
+        TYPE_ERROR("discrete_log() requires 'mpz' arguments");
+        Py_XDECREF((PyObject*)tempg);
+        Py_XDECREF((PyObject*)temph);
+        Py_XDECREF((PyObject*)tempp);
+        return NULL;
+    }
+
+    if (mpz_cmp_ui(tempp->z, 2) < 0) {
+        VALUE_ERROR("discrete_log() requires 'p' > 1");
+        goto err;
+    }
+
+    if (!tempn) {
+        if (!mpz_probab_prime_p(tempp->z, 25)) {
+            VALUE_ERROR("discrete_log() requires 'order' if 'p' is not prime");
+            goto err;
+        }
+        if (!(tempn = GMPy_MPZ_New(NULL))) {
+            /* LCOV_EXCL_START */
+            goto err;
+            /* LCOV_EXCL_STOP */
+        }
+        mpz_sub_ui(tempn->z, tempp->z, 1);
+    }
+    else if (mpz_sgn(tempn->z) <= 0) {
+        VALUE_ERROR("discrete_log() requires 'order' > 0");
+        goto err;
+    }
+
+    mpz_mod(tempg->z, tempg->z, tempp->z);
+    mpz_mod(temph->z, temph->z, tempp->z);
+
+    mpz_init(t);
+    mpz_gcd(t, tempg->z, tempp->z);
+    if (mpz_cmp_ui(t, 1) != 0) {
+        mpz_clear(t);
+        VALUE_ERROR("discrete_log() requires gcd(g, p) == 1");
+        goto err;
+    }
+    mpz_powm(t, tempg->z, tempn->z, tempp->z);
+    if (mpz_cmp_ui(t, 1) != 0) {
+        mpz_clear(t);
+        VALUE_ERROR("discrete_log() requires 'order' to be a multiple of the order of 'g'");
+        goto err;
+    }
+    mpz_clear(t);
+
+    if (prove_init_small_primes() < 0 || !(result = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        goto err;
+        /* LCOV_EXCL_STOP */
+    }
+
+    prove_factors_init(&f);
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    rc = prove_find_factors(&f, tempn->z, NULL);
+    if (rc == 0) {
+        /* Check that the factorization is complete. */
+        mpz_init_set(t, tempn->z);
+        for (i = 0; i < f.count; i++) {
+            mpz_remove(t, t, f.q[i]);
+        }
+        rc = (mpz_cmp_ui(t, 1) == 0) ? 1 : DLOG_NOFACTOR;
+        mpz_clear(t);
+    }
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (rc == 1) {
+        rc = dlog_solve(result->z, tempg->z, temph->z, tempp->z, tempn->z,
+                        &f, context);
+    }
+    prove_factors_clear(&f);
+
+    if (rc == 1) {
+        Py_DECREF((PyObject*)tempg);
+        Py_DECREF((PyObject*)temph);
+        Py_DECREF((PyObject*)tempp);
+        Py_DECREF((PyObject*)tempn);
+        return (PyObject*)result;
+    }
+
+    if (rc == DLOG_NOMEM) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    else if (rc == DLOG_NOFACTOR) {
+        VALUE_ERROR("discrete_log() could not factor the group order");
+    }
+    else if (rc == DLOG_RHO_FAILED) {
+        RUNTIME_ERROR("discrete_log() failed, Pollard's rho method did not find the logarithm");
+    }
+    else if (rc == 0) {
+        VALUE_ERROR("discrete_log() no solution exists");
+    }
+
+  err:
+    Py_XDECREF((PyObject*)result);
+    Py_DECREF((PyObject*)tempg);
+    Py_DECREF((PyObject*)temph);
+    Py_DECREF((PyObject*)tempp);
+    Py_XDECREF((PyObject*)tempn);
+    return NULL;
+}
@@ -533,6 +533,272 @@ GMPy_MPZ_Function_Divm(PyObject *self, PyObject * const *args,
     }
 }
 
+/* Convert the items of a sequence to mpz. Returns a new array of
+ * references that must be released with GMPy_MPZ_Many_Free().
+ */
+
+static MPZ_Object **
+GMPy_MPZ_Many_From_Seq(PyObject *obj, Py_ssize_t *count, const char *msg)
+{
+    PyObject *seq;
+    MPZ_Object **result;
+    Py_ssize_t i;
+
+    if (!(seq = PySequence_Fast(obj, msg))) {
+        return NULL;
+    }
+    *count = PySequence_Fast_GET_SIZE(seq);
+    if (!(result = PyMem_Calloc(*count ? *count : 1, sizeof(MPZ_Object*)))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        return (MPZ_Object**)PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < *count; i++) {
+        if (!(result[i] = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), NULL))) {
+            TYPE_ERROR(msg);
+            while (--i >= 0) {
+                Py_DECREF((PyObject*)result[i]);
+            }
+            PyMem_Free(result);
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+static void
+GMPy_MPZ_Many_Free(MPZ_Object **items, Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    if (items) {
+        for (i = 0; i < count; i++) {
+            Py_XDECREF((PyObject*)items[i]);
+        }
+        PyMem_Free(items);
+    }
+}
+
+/* Return a list of count new mpz. */
+
+static PyObject *
+GMPy_MPZ_Many_New(Py_ssize_t count)
+{
+    PyObject *result;
+    MPZ_Object *temp;
+    Py_ssize_t i;
+
+    if (!(result = PyList_New(count))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < count; i++) {
+        if (!(temp = GMPy_MPZ_New(NULL))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+    }
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_gcdext_many,
+"gcdext_many(a_lst, b_lst, /) -> tuple[list[mpz], list[mpz], list[mpz]]\n\n"
+"Return three lists (g,s,t) such that g[i] == gcd(a_lst[i],b_lst[i])\n"
+"and g[i] == a_lst[i]*s[i] + b_lst[i]*t[i]. The sequences must have the\n"
+"same length. Will always release the GIL.");
+
+static PyObject *
+GMPy_MPZ_Function_GCDext_Many(PyObject *self, PyObject * const *args,
+                              Py_ssize_t nargs)
+{
+    PyObject *g = NULL, *s = NULL, *t = NULL, *result = NULL;
+    MPZ_Object **a = NULL, **b = NULL;
+    Py_ssize_t i, na = 0, nb = 0;
+    unsigned long serial;
+
+    if (nargs != 2) {
+        TYPE_ERROR("gcdext_many() requires 2 arguments");
+        return NULL;
+    }
+
+    if (!(a = GMPy_MPZ_Many_From_Seq(args[0], &na, "gcdext_many() requires sequences of integers")) ||
+        !(b = GMPy_MPZ_Many_From_Seq(args[1], &nb, "gcdext_many() requires sequences of integers"))) {
+        goto done;
+    }
+    if (na != nb) {
+        VALUE_ERROR("gcdext_many() requires sequences of the same length");
+        goto done;
+    }
+
+    if (!(g = GMPy_MPZ_Many_New(na)) ||
+        !(s = GMPy_MPZ_Many_New(na)) ||
+        !(t = GMPy_MPZ_Many_New(na))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    serial = gmpy_progress_begin("gcdext_many", na);
+    Py_BEGIN_ALLOW_THREADS;
+    for (i = 0; i < na; i++) {
+        mpz_gcdext(MPZ(PyList_GET_ITEM(g, i)), MPZ(PyList_GET_ITEM(s, i)),
+                   MPZ(PyList_GET_ITEM(t, i)), a[i]->z, b[i]->z);
+        gmpy_progress_update(serial, i + 1);
+    }
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+
+    result = PyTuple_Pack(3, g, s, t);
+
+  done:
+    Py_XDECREF(g);
+    Py_XDECREF(s);
+    Py_XDECREF(t);
+    GMPy_MPZ_Many_Free(a, na);
+    GMPy_MPZ_Many_Free(b, nb);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_divm_many,
+"divm_many(a_lst, b_lst, m, /) -> list[mpz]\n\n"
+"Return a list of x[i] such that b_lst[i]*x[i] == a_lst[i] mod m. The\n"
+"sequences must have the same length. All the inverses are computed\n"
+"with a single modular inversion when possible. Raises a\n"
+"`ZeroDivisionError` exception if some x[i] does not exist. Will always\n"
+"release the GIL.");
+
+static PyObject *
+GMPy_MPZ_Function_Divm_Many(PyObject *self, PyObject * const *args,
+                            Py_ssize_t nargs)
+{
+    PyObject *result = NULL;
+    MPZ_Object **a = NULL, **b = NULL, *m = NULL;
+    Py_ssize_t i, na = 0, nb = 0;
+    mpz_t inv, num, den, mod, gcd;
+    unsigned long serial;
+    int ok = 1;
+
+    if (nargs != 3) {
+        TYPE_ERROR("divm_many() requires 3 arguments");
+        return NULL;
+    }
+
+    if (!(m = GMPy_MPZ_From_Integer(args[2], NULL))) {
+        TYPE_ERROR("divm_many() requires an integer modulus");
+        return NULL;
+    }
+    if (mpz_sgn(m->z) == 0) {
+        ZERO_ERROR("not invertible");
+        goto done;
+    }
+    if (!(a = GMPy_MPZ_Many_From_Seq(args[0], &na, "divm_many() requires sequences of integers")) ||
+        !(b = GMPy_MPZ_Many_From_Seq(args[1], &nb, "divm_many() requires sequences of integers"))) {
+        goto done;
+    }
+    if (na != nb) {
+        VALUE_ERROR("divm_many() requires sequences of the same length");
+        goto done;
+    }
+    if (!(result = GMPy_MPZ_Many_New(na))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    /* Both passes report progress, so there are 2*na steps. */
+    serial = gmpy_progress_begin("divm_many", 2 * na);
+    Py_BEGIN_ALLOW_THREADS;
+    mpz_init(inv);
+
+    /* Montgomery's trick: store the prefix products of b in the result
+     * and invert only the last one. The inverse of b[i] is then the
+     * inverse of the prefix product up to b[i] times the prefix product
+     * up to b[i-1].
+     */
+    for (i = 0; i < na; i++) {
+        if (i == 0)
+            mpz_mod(MPZ(PyList_GET_ITEM(result, 0)), b[0]->z, m->z);
+        else {
+            mpz_mul(MPZ(PyList_GET_ITEM(result, i)),
+                    MPZ(PyList_GET_ITEM(result, i - 1)), b[i]->z);
+            mpz_mod(MPZ(PyList_GET_ITEM(result, i)),
+                    MPZ(PyList_GET_ITEM(result, i)), m->z);
+        }
+        gmpy_progress_update(serial, i + 1);
+    }
+
+    if (na > 0 && mpz_invert(inv, MPZ(PyList_GET_ITEM(result, na - 1)), m->z)) {
+        for (i = na - 1; i >= 0; i--) {
+            mpz_ptr x = MPZ(PyList_GET_ITEM(result, i));
+
+            if (i > 0) {
+                mpz_mul(x, inv, MPZ(PyList_GET_ITEM(result, i - 1)));
+                mpz_mul(inv, inv, b[i]->z);
+                mpz_mod(inv, inv, m->z);
+            }
+            else {
+                mpz_set(x, inv);
+            }
+            mpz_mul(x, x, a[i]->z);
+            mpz_mod(x, x, m->z);
+            gmpy_progress_update(serial, 2 * na - i);
+        }
+    }
+    else {
+        /* Some b[i] is not invertible. Solve each congruence separately
+         * and, as divm() does, remove a common factor of a[i], b[i], and
+         * m if needed.
+         */
+        mpz_init(num);
+        mpz_init(den);
+        mpz_init(mod);
+        mpz_init(gcd);
+        for (i = 0; i < na && ok; i++) {
+            mpz_ptr x = MPZ(PyList_GET_ITEM(result, i));
+
+            mpz_set(num, a[i]->z);
+            mpz_set(mod, m->z);
+            if (!mpz_invert(x, b[i]->z, mod)) {
+                mpz_gcd(gcd, num, b[i]->z);
+                mpz_gcd(gcd, gcd, mod);
+                mpz_divexact(num, num, gcd);
+                mpz_divexact(den, b[i]->z, gcd);
+                mpz_divexact(mod, mod, gcd);
+                ok = mpz_invert(x, den, mod);
+            }
+            mpz_mul(x, x, num);
+            mpz_mod(x, x, mod);
+            gmpy_progress_update(serial, na + i + 1);
+        }
+        mpz_clear(num);
+        mpz_clear(den);
+        mpz_clear(mod);
+        mpz_clear(gcd);
+    }
+
+    mpz_clear(inv);
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+
+    if (!ok) {
+        ZERO_ERROR("not invertible");
+        Py_CLEAR(result);
+    }
+
+  done:
+    GMPy_MPZ_Many_Free(a, na);
+    GMPy_MPZ_Many_Free(b, nb);
+    Py_DECREF((PyObject*)m);
+    return result;
+}
+
 PyDoc_STRVAR(GMPy_doc_mpz_function_fac,
 "fac(n, /) -> mpz\n\n"
 "Return the exact factorial of n.\n\n"
@@ -543,6 +809,9 @@ GMPy_MPZ_Function_Fac(PyObject *self, PyObject *other)
 {
     MPZ_Object *result = NULL;
     unsigned long n;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     n = GMPy_Integer_AsUnsignedLong(other);
     if (n == (unsigned long)(-1) && PyErr_Occurred()) {
@@ -550,7 +819,9 @@ GMPy_MPZ_Function_Fac(PyObject *self, PyObject *other)
     }
 
     if ((result = GMPy_MPZ_New(NULL))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_fac_ui(result->z, n);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
     }
     return (PyObject*)result;
 }
@@ -565,6 +836,9 @@ GMPy_MPZ_Function_DoubleFac(PyObject *self, PyObject *other)
 {
     MPZ_Object *result = NULL;
     unsigned long n;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     n = GMPy_Integer_AsUnsignedLong(other);
     if (n == (unsigned long)(-1) && PyErr_Occurred()) {
@@ -572,7 +846,9 @@ GMPy_MPZ_Function_DoubleFac(PyObject *self, PyObject *other)
     }
 
     if ((result = GMPy_MPZ_New(NULL))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_2fac_ui(result->z, n);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
     }
     return (PyObject*)result;
 }
@@ -587,6 +863,9 @@ GMPy_MPZ_Function_Primorial(PyObject *self, PyObject *other)
 {
     MPZ_Object *result = NULL;
     unsigned long n;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     n = GMPy_Integer_AsUnsignedLong(other);
     if (n == (unsigned long)(-1) && PyErr_Occurred()) {
@@ -594,7 +873,9 @@ GMPy_MPZ_Function_Primorial(PyObject *self, PyObject *other)
     }
 
     if ((result = GMPy_MPZ_New(NULL))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_primorial_ui(result->z, n);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
     }
     return (PyObject*)result;
 }
@@ -610,6 +891,9 @@ GMPy_MPZ_Function_MultiFac(PyObject *self, PyObject *const *args,
 {
     MPZ_Object *result = NULL;
     unsigned long n, m;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     if (nargs != 2) {
         TYPE_ERROR("multi_fac() requires 2 integer arguments");
@@ -627,7 +911,9 @@ GMPy_MPZ_Function_MultiFac(PyObject *self, PyObject *const *args,
     }
 
     if ((result = GMPy_MPZ_New(NULL))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_mfac_uiui(result->z, n, m);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
     }
     return (PyObject*)result;
 }
@@ -640,14 +926,19 @@ static PyObject *
 GMPy_MPZ_Function_Fib(PyObject *self, PyObject *other)
 {
     MPZ_Object *result = NULL;
-    unsigned long  n;
+    unsigned long n;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     n = GMPy_Integer_AsUnsignedLong(other);
     if (n == (unsigned long)(-1) && PyErr_Occurred()) {
         return NULL;
     }
     if ((result = GMPy_MPZ_New(NULL))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_fib_ui(result->z, n);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
     }
     return (PyObject*)result;
 }
@@ -695,6 +986,9 @@ GMPy_MPZ_Function_Lucas(PyObject *self, PyObject *other)
 {
     MPZ_Object *result = NULL;
     unsigned long n;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
 
     n = GMPy_Integer_AsUnsignedLong(other);
     if (n == (unsigned long)(-1) && PyErr_Occurred()) {
@@ -702,7 +996,9 @@ GMPy_MPZ_Function_Lucas(PyObject *self, PyObject *other)
     }
 
     if ((result = GMPy_MPZ_New(NULL))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_lucnum_ui(result->z, n);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
     }
     return (PyObject*)result;
 }
@@ -1748,6 +2044,231 @@ GMPy_MPZ_Method_IsOdd(PyObject *self, PyObject *other)
         Py_RETURN_FALSE;
 }
 
+/* Bit field kernels for slicing mpz and xmpz objects. They work on whole
+ * limbs instead of calling mpz_tstbit() and mpz_setbit() for every bit, and
+ * follow the same two's complement convention for negative numbers.
+ */
+
+/* Set r to the len bits of x beginning at bit start. r must not be x. */
+
+static void
+gmpy_mpz_get_bits(mpz_t r, const mpz_t x, mp_bitcnt_t start, mp_bitcnt_t len)
+{
+    mp_size_t xn = mpz_size(x), rn, first, avail, i;
+    unsigned int shift;
+    const mp_limb_t *xp;
+    mp_limb_t *rp;
+
+    if (len == 0) {
+        mpz_set_ui(r, 0);
+        return;
+    }
+
+    rn = (mp_size_t)((len - 1) / GMP_NUMB_BITS + 1);
+    first = (mp_size_t)(start / GMP_NUMB_BITS);
+    shift = (unsigned int)(start % GMP_NUMB_BITS);
+    avail = (xn > first) ? xn - first : 0;
+    xp = mpz_limbs_read(x);
+    rp = mpz_limbs_write(r, rn);
+
+    if (avail > rn) {
+        if (shift) {
+            mpn_rshift(rp, xp + first, rn, shift);
+            rp[rn - 1] |= xp[first + rn] << (GMP_NUMB_BITS - shift);
+        }
+        else {
+            mpn_copyi(rp, xp + first, rn);
+        }
+    }
+    else {
+        if (avail && shift)
+            mpn_rshift(rp, xp + first, avail, shift);
+        else if (avail)
+            mpn_copyi(rp, xp + first, avail);
+        for (i = avail; i < rn; i++)
+            rp[i] = 0;
+    }
+    if (len % GMP_NUMB_BITS)
+        rp[rn - 1] &= ((mp_limb_t)1 << (len % GMP_NUMB_BITS)) - 1;
+    mpz_limbs_finish(r, rn);
+
+    /* For x = -a, the bits beginning at start are the low len bits of
+     * floor(-a / 2**start) = -(floor(a / 2**start) + (a mod 2**start != 0)).
+     */
+    if (mpz_sgn(x) < 0) {
+        if (mpz_scan1(x, 0) < start)
+            mpz_add_ui(r, r, 1);
+        mpz_neg(r, r);
+        mpz_fdiv_r_2exp(r, r, len);
+    }
+}
+
+/* Set r to the count bits of x at start, start+step, start+2*step, ...
+ * r must not be x.
+ */
+
+static void
+gmpy_mpz_gather_bits(mpz_t r, const mpz_t x, Py_ssize_t start,
+                     Py_ssize_t step, Py_ssize_t count)
+{
+    mpz_t span;
+    mpz_srcptr src = x;
+    const mp_limb_t *xp;
+    mp_limb_t *rp, acc = 0;
+    mp_size_t xn, rn, li;
+    Py_ssize_t i, pos, low;
+
+    if (count <= 0) {
+        mpz_set_ui(r, 0);
+        return;
+    }
+
+    if (step == 1) {
+        gmpy_mpz_get_bits(r, x, (mp_bitcnt_t)start, (mp_bitcnt_t)count);
+        return;
+    }
+
+    /* Negative numbers are first converted to the two's complement bits
+     * of the span covered by the slice.
+     */
+    mpz_init(span);
+    if (mpz_sgn(x) < 0) {
+        low = (step < 0) ? start + (count - 1) * step : start;
+        gmpy_mpz_get_bits(span, x, (mp_bitcnt_t)low,
+                          (mp_bitcnt_t)((count - 1) * (step < 0 ? -step : step) + 1));
+        pos = start - low;
+        src = span;
+    }
+    else {
+        pos = start;
+    }
+
+    xn = mpz_size(src);
+    xp = mpz_limbs_read(src);
+    rn = (mp_size_t)((count - 1) / GMP_NUMB_BITS + 1);
+    rp = mpz_limbs_write(r, rn);
+
+    for (i = 0; i < count; i++, pos += step) {
+        li = (mp_size_t)(pos / GMP_NUMB_BITS);
+        if (li < xn)
+            acc |= ((xp[li] >> (pos % GMP_NUMB_BITS)) & 1) << (i % GMP_NUMB_BITS);
+        if (i % GMP_NUMB_BITS == GMP_NUMB_BITS - 1) {
+            rp[i / GMP_NUMB_BITS] = acc;
+            acc = 0;
+        }
+    }
+    if (count % GMP_NUMB_BITS)
+        rp[rn - 1] = acc;
+    mpz_limbs_finish(r, rn);
+    mpz_clear(span);
+}
+
+/* Replace the count bits of x at start, start+step, start+2*step, ... with
+ * the low count bits of v. Requires x >= 0 and 0 <= v < 2**count.
+ */
+
+static void
+_gmpy_mpz_scatter_bits(mpz_t x, Py_ssize_t start, Py_ssize_t step,
+                       Py_ssize_t count, const mpz_t v, int fill)
+{
+    mpz_t t;
+    const mp_limb_t *tp = NULL;
+    mp_limb_t *xp, w, mask;
+    mp_size_t xn, nn, tn = 0, first, last, j;
+    Py_ssize_t i, pos, top;
+    unsigned int lo, hi;
+
+    top = (step < 0) ? start : start + (count - 1) * step;
+    xn = mpz_size(x);
+    nn = (mp_size_t)(top / GMP_NUMB_BITS + 1);
+    if (nn < xn)
+        nn = xn;
+    xp = mpz_limbs_modify(x, nn);
+    for (j = xn; j < nn; j++)
+        xp[j] = 0;
+
+    mpz_init(t);
+    if (step == 1) {
+        /* Align the new bits with the limbs of x and merge whole limbs. */
+        first = (mp_size_t)(start / GMP_NUMB_BITS);
+        last = (mp_size_t)(top / GMP_NUMB_BITS);
+        if (!fill) {
+            mpz_mul_2exp(t, v, (mp_bitcnt_t)(start % GMP_NUMB_BITS));
+            tn = mpz_size(t);
+            tp = mpz_limbs_read(t);
+        }
+        for (j = first; j <= last; j++) {
+            if (fill)
+                w = (fill > 0) ? ~(mp_limb_t)0 : 0;
+            else
+                w = (j - first < tn) ? tp[j - first] : 0;
+            lo = (j == first) ? (unsigned int)(start % GMP_NUMB_BITS) : 0;
+            hi = (j == last) ? (unsigned int)(top % GMP_NUMB_BITS) + 1 : GMP_NUMB_BITS;
+            mask = (hi == GMP_NUMB_BITS) ? ~(mp_limb_t)0 : ((mp_limb_t)1 << hi) - 1;
+            mask &= ~(((mp_limb_t)1 << lo) - 1);
+            xp[j] = (xp[j] & ~mask) | (w & mask);
+        }
+    }
+    else {
+        if (!fill) {
+            tn = mpz_size(v);
+            tp = mpz_limbs_read(v);
+        }
+        for (i = 0, pos = start; i < count; i++, pos += step) {
+            j = (mp_size_t)(i / GMP_NUMB_BITS);
+            if (fill)
+                w = (fill > 0);
+            else
+                w = (j < tn) ? (tp[j] >> (i % GMP_NUMB_BITS)) & 1 : 0;
+            mask = (mp_limb_t)1 << (pos % GMP_NUMB_BITS);
+            j = (mp_size_t)(pos / GMP_NUMB_BITS);
+            xp[j] = w ? (xp[j] | mask) : (xp[j] & ~mask);
+        }
+    }
+    mpz_limbs_finish(x, nn);
+    mpz_clear(t);
+}
+
+/* Replace the count bits of x at start, start+step, start+2*step, ... with
+ * the low count bits of v.
+ */
+
+static void
+gmpy_mpz_scatter_bits(mpz_t x, Py_ssize_t start, Py_ssize_t step,
+                      Py_ssize_t count, const mpz_t v)
+{
+    mpz_t t;
+    int fill = 0, negative = (mpz_sgn(x) < 0);
+
+    if (count <= 0)
+        return;
+
+    mpz_init(t);
+    if (mpz_sgn(v) == 0)
+        fill = -1;
+    else if (mpz_cmp_si(v, -1) == 0)
+        fill = 1;
+    else
+        mpz_fdiv_r_2exp(t, v, (mp_bitcnt_t)count);
+
+    /* The bits of a negative x are the complements of the bits of -x-1. */
+    if (negative) {
+        mpz_com(x, x);
+        if (fill)
+            fill = -fill;
+        else {
+            mpz_com(t, t);
+            mpz_fdiv_r_2exp(t, t, (mp_bitcnt_t)count);
+        }
+    }
+
+    _gmpy_mpz_scatter_bits(x, start, step, count, t, fill);
+
+    if (negative)
+        mpz_com(x, x);
+    mpz_clear(t);
+}
+
 /*
  * Add mapping support to mpz objects.
  */
@@ -1775,7 +2296,7 @@ GMPy_MPZ_Method_SubScript(MPZ_Object *self, PyObject *item)
         return PyLong_FromLong(mpz_tstbit(self->z, i));
     }
     else if (PySlice_Check(item)) {
-        Py_ssize_t start, stop, step, slicelength, cur, i;
+        Py_ssize_t start, stop, step, slicelength;
         MPZ_Object *result;
 
         if (PySlice_GetIndicesEx(item,
@@ -1792,14 +2313,7 @@ GMPy_MPZ_Method_SubScript(MPZ_Object *self, PyObject *item)
             return NULL;
         }
 
-        mpz_set_ui(result->z, 0);
-        if (slicelength > 0) {
-            for (cur = start, i = 0; i < slicelength; cur += step, i++) {
-                if(mpz_tstbit(self->z, cur)) {
-                    mpz_setbit(result->z, i);
-                }
-            }
-        }
+        gmpy_mpz_gather_bits(result->z, self->z, start, step, slicelength);
         return (PyObject*)result;
     }
     else {
@@ -68,6 +68,11 @@ static PyObject * GMPy_MPZ_Function_GCD(PyObject *self, PyObject * const *args,
 static PyObject * GMPy_MPZ_Function_LCM(PyObject *self, PyObject * const *args, Py_ssize_t nargs);
 static PyObject * GMPy_MPZ_Function_GCDext(PyObject *self, PyObject * const *args, Py_ssize_t nargs);
 static PyObject * GMPy_MPZ_Function_Divm(PyObject *self, PyObject * const *args, Py_ssize_t nargs);
+static MPZ_Object ** GMPy_MPZ_Many_From_Seq(PyObject *obj, Py_ssize_t *count, const char *msg);
+static void       GMPy_MPZ_Many_Free(MPZ_Object **items, Py_ssize_t count);
+static PyObject * GMPy_MPZ_Many_New(Py_ssize_t count);
+static PyObject * GMPy_MPZ_Function_GCDext_Many(PyObject *self, PyObject * const *args, Py_ssize_t nargs);
+static PyObject * GMPy_MPZ_Function_Divm_Many(PyObject *self, PyObject * const *args, Py_ssize_t nargs);
 static PyObject * GMPy_MPZ_Function_Fac(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_Primorial(PyObject *self, PyObject *other);
 static PyObject * GMPy_MPZ_Function_DoubleFac(PyObject *self, PyObject *other);
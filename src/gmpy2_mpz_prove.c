@@ -0,0 +1,1182 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_mpz_prove.c                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Primality proofs that produce a certificate.
+ *
+ * The probable-prime tests in gmpy_mpz_prp.c can only show that a number
+ * is *probably* prime. The functions in this file construct a proof of
+ * primality and return it as a certificate that can be checked later,
+ * much faster than it was created.
+ *
+ * Three kinds of proof are used:
+ *
+ *   1) n < 2**64: a Miller-Rabin test using the first twelve prime bases
+ *      is deterministic for all n < 3.3 * 10**24.
+ *
+ *   2) N-1 proofs: if the factored part F of n-1 satisfies (F+1)**2 > n,
+ *      the generalized Pocklington theorem is used. If only F**3 >= n,
+ *      the Brillhart-Lehmer-Selfridge "cube root" theorem is used. For
+ *      each prime q dividing F, a witness a_q must satisfy
+ *
+ *          a_q**(n-1) == 1 (mod n) and gcd(a_q**((n-1)/q) - 1, n) == 1
+ *
+ *   3) N+1 proofs: if the factored part F of n+1 satisfies (F-1)**2 > n,
+ *      Morrison's theorem is used with a Lucas sequence U(P,Q) such that
+ *      jacobi(P*P-4*Q, n) == -1, U_(n+1) == 0 (mod n), and
+ *      gcd(U_((n+1)/q), n) == 1 for each prime q dividing F.
+ *
+ * The prime factors q used in the N-1 and N+1 proofs are proven
+ * recursively. The certificate formats are:
+ *
+ *   n                                        n < 2**64
+ *   (n, 'n-1', ((a_1, cert_1), ...))        N-1 proof
+ *   (n, 'n+1', P, Q, (cert_1, ...))         N+1 proof
+ *
+ * where cert_i is the certificate for the prime q_i. The q_i must appear
+ * in increasing order.
+ *
+ * Finding the factors of n-1 and n+1 uses trial division followed by
+ * Brent's variant of Pollard's rho method. The modular exponentiation and
+ * factoring steps release the GIL if the context allows it, so several
+ * certificates can be constructed concurrently from different threads.
+ * Elliptic curve (ECPP) proofs are not implemented. For a prime whose n-1
+ * and n+1 cannot be factored far enough, which is common for random primes
+ * of 160 bits or more, no certificate is returned.
+ */
+
+#define PROVE_COMPOSITE  0
+#define PROVE_PRIME      1
+#define PROVE_UNKNOWN   -1
+#define PROVE_ERROR     -2
+
+#define PROVE_TRIAL_LIMIT 65536
+#define PROVE_RHO_LIMIT   (1UL << 21)
+#define PROVE_MAX_BASES   64
+
+typedef struct {
+    mpz_t *q;
+    Py_ssize_t count;
+    Py_ssize_t alloc;
+} prove_factors;
+
+static unsigned int *prove_small_primes = NULL;
+static Py_ssize_t prove_num_small_primes = 0;
+
+GMPY_MUTEX(prove_lock);
+
+static int
+_prove_init_small_primes(void)
+{
+    char *sieve;
+    unsigned int i, j, count = 0;
+
+    if (prove_small_primes) {
+        return 0;
+    }
+
+    if (!(sieve = calloc(PROVE_TRIAL_LIMIT, 1))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 2; i < PROVE_TRIAL_LIMIT; i++) {
+        if (!sieve[i]) {
+            count++;
+            for (j = i * i; j < PROVE_TRIAL_LIMIT; j += i) {
+                sieve[j] = 1;
+            }
+        }
+    }
+
+    if (!(prove_small_primes = malloc(count * sizeof(unsigned int)))) {
+        /* LCOV_EXCL_START */
+        free(sieve);
+        PyErr_NoMemory();
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 2, j = 0; i < PROVE_TRIAL_LIMIT; i++) {
+        if (!sieve[i]) {
+            prove_small_primes[j++] = i;
+        }
+    }
+    prove_num_small_primes = count;
+    free(sieve);
+    return 0;
+}
+
+static int
+prove_init_small_primes(void)
+{
+    int result;
+
+    GMPY_LOCK(prove_lock);
+    result = _prove_init_small_primes();
+    GMPY_UNLOCK(prove_lock);
+    return result;
+}
+
+static void
+prove_factors_init(prove_factors *f)
+{
+    f->q = NULL;
+    f->count = 0;
+    f->alloc = 0;
+}
+
+static void
+prove_factors_clear(prove_factors *f)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < f->count; i++) {
+        mpz_clear(f->q[i]);
+    }
+    free(f->q);
+    prove_factors_init(f);
+}
+
+/* Add q to the list of distinct prime factors. Returns 1 if q was added, 0
+ * if it was already in the list, or -1 if memory could not be allocated.
+ * Does not require the GIL.
+ */
+
+static int
+prove_factors_add(prove_factors *f, const mpz_t q)
+{
+    Py_ssize_t i;
+    mpz_t *temp;
+
+    for (i = 0; i < f->count; i++) {
+        if (mpz_cmp(f->q[i], q) == 0) {
+            return 0;
+        }
+    }
+
+    if (f->count == f->alloc) {
+        f->alloc = f->alloc ? 2 * f->alloc : 16;
+        if (!(temp = realloc(f->q, f->alloc * sizeof(mpz_t)))) {
+            /* LCOV_EXCL_START */
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        f->q = temp;
+    }
+    mpz_init_set(f->q[f->count++], q);
+    return 1;
+}
+
+static int
+prove_factors_cmp(const void *a, const void *b)
+{
+    return mpz_cmp((mpz_srcptr)a, (mpz_srcptr)b);
+}
+
+/* Brent's variant of Pollard's rho method. Returns 1 and sets d to a
+ * non-trivial factor of m, or returns 0 if no factor was found within
+ * limit iterations. m must be odd, composite, and not a perfect power of
+ * a small prime.
+ */
+
+static int
+prove_rho(mpz_t d, const mpz_t m, unsigned long c, unsigned long limit)
+{
+    mpz_t x, y, ys, q, t;
+    unsigned long r = 1, k, i, batch;
+    int found = 0;
+
+    mpz_init_set_ui(y, 2);
+    mpz_init(x);
+    mpz_init(ys);
+    mpz_init_set_ui(q, 1);
+    mpz_init(t);
+    mpz_set_ui(d, 1);
+
+    while (mpz_cmp_ui(d, 1) == 0 && r <= limit) {
+        mpz_set(x, y);
+        for (i = 0; i < r; i++) {
+            mpz_mul(y, y, y);
+            mpz_add_ui(y, y, c);
+            mpz_mod(y, y, m);
+        }
+        for (k = 0; k < r && mpz_cmp_ui(d, 1) == 0; k += batch) {
+            mpz_set(ys, y);
+            batch = (r - k < 128) ? r - k : 128;
+            for (i = 0; i < batch; i++) {
+                mpz_mul(y, y, y);
+                mpz_add_ui(y, y, c);
+                mpz_mod(y, y, m);
+                mpz_sub(t, x, y);
+                mpz_mul(q, q, t);
+                mpz_mod(q, q, m);
+            }
+            mpz_gcd(d, q, m);
+        }
+        r *= 2;
+    }
+
+    /* The batched gcd may have collected all the factors of m. Backtrack
+     * one step at a time from the start of the last batch.
+     */
+    if (mpz_cmp(d, m) == 0) {
+        do {
+            mpz_mul(ys, ys, ys);
+            mpz_add_ui(ys, ys, c);
+            mpz_mod(ys, ys, m);
+            mpz_sub(t, x, ys);
+            mpz_gcd(d, t, m);
+        } while (mpz_cmp_ui(d, 1) == 0);
+    }
+
+    found = (mpz_cmp_ui(d, 1) > 0) && (mpz_cmp(d, m) < 0);
+
+    mpz_clear(x);
+    mpz_clear(y);
+    mpz_clear(ys);
+    mpz_clear(q);
+    mpz_clear(t);
+    return found;
+}
+
+/* Find prime factors of m using trial division and Pollard's rho method.
+ * If n is not NULL, the search stops early once the completely factored
+ * part F of m satisfies F**3 >= n since that is enough for a proof. Factors
+ * that could not be found are silently ignored. Returns -1 if memory could
+ * not be allocated. Does not require the GIL.
+ */
+
+static int
+prove_find_factors(prove_factors *f, mpz_srcptr m, mpz_srcptr n)
+{
+    mpz_t rem, d, F, t, *stack = NULL;
+    Py_ssize_t i, top = 0, size;
+    unsigned long c;
+    int ret = 0, added;
+
+    mpz_init_set(rem, m);
+    mpz_init(d);
+    mpz_init(F);
+    mpz_init(t);
+
+    for (i = 0; i < prove_num_small_primes; i++) {
+        if (mpz_divisible_ui_p(rem, prove_small_primes[i])) {
+            mpz_set_ui(d, prove_small_primes[i]);
+            if (prove_factors_add(f, d) < 0) {
+                /* LCOV_EXCL_START */
+                ret = -1;
+                goto cleanup;
+                /* LCOV_EXCL_STOP */
+            }
+            mpz_remove(rem, rem, d);
+        }
+    }
+
+    if (mpz_cmp_ui(rem, 1) == 0) {
+        goto cleanup;
+    }
+    mpz_divexact(F, m, rem);
+
+    /* Each split at least halves the size of the cofactor so the number
+     * of pending cofactors is bounded by the bit length.
+     */
+    size = (Py_ssize_t)mpz_sizeinbase(rem, 2) + 1;
+    if (!(stack = malloc(size * sizeof(mpz_t)))) {
+        /* LCOV_EXCL_START */
+        ret = -1;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_init_set(stack[top++], rem);
+
+    while (top > 0) {
+        if (n) {
+            mpz_mul(t, F, F);
+            mpz_mul(t, t, F);
+            if (mpz_cmp(t, n) >= 0) {
+                break;
+            }
+        }
+
+        top--;
+        if (mpz_probab_prime_p(stack[top], 25)) {
+            if ((added = prove_factors_add(f, stack[top])) < 0) {
+                /* LCOV_EXCL_START */
+                ret = -1;
+                mpz_clear(stack[top]);
+                goto cleanup;
+                /* LCOV_EXCL_STOP */
+            }
+            /* The same prime can come off the stack more than once, but
+             * its full power in m is only part of F once.
+             */
+            if (added) {
+                mpz_set(t, rem);
+                mpz_remove(t, t, stack[top]);
+                mpz_divexact(d, rem, t);
+                mpz_mul(F, F, d);
+            }
+            mpz_clear(stack[top]);
+            continue;
+        }
+        if (mpz_perfect_power_p(stack[top])) {
+            /* Only the distinct prime factors are needed so replace the
+             * perfect power by its smallest exact root.
+             */
+            for (c = 2; !mpz_root(d, stack[top], c); c++);
+            mpz_set(stack[top++], d);
+            continue;
+        }
+        for (c = 1; c < 3; c++) {
+            if (prove_rho(d, stack[top], c, PROVE_RHO_LIMIT)) {
+                break;
+            }
+        }
+        if (c == 3) {
+            mpz_clear(stack[top]);
+            continue;
+        }
+        mpz_divexact(stack[top], stack[top], d);
+        mpz_init_set(stack[top + 1], d);
+        top += 2;
+    }
+
+  cleanup:
+    while (top > 0) {
+        mpz_clear(stack[--top]);
+    }
+    free(stack);
+    mpz_clear(rem);
+    mpz_clear(d);
+    mpz_clear(F);
+    mpz_clear(t);
+    return ret;
+}
+
+/* Deterministic Miller-Rabin test valid for all n < 2**64. */
+
+static int
+prove_small_is_prime(const mpz_t n)
+{
+    static const unsigned long bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    mpz_t nm1, d, x;
+    mp_bitcnt_t s, j;
+    size_t i;
+    int result = 1;
+
+    if (mpz_cmp_ui(n, 2) < 0) {
+        return 0;
+    }
+    for (i = 0; i < sizeof(bases) / sizeof(bases[0]); i++) {
+        if (mpz_cmp_ui(n, bases[i]) == 0) {
+            return 1;
+        }
+        if (mpz_divisible_ui_p(n, bases[i])) {
+            return 0;
+        }
+    }
+
+    mpz_init(nm1);
+    mpz_init(d);
+    mpz_init(x);
+    mpz_sub_ui(nm1, n, 1);
+    s = mpz_scan1(nm1, 0);
+    mpz_tdiv_q_2exp(d, nm1, s);
+
+    for (i = 0; result && i < sizeof(bases) / sizeof(bases[0]); i++) {
+        mpz_set_ui(x, bases[i]);
+        mpz_powm(x, x, d, n);
+        if (mpz_cmp_ui(x, 1) == 0 || mpz_cmp(x, nm1) == 0) {
+            continue;
+        }
+        for (j = 1; j < s; j++) {
+            mpz_powm_ui(x, x, 2, n);
+            if (mpz_cmp(x, nm1) == 0) {
+                break;
+            }
+        }
+        if (j >= s) {
+            result = 0;
+        }
+    }
+
+    mpz_clear(nm1);
+    mpz_clear(d);
+    mpz_clear(x);
+    return result;
+}
+
+/* Set u to U_k(P,Q) mod n where n is odd and k >= 1. */
+
+static void
+prove_lucas_u(mpz_t u, const mpz_t k, long p, long q, const mpz_t n)
+{
+    mpz_t v, qk, dd, t, w;
+    mp_bitcnt_t i;
+
+    mpz_init(v);
+    mpz_init(qk);
+    mpz_init(dd);
+    mpz_init(t);
+    mpz_init(w);
+
+    /* D = P*P - 4*Q */
+    mpz_set_si(dd, p);
+    mpz_mul_si(dd, dd, p);
+    mpz_set_si(t, q);
+    mpz_submul_ui(dd, t, 4);
+    mpz_mod(dd, dd, n);
+
+    mpz_set_si(v, p);
+    mpz_mod(v, v, n);
+    mpz_set_si(qk, q);
+    mpz_mod(qk, qk, n);
+    mpz_set_ui(t, 1);
+
+    for (i = mpz_sizeinbase(k, 2) - 1; i-- > 0;) {
+        /* U_2k = U_k*V_k, V_2k = V_k**2 - 2*Q**k */
+        mpz_mul(t, t, v);
+        mpz_mod(t, t, n);
+        mpz_mul(v, v, v);
+        mpz_submul_ui(v, qk, 2);
+        mpz_mod(v, v, n);
+        mpz_mul(qk, qk, qk);
+        mpz_mod(qk, qk, n);
+        if (mpz_tstbit(k, i)) {
+            /* U_2k+1 = (P*U_2k + V_2k)/2, V_2k+1 = (D*U_2k + P*V_2k)/2 */
+            mpz_mul(w, dd, t);
+            mpz_mul_si(t, t, p);
+            mpz_add(t, t, v);
+            mpz_mod(t, t, n);
+            if (mpz_odd_p(t)) {
+                mpz_add(t, t, n);
+            }
+            mpz_tdiv_q_2exp(t, t, 1);
+            mpz_mul_si(v, v, p);
+            mpz_add(v, v, w);
+            mpz_mod(v, v, n);
+            if (mpz_odd_p(v)) {
+                mpz_add(v, v, n);
+            }
+            mpz_tdiv_q_2exp(v, v, 1);
+            mpz_mul_si(qk, qk, q);
+            mpz_mod(qk, qk, n);
+        }
+    }
+    mpz_set(u, t);
+
+    mpz_clear(v);
+    mpz_clear(qk);
+    mpz_clear(dd);
+    mpz_clear(t);
+    mpz_clear(w);
+}
+
+static int GMPy_MPZ_Prove(PyObject **cert, const mpz_t n, CTXT_Object *context);
+
+/* Prove each factor in f, in increasing order, until the product of the
+ * proven prime powers dividing m satisfies done(F, n). The certificates are
+ * returned in a new list and the product in F.
+ */
+
+static int
+prove_certify_factors(PyObject **certs, mpz_t F, prove_factors *f,
+                      const mpz_t m, const mpz_t n, int minus,
+                      CTXT_Object *context)
+{
+    PyObject *qcert = NULL;
+    mpz_t qe, t;
+    Py_ssize_t i;
+    int rc;
+
+    if (!(*certs = PyList_New(0))) {
+        /* LCOV_EXCL_START */
+        return PROVE_ERROR;
+        /* LCOV_EXCL_STOP */
+    }
+
+    mpz_init(qe);
+    mpz_init(t);
+    mpz_set_ui(F, 1);
+    qsort(f->q, f->count, sizeof(mpz_t), prove_factors_cmp);
+
+    for (i = 0; i < f->count; i++) {
+        rc = GMPy_MPZ_Prove(&qcert, f->q[i], context);
+        if (rc == PROVE_ERROR) {
+            /* LCOV_EXCL_START */
+            Py_CLEAR(*certs);
+            goto cleanup;
+            /* LCOV_EXCL_STOP */
+        }
+        if (rc != PROVE_PRIME) {
+            continue;
+        }
+        if (PyList_Append(*certs, qcert) < 0) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(qcert);
+            Py_CLEAR(*certs);
+            rc = PROVE_ERROR;
+            goto cleanup;
+            /* LCOV_EXCL_STOP */
+        }
+        Py_DECREF(qcert);
+
+        mpz_set(t, m);
+        mpz_set_ui(qe, 1);
+        while (mpz_divisible_p(t, f->q[i])) {
+            mpz_divexact(t, t, f->q[i]);
+            mpz_mul(qe, qe, f->q[i]);
+        }
+        mpz_mul(F, F, qe);
+
+        /* N-1 requires (F+1)**2 > n, N+1 requires (F-1)**2 > n. */
+        if (minus) {
+            mpz_add_ui(t, F, 1);
+        }
+        else {
+            mpz_sub_ui(t, F, 1);
+        }
+        mpz_mul(t, t, t);
+        if (mpz_cmp(t, n) > 0) {
+            break;
+        }
+    }
+    rc = PROVE_PRIME;
+
+  cleanup:
+    mpz_clear(qe);
+    mpz_clear(t);
+    return rc;
+}
+
+/* Return the prime q stored in a certificate. */
+
+static PyObject *
+prove_cert_prime(PyObject *cert)
+{
+    return PyTuple_Check(cert) ? PyTuple_GET_ITEM(cert, 0) : cert;
+}
+
+/* Check the Brillhart-Lehmer-Selfridge condition for n^(1/3) <= F <= n^(1/2):
+ * write n = c2*F**2 + c1*F + 1, then n is prime if c1**2 - 4*c2 is not a
+ * square.
+ */
+
+static int
+prove_bls_condition(const mpz_t F, const mpz_t n)
+{
+    mpz_t c1, c2, t;
+    int result;
+
+    mpz_init(c1);
+    mpz_init(c2);
+    mpz_init(t);
+
+    mpz_mul(t, F, F);
+    mpz_mul(t, t, F);
+    if (mpz_cmp(t, n) < 0) {
+        result = 0;
+    }
+    else {
+        mpz_sub_ui(t, n, 1);
+        mpz_tdiv_q(t, t, F);
+        mpz_tdiv_qr(c2, c1, t, F);
+        mpz_mul(t, c1, c1);
+        mpz_submul_ui(t, c2, 4);
+        result = (mpz_sgn(t) < 0) || !mpz_perfect_square_p(t);
+    }
+
+    mpz_clear(c1);
+    mpz_clear(c2);
+    mpz_clear(t);
+    return result;
+}
+
+static int
+prove_nm1(PyObject **cert, const mpz_t n, CTXT_Object *context)
+{
+    PyObject *certs = NULL, *witnesses = NULL, *item = NULL;
+    MPZ_Object *a = NULL, *tempn = NULL;
+    prove_factors f;
+    mpz_t nm1, F, e, t;
+    Py_ssize_t i, count;
+    unsigned long base;
+    int rc, ok = 0;
+
+    prove_factors_init(&f);
+    mpz_init(nm1);
+    mpz_init(F);
+    mpz_init(e);
+    mpz_init(t);
+    mpz_sub_ui(nm1, n, 1);
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    ok = prove_find_factors(&f, nm1, n);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (ok < 0) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        rc = PROVE_ERROR;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+
+    rc = prove_certify_factors(&certs, F, &f, nm1, n, 1, context);
+    if (rc != PROVE_PRIME) {
+        goto cleanup;
+    }
+
+    mpz_add_ui(t, F, 1);
+    mpz_mul(t, t, t);
+    if (mpz_cmp(t, n) <= 0 && !prove_bls_condition(F, n)) {
+        rc = PROVE_UNKNOWN;
+        goto cleanup;
+    }
+
+    count = PyList_GET_SIZE(certs);
+    if (!(witnesses = PyTuple_New(count))) {
+        /* LCOV_EXCL_START */
+        rc = PROVE_ERROR;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 0; i < count; i++) {
+        item = PyList_GET_ITEM(certs, i);
+        mpz_set(e, nm1);
+        mpz_divexact(e, e, MPZ(prove_cert_prime(item)));
+        ok = 0;
+        for (base = 2; base < 2 + PROVE_MAX_BASES; base++) {
+            mpz_set_ui(t, base);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            mpz_powm(t, t, e, n);
+            GMPY_MAYBE_END_ALLOW_THREADS(context);
+            mpz_sub_ui(F, t, 1);
+            mpz_gcd(F, F, n);
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            mpz_powm(t, t, MPZ(prove_cert_prime(item)), n);
+            GMPY_MAYBE_END_ALLOW_THREADS(context);
+            if (mpz_cmp_ui(t, 1) != 0) {
+                rc = PROVE_COMPOSITE;
+                goto cleanup;
+            }
+            if (mpz_cmp_ui(F, 1) == 0) {
+                ok = 1;
+                break;
+            }
+        }
+        if (!ok) {
+            rc = PROVE_UNKNOWN;
+            goto cleanup;
+        }
+        if (!(a = GMPy_MPZ_New(NULL))) {
+            /* LCOV_EXCL_START */
+            rc = PROVE_ERROR;
+            goto cleanup;
+            /* LCOV_EXCL_STOP */
+        }
+        mpz_set_ui(a->z, base);
+        PyTuple_SET_ITEM(witnesses, i, Py_BuildValue("(NO)", a, item));
+        if (!PyTuple_GET_ITEM(witnesses, i)) {
+            /* LCOV_EXCL_START */
+            rc = PROVE_ERROR;
+            goto cleanup;
+            /* LCOV_EXCL_STOP */
+        }
+    }
+
+    if (!(tempn = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        rc = PROVE_ERROR;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_set(tempn->z, n);
+    if (!(*cert = Py_BuildValue("(NsO)", tempn, "n-1", witnesses))) {
+        /* LCOV_EXCL_START */
+        rc = PROVE_ERROR;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+    rc = PROVE_PRIME;
+
+  cleanup:
+    Py_XDECREF(certs);
+    Py_XDECREF(witnesses);
+    prove_factors_clear(&f);
+    mpz_clear(nm1);
+    mpz_clear(F);
+    mpz_clear(e);
+    mpz_clear(t);
+    return rc;
+}
+
+static int
+prove_np1(PyObject **cert, const mpz_t n, CTXT_Object *context)
+{
+    PyObject *certs = NULL, *qcerts = NULL;
+    MPZ_Object *tempn = NULL, *tempp = NULL, *tempq = NULL;
+    prove_factors f;
+    mpz_t np1, F, e, t;
+    Py_ssize_t i, count;
+    long p, q = -1;
+    int rc, ok = 0;
+
+    prove_factors_init(&f);
+    mpz_init(np1);
+    mpz_init(F);
+    mpz_init(e);
+    mpz_init(t);
+    mpz_add_ui(np1, n, 1);
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    ok = prove_find_factors(&f, np1, n);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    if (ok < 0) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        rc = PROVE_ERROR;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+
+    rc = prove_certify_factors(&certs, F, &f, np1, n, 0, context);
+    if (rc != PROVE_PRIME) {
+        goto cleanup;
+    }
+
+    mpz_sub_ui(t, F, 1);
+    mpz_mul(t, t, t);
+    if (mpz_cmp(t, n) <= 0) {
+        rc = PROVE_UNKNOWN;
+        goto cleanup;
+    }
+
+    /* Search for a Lucas sequence with Q = -1 and D = P*P + 4. */
+    count = PyList_GET_SIZE(certs);
+    ok = 0;
+    for (p = 1; p <= PROVE_MAX_BASES && !ok; p++) {
+        mpz_set_si(t, p * p - 4 * q);
+        if (mpz_jacobi(t, n) != -1) {
+            continue;
+        }
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        prove_lucas_u(t, np1, p, q, n);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (mpz_sgn(t) != 0) {
+            rc = PROVE_COMPOSITE;
+            goto cleanup;
+        }
+        ok = 1;
+        for (i = 0; i < count && ok; i++) {
+            mpz_divexact(e, np1, MPZ(prove_cert_prime(PyList_GET_ITEM(certs, i))));
+            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+            prove_lucas_u(t, e, p, q, n);
+            GMPY_MAYBE_END_ALLOW_THREADS(context);
+            mpz_gcd(t, t, n);
+            ok = (mpz_cmp_ui(t, 1) == 0);
+        }
+    }
+    if (!ok) {
+        rc = PROVE_UNKNOWN;
+        goto cleanup;
+    }
+    p--;
+
+    if (!(qcerts = PyList_AsTuple(certs)) ||
+        !(tempn = GMPy_MPZ_New(NULL)) ||
+        !(tempp = GMPy_MPZ_New(NULL)) ||
+        !(tempq = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        Py_XDECREF((PyObject*)tempn);
+        Py_XDECREF((PyObject*)tempp);
+        rc = PROVE_ERROR;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_set(tempn->z, n);
+    mpz_set_si(tempp->z, p);
+    mpz_set_si(tempq->z, q);
+    if (!(*cert = Py_BuildValue("(NsNNO)", tempn, "n+1", tempp, tempq, qcerts))) {
+        /* LCOV_EXCL_START */
+        rc = PROVE_ERROR;
+        goto cleanup;
+        /* LCOV_EXCL_STOP */
+    }
+    rc = PROVE_PRIME;
+
+  cleanup:
+    Py_XDECREF(certs);
+    Py_XDECREF(qcerts);
+    prove_factors_clear(&f);
+    mpz_clear(np1);
+    mpz_clear(F);
+    mpz_clear(e);
+    mpz_clear(t);
+    return rc;
+}
+
+/* Try to prove n is prime. On success, returns PROVE_PRIME and sets *cert
+ * to a new reference to the certificate.
+ */
+
+static int
+GMPy_MPZ_Prove(PyObject **cert, const mpz_t n, CTXT_Object *context)
+{
+    MPZ_Object *tempn = NULL;
+    int rc;
+
+    *cert = NULL;
+
+    if (mpz_sizeinbase(n, 2) <= 64) {
+        if (!prove_small_is_prime(n)) {
+            return PROVE_COMPOSITE;
+        }
+        if (!(tempn = GMPy_MPZ_New(NULL))) {
+            /* LCOV_EXCL_START */
+            return PROVE_ERROR;
+            /* LCOV_EXCL_STOP */
+        }
+        mpz_set(tempn->z, n);
+        *cert = (PyObject*)tempn;
+        return PROVE_PRIME;
+    }
+
+    if (!mpz_probab_prime_p(n, 25)) {
+        return PROVE_COMPOSITE;
+    }
+
+    rc = prove_nm1(cert, n, context);
+    if (rc != PROVE_UNKNOWN) {
+        return rc;
+    }
+    return prove_np1(cert, n, context);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_prime_certificate,
+"prime_certificate(n, /) -> mpz | tuple\n\n"
+"Return a certificate proving that n is prime. A certificate has one\n"
+"of the following forms:\n\n"
+"    n                                  n < 2**64\n"
+"    (n, 'n-1', ((a1, cert1), ...))     Pocklington or BLS N-1 proof\n"
+"    (n, 'n+1', P, Q, (cert1, ...))     Morrison N+1 proof\n\n"
+"where certi is the certificate of a prime factor qi of n-1 (or n+1)\n"
+"and ai is the corresponding witness. Use `verify_prime_certificate()`\n"
+"to check a certificate. Raises `ValueError` if n is not prime.\n\n"
+"Only N-1 and N+1 proofs are implemented, not elliptic curve (ECPP)\n"
+"proofs. They need n-1 or n+1, and the same for each prime in the\n"
+"certificate, to be factored to about a third of their size. That is\n"
+"usually possible for numbers of special form, but often not for random\n"
+"primes of 160 bits or more. If no proof is found, None is returned:\n"
+"n is then only a probable prime.");
+
+static PyObject *
+GMPy_MPZ_Function_PrimeCertificate(PyObject *self, PyObject *other)
+{
+    MPZ_Object *tempx = NULL;
+    PyObject *result = NULL;
+    CTXT_Object *context = NULL;
+    int rc;
+
+    CHECK_CONTEXT(context);
+
+    if (!(tempx = GMPy_MPZ_From_Integer(other, NULL))) {
+        TYPE_ERROR("prime_certificate() requires 'mpz' argument");
+        return NULL;
+    }
+
+    if (prove_init_small_primes() < 0) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)tempx);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+
+    rc = GMPy_MPZ_Prove(&result, tempx->z, context);
+    Py_DECREF((PyObject*)tempx);
+
+    if (rc == PROVE_COMPOSITE) {
+        VALUE_ERROR("prime_certificate() argument is not prime");
+    }
+    else if (rc == PROVE_UNKNOWN) {
+        Py_RETURN_NONE;
+    }
+    return result;
+}
+
+/* Convert an item of a certificate to an mpz. Returns NULL without an
+ * exception set if the item is not an integer.
+ */
+
+static MPZ_Object *
+prove_cert_integer(PyObject *obj)
+{
+    if (!IS_INTEGER(obj)) {
+        return NULL;
+    }
+    return GMPy_MPZ_From_Integer(obj, NULL);
+}
+
+static int prove_verify(PyObject *cert, mpz_t q);
+
+/* Verify the certificates in the sequence certs. For each prime q (which must
+ * be in increasing order), multiply F by the largest power of q dividing m.
+ * If witnesses is not zero, each item is an (a, cert) pair and the N-1
+ * witness condition is checked. The prime q is returned in *primes.
+ */
+
+static int
+prove_verify_factors(PyObject *certs, int witnesses, mpz_t F, mpz_t **primes,
+                     Py_ssize_t *count, const mpz_t m, const mpz_t n)
+{
+    PyObject *item;
+    MPZ_Object *a = NULL;
+    mpz_t q, prev, t, e;
+    Py_ssize_t i;
+    int result = 0;
+
+    if (!PyTuple_Check(certs)) {
+        return 0;
+    }
+
+    *count = PyTuple_GET_SIZE(certs);
+    if (!(*primes = malloc((*count + 1) * sizeof(mpz_t)))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    mpz_init(q);
+    mpz_init_set_ui(prev, 1);
+    mpz_init(t);
+    mpz_init(e);
+    mpz_set_ui(F, 1);
+
+    for (i = 0; i < *count; i++) {
+        mpz_init((*primes)[i]);
+    }
+
+    for (i = 0; i < *count; i++) {
+        item = PyTuple_GET_ITEM(certs, i);
+        if (witnesses) {
+            if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 2 ||
+                !(a = prove_cert_integer(PyTuple_GET_ITEM(item, 0)))) {
+                goto cleanup;
+            }
+            item = PyTuple_GET_ITEM(item, 1);
+        }
+        if ((result = prove_verify(item, q)) != 1) {
+            goto cleanup;
+        }
+        result = 0;
+        if (mpz_cmp(q, prev) <= 0 || !mpz_divisible_p(m, q)) {
+            goto cleanup;
+        }
+        mpz_set(prev, q);
+        mpz_set((*primes)[i], q);
+
+        mpz_set(t, m);
+        while (mpz_divisible_p(t, q)) {
+            mpz_divexact(t, t, q);
+            mpz_mul(F, F, q);
+        }
+
+        if (witnesses) {
+            /* a**(n-1) == 1 and gcd(a**((n-1)/q) - 1, n) == 1 */
+            mpz_divexact(e, m, q);
+            mpz_powm(t, a->z, e, n);
+            mpz_sub_ui(e, t, 1);
+            mpz_gcd(e, e, n);
+            if (mpz_cmp_ui(e, 1) != 0) {
+                goto cleanup;
+            }
+            mpz_powm(t, t, q, n);
+            if (mpz_cmp_ui(t, 1) != 0) {
+                goto cleanup;
+            }
+            Py_CLEAR(a);
+        }
+    }
+    result = 1;
+
+  cleanup:
+    Py_XDECREF((PyObject*)a);
+    mpz_clear(q);
+    mpz_clear(prev);
+    mpz_clear(t);
+    mpz_clear(e);
+    return result;
+}
+
+/* Returns 1 and sets q to the prime if cert is a valid certificate, 0 if it
+ * is not valid, and -1 if an error occurred.
+ */
+
+static int
+prove_verify(PyObject *cert, mpz_t q)
+{
+    MPZ_Object *n = NULL, *p = NULL, *qq = NULL;
+    PyObject *tag;
+    mpz_t m, F, t, *primes = NULL;
+    Py_ssize_t i, count = 0, size;
+    int result = 0, minus;
+
+    if (!PyTuple_Check(cert)) {
+        if (!(n = prove_cert_integer(cert))) {
+            return 0;
+        }
+        result = (mpz_sizeinbase(n->z, 2) <= 64) && prove_small_is_prime(n->z);
+        mpz_set(q, n->z);
+        Py_DECREF((PyObject*)n);
+        return result;
+    }
+
+    size = PyTuple_GET_SIZE(cert);
+    if (size < 3 || !(n = prove_cert_integer(PyTuple_GET_ITEM(cert, 0)))) {
+        return 0;
+    }
+    tag = PyTuple_GET_ITEM(cert, 1);
+    if (!PyUnicode_Check(tag)) {
+        Py_DECREF((PyObject*)n);
+        return 0;
+    }
+    if (size == 3 && PyUnicode_CompareWithASCIIString(tag, "n-1") == 0) {
+        minus = 1;
+    }
+    else if (size == 5 && PyUnicode_CompareWithASCIIString(tag, "n+1") == 0) {
+        minus = 0;
+    }
+    else {
+        Py_DECREF((PyObject*)n);
+        return 0;
+    }
+
+    if (mpz_cmp_ui(n->z, 3) < 0 || mpz_even_p(n->z)) {
+        Py_DECREF((PyObject*)n);
+        return 0;
+    }
+
+    mpz_init(m);
+    mpz_init(F);
+    mpz_init(t);
+
+    if (minus) {
+        mpz_sub_ui(m, n->z, 1);
+        result = prove_verify_factors(PyTuple_GET_ITEM(cert, 2), 1, F,
+                                      &primes, &count, m, n->z);
+        if (result == 1) {
+            mpz_add_ui(t, F, 1);
+            mpz_mul(t, t, t);
+            if (mpz_cmp(t, n->z) <= 0 && !prove_bls_condition(F, n->z)) {
+                result = 0;
+            }
+        }
+    }
+    else {
+        mpz_add_ui(m, n->z, 1);
+        if (!(p = prove_cert_integer(PyTuple_GET_ITEM(cert, 2))) ||
+            !(qq = prove_cert_integer(PyTuple_GET_ITEM(cert, 3))) ||
+            !mpz_fits_slong_p(p->z) || !mpz_fits_slong_p(qq->z) ||
+            mpz_cmpabs_ui(p->z, 1UL << 30) > 0 ||
+            mpz_cmpabs_ui(qq->z, 1UL << 28) > 0) {
+            result = 0;
+            goto cleanup;
+        }
+        /* gcd(n, 2*Q) == 1 and jacobi(P*P - 4*Q, n) == -1 */
+        mpz_gcd(t, n->z, qq->z);
+        if (mpz_cmp_ui(t, 1) != 0) {
+            result = 0;
+            goto cleanup;
+        }
+        mpz_mul(t, p->z, p->z);
+        mpz_submul_ui(t, qq->z, 4);
+        if (mpz_jacobi(t, n->z) != -1) {
+            result = 0;
+            goto cleanup;
+        }
+        prove_lucas_u(t, m, mpz_get_si(p->z), mpz_get_si(qq->z), n->z);
+        if (mpz_sgn(t) != 0) {
+            result = 0;
+            goto cleanup;
+        }
+        result = prove_verify_factors(PyTuple_GET_ITEM(cert, 4), 0, F,
+                                      &primes, &count, m, n->z);
+        for (i = 0; result == 1 && i < count; i++) {
+            mpz_divexact(t, m, primes[i]);
+            prove_lucas_u(t, t, mpz_get_si(p->z), mpz_get_si(qq->z), n->z);
+            mpz_gcd(t, t, n->z);
+            if (mpz_cmp_ui(t, 1) != 0) {
+                result = 0;
+            }
+        }
+        if (result == 1) {
+            mpz_sub_ui(t, F, 1);
+            mpz_mul(t, t, t);
+            if (mpz_cmp(t, n->z) <= 0) {
+                result = 0;
+            }
+        }
+    }
+    mpz_set(q, n->z);
+
+  cleanup:
+    if (primes) {
+        for (i = 0; i < count; i++) {
+            mpz_clear(primes[i]);
+        }
+        free(primes);
+    }
+    Py_XDECREF((PyObject*)n);
+    Py_XDECREF((PyObject*)p);
+    Py_XDECREF((PyObject*)qq);
+    mpz_clear(m);
+    mpz_clear(F);
+    mpz_clear(t);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_verify_prime_certificate,
+"verify_prime_certificate(cert, /) -> bool\n\n"
+"Return `True` if cert is a valid primality certificate as returned\n"
+"by `prime_certificate()`. The prime that is proven is cert itself\n"
+"if cert is an integer, otherwise cert[0].");
+
+static PyObject *
+GMPy_MPZ_Function_VerifyPrimeCertificate(PyObject *self, PyObject *other)
+{
+    mpz_t q;
+    int result;
+
+    mpz_init(q);
+    result = prove_verify(other, q);
+    mpz_clear(q);
+
+    if (result < 0) {
+        return NULL;
+    }
+    return PyBool_FromLong(result);
+}
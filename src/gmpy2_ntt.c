@@ -0,0 +1,1119 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_ntt.c                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Polynomial arithmetic using number-theoretic transforms.
+ *
+ * Polynomials are arrays of mpz_t coefficients, constant term first. A
+ * product is computed modulo several primes p = c*2**32 + 1 < 2**62, each
+ * of which has a root of unity of order 2**32, and the coefficients are
+ * lifted back to mpz using the CRT tree of an rns basis (see gmpy2_rns.c).
+ * Enough primes are used that their product is more than twice the largest
+ * possible coefficient, so the result is exact. The transforms for each
+ * prime are independent and run without the GIL.
+ *
+ * Division modulo m uses Newton iteration to compute the reciprocal of the
+ * reversed divisor and multipoint evaluation uses a subproduct tree. Both
+ * are built on top of the NTT product.
+ */
+
+#define NTT_ROOT_BITS      32
+#define NTT_PRIME_BITS     61   /* every prime is > 2**61 */
+#define NTT_MUL_THRESHOLD  16   /* schoolbook products below this length */
+#define NTT_DIV_THRESHOLD  32   /* long division below this quotient length */
+#define NTT_EVAL_THRESHOLD 32   /* Horner's rule below this many points */
+
+/* The primes are found on demand, in decreasing order, and the rns basis
+ * built from the first k primes is cached in ntt_bases[k]. Both are only
+ * modified while holding the GIL; a basis is never freed once created.
+ */
+
+static uint64_t *ntt_primes = NULL;
+static Py_ssize_t ntt_prime_count = 0;
+static uint64_t ntt_next_c = (UINT64_C(1) << (RNS_MAX_BITS - NTT_ROOT_BITS)) - 1;
+static rns_basis **ntt_bases = NULL;
+static Py_ssize_t ntt_bases_alloc = 0;
+
+#if defined(__SIZEOF_INT128__)
+
+/* Multiplication by a fixed w < p using Shoup's precomputed quotient
+ * wpre = floor(w * 2**64 / p).
+ */
+
+static inline uint64_t
+ntt_shoup_pre(uint64_t w, uint64_t p)
+{
+    return (uint64_t)((((rns_u128)w) << 64) / p);
+}
+
+static inline uint64_t
+ntt_mulmod_shoup(uint64_t a, uint64_t w, uint64_t wpre, uint64_t p)
+{
+    uint64_t q = (uint64_t)(((rns_u128)a * wpre) >> 64);
+    uint64_t r = a * w - q * p;
+
+    return (r >= p) ? r - p : r;
+}
+
+#else
+
+static inline uint64_t
+ntt_shoup_pre(uint64_t w, uint64_t p)
+{
+    return 0;
+}
+
+static inline uint64_t
+ntt_mulmod_shoup(uint64_t a, uint64_t w, uint64_t wpre, uint64_t p)
+{
+    return rns_mulmod(a, w, p, 0, 0);
+}
+
+#endif
+
+static uint64_t
+ntt_powmod(uint64_t b, uint64_t e, uint64_t p, uint64_t mu, int k)
+{
+    uint64_t r = 1;
+
+    while (e) {
+        if (e & 1) {
+            r = rns_mulmod(r, b, p, mu, k);
+        }
+        b = rns_mulmod(b, b, p, mu, k);
+        e >>= 1;
+    }
+    return r;
+}
+
+/* Deterministic Miller-Rabin test for odd n > 37 and n < 2**62. */
+
+static int
+ntt_is_prime(uint64_t n)
+{
+    static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    uint64_t d = n - 1, x, mu;
+    int i, r, s = 0, k = RNS_MAX_BITS;
+
+    while (k > 1 && !(n >> (k - 1))) {
+        k--;
+    }
+    mu = rns_barrett_mu(n, k);
+    while (!(d & 1)) {
+        d >>= 1;
+        s++;
+    }
+    for (i = 0; i < 12; i++) {
+        x = ntt_powmod(bases[i], d, n, mu, k);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        for (r = 1; r < s; r++) {
+            x = rns_mulmod(x, x, n, mu, k);
+            if (x == n - 1) {
+                break;
+            }
+        }
+        if (r == s) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Return the basis made from the first count primes, or NULL with an
+ * exception set. The GIL must be held.
+ */
+
+GMPY_MUTEX(ntt_lock);
+
+static rns_basis *
+_ntt_get_basis(Py_ssize_t count)
+{
+    rns_basis **bases;
+    uint64_t *primes, p;
+
+    if (count < ntt_bases_alloc && ntt_bases[count]) {
+        return ntt_bases[count];
+    }
+
+    if (count >= ntt_bases_alloc) {
+        if (!(bases = PyMem_Realloc(ntt_bases, (count + 1) * sizeof(rns_basis*)))) {
+            /* LCOV_EXCL_START */
+            return (rns_basis*)PyErr_NoMemory();
+            /* LCOV_EXCL_STOP */
+        }
+        memset(bases + ntt_bases_alloc, 0,
+               (count + 1 - ntt_bases_alloc) * sizeof(rns_basis*));
+        ntt_bases = bases;
+        ntt_bases_alloc = count + 1;
+    }
+
+    if (count > ntt_prime_count) {
+        if (!(primes = PyMem_Realloc(ntt_primes, count * sizeof(uint64_t)))) {
+            /* LCOV_EXCL_START */
+            return (rns_basis*)PyErr_NoMemory();
+            /* LCOV_EXCL_STOP */
+        }
+        ntt_primes = primes;
+        while (ntt_prime_count < count) {
+            if (ntt_next_c < (UINT64_C(1) << (NTT_PRIME_BITS - NTT_ROOT_BITS))) {
+                /* LCOV_EXCL_START */
+                OVERFLOW_ERROR("polynomial coefficients are too large");
+                return NULL;
+                /* LCOV_EXCL_STOP */
+            }
+            p = (ntt_next_c-- << NTT_ROOT_BITS) + 1;
+            if (ntt_is_prime(p)) {
+                ntt_primes[ntt_prime_count++] = p;
+            }
+        }
+    }
+
+    ntt_bases[count] = rns_basis_from_array(ntt_primes, count);
+    return ntt_bases[count];
+}
+
+static rns_basis *
+ntt_get_basis(Py_ssize_t count)
+{
+    rns_basis *result;
+
+    GMPY_LOCK(ntt_lock);
+    result = _ntt_get_basis(count);
+    GMPY_UNLOCK(ntt_lock);
+    return result;
+}
+
+/* Return the number of primes needed to represent values with the given
+ * number of bits, plus a sign bit.
+ */
+
+static Py_ssize_t
+ntt_prime_count_for(size_t bits)
+{
+    return (Py_ssize_t)((bits + 1) / NTT_PRIME_BITS + 1);
+}
+
+static size_t
+ntt_bit_length(size_t n)
+{
+    size_t r = 0;
+
+    while (n) {
+        r++;
+        n >>= 1;
+    }
+    return r;
+}
+
+/* Forward transform of length n using decimation in frequency. The input
+ * is in natural order and the output is in bit-reversed order. w[j] is
+ * omega**j for j < n/2 where omega has order n.
+ */
+
+static void
+ntt_forward(uint64_t *a, size_t n, const uint64_t *w, const uint64_t *wpre,
+            uint64_t p)
+{
+    size_t len, st, s, j;
+    uint64_t u, v;
+
+    for (len = n / 2, st = 1; len >= 1; len >>= 1, st <<= 1) {
+        for (s = 0; s < n; s += 2 * len) {
+            for (j = 0; j < len; j++) {
+                u = a[s + j];
+                v = a[s + j + len];
+                a[s + j] = rns_addmod(u, v, p);
+                a[s + j + len] = ntt_mulmod_shoup(rns_submod(u, v, p),
+                                                  w[j * st], wpre[j * st], p);
+            }
+        }
+    }
+}
+
+/* Inverse transform using decimation in time; the input is in bit-reversed
+ * order and the output in natural order. The result is not scaled by 1/n.
+ * w[j] is omega**-j.
+ */
+
+static void
+ntt_inverse(uint64_t *a, size_t n, const uint64_t *w, const uint64_t *wpre,
+            uint64_t p)
+{
+    size_t len, st, s, j;
+    uint64_t u, v;
+
+    for (len = 1, st = n / 2; len < n; len <<= 1, st >>= 1) {
+        for (s = 0; s < n; s += 2 * len) {
+            for (j = 0; j < len; j++) {
+                u = a[s + j];
+                v = ntt_mulmod_shoup(a[s + j + len], w[j * st], wpre[j * st], p);
+                a[s + j] = rns_addmod(u, v, p);
+                a[s + j + len] = rns_submod(u, v, p);
+            }
+        }
+    }
+}
+
+/* Fill w[0..half-1] with powers of x and their Shoup quotients. */
+
+static void
+ntt_powers(uint64_t *w, uint64_t *wpre, size_t half, uint64_t x, uint64_t p,
+           uint64_t mu, int k)
+{
+    size_t j;
+
+    w[0] = 1;
+    for (j = 1; j < half; j++) {
+        w[j] = rns_mulmod(w[j - 1], x, p, mu, k);
+    }
+    for (j = 0; j < half; j++) {
+        wpre[j] = ntt_shoup_pre(w[j], p);
+    }
+}
+
+/* Multiply the polynomials whose residues modulo p are stored in fa and fb
+ * (zero padded to length n). The product is stored in fa. If fb is NULL,
+ * fa is squared.
+ */
+
+static void
+ntt_mul_prime(uint64_t *fa, uint64_t *fb, size_t n, uint64_t p, uint64_t mu,
+              int k, uint64_t *w, uint64_t *wpre)
+{
+    uint64_t c = (p - 1) >> NTT_ROOT_BITS, g, root, omega, ninv;
+    size_t i, logn = ntt_bit_length(n) - 1;
+
+    /* A quadratic non-residue raised to the power c has order 2**32. */
+    for (g = 3; ntt_powmod(g, (p - 1) / 2, p, mu, k) != p - 1; g++);
+    root = ntt_powmod(g, c, p, mu, k);
+    omega = ntt_powmod(root, UINT64_C(1) << (NTT_ROOT_BITS - logn), p, mu, k);
+
+    ntt_powers(w, wpre, n / 2, omega, p, mu, k);
+    ntt_forward(fa, n, w, wpre, p);
+    if (fb) {
+        ntt_forward(fb, n, w, wpre, p);
+        for (i = 0; i < n; i++) {
+            fa[i] = rns_mulmod(fa[i], fb[i], p, mu, k);
+        }
+    }
+    else {
+        for (i = 0; i < n; i++) {
+            fa[i] = rns_mulmod(fa[i], fa[i], p, mu, k);
+        }
+    }
+
+    ntt_powers(w, wpre, n / 2, ntt_powmod(omega, n - 1, p, mu, k), p, mu, k);
+    ntt_inverse(fa, n, w, wpre, p);
+    ninv = ntt_powmod(n % p, p - 2, p, mu, k);
+    for (i = 0; i < n; i++) {
+        fa[i] = rns_mulmod(fa[i], ninv, p, mu, k);
+    }
+}
+
+static mpz_t *
+ntt_vec_new(Py_ssize_t n)
+{
+    mpz_t *v;
+    Py_ssize_t i;
+
+    if ((v = malloc((n ? n : 1) * sizeof(mpz_t)))) {
+        for (i = 0; i < n; i++) {
+            mpz_init(v[i]);
+        }
+    }
+    return v;
+}
+
+static void
+ntt_vec_free(mpz_t *v, Py_ssize_t n)
+{
+    Py_ssize_t i;
+
+    if (v) {
+        for (i = 0; i < n; i++) {
+            mpz_clear(v[i]);
+        }
+        free(v);
+    }
+}
+
+/* Set r[0..na+nb-2] to the product of a[0..na-1] and b[0..nb-1] where
+ * na, nb >= 1. r must not overlap a or b. If m is not NULL, the
+ * coefficients of a and b must be in [0, m) and the result is reduced
+ * modulo m. Otherwise the coefficients may be negative and the basis must
+ * have enough primes for the result. Returns 0 on success or -1 if memory
+ * could not be allocated. Does not need the GIL.
+ */
+
+static int
+ntt_poly_mul(mpz_t *r, mpz_t *a, Py_ssize_t na, mpz_t *b, Py_ssize_t nb,
+             mpz_srcptr m, const rns_basis *basis)
+{
+    uint64_t *fa = NULL, *fb = NULL, *w = NULL, *wpre = NULL;
+    Py_ssize_t i, j, nr = na + nb - 1;
+    size_t n = 1;
+    int square = (a == b && na == nb);
+    mpz_t half;
+
+    if (na < NTT_MUL_THRESHOLD || nb < NTT_MUL_THRESHOLD) {
+        for (i = 0; i < nr; i++) {
+            mpz_set_ui(r[i], 0);
+        }
+        for (i = 0; i < na; i++) {
+            for (j = 0; j < nb; j++) {
+                mpz_addmul(r[i + j], a[i], b[j]);
+            }
+        }
+        if (m) {
+            for (i = 0; i < nr; i++) {
+                mpz_mod(r[i], r[i], m);
+            }
+        }
+        return 0;
+    }
+
+    while (n < (size_t)nr) {
+        n <<= 1;
+    }
+    if (ntt_bit_length(n) - 1 > NTT_ROOT_BITS ||
+        n > PY_SSIZE_T_MAX / sizeof(uint64_t) / basis->count) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (!(fa = calloc(n * basis->count, sizeof(uint64_t))) ||
+        (!square && !(fb = calloc(n * basis->count, sizeof(uint64_t)))) ||
+        !(w = malloc(n / 2 * sizeof(uint64_t))) ||
+        !(wpre = malloc(n / 2 * sizeof(uint64_t)))) {
+        /* LCOV_EXCL_START */
+        free(fa);
+        free(fb);
+        free(w);
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 0; i < na; i++) {
+        rns_from_mpz(basis, fa + i, n, a[i]);
+    }
+    if (!square) {
+        for (i = 0; i < nb; i++) {
+            rns_from_mpz(basis, fb + i, n, b[i]);
+        }
+    }
+
+    for (j = 0; j < basis->count; j++) {
+        ntt_mul_prime(fa + j * n, square ? NULL : fb + j * n, n,
+                      basis->mod[j], basis->mu[j], basis->bits[j], w, wpre);
+    }
+
+    mpz_init(half);
+    mpz_fdiv_q_2exp(half, basis->prod[1], 1);
+    for (i = 0; i < nr; i++) {
+        rns_to_mpz(basis, fa + i, n, r[i]);
+        if (m) {
+            mpz_mod(r[i], r[i], m);
+        }
+        else if (mpz_cmp(r[i], half) > 0) {
+            mpz_sub(r[i], r[i], basis->prod[1]);
+        }
+    }
+    mpz_clear(half);
+
+    free(fa);
+    free(fb);
+    free(w);
+    free(wpre);
+    return 0;
+}
+
+/* Set dst[0..len-1] to the product of a and b modulo x**len and m. */
+
+static int
+ntt_poly_mul_trunc(mpz_t *dst, Py_ssize_t len, mpz_t *a, Py_ssize_t na,
+                   mpz_t *b, Py_ssize_t nb, mpz_srcptr m,
+                   const rns_basis *basis)
+{
+    mpz_t *t;
+    Py_ssize_t i, nt = na + nb - 1;
+
+    if (!(t = ntt_vec_new(nt))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    if (ntt_poly_mul(t, a, na, b, nb, m, basis)) {
+        /* LCOV_EXCL_START */
+        ntt_vec_free(t, nt);
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < len; i++) {
+        if (i < nt)
+            mpz_swap(dst[i], t[i]);
+        else
+            mpz_set_ui(dst[i], 0);
+    }
+    ntt_vec_free(t, nt);
+    return 0;
+}
+
+/* Divide a[0..na-1] by b[0..nb-1] modulo m where na >= nb >= 1, the
+ * coefficients are in [0, m), and lcinv is the inverse of b[nb-1] modulo m.
+ * The quotient is stored in q[0..na-nb] and the remainder in r[0..nb-2].
+ * Returns 0 on success or -1 if memory could not be allocated. Does not
+ * need the GIL.
+ */
+
+static int
+ntt_poly_divrem(mpz_t *q, mpz_t *r, mpz_t *a, Py_ssize_t na, mpz_t *b,
+                Py_ssize_t nb, mpz_srcptr lcinv, mpz_srcptr m,
+                const rns_basis *basis)
+{
+    mpz_t *t = NULL, *f = NULL, *g = NULL, *e = NULL;
+    Py_ssize_t i, j, l, l2, kq = na - nb + 1;
+    int rc = -1;
+
+    if (kq < NTT_DIV_THRESHOLD || nb < NTT_MUL_THRESHOLD) {
+        /* Long division. */
+        if (!(t = ntt_vec_new(na))) {
+            /* LCOV_EXCL_START */
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        for (i = 0; i < na; i++) {
+            mpz_set(t[i], a[i]);
+        }
+        for (i = kq - 1; i >= 0; i--) {
+            mpz_mul(q[i], t[i + nb - 1], lcinv);
+            mpz_mod(q[i], q[i], m);
+            for (j = 0; j < nb - 1; j++) {
+                mpz_submul(t[i + j], q[i], b[j]);
+                mpz_mod(t[i + j], t[i + j], m);
+            }
+        }
+        for (i = 0; i < nb - 1; i++) {
+            mpz_swap(r[i], t[i]);
+        }
+        ntt_vec_free(t, na);
+        return 0;
+    }
+
+    /* Compute g = 1/f modulo x**kq where f is b reversed, using the Newton
+     * iteration g = g*(2 - f*g), then the reversed quotient is a reversed
+     * times g modulo x**kq.
+     */
+    if (!(f = ntt_vec_new(nb)) || !(g = ntt_vec_new(kq)) ||
+        !(e = ntt_vec_new(na > 2 * kq ? na : 2 * kq))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < nb; i++) {
+        mpz_set(f[i], b[nb - 1 - i]);
+    }
+    mpz_set(g[0], lcinv);
+    for (l = 1; l < kq; l = l2) {
+        l2 = (2 * l < kq) ? 2 * l : kq;
+        if (ntt_poly_mul_trunc(e, l2, f, (nb < l2) ? nb : l2, g, l, m, basis)) {
+            /* LCOV_EXCL_START */
+            goto done;
+            /* LCOV_EXCL_STOP */
+        }
+        for (i = 0; i < l2; i++) {
+            if (mpz_sgn(e[i]))
+                mpz_sub(e[i], m, e[i]);
+        }
+        mpz_add_ui(e[0], e[0], 2);
+        mpz_mod(e[0], e[0], m);
+        if (ntt_poly_mul_trunc(g, l2, g, l, e, l2, m, basis)) {
+            /* LCOV_EXCL_START */
+            goto done;
+            /* LCOV_EXCL_STOP */
+        }
+    }
+
+    for (i = 0; i < kq; i++) {
+        mpz_set(e[i], a[na - 1 - i]);
+    }
+    if (ntt_poly_mul_trunc(e, kq, e, kq, g, kq, m, basis)) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < kq; i++) {
+        mpz_swap(q[i], e[kq - 1 - i]);
+    }
+
+    /* r = a - b*q */
+    if (ntt_poly_mul_trunc(e, nb - 1, b, nb, q, kq, m, basis)) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < nb - 1; i++) {
+        mpz_sub(r[i], a[i], e[i]);
+        mpz_mod(r[i], r[i], m);
+    }
+    rc = 0;
+
+  done:
+    ntt_vec_free(f, nb);
+    ntt_vec_free(g, kq);
+    ntt_vec_free(e, na > 2 * kq ? na : 2 * kq);
+    return rc;
+}
+
+/* Multipoint evaluation with a subproduct tree. tree[node] holds the
+ * product of (x - x[i]) for lo <= i < hi, which has hi - lo + 1
+ * coefficients.
+ */
+
+typedef struct {
+    mpz_t **tree;
+    Py_ssize_t *tlen;
+    mpz_t *x;
+    mpz_t *out;
+    mpz_srcptr m;
+    const rns_basis *basis;
+} ntt_eval_state;
+
+static int
+ntt_eval_build(ntt_eval_state *s, Py_ssize_t node, Py_ssize_t lo, Py_ssize_t hi)
+{
+    Py_ssize_t i, k, d, mid = lo + (hi - lo) / 2;
+    mpz_t *v;
+
+    if (!(v = s->tree[node] = ntt_vec_new(hi - lo + 1))) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    s->tlen[node] = hi - lo + 1;
+
+    if (hi - lo <= NTT_EVAL_THRESHOLD) {
+        mpz_set_ui(v[0], 1);
+        for (i = lo, d = 0; i < hi; i++, d++) {
+            /* Multiply v (degree d) by x - x[i]. */
+            mpz_set(v[d + 1], v[d]);
+            for (k = d; k >= 1; k--) {
+                mpz_mul(v[k], v[k], s->x[i]);
+                mpz_sub(v[k], v[k - 1], v[k]);
+                mpz_mod(v[k], v[k], s->m);
+            }
+            mpz_mul(v[0], v[0], s->x[i]);
+            mpz_neg(v[0], v[0]);
+            mpz_mod(v[0], v[0], s->m);
+        }
+        return 0;
+    }
+
+    if (ntt_eval_build(s, 2 * node, lo, mid) ||
+        ntt_eval_build(s, 2 * node + 1, mid, hi)) {
+        return -1;
+    }
+    return ntt_poly_mul(v, s->tree[2 * node], mid - lo + 1,
+                        s->tree[2 * node + 1], hi - mid + 1, s->m, s->basis);
+}
+
+/* Evaluate the polynomial r[0..nr-1] at x[lo..hi-1]. */
+
+static int
+ntt_eval_tree(ntt_eval_state *s, Py_ssize_t node, Py_ssize_t lo, Py_ssize_t hi,
+              mpz_t *r, Py_ssize_t nr)
+{
+    Py_ssize_t i, k, len = hi - lo + 1, mid = lo + (hi - lo) / 2, nq = 0;
+    mpz_t *q = NULL, *rem = NULL, one;
+    int rc = -1;
+
+    if (nr >= len) {
+        /* Reduce r modulo the monic polynomial tree[node]. */
+        nq = nr - len + 1;
+        if (!(q = ntt_vec_new(nq)) || !(rem = ntt_vec_new(len - 1))) {
+            /* LCOV_EXCL_START */
+            goto done;
+            /* LCOV_EXCL_STOP */
+        }
+        mpz_init_set_ui(one, 1);
+        rc = ntt_poly_divrem(q, rem, r, nr, s->tree[node], len, one, s->m, s->basis);
+        mpz_clear(one);
+        if (rc) {
+            /* LCOV_EXCL_START */
+            goto done;
+            /* LCOV_EXCL_STOP */
+        }
+        r = rem;
+        nr = len - 1;
+    }
+
+    if (hi - lo <= NTT_EVAL_THRESHOLD) {
+        for (i = lo; i < hi; i++) {
+            mpz_set_ui(s->out[i], 0);
+            for (k = nr - 1; k >= 0; k--) {
+                mpz_mul(s->out[i], s->out[i], s->x[i]);
+                mpz_add(s->out[i], s->out[i], r[k]);
+                mpz_mod(s->out[i], s->out[i], s->m);
+            }
+        }
+        rc = 0;
+    }
+    else if (ntt_eval_tree(s, 2 * node, lo, mid, r, nr) ||
+             ntt_eval_tree(s, 2 * node + 1, mid, hi, r, nr)) {
+        rc = -1;
+    }
+    else {
+        rc = 0;
+    }
+
+  done:
+    ntt_vec_free(q, nq);
+    ntt_vec_free(rem, len - 1);
+    return rc;
+}
+
+/* Set out[i] to the value of a[0..na-1] at x[i] modulo m for 0 <= i < n,
+ * where n >= 1. Returns 0 on success or -1 if memory could not be
+ * allocated. Does not need the GIL.
+ */
+
+static int
+ntt_poly_eval(mpz_t *out, mpz_t *a, Py_ssize_t na, mpz_t *x, Py_ssize_t n,
+              mpz_srcptr m, const rns_basis *basis)
+{
+    ntt_eval_state s;
+    Py_ssize_t i;
+    int rc = -1;
+
+    s.tree = calloc(4 * n, sizeof(mpz_t*));
+    s.tlen = calloc(4 * n, sizeof(Py_ssize_t));
+    s.x = x;
+    s.out = out;
+    s.m = m;
+    s.basis = basis;
+
+    if (s.tree && s.tlen && !ntt_eval_build(&s, 1, 0, n)) {
+        rc = ntt_eval_tree(&s, 1, 0, n, a, na);
+    }
+
+    if (s.tree && s.tlen) {
+        for (i = 1; i < 4 * n; i++) {
+            ntt_vec_free(s.tree[i], s.tlen[i]);
+        }
+    }
+    free(s.tree);
+    free(s.tlen);
+    return rc;
+}
+
+/* Convert a sequence of integers to a vector of mpz_t, reduced modulo m if
+ * m is not NULL. If strip is set, high order zero coefficients are removed.
+ */
+
+static mpz_t *
+ntt_vec_from_seq(PyObject *obj, Py_ssize_t *n, mpz_srcptr m, int strip,
+                 const char *name)
+{
+    PyObject *seq;
+    MPZ_Object *temp;
+    mpz_t *v;
+    Py_ssize_t i, size;
+
+    if (!(seq = PySequence_Fast(obj, ""))) {
+        PyErr_Format(PyExc_TypeError, "%s() requires sequences of integers", name);
+        return NULL;
+    }
+    size = PySequence_Fast_GET_SIZE(seq);
+    if (!(v = ntt_vec_new(size))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < size; i++) {
+        if (!(temp = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), NULL))) {
+            PyErr_Format(PyExc_TypeError, "%s() requires sequences of integers", name);
+            ntt_vec_free(v, size);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        if (m)
+            mpz_mod(v[i], temp->z, m);
+        else
+            mpz_set(v[i], temp->z);
+        Py_DECREF((PyObject*)temp);
+    }
+    Py_DECREF(seq);
+
+    for (*n = size; strip && *n > 0 && !mpz_sgn(v[*n - 1]); (*n)--);
+    for (i = *n; i < size; i++) {
+        mpz_clear(v[i]);
+    }
+    return v;
+}
+
+/* Return the coefficients v[0..n-1] as a list of mpz without high order
+ * zero coefficients. The values in v are moved into the list.
+ */
+
+static PyObject *
+ntt_vec_to_list(mpz_t *v, Py_ssize_t n)
+{
+    PyObject *result;
+    MPZ_Object *temp;
+    Py_ssize_t i;
+
+    while (n > 0 && !mpz_sgn(v[n - 1])) {
+        n--;
+    }
+    if (!(result = PyList_New(n))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < n; i++) {
+        if (!(temp = GMPy_MPZ_New(NULL))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        mpz_swap(temp->z, v[i]);
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+    }
+    return result;
+}
+
+static MPZ_Object *
+ntt_get_modulus(PyObject *obj, const char *name)
+{
+    MPZ_Object *result;
+
+    if (!(result = GMPy_MPZ_From_Integer(obj, NULL))) {
+        PyErr_Format(PyExc_TypeError, "%s() requires an integer modulus", name);
+        return NULL;
+    }
+    if (mpz_cmp_ui(result->z, 2) < 0) {
+        PyErr_Format(PyExc_ValueError, "%s() requires modulus > 1", name);
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return result;
+}
+
+static size_t
+ntt_vec_max_bits(mpz_t *v, Py_ssize_t n)
+{
+    size_t bits = 0, t;
+    Py_ssize_t i;
+
+    for (i = 0; i < n; i++) {
+        t = mpz_sizeinbase(v[i], 2);
+        bits = (t > bits) ? t : bits;
+    }
+    return bits;
+}
+
+/* Shared implementation of poly_mul() and poly_sqr(). If y is NULL, x is
+ * squared.
+ */
+
+static PyObject *
+ntt_mul_function(PyObject *x, PyObject *y, PyObject *modulus, const char *name)
+{
+    PyObject *result = NULL;
+    MPZ_Object *m = NULL;
+    CTXT_Object *context = NULL;
+    mpz_t *a = NULL, *b = NULL, *r = NULL;
+    Py_ssize_t na = 0, nb = 0, nr = 0;
+    rns_basis *basis = NULL;
+    size_t bits;
+    int rc;
+
+    CHECK_CONTEXT(context);
+
+    if (modulus != Py_None && !(m = ntt_get_modulus(modulus, name))) {
+        return NULL;
+    }
+    if (!(a = ntt_vec_from_seq(x, &na, m ? m->z : NULL, 1, name)) ||
+        (y && !(b = ntt_vec_from_seq(y, &nb, m ? m->z : NULL, 1, name)))) {
+        goto done;
+    }
+    if (!y) {
+        b = a;
+        nb = na;
+    }
+
+    if (na == 0 || nb == 0) {
+        result = PyList_New(0);
+        goto done;
+    }
+
+    nr = na + nb - 1;
+    if (na >= NTT_MUL_THRESHOLD && nb >= NTT_MUL_THRESHOLD) {
+        if (m)
+            bits = 2 * mpz_sizeinbase(m->z, 2);
+        else
+            bits = ntt_vec_max_bits(a, na) + ntt_vec_max_bits(b, nb) + 1;
+        bits += ntt_bit_length(na < nb ? na : nb);
+        if (!(basis = ntt_get_basis(ntt_prime_count_for(bits)))) {
+            goto done;
+        }
+    }
+
+    if (!(r = ntt_vec_new(nr))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    rc = ntt_poly_mul(r, a, na, b, nb, m ? m->z : NULL, basis);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+    if (rc) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    result = ntt_vec_to_list(r, nr);
+
+  done:
+    ntt_vec_free(r, nr);
+    if (b != a) {
+        ntt_vec_free(b, nb);
+    }
+    ntt_vec_free(a, na);
+    Py_XDECREF((PyObject*)m);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_poly_mul,
+"poly_mul(a, b, /, modulus=None) -> list[mpz]\n\n"
+"Return the product of the polynomials a and b, given as sequences of\n"
+"integer coefficients with the constant term first. If modulus is given,\n"
+"the coefficients are reduced modulo modulus. Large products are computed\n"
+"using number-theoretic transforms modulo several word-size primes and\n"
+"the Chinese Remainder Theorem. High order zero coefficients are removed\n"
+"from the result.");
+
+static PyObject *
+GMPy_MPZ_Function_PolyMul(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *a, *b, *modulus = Py_None;
+    static char *kwlist[] = {"", "", "modulus", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|O", kwlist,
+                                     &a, &b, &modulus)) {
+        return NULL;
+    }
+    return ntt_mul_function(a, b, modulus, "poly_mul");
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_poly_sqr,
+"poly_sqr(a, /, modulus=None) -> list[mpz]\n\n"
+"Return the square of the polynomial a. This is faster than\n"
+"poly_mul(a, a) since only one forward transform is needed.");
+
+static PyObject *
+GMPy_MPZ_Function_PolySqr(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *a, *modulus = Py_None;
+    static char *kwlist[] = {"", "modulus", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist,
+                                     &a, &modulus)) {
+        return NULL;
+    }
+    return ntt_mul_function(a, NULL, modulus, "poly_sqr");
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_poly_divmod,
+"poly_divmod(a, b, modulus, /) -> tuple[list[mpz], list[mpz]]\n\n"
+"Return the quotient and remainder of the polynomial a divided by the\n"
+"polynomial b with coefficients modulo modulus. The leading coefficient\n"
+"of b must be invertible modulo modulus. Large divisions use Newton\n"
+"iteration to compute the reciprocal of b.");
+
+static PyObject *
+GMPy_MPZ_Function_PolyDivMod(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *result = NULL, *ql = NULL, *rl = NULL;
+    MPZ_Object *m;
+    CTXT_Object *context = NULL;
+    mpz_t *a = NULL, *b = NULL, *q = NULL, *r = NULL, lcinv;
+    Py_ssize_t na = 0, nb = 0, nq = 0;
+    rns_basis *basis;
+    int rc;
+
+    CHECK_CONTEXT(context);
+
+    if (nargs != 3) {
+        TYPE_ERROR("poly_divmod() requires 3 arguments");
+        return NULL;
+    }
+    if (!(m = ntt_get_modulus(args[2], "poly_divmod"))) {
+        return NULL;
+    }
+    mpz_init(lcinv);
+    if (!(a = ntt_vec_from_seq(args[0], &na, m->z, 1, "poly_divmod")) ||
+        !(b = ntt_vec_from_seq(args[1], &nb, m->z, 1, "poly_divmod"))) {
+        goto done;
+    }
+    if (nb == 0) {
+        ZERO_ERROR("poly_divmod() division by zero polynomial");
+        goto done;
+    }
+    if (!mpz_invert(lcinv, b[nb - 1], m->z)) {
+        VALUE_ERROR("poly_divmod() requires the leading coefficient of b to be invertible");
+        goto done;
+    }
+
+    if (na < nb) {
+        if ((ql = PyList_New(0)) && (rl = ntt_vec_to_list(a, na))) {
+            result = PyTuple_Pack(2, ql, rl);
+        }
+        goto done;
+    }
+
+    nq = na - nb + 1;
+    if (!(basis = ntt_get_basis(ntt_prime_count_for(2 * mpz_sizeinbase(m->z, 2) +
+                                                    ntt_bit_length(na))))) {
+        goto done;
+    }
+    if (!(q = ntt_vec_new(nq)) || !(r = ntt_vec_new(nb - 1))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    rc = ntt_poly_divrem(q, r, a, na, b, nb, lcinv, m->z, basis);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+    if (rc) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    if ((ql = ntt_vec_to_list(q, nq)) && (rl = ntt_vec_to_list(r, nb - 1))) {
+        result = PyTuple_Pack(2, ql, rl);
+    }
+
+  done:
+    Py_XDECREF(ql);
+    Py_XDECREF(rl);
+    ntt_vec_free(q, nq);
+    ntt_vec_free(r, nb - 1);
+    ntt_vec_free(a, na);
+    ntt_vec_free(b, nb);
+    mpz_clear(lcinv);
+    Py_DECREF((PyObject*)m);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_poly_eval,
+"poly_eval(a, points, modulus, /) -> list[mpz]\n\n"
+"Return the values of the polynomial a at each of the points modulo\n"
+"modulus. Many points are evaluated together using a subproduct tree.");
+
+static PyObject *
+GMPy_MPZ_Function_PolyEval(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *result = NULL;
+    MPZ_Object *m;
+    CTXT_Object *context = NULL;
+    mpz_t *a = NULL, *x = NULL, *out = NULL;
+    Py_ssize_t na = 0, nx = 0, size;
+    rns_basis *basis;
+    int rc;
+
+    CHECK_CONTEXT(context);
+
+    if (nargs != 3) {
+        TYPE_ERROR("poly_eval() requires 3 arguments");
+        return NULL;
+    }
+    if (!(m = ntt_get_modulus(args[2], "poly_eval"))) {
+        return NULL;
+    }
+    if (!(a = ntt_vec_from_seq(args[0], &na, m->z, 1, "poly_eval")) ||
+        !(x = ntt_vec_from_seq(args[1], &nx, m->z, 0, "poly_eval"))) {
+        goto done;
+    }
+    if (nx == 0) {
+        result = PyList_New(0);
+        goto done;
+    }
+
+    size = (na > nx) ? na : nx;
+    if (!(basis = ntt_get_basis(ntt_prime_count_for(2 * mpz_sizeinbase(m->z, 2) +
+                                                    ntt_bit_length(size + 1))))) {
+        goto done;
+    }
+    if (!(out = ntt_vec_new(nx))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    rc = ntt_poly_eval(out, a, na, x, nx, m->z, basis);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+    if (rc) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    if ((result = PyList_New(nx))) {
+        for (size = 0; size < nx; size++) {
+            MPZ_Object *temp;
+
+            if (!(temp = GMPy_MPZ_New(NULL))) {
+                /* LCOV_EXCL_START */
+                Py_CLEAR(result);
+                goto done;
+                /* LCOV_EXCL_STOP */
+            }
+            mpz_swap(temp->z, out[size]);
+            PyList_SET_ITEM(result, size, (PyObject*)temp);
+        }
+    }
+
+  done:
+    ntt_vec_free(out, nx);
+    ntt_vec_free(x, nx);
+    ntt_vec_free(a, na);
+    Py_DECREF((PyObject*)m);
+    return result;
+}
@@ -0,0 +1,593 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_numpy.c                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Bulk conversion between gmpy2 types and arrays that support the buffer
+ * protocol, such as numpy.ndarray and array.array.
+ *
+ * from_numpy() reads the buffer directly and converts each element in a
+ * single loop. to_numpy() creates the destination array with numpy.empty()
+ * and writes each converted element into its buffer. NumPy is only needed
+ * at runtime by to_numpy(); there is no build-time dependency.
+ *
+ * Supported element formats are the native integer codes, '?', 'f', 'd',
+ * 'g', and 'O' (Python objects).
+ */
+
+#define NP_TARGET_DEFAULT  0
+#define NP_TARGET_MPZ      1
+#define NP_TARGET_MPQ      2
+#define NP_TARGET_MPFR     3
+#define NP_TARGET_MPC      4
+
+/* Return the element code of a buffer format string, or 0 if the format is
+ * not supported. Explicit byte orders are accepted only if they match the
+ * native byte order; sizes are always taken from the itemsize.
+ */
+
+static char
+np_buffer_code(const char *format, Py_ssize_t itemsize)
+{
+    char code;
+
+    if (!format)
+        return itemsize == 1 ? 'B' : 0;
+
+    if (*format == '@' || *format == '=') {
+        format++;
+    }
+#if PY_LITTLE_ENDIAN
+    else if (*format == '<') {
+        format++;
+    }
+#else
+    else if (*format == '>' || *format == '!') {
+        format++;
+    }
+#endif
+
+    code = format[0];
+    if (!code || format[1])
+        return 0;
+
+    switch (code) {
+        case 'b': case 'h': case 'i': case 'l': case 'q': case 'n':
+        case 'B': case 'H': case 'I': case 'L': case 'Q': case 'N':
+        case '?':
+            if (itemsize == 1 || itemsize == 2 || itemsize == 4 || itemsize == 8)
+                return code;
+            return 0;
+        case 'f':
+            return itemsize == (Py_ssize_t)sizeof(float) ? code : 0;
+        case 'd':
+            return itemsize == (Py_ssize_t)sizeof(double) ? code : 0;
+        case 'g':
+            return itemsize == (Py_ssize_t)sizeof(long double) ? code : 0;
+        case 'O':
+            return itemsize == (Py_ssize_t)sizeof(PyObject*) ? code : 0;
+        default:
+            return 0;
+    }
+}
+
+#define NP_IS_SIGNED(c) ((c) == 'b' || (c) == 'h' || (c) == 'i' || \
+                         (c) == 'l' || (c) == 'q' || (c) == 'n')
+#define NP_IS_FLOAT(c) ((c) == 'f' || (c) == 'd' || (c) == 'g')
+
+/* Read an integer element of the given size as a magnitude. Returns 1 if
+ * the element is negative.
+ */
+
+static int
+np_get_word(const char *ptr, char code, Py_ssize_t size, uint64_t *mag)
+{
+    int8_t s8; int16_t s16; int32_t s32; int64_t s64;
+    uint8_t u8; uint16_t u16; uint32_t u32;
+
+    if (NP_IS_SIGNED(code)) {
+        switch (size) {
+            case 1: memcpy(&s8, ptr, 1); s64 = s8; break;
+            case 2: memcpy(&s16, ptr, 2); s64 = s16; break;
+            case 4: memcpy(&s32, ptr, 4); s64 = s32; break;
+            default: memcpy(&s64, ptr, 8); break;
+        }
+        *mag = s64 < 0 ? (uint64_t)0 - (uint64_t)s64 : (uint64_t)s64;
+        return s64 < 0;
+    }
+    switch (size) {
+        case 1: memcpy(&u8, ptr, 1); *mag = u8; break;
+        case 2: memcpy(&u16, ptr, 2); *mag = u16; break;
+        case 4: memcpy(&u32, ptr, 4); *mag = u32; break;
+        default: memcpy(mag, ptr, 8); break;
+    }
+    return 0;
+}
+
+/* Read an integer element of the given size into z. */
+
+static void
+np_get_integer(mpz_t z, const char *ptr, char code, Py_ssize_t size)
+{
+    uint64_t mag;
+
+    if (np_get_word(ptr, code, size, &mag)) {
+        mpz_set_uint64(z, mag);
+        mpz_neg(z, z);
+    }
+    else {
+        mpz_set_uint64(z, mag);
+    }
+}
+
+/* Store z as an integer element of the given size. Returns -1 if z is out
+ * of range.
+ */
+
+static int
+np_set_integer(char *ptr, char code, Py_ssize_t size, mpz_t z)
+{
+    uint64_t u = 0, limit;
+    int64_t s;
+    int sign = mpz_sgn(z);
+
+    if (mpz_sizeinbase(z, 2) > 64)
+        return -1;
+    mpz_export(&u, NULL, 1, sizeof(u), 0, 0, z);
+
+    if (NP_IS_SIGNED(code)) {
+        limit = (uint64_t)1 << (size * 8 - 1);
+        if (sign >= 0 ? u >= limit : u > limit)
+            return -1;
+        s = sign >= 0 ? (int64_t)u : -(int64_t)(u - 1) - 1;
+        switch (size) {
+            case 1: { int8_t v = (int8_t)s; memcpy(ptr, &v, 1); break; }
+            case 2: { int16_t v = (int16_t)s; memcpy(ptr, &v, 2); break; }
+            case 4: { int32_t v = (int32_t)s; memcpy(ptr, &v, 4); break; }
+            default: memcpy(ptr, &s, 8); break;
+        }
+    }
+    else {
+        if (sign < 0 || (size < 8 && (u >> (size * 8))))
+            return -1;
+        switch (size) {
+            case 1: { uint8_t v = (uint8_t)u; memcpy(ptr, &v, 1); break; }
+            case 2: { uint16_t v = (uint16_t)u; memcpy(ptr, &v, 2); break; }
+            case 4: { uint32_t v = (uint32_t)u; memcpy(ptr, &v, 4); break; }
+            default: memcpy(ptr, &u, 8); break;
+        }
+    }
+    return 0;
+}
+
+/* Convert one Python object element to the requested type. */
+
+static PyObject *
+np_convert_object(PyObject *item, int target, CTXT_Object *context)
+{
+    int xtype = GMPy_ObjectType(item);
+
+    if (target == NP_TARGET_DEFAULT) {
+        if (IS_TYPE_INTEGER(xtype))
+            target = NP_TARGET_MPZ;
+        else if (IS_TYPE_RATIONAL(xtype))
+            target = NP_TARGET_MPQ;
+        else if (IS_TYPE_REAL(xtype))
+            target = NP_TARGET_MPFR;
+        else if (IS_TYPE_COMPLEX(xtype))
+            target = NP_TARGET_MPC;
+        else {
+            TYPE_ERROR("from_numpy() requires numeric elements");
+            return NULL;
+        }
+    }
+
+    switch (target) {
+        case NP_TARGET_MPZ:
+            return PyObject_CallFunctionObjArgs((PyObject*)&MPZ_Type, item, NULL);
+        case NP_TARGET_MPQ:
+            return PyObject_CallFunctionObjArgs((PyObject*)&MPQ_Type, item, NULL);
+        case NP_TARGET_MPFR:
+            if (IS_TYPE_REAL(xtype))
+                return (PyObject*)GMPy_MPFR_From_RealWithType(item, xtype, 0, context);
+            return PyObject_CallFunctionObjArgs((PyObject*)&MPFR_Type, item, NULL);
+        default:
+            if (IS_TYPE_COMPLEX(xtype))
+                return (PyObject*)GMPy_MPC_From_ComplexWithType(item, xtype, 0, 0, context);
+            return PyObject_CallFunctionObjArgs((PyObject*)&MPC_Type, item, NULL);
+    }
+}
+
+/* Convert one buffer element. tempz and tempf are scratch objects that hold
+ * the exact value of integer and floating-point elements.
+ */
+
+static PyObject *
+np_convert_element(const char *ptr, char code, Py_ssize_t size, int target,
+                   MPZ_Object *tempz, MPFR_Object *tempf, CTXT_Object *context)
+{
+    MPZ_Object *z;
+    MPFR_Object *result;
+    PyObject *item;
+    float f;
+    double d;
+    long double ld;
+
+    if (code == 'O') {
+        memcpy(&item, ptr, sizeof(PyObject*));
+        if (!item) {
+            TYPE_ERROR("from_numpy() requires numeric elements");
+            return NULL;
+        }
+        return np_convert_object(item, target, context);
+    }
+
+    if (!NP_IS_FLOAT(code)) {
+        if (code == '?')
+            mpz_set_ui(tempz->z, *ptr != 0);
+        else
+            np_get_integer(tempz->z, ptr, code, size);
+
+        switch (target) {
+            case NP_TARGET_MPQ:
+                return (PyObject*)GMPy_MPQ_From_MPZ(tempz, context);
+            case NP_TARGET_MPFR:
+                return (PyObject*)GMPy_MPFR_From_MPZ(tempz, 0, context);
+            case NP_TARGET_MPC:
+                return (PyObject*)GMPy_MPC_From_MPZ(tempz, 0, 0, context);
+            default:
+                if ((z = GMPy_MPZ_New(context)))
+                    mpz_set(z->z, tempz->z);
+                return (PyObject*)z;
+        }
+    }
+
+    /* tempf has enough precision to hold any element exactly. */
+    switch (code) {
+        case 'f':
+            memcpy(&f, ptr, sizeof(f));
+            mpfr_set_flt(tempf->f, f, MPFR_RNDN);
+            break;
+        case 'd':
+            memcpy(&d, ptr, sizeof(d));
+            mpfr_set_d(tempf->f, d, MPFR_RNDN);
+            break;
+        default:
+            memcpy(&ld, ptr, sizeof(ld));
+            mpfr_set_ld(tempf->f, ld, MPFR_RNDN);
+            break;
+    }
+
+    switch (target) {
+        case NP_TARGET_MPZ:
+            if (mpfr_nan_p(tempf->f)) {
+                VALUE_ERROR("'mpz' does not support NaN");
+                return NULL;
+            }
+            if (mpfr_inf_p(tempf->f)) {
+                OVERFLOW_ERROR("'mpz' does not support Infinity");
+                return NULL;
+            }
+            if ((z = GMPy_MPZ_New(context)))
+                mpfr_get_z(z->z, tempf->f, MPFR_RNDZ);
+            return (PyObject*)z;
+        case NP_TARGET_MPQ:
+            return (PyObject*)GMPy_MPQ_From_MPFR(tempf, context);
+        case NP_TARGET_MPC:
+            return (PyObject*)GMPy_MPC_From_MPFR(tempf, 0, 0, context);
+        default:
+            /* Not GMPy_MPFR_From_MPFR(), which can return tempf itself. */
+            if ((result = GMPy_MPFR_New(GET_MPFR_PREC(context), context))) {
+                mpfr_clear_flags();
+                result->rc = mpfr_set(result->f, tempf->f,
+                                      GET_MPFR_ROUND(context));
+                _GMPy_MPFR_Cleanup(&result, context);
+            }
+            return (PyObject*)result;
+    }
+}
+
+/* Recursively convert one dimension of the buffer to a list. */
+
+static PyObject *
+np_convert_dim(Py_buffer *view, const char *ptr, int dim, char code, int target,
+               MPZ_Object *tempz, MPFR_Object *tempf, CTXT_Object *context)
+{
+    PyObject *result, *item;
+    Py_ssize_t i, n;
+
+    if (dim == view->ndim) {
+        return np_convert_element(ptr, code, view->itemsize, target,
+                                  tempz, tempf, context);
+    }
+
+    n = view->shape[dim];
+    if (!(result = PyList_New(n)))
+        return NULL;
+
+    for (i = 0; i < n; i++) {
+        if (!(item = np_convert_dim(view, ptr + i * view->strides[dim], dim + 1,
+                                    code, target, tempz, tempf, context))) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_from_numpy,
+"from_numpy(arr, type=None, /) -> list\n\n"
+"Convert the elements of an array that supports the buffer protocol, such\n"
+"as a `numpy.ndarray`, to gmpy2 objects. The buffer is read directly.\n"
+"type may be `mpz`, `mpq`, `mpfr`, or `mpc`. If type is None, integer\n"
+"arrays are converted to `mpz`, floating-point arrays to `mpfr`, and the\n"
+"elements of object arrays to the gmpy2 type that matches each element.\n"
+"Multi-dimensional arrays are returned as nested lists, like tolist().\n"
+"Floating-point values are rounded to the current context precision.");
+
+static PyObject *
+GMPy_Function_From_NumPy(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    Py_buffer view;
+    PyObject *result = NULL, *type = Py_None;
+    MPZ_Object *tempz = NULL;
+    MPFR_Object *tempf = NULL;
+    int target;
+    char code;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (nargs < 1 || nargs > 2) {
+        TYPE_ERROR("from_numpy() requires 1 or 2 arguments");
+        return NULL;
+    }
+    if (nargs == 2)
+        type = args[1];
+
+    if (type == Py_None)
+        target = NP_TARGET_DEFAULT;
+    else if (type == (PyObject*)&MPZ_Type)
+        target = NP_TARGET_MPZ;
+    else if (type == (PyObject*)&MPQ_Type)
+        target = NP_TARGET_MPQ;
+    else if (type == (PyObject*)&MPFR_Type)
+        target = NP_TARGET_MPFR;
+    else if (type == (PyObject*)&MPC_Type)
+        target = NP_TARGET_MPC;
+    else {
+        TYPE_ERROR("from_numpy() type must be mpz, mpq, mpfr, mpc, or None");
+        return NULL;
+    }
+
+    if (PyObject_GetBuffer(args[0], &view, PyBUF_RECORDS_RO) < 0)
+        return NULL;
+
+    if (!(code = np_buffer_code(view.format, view.itemsize))) {
+        PyErr_Format(PyExc_TypeError,
+                     "from_numpy() does not support buffer format '%s'",
+                     view.format ? view.format : "B");
+        goto done;
+    }
+
+    if (target == NP_TARGET_DEFAULT && code != 'O')
+        target = NP_IS_FLOAT(code) ? NP_TARGET_MPFR : NP_TARGET_MPZ;
+
+    if (!(tempz = GMPy_MPZ_New(context)) ||
+        !(tempf = GMPy_MPFR_New(LDBL_MANT_DIG > DBL_MANT_DIG ?
+                                LDBL_MANT_DIG : DBL_MANT_DIG, context))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    result = np_convert_dim(&view, (const char*)view.buf, 0, code, target,
+                            tempz, tempf, context);
+
+  done:
+    Py_XDECREF((PyObject*)tempz);
+    Py_XDECREF((PyObject*)tempf);
+    PyBuffer_Release(&view);
+    return result;
+}
+
+/* Choose a dtype for to_numpy() when none is given: int64 if every item is
+ * an integer, float64 if every item is real, and object otherwise.
+ */
+
+static const char *
+np_default_dtype(PyObject *seq)
+{
+    Py_ssize_t i, n = PySequence_Fast_GET_SIZE(seq);
+    int all_integer = 1, xtype;
+
+    for (i = 0; i < n; i++) {
+        xtype = GMPy_ObjectType(PySequence_Fast_GET_ITEM(seq, i));
+        if (!IS_TYPE_INTEGER(xtype)) {
+            all_integer = 0;
+            if (!IS_TYPE_REAL(xtype))
+                return "object";
+        }
+    }
+    return all_integer ? "int64" : "float64";
+}
+
+/* Store one item into a buffer element. */
+
+static int
+np_store_element(char *ptr, char code, Py_ssize_t size, PyObject *item,
+                 CTXT_Object *context)
+{
+    MPZ_Object *z;
+    MPFR_Object *f;
+    PyObject *old;
+    int xtype, res;
+    float fv;
+    double dv;
+    long double ldv;
+
+    if (code == 'O') {
+        memcpy(&old, ptr, sizeof(PyObject*));
+        Py_INCREF(item);
+        memcpy(ptr, &item, sizeof(PyObject*));
+        Py_XDECREF(old);
+        return 0;
+    }
+
+    if (code == '?') {
+        if ((res = PyObject_IsTrue(item)) < 0)
+            return -1;
+        *ptr = (char)res;
+        return 0;
+    }
+
+    xtype = GMPy_ObjectType(item);
+
+    if (!NP_IS_FLOAT(code)) {
+        if (!IS_TYPE_INTEGER(xtype)) {
+            TYPE_ERROR("to_numpy() requires integer items for integer dtypes");
+            return -1;
+        }
+        if (!(z = GMPy_MPZ_From_IntegerWithType(item, xtype, context)))
+            return -1;
+        res = np_set_integer(ptr, code, size, z->z);
+        if (res < 0) {
+            if (!NP_IS_SIGNED(code) && mpz_sgn(z->z) < 0)
+                OVERFLOW_ERROR("negative value for unsigned array dtype");
+            else
+                OVERFLOW_ERROR("value too large for the array dtype");
+        }
+        Py_DECREF((PyObject*)z);
+        return res;
+    }
+
+    if (IS_TYPE_PyFloat(xtype) && code == 'd') {
+        dv = PyFloat_AS_DOUBLE(item);
+        memcpy(ptr, &dv, sizeof(dv));
+        return 0;
+    }
+
+    if (!IS_TYPE_REAL(xtype)) {
+        TYPE_ERROR("to_numpy() requires real items for floating-point dtypes");
+        return -1;
+    }
+    if (!(f = GMPy_MPFR_From_RealWithType(item, xtype, 1, context)))
+        return -1;
+
+    switch (code) {
+        case 'f':
+            fv = mpfr_get_flt(f->f, GET_MPFR_ROUND(context));
+            memcpy(ptr, &fv, sizeof(fv));
+            break;
+        case 'd':
+            dv = mpfr_get_d(f->f, GET_MPFR_ROUND(context));
+            memcpy(ptr, &dv, sizeof(dv));
+            break;
+        default:
+            ldv = mpfr_get_ld(f->f, GET_MPFR_ROUND(context));
+            memcpy(ptr, &ldv, sizeof(ldv));
+            break;
+    }
+    Py_DECREF((PyObject*)f);
+    return 0;
+}
+
+PyDoc_STRVAR(GMPy_doc_function_to_numpy,
+"to_numpy(seq, dtype=None, /) -> numpy.ndarray\n\n"
+"Return a one-dimensional `numpy.ndarray` containing the items of seq.\n"
+"The array is created with numpy.empty() and its buffer is filled\n"
+"directly. dtype may be any NumPy dtype with an integer, bool, float32,\n"
+"float64, longdouble, or object element type. Integer items that do not\n"
+"fit raise OverflowError. Real items are rounded using the rounding mode\n"
+"of the current context. If dtype is None, int64 is used if every item is\n"
+"an integer, float64 if every item is real, and object otherwise.");
+
+static PyObject *
+GMPy_Function_To_NumPy(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    Py_buffer view;
+    PyObject *seq = NULL, *numpy = NULL, *dtype = NULL, *result = NULL;
+    Py_ssize_t i, n;
+    char code;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (nargs < 1 || nargs > 2) {
+        TYPE_ERROR("to_numpy() requires 1 or 2 arguments");
+        return NULL;
+    }
+
+    if (!(seq = PySequence_Fast(args[0], "to_numpy() requires a sequence")))
+        return NULL;
+    n = PySequence_Fast_GET_SIZE(seq);
+
+    if (nargs == 2 && args[1] != Py_None) {
+        Py_INCREF(args[1]);
+        dtype = args[1];
+    }
+    else if (!(dtype = PyUnicode_FromString(np_default_dtype(seq)))) {
+        /* LCOV_EXCL_START */
+        goto error;
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (!(numpy = PyImport_ImportModule("numpy")))
+        goto error;
+
+    if (!(result = PyObject_CallMethod(numpy, "empty", "nO", n, dtype)))
+        goto error;
+
+    if (PyObject_GetBuffer(result, &view, PyBUF_RECORDS) < 0)
+        goto error;
+
+    if (view.ndim != 1 || !(code = np_buffer_code(view.format, view.itemsize))) {
+        PyErr_Format(PyExc_TypeError,
+                     "to_numpy() does not support dtype with buffer format '%s'",
+                     view.format ? view.format : "B");
+        PyBuffer_Release(&view);
+        goto error;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (np_store_element((char*)view.buf + i * view.strides[0], code,
+                             view.itemsize, PySequence_Fast_GET_ITEM(seq, i),
+                             context) < 0) {
+            PyBuffer_Release(&view);
+            goto error;
+        }
+    }
+
+    PyBuffer_Release(&view);
+    Py_DECREF(numpy);
+    Py_DECREF(dtype);
+    Py_DECREF(seq);
+    return result;
+
+  error:
+    Py_XDECREF(result);
+    Py_XDECREF(numpy);
+    Py_XDECREF(dtype);
+    Py_XDECREF(seq);
+    return NULL;
+}
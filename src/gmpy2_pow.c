@@ -148,7 +148,9 @@ GMPy_Integer_PowWithType(PyObject *b, int btype, PyObject *e, int etype,
             has_inverse = mpz_invert(base, tempb->z, mm);
             if (has_inverse) {
                 mpz_abs(exp, tempe->z);
-                mpz_powm(result->z, base, exp, mm);
+                if (!GMPy_MPZ_PowM_Parallel(result->z, base, exp, mm, context)) {
+                    mpz_powm(result->z, base, exp, mm);
+                }
             }
             mpz_clear(base);
             mpz_clear(exp);
@@ -168,6 +170,11 @@ GMPy_Integer_PowWithType(PyObject *b, int btype, PyObject *e, int etype,
                 goto err;
             }
         }
+        else if (GMPy_MPZ_PowM_Parallel(result->z, tempb->z, tempe->z, mm, context)) {
+            mpz_clear(mm);
+            if ((sign < 0) && (mpz_sgn(result->z) > 0))
+                mpz_add(result->z, result->z, tempm->z);
+        }
         else {
             GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
             mpz_powm(result->z, tempb->z, tempe->z, mm);
@@ -644,7 +651,9 @@ GMPy_Complex_PowWithType(PyObject *base, int btype, PyObject *exp, int etype,
 PyDoc_STRVAR(GMPy_doc_integer_powmod,
 "powmod(x, y, m, /) -> mpz\n\n"
 "Return (x**y) mod m. Same as the three argument version of Python's\n"
-"built-in `pow`, but converts all three arguments to `mpz`.");
+"built-in `pow`, but converts all three arguments to `mpz`. If m is\n"
+"odd with at least 262144 bits and `context.threads` is at least 4, the\n"
+"work is shared by `context.threads` threads.");
 
 static PyObject *
 GMPy_Integer_PowMod(PyObject *self, PyObject *args)
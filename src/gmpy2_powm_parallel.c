@@ -0,0 +1,426 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_powm_parallel.c                                                   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Modular exponentiation using several threads.
+ *
+ * mpz_powm() runs on a single core. For an odd modulus with at least
+ * GMPY_POWM_PARALLEL_THRESHOLD bits and context.threads of at least
+ * GMPY_POWM_PARALLEL_MIN_THREADS, b**e mod m is instead computed by
+ * left-to-right sliding window exponentiation with Barrett reduction. Every product, including the two in each reduction
+ * and those that build the window table, is split by up to POWM_MAX_DEPTH
+ * levels of Karatsuba into 3**depth independent sub-products. The worker
+ * threads and the calling thread share the sub-products, then the calling
+ * thread combines them.
+ *
+ * The workers only exist for the duration of one exponentiation. They
+ * never touch Python objects, so the whole computation runs without the
+ * GIL.
+ */
+
+#define POWM_MAX_DEPTH 4     /* at most 81 sub-products */
+#define POWM_MAX_NODES 121   /* 1 + 3 + 9 + 27 + 81 */
+#define POWM_MIN_LIMBS 128   /* smallest operand of a sub-product */
+
+typedef struct powm_pool powm_pool;
+
+typedef struct {
+    powm_pool *pool;
+    int id;
+    PyThread_type_lock start;
+    PyThread_type_lock done;
+} powm_worker;
+
+/* The Karatsuba tree of the current product is stored level by level;
+ * node i of level l is at index (3**l - 1)/2 + i and its children are the
+ * low halves, the high halves and the sums of the halves.
+ */
+
+struct powm_pool {
+    int nthreads;            /* including the calling thread */
+    int stop;
+    int square;
+    int depth;
+    mpz_t x[POWM_MAX_NODES];
+    mpz_t y[POWM_MAX_NODES];
+    mpz_t p[POWM_MAX_NODES];
+    mp_bitcnt_t half[POWM_MAX_NODES];
+    powm_worker workers[GMPY_MAX_THREADS];
+};
+
+static const int powm_pow3[POWM_MAX_DEPTH + 1] = {1, 3, 9, 27, 81};
+
+#define POWM_NODE(l, i) ((powm_pow3[l] - 1) / 2 + (i))
+
+static void
+powm_leaves(powm_pool *pool, int id)
+{
+    int i, j;
+
+    for (i = id; i < powm_pow3[pool->depth]; i += pool->nthreads) {
+        j = POWM_NODE(pool->depth, i);
+        if (pool->square) {
+            mpz_mul(pool->p[j], pool->x[j], pool->x[j]);
+        }
+        else {
+            mpz_mul(pool->p[j], pool->x[j], pool->y[j]);
+        }
+    }
+}
+
+static void
+powm_worker_main(void *arg)
+{
+    powm_worker *w = (powm_worker*)arg;
+
+    for (;;) {
+        PyThread_acquire_lock(w->start, WAIT_LOCK);
+        if (w->pool->stop) {
+            PyThread_release_lock(w->done);
+            return;
+        }
+        powm_leaves(w->pool, w->id);
+        PyThread_release_lock(w->done);
+    }
+}
+
+/* Choose the number of Karatsuba levels for operands of n limbs. The cost
+ * model assumes a product of half the size takes 0.35 of the time, which
+ * is about right for the Toom-Cook range used by GMP at these sizes.
+ */
+
+static int
+powm_depth(int nthreads, size_t n)
+{
+    int d, best = 0;
+    double scale = 1.0, cost, best_cost = 1.0;
+
+    for (d = 1; d <= POWM_MAX_DEPTH && (n >> d) >= POWM_MIN_LIMBS; d++) {
+        scale *= 0.35;
+        cost = ((powm_pow3[d] + nthreads - 1) / nthreads) * scale;
+        if (cost < best_cost) {
+            best = d;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+/* Set r = a * b. r may be the same as a or b. */
+
+static void
+powm_mul(powm_pool *pool, mpz_ptr r, mpz_srcptr a, mpz_srcptr b)
+{
+    int l, i, j, k, t;
+    size_t n;
+    mp_bitcnt_t h;
+
+    pool->square = (a == b);
+    n = mpz_size(a);
+    if (!pool->square && mpz_size(b) > n) {
+        n = mpz_size(b);
+    }
+    if (!(pool->depth = powm_depth(pool->nthreads, n))) {
+        mpz_mul(r, a, b);
+        return;
+    }
+
+    mpz_set(pool->x[0], a);
+    if (!pool->square) {
+        mpz_set(pool->y[0], b);
+    }
+
+    for (l = 0; l < pool->depth; l++) {
+        for (i = 0; i < powm_pow3[l]; i++) {
+            j = POWM_NODE(l, i);
+            k = POWM_NODE(l + 1, 3 * i);
+            n = mpz_size(pool->x[j]);
+            if (!pool->square && mpz_size(pool->y[j]) > n) {
+                n = mpz_size(pool->y[j]);
+            }
+            h = pool->half[j] = ((n + 1) / 2) * GMP_NUMB_BITS;
+            mpz_tdiv_r_2exp(pool->x[k], pool->x[j], h);
+            mpz_tdiv_q_2exp(pool->x[k + 1], pool->x[j], h);
+            mpz_add(pool->x[k + 2], pool->x[k], pool->x[k + 1]);
+            if (!pool->square) {
+                mpz_tdiv_r_2exp(pool->y[k], pool->y[j], h);
+                mpz_tdiv_q_2exp(pool->y[k + 1], pool->y[j], h);
+                mpz_add(pool->y[k + 2], pool->y[k], pool->y[k + 1]);
+            }
+        }
+    }
+
+    for (t = 1; t < pool->nthreads; t++) {
+        PyThread_release_lock(pool->workers[t].start);
+    }
+    powm_leaves(pool, 0);
+    for (t = 1; t < pool->nthreads; t++) {
+        PyThread_acquire_lock(pool->workers[t].done, WAIT_LOCK);
+    }
+
+    /* p = p0 + (p2 - p0 - p1)*2**h + p1*2**(2*h) */
+    for (l = pool->depth - 1; l >= 0; l--) {
+        for (i = 0; i < powm_pow3[l]; i++) {
+            j = POWM_NODE(l, i);
+            k = POWM_NODE(l + 1, 3 * i);
+            h = pool->half[j];
+            mpz_sub(pool->p[k + 2], pool->p[k + 2], pool->p[k]);
+            mpz_sub(pool->p[k + 2], pool->p[k + 2], pool->p[k + 1]);
+            mpz_mul_2exp(pool->p[j], pool->p[k + 1], h);
+            mpz_add(pool->p[j], pool->p[j], pool->p[k + 2]);
+            mpz_mul_2exp(pool->p[j], pool->p[j], h);
+            mpz_add(pool->p[j], pool->p[j], pool->p[k]);
+        }
+    }
+    mpz_swap(r, pool->p[0]);
+}
+
+/* Set r = x mod m for 0 <= x < m**2, where mu = floor(4**k / m) and m has
+ * k bits. t is scratch space and must differ from x.
+ */
+
+static void
+powm_reduce(powm_pool *pool, mpz_ptr r, mpz_srcptr x, mpz_srcptr m,
+            mpz_srcptr mu, mp_bitcnt_t k, mpz_ptr t)
+{
+    mpz_tdiv_q_2exp(t, x, k - 1);
+    powm_mul(pool, t, t, mu);
+    mpz_tdiv_q_2exp(t, t, k + 1);
+    powm_mul(pool, t, t, m);
+    mpz_sub(r, x, t);
+    while (mpz_cmp(r, m) >= 0) {
+        mpz_sub(r, r, m);
+    }
+}
+
+/* Start the workers. Returns the number of threads that can be used,
+ * which is 1 if no worker could be started.
+ */
+
+static int
+powm_pool_start(powm_pool *pool, int nthreads)
+{
+    int t;
+    powm_worker *w;
+
+    pool->nthreads = 1;
+    pool->stop = 0;
+    for (t = 1; t < nthreads; t++) {
+        w = &pool->workers[t];
+        w->pool = pool;
+        w->id = t;
+        if (!(w->start = PyThread_allocate_lock())) {
+            break;
+        }
+        if (!(w->done = PyThread_allocate_lock())) {
+            PyThread_free_lock(w->start);
+            break;
+        }
+        PyThread_acquire_lock(w->start, WAIT_LOCK);
+        PyThread_acquire_lock(w->done, WAIT_LOCK);
+        if (PyThread_start_new_thread(powm_worker_main, w) == PYTHREAD_INVALID_THREAD_ID) {
+            PyThread_free_lock(w->start);
+            PyThread_free_lock(w->done);
+            break;
+        }
+        pool->nthreads = t + 1;
+    }
+    return pool->nthreads;
+}
+
+static void
+powm_pool_stop(powm_pool *pool)
+{
+    int t;
+
+    pool->stop = 1;
+    for (t = 1; t < pool->nthreads; t++) {
+        PyThread_release_lock(pool->workers[t].start);
+    }
+    for (t = 1; t < pool->nthreads; t++) {
+        PyThread_acquire_lock(pool->workers[t].done, WAIT_LOCK);
+        PyThread_free_lock(pool->workers[t].start);
+        PyThread_free_lock(pool->workers[t].done);
+    }
+}
+
+/* Choose the window size that minimizes the table size plus the expected
+ * number of multiplications for an exponent of ebits bits.
+ */
+
+static int
+powm_window(size_t ebits)
+{
+    int w, best = 1;
+    double cost, best_cost = (double)ebits / 2;
+
+    for (w = 2; w <= 10; w++) {
+        cost = (double)((size_t)1 << (w - 1)) + (double)ebits / (w + 1);
+        if (cost < best_cost) {
+            best = w;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+/* Set r = b**e mod m for e >= 0 and m > 1. Returns -1 if the workers or
+ * the scratch space could not be allocated, in which case r is unchanged.
+ * Must be called without the GIL.
+ */
+
+static int
+powm_parallel(mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m,
+              int nthreads, unsigned long serial)
+{
+    powm_pool *pool;
+    mpz_t mu, acc, t, s, *tab;
+    mp_bitcnt_t k = mpz_sizeinbase(m, 2);
+    size_t ebits = mpz_sizeinbase(e, 2), ntab, j;
+    int w, i, first = 1;
+    unsigned long val;
+    Py_ssize_t n;
+
+    if (!(pool = PyMem_RawMalloc(sizeof(powm_pool)))) {
+        return -1;
+    }
+    w = powm_window(ebits);
+    ntab = (size_t)1 << (w - 1);
+    if (!(tab = PyMem_RawMalloc(ntab * sizeof(mpz_t)))) {
+        PyMem_RawFree(pool);
+        return -1;
+    }
+    if (powm_pool_start(pool, nthreads) == 1) {
+        PyMem_RawFree(tab);
+        PyMem_RawFree(pool);
+        return -1;
+    }
+    for (i = 0; i < POWM_MAX_NODES; i++) {
+        mpz_init(pool->x[i]);
+        mpz_init(pool->y[i]);
+        mpz_init(pool->p[i]);
+    }
+    mpz_init(mu);
+    mpz_init(acc);
+    mpz_init(t);
+    mpz_init(s);
+    for (j = 0; j < ntab; j++) {
+        mpz_init(tab[j]);
+    }
+
+    mpz_setbit(mu, 2 * k);
+    mpz_fdiv_q(mu, mu, m);
+
+    /* tab[j] = b**(2*j + 1) mod m */
+    mpz_mod(tab[0], b, m);
+    if (ntab > 1) {
+        powm_mul(pool, t, tab[0], tab[0]);
+        powm_reduce(pool, acc, t, m, mu, k, s);
+        for (j = 1; j < ntab; j++) {
+            powm_mul(pool, t, tab[j - 1], acc);
+            powm_reduce(pool, tab[j], t, m, mu, k, s);
+        }
+    }
+
+    mpz_set_ui(acc, 1);
+    for (n = (Py_ssize_t)ebits - 1; n >= 0; ) {
+        if (!mpz_tstbit(e, n)) {
+            if (!first) {
+                powm_mul(pool, t, acc, acc);
+                powm_reduce(pool, acc, t, m, mu, k, s);
+            }
+            n--;
+        }
+        else {
+            /* Take the longest window e[lo..n] that ends in a 1 bit. */
+            Py_ssize_t lo = n - w + 1 < 0 ? 0 : n - w + 1;
+
+            while (!mpz_tstbit(e, lo)) {
+                lo++;
+            }
+            val = 0;
+            for (i = (int)(n - lo); i >= 0; i--) {
+                val = (val << 1) | mpz_tstbit(e, lo + i);
+                if (!first) {
+                    powm_mul(pool, t, acc, acc);
+                    powm_reduce(pool, acc, t, m, mu, k, s);
+                }
+            }
+            if (first) {
+                mpz_set(acc, tab[val >> 1]);
+                first = 0;
+            }
+            else {
+                powm_mul(pool, t, acc, tab[val >> 1]);
+                powm_reduce(pool, acc, t, m, mu, k, s);
+            }
+            n = lo - 1;
+        }
+        gmpy_progress_update(serial, (Py_ssize_t)ebits - 1 - n);
+    }
+    mpz_swap(r, acc);
+
+    powm_pool_stop(pool);
+    for (i = 0; i < POWM_MAX_NODES; i++) {
+        mpz_clear(pool->x[i]);
+        mpz_clear(pool->y[i]);
+        mpz_clear(pool->p[i]);
+    }
+    for (j = 0; j < ntab; j++) {
+        mpz_clear(tab[j]);
+    }
+    mpz_clear(mu);
+    mpz_clear(acc);
+    mpz_clear(t);
+    mpz_clear(s);
+    PyMem_RawFree(tab);
+    PyMem_RawFree(pool);
+    return 0;
+}
+
+/* Compute r = b**e mod m with powm_parallel() if the modulus is odd and
+ * large enough and the context allows enough threads. Returns 1 if r was
+ * set, or 0 if the caller should use mpz_powm(). e must be >= 0 and m > 0.
+ * Must be called with the GIL held; it is released during the computation.
+ */
+
+static int
+GMPy_MPZ_PowM_Parallel(mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m,
+                       CTXT_Object *context)
+{
+    unsigned long serial;
+    int status;
+
+    if (GET_THREADS(context) < GMPY_POWM_PARALLEL_MIN_THREADS ||
+        mpz_even_p(m) ||
+        mpz_sizeinbase(m, 2) < GMPY_POWM_PARALLEL_THRESHOLD) {
+        return 0;
+    }
+
+    serial = gmpy_progress_begin("powmod", (Py_ssize_t)mpz_sizeinbase(e, 2));
+    Py_BEGIN_ALLOW_THREADS;
+    status = powm_parallel(r, b, e, m, GET_THREADS(context), serial);
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+    return status == 0;
+}
@@ -0,0 +1,52 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_powm_parallel.h                                                   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_POWM_PARALLEL_H
+#define GMPY_POWM_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* powm_parallel() does about 1.4 to 2.7 times the work of mpz_powm(), so
+ * it can only win with several cores. Measured on one core for odd moduli
+ * of 2**14 to 2**20 bits, its critical path (the work of the calling
+ * thread plus the largest share of each product) is 0.9 to 1.5 times that
+ * of mpz_powm() with 2 threads and 0.6 to 1.0 times with 4 threads. Below
+ * 2**18 bits one product on the critical path takes less than about
+ * 0.3 ms, which is not large against waking the workers for it.
+ * mpz_powm() is used below GMPY_POWM_PARALLEL_MIN_THREADS threads, for
+ * moduli with fewer than GMPY_POWM_PARALLEL_THRESHOLD bits and for even
+ * moduli, which mpz_powm() splits into an odd part and a power of two.
+ */
+
+#define GMPY_POWM_PARALLEL_THRESHOLD 262144
+#define GMPY_POWM_PARALLEL_MIN_THREADS 4
+
+static int GMPy_MPZ_PowM_Parallel(mpz_t r, const mpz_t b, const mpz_t e, const mpz_t m, CTXT_Object *context);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
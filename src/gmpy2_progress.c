@@ -0,0 +1,163 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_progress.c                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Progress reporting for long-running kernels. */
+
+static gmpy_progress progress[GMPY_PROGRESS_SLOTS];
+static unsigned long progress_count = 0;
+
+GMPY_MUTEX(progress_lock);
+
+/* done and serial are accessed without the lock. */
+
+#ifdef Py_GIL_DISABLED
+#  define PROGRESS_LOAD_DONE(r) _Py_atomic_load_ssize_relaxed(&(r)->done)
+#  define PROGRESS_STORE_DONE(r, v) _Py_atomic_store_ssize_relaxed(&(r)->done, (v))
+#  define PROGRESS_LOAD_SERIAL(r) _Py_atomic_load_ulong(&(r)->serial)
+#  define PROGRESS_STORE_SERIAL(r, v) _Py_atomic_store_ulong(&(r)->serial, (v))
+#else
+#  define PROGRESS_LOAD_DONE(r) (*(volatile Py_ssize_t*)&(r)->done)
+#  define PROGRESS_STORE_DONE(r, v) (*(volatile Py_ssize_t*)&(r)->done = (v))
+#  define PROGRESS_LOAD_SERIAL(r) (*(volatile unsigned long*)&(r)->serial)
+#  define PROGRESS_STORE_SERIAL(r, v) (*(volatile unsigned long*)&(r)->serial = (v))
+#endif
+
+/* Start reporting a kernel that takes total steps. The calling thread's
+ * record is reused, otherwise a free one, otherwise the oldest one.
+ */
+
+static unsigned long
+gmpy_progress_begin(const char *stage, Py_ssize_t total)
+{
+    unsigned long thread = PyThread_get_thread_ident(), serial;
+    int i, slot = -1;
+
+    GMPY_LOCK(progress_lock);
+    for (i = 0; i < GMPY_PROGRESS_SLOTS; i++) {
+        if (progress[i].stage && progress[i].thread == thread) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && !progress[i].stage) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        for (slot = 0, i = 1; i < GMPY_PROGRESS_SLOTS; i++) {
+            if (progress[i].serial < progress[slot].serial) {
+                slot = i;
+            }
+        }
+    }
+    serial = ++progress_count * GMPY_PROGRESS_SLOTS + (unsigned long)slot;
+    PROGRESS_STORE_SERIAL(&progress[slot], serial);
+    PROGRESS_STORE_DONE(&progress[slot], 0);
+    progress[slot].total = total;
+    progress[slot].thread = thread;
+    progress[slot].stage = stage;
+    GMPY_UNLOCK(progress_lock);
+    return serial;
+}
+
+/* May be called without the GIL. */
+
+static void
+gmpy_progress_update(unsigned long serial, Py_ssize_t done)
+{
+    gmpy_progress *r = &progress[serial % GMPY_PROGRESS_SLOTS];
+
+    if (PROGRESS_LOAD_SERIAL(r) == serial) {
+        PROGRESS_STORE_DONE(r, done);
+    }
+}
+
+static void
+gmpy_progress_end(unsigned long serial)
+{
+    gmpy_progress *r = &progress[serial % GMPY_PROGRESS_SLOTS];
+
+    GMPY_LOCK(progress_lock);
+    if (PROGRESS_LOAD_SERIAL(r) == serial) {
+        r->stage = NULL;
+    }
+    GMPY_UNLOCK(progress_lock);
+}
+
+PyDoc_STRVAR(GMPy_doc_progress,
+"progress(thread=None, /) -> tuple[str, int, int] | None\n\n"
+"Return a 3-tuple (stage, done, total) describing the long-running\n"
+"computation in the thread with identifier thread (see\n"
+"`threading.get_ident()` and `threading.Thread.ident`), or None if that\n"
+"thread is not running one. If thread is None, the most recently\n"
+"started computation in any thread is described; when several threads\n"
+"run computations at once, only the newest one is visible this way.\n"
+"stage is the name of the function (or of the current phase) and\n"
+"done/total is the fraction completed. Only functions that loop over\n"
+"many elements or steps report progress; single GMP or MPFR calls, like\n"
+"fac() or const_pi(), do not. A computation that starts another one in\n"
+"the same thread is superseded by it. At most 16 computations are\n"
+"tracked at once. The record can only be read from another thread while\n"
+"the computation has released the GIL.");
+
+static PyObject *
+GMPy_get_progress(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    const char *stage = NULL;
+    Py_ssize_t done = 0, total = 0;
+    unsigned long thread = 0, newest = 0;
+    int i, any = 1;
+
+    if (nargs > 1) {
+        TYPE_ERROR("progress() takes at most 1 argument");
+        return NULL;
+    }
+    if (nargs == 1 && args[0] != Py_None) {
+        thread = PyLong_AsUnsignedLong(args[0]);
+        if (thread == (unsigned long)-1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        any = 0;
+    }
+
+    GMPY_LOCK(progress_lock);
+    for (i = 0; i < GMPY_PROGRESS_SLOTS; i++) {
+        if (!progress[i].stage ||
+            (any ? progress[i].serial < newest : progress[i].thread != thread)) {
+            continue;
+        }
+        newest = progress[i].serial;
+        stage = progress[i].stage;
+        done = PROGRESS_LOAD_DONE(&progress[i]);
+        total = progress[i].total;
+    }
+    GMPY_UNLOCK(progress_lock);
+
+    if (!stage) {
+        Py_RETURN_NONE;
+    }
+    if (done > total) {
+        done = total;
+    }
+    return Py_BuildValue("(snn)", stage, done, total);
+}
@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_progress.h                                                        *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_PROGRESS_H
+#define GMPY_PROGRESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Progress of the long-running kernels. Each thread running a kernel has
+ * its own record, up to GMPY_PROGRESS_SLOTS at once. The stage is a static
+ * string and is NULL when the record is free. Records are claimed and
+ * released under a lock; kernels update done while the GIL is released.
+ * Each kernel holds the serial returned by gmpy_progress_begin(), which
+ * also identifies its record, so that a kernel that has been superseded
+ * by a newer one no longer changes the record.
+ */
+
+#define GMPY_PROGRESS_SLOTS 16
+
+typedef struct {
+    const char *stage;
+    Py_ssize_t done;
+    Py_ssize_t total;
+    unsigned long serial;
+    unsigned long thread;    /* PyThread_get_thread_ident() of the kernel */
+} gmpy_progress;
+
+/* Only update the record every GMPY_PROGRESS_MASK+1 steps in loops where
+ * each step is cheap.
+ */
+
+#define GMPY_PROGRESS_MASK 1023
+
+static unsigned long gmpy_progress_begin(const char *stage, Py_ssize_t total);
+static void gmpy_progress_update(unsigned long serial, Py_ssize_t done);
+static void gmpy_progress_end(unsigned long serial);
+
+static PyObject * GMPy_get_progress(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,817 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_qform.c                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Binary quadratic forms.
+ *
+ * A qform object is a positive definite form (a, b, c) with discriminant
+ * D = b**2 - 4*a*c < 0. The forms of discriminant D modulo equivalence make
+ * up the class group of D. Products are computed with Shanks' NUCOMP and
+ * squares with NUDUPL, as described by Jacobson and van der Poorten. The
+ * composition is stopped half way by a partial extended gcd bounded by
+ * L = floor((|D|/4)**(1/4)), so the intermediate values are about half the
+ * size of those in Dirichlet composition and the result is almost reduced.
+ *
+ * The kernels work on qform_t values with temporaries from a qform_work
+ * structure so an exponentiation does not allocate. The GIL is released
+ * while they run.
+ */
+
+/* Exponent bits processed between checks for pending signals. */
+
+#define QFORM_POW_CHUNK 256
+
+typedef struct {
+    mpz_t a1, a2, c2, ss, m, k, s, sp, t, u2, v1, v2;
+    mpz_t r1, r2, co1, co2, q, m1, m2;
+    mpz_t ca, cb, cc;
+} qform_work;
+
+static void
+qform_work_init(qform_work *w)
+{
+    mpz_init(w->a1); mpz_init(w->a2); mpz_init(w->c2); mpz_init(w->ss);
+    mpz_init(w->m); mpz_init(w->k); mpz_init(w->s); mpz_init(w->sp);
+    mpz_init(w->t); mpz_init(w->u2); mpz_init(w->v1); mpz_init(w->v2);
+    mpz_init(w->r1); mpz_init(w->r2); mpz_init(w->co1); mpz_init(w->co2);
+    mpz_init(w->q); mpz_init(w->m1); mpz_init(w->m2);
+    mpz_init(w->ca); mpz_init(w->cb); mpz_init(w->cc);
+}
+
+static void
+qform_work_clear(qform_work *w)
+{
+    mpz_clear(w->a1); mpz_clear(w->a2); mpz_clear(w->c2); mpz_clear(w->ss);
+    mpz_clear(w->m); mpz_clear(w->k); mpz_clear(w->s); mpz_clear(w->sp);
+    mpz_clear(w->t); mpz_clear(w->u2); mpz_clear(w->v1); mpz_clear(w->v2);
+    mpz_clear(w->r1); mpz_clear(w->r2); mpz_clear(w->co1); mpz_clear(w->co2);
+    mpz_clear(w->q); mpz_clear(w->m1); mpz_clear(w->m2);
+    mpz_clear(w->ca); mpz_clear(w->cb); mpz_clear(w->cc);
+}
+
+static void
+qform_init(qform_t *f)
+{
+    mpz_init(f->a);
+    mpz_init(f->b);
+    mpz_init(f->c);
+}
+
+static void
+qform_clear(qform_t *f)
+{
+    mpz_clear(f->a);
+    mpz_clear(f->b);
+    mpz_clear(f->c);
+}
+
+static void
+qform_set(qform_t *r, const qform_t *f)
+{
+    mpz_set(r->a, f->a);
+    mpz_set(r->b, f->b);
+    mpz_set(r->c, f->c);
+}
+
+/* The principal form (1, D mod 2, (D mod 2 - D)/4). */
+
+static void
+qform_set_identity(qform_t *r, mpz_srcptr D)
+{
+    mpz_set_ui(r->a, 1);
+    mpz_set_ui(r->b, mpz_odd_p(D) ? 1 : 0);
+    mpz_sub(r->c, r->b, D);
+    mpz_fdiv_q_2exp(r->c, r->c, 2);
+}
+
+/* A form is reduced if -a < b <= a <= c, and b >= 0 if a = c. */
+
+static int
+qform_is_reduced(const qform_t *f)
+{
+    int cmp = mpz_cmpabs(f->b, f->a);
+
+    if (cmp > 0 || (cmp == 0 && mpz_sgn(f->b) < 0)) {
+        return 0;
+    }
+    cmp = mpz_cmp(f->a, f->c);
+    return cmp < 0 || (cmp == 0 && mpz_sgn(f->b) >= 0);
+}
+
+/* Replace (a, b, c) by the equivalent form with -a < b <= a. */
+
+static void
+qform_normalize(qform_work *w, mpz_ptr a, mpz_ptr b, mpz_ptr c)
+{
+    mpz_mul_2exp(w->m1, a, 1);
+    mpz_sub(w->t, a, b);
+    mpz_fdiv_q(w->q, w->t, w->m1);
+    if (mpz_sgn(w->q) == 0) {
+        return;
+    }
+    /* c += q*(b + a*q), b += 2*a*q */
+    mpz_set(w->t, b);
+    mpz_addmul(w->t, a, w->q);
+    mpz_addmul(c, w->q, w->t);
+    mpz_mul_2exp(w->t, w->t, 1);
+    mpz_sub(b, w->t, b);
+}
+
+static void
+qform_reduce(qform_work *w, mpz_ptr a, mpz_ptr b, mpz_ptr c)
+{
+    int cmp;
+
+    qform_normalize(w, a, b, c);
+    while ((cmp = mpz_cmp(a, c)) > 0 || (cmp == 0 && mpz_sgn(b) < 0)) {
+        mpz_swap(a, c);
+        mpz_neg(b, b);
+        qform_normalize(w, a, b, c);
+    }
+}
+
+/* Run the Euclidean algorithm on (r2, r1) until r1 <= L, keeping the
+ * cofactors of r1 in co2 (previous) and co1 (current).
+ *
+ * While r1 is large, runs of quotients are found from the leading bits of
+ * r2 and r1 using Lehmer's method (Knuth, Algorithm 4.5.2L) and applied as
+ * a 2x2 matrix. If a run passes the bound it is undone and the remaining
+ * steps are done one at a time.
+ */
+
+#define QFORM_LEHMER_BITS ((int)(sizeof(long) * CHAR_BIT) - 2)
+
+/* (x, y) = (A*x + B*y, C*x + D*y), using t and u as temporaries. */
+
+static void
+qform_apply_matrix(mpz_ptr x, mpz_ptr y, long A, long B, long C, long D,
+                   mpz_ptr t, mpz_ptr u)
+{
+    mpz_mul_si(t, x, A);
+    mpz_mul_si(u, y, B);
+    mpz_add(t, t, u);
+    mpz_mul_si(u, x, C);
+    mpz_mul_si(x, y, D);
+    mpz_add(y, u, x);
+    mpz_swap(x, t);
+}
+
+static void
+qform_xgcd_partial(qform_work *w, mpz_srcptr L)
+{
+    size_t nL = mpz_sizeinbase(L, 2), n;
+    long a, b, bound, A, B, C, D, T, q;
+    int lehmer = 1;
+
+    mpz_set_ui(w->co2, 0);
+    mpz_set_si(w->co1, -1);
+    while (mpz_sgn(w->r1) && mpz_cmp(w->r1, L) > 0) {
+        if (lehmer && mpz_sizeinbase(w->r1, 2) > nL) {
+            n = mpz_sizeinbase(w->r2, 2) - QFORM_LEHMER_BITS;
+            mpz_tdiv_q_2exp(w->q, w->r2, n);
+            a = mpz_get_si(w->q);
+            mpz_tdiv_q_2exp(w->q, w->r1, n);
+            b = mpz_get_si(w->q);
+            mpz_tdiv_q_2exp(w->q, L, n);
+            bound = mpz_get_si(w->q) + 1;
+            A = 1; B = 0; C = 0; D = 1;
+            while (b + C > 0 && b + D > 0 && a + A >= 0 && a + B >= 0) {
+                /* Most quotients are small, so avoid the division. */
+                T = a + A - (b + C);
+                for (q = 1; q < 4 && T >= b + C; q++) {
+                    T -= b + C;
+                }
+                if (T >= b + C) {
+                    q = (a + A) / (b + C);
+                }
+                else if (T < 0) {
+                    q = 0;
+                }
+                if (q * (b + D) > a + B || a + B - q * (b + D) >= b + D ||
+                    a - q * b <= bound) {
+                    break;
+                }
+                T = A - q * C; A = C; C = T;
+                T = B - q * D; B = D; D = T;
+                T = a - q * b; a = b; b = T;
+            }
+            if (B != 0) {
+                qform_apply_matrix(w->r2, w->r1, A, B, C, D, w->q, w->s);
+                if (mpz_cmp(w->r1, L) > 0) {
+                    qform_apply_matrix(w->co2, w->co1, A, B, C, D, w->q, w->s);
+                    continue;
+                }
+                /* Undo the run with the inverse matrix, det = A*D - B*C. */
+                if (A * D - B * C > 0) {
+                    qform_apply_matrix(w->r2, w->r1, D, -B, -C, A, w->q, w->s);
+                }
+                else {
+                    qform_apply_matrix(w->r2, w->r1, -D, B, C, -A, w->q, w->s);
+                }
+                lehmer = 0;
+            }
+        }
+        mpz_fdiv_qr(w->q, w->r2, w->r2, w->r1);
+        mpz_swap(w->r2, w->r1);
+        mpz_submul(w->co2, w->q, w->co1);
+        mpz_swap(w->co2, w->co1);
+    }
+}
+
+/* Finish a composition after the partial gcd of (a1, k). On entry t is
+ * a2*r1 (a1*r1 for NUDUPL) and m1 and m2 are set as in NUCOMP. On return
+ * ca, cb, and cc hold the result, which is not yet reduced.
+ */
+
+static void
+qform_finish(qform_work *w, mpz_srcptr b2, mpz_srcptr D)
+{
+    /* ca = ±(r1*m1 - co1*m2), cb = 2*(t - ca*co2)/co1 - b2 mod 2*ca */
+    mpz_mul(w->ca, w->r1, w->m1);
+    mpz_submul(w->ca, w->co1, w->m2);
+    if (mpz_sgn(w->co1) > 0) {
+        mpz_neg(w->ca, w->ca);
+    }
+    mpz_set(w->cb, w->t);
+    mpz_submul(w->cb, w->ca, w->co2);
+    mpz_mul_2exp(w->cb, w->cb, 1);
+    mpz_divexact(w->cb, w->cb, w->co1);
+    mpz_sub(w->cb, w->cb, b2);
+    mpz_mul_2exp(w->t, w->ca, 1);
+    mpz_fdiv_r(w->cb, w->cb, w->t);
+
+    mpz_mul(w->cc, w->cb, w->cb);
+    mpz_sub(w->cc, w->cc, D);
+    mpz_divexact(w->cc, w->cc, w->ca);
+    mpz_fdiv_q_2exp(w->cc, w->cc, 2);
+    if (mpz_sgn(w->ca) < 0) {
+        mpz_neg(w->ca, w->ca);
+        mpz_neg(w->cc, w->cc);
+    }
+}
+
+/* r = f*g with NUCOMP. r may be the same as f or g. */
+
+static void
+qform_nucomp(qform_work *w, qform_t *r, const qform_t *f, const qform_t *g,
+             mpz_srcptr D, mpz_srcptr L)
+{
+    if (mpz_cmp(f->a, g->a) > 0) {
+        const qform_t *temp = f;
+        f = g;
+        g = temp;
+    }
+    mpz_set(w->a1, f->a);
+    mpz_set(w->a2, g->a);
+    mpz_set(w->c2, g->c);
+
+    /* ss = (b1 + b2)/2, m = (b1 - b2)/2 */
+    mpz_add(w->ss, f->b, g->b);
+    mpz_fdiv_q_2exp(w->ss, w->ss, 1);
+    mpz_sub(w->m, f->b, g->b);
+    mpz_fdiv_q_2exp(w->m, w->m, 1);
+
+    /* sp = gcd(a2, a1) and k = m*v1 mod a1 where v1*a2 = sp mod a1 */
+    mpz_fdiv_r(w->t, w->a2, w->a1);
+    if (mpz_sgn(w->t) == 0) {
+        mpz_set_ui(w->v1, 0);
+        mpz_set(w->sp, w->a1);
+    }
+    else {
+        mpz_gcdext(w->sp, w->v1, NULL, w->t, w->a1);
+    }
+    mpz_mul(w->k, w->m, w->v1);
+    mpz_fdiv_r(w->k, w->k, w->a1);
+
+    if (mpz_cmp_ui(w->sp, 1)) {
+        mpz_gcdext(w->s, w->v2, w->u2, w->ss, w->sp);
+        mpz_mul(w->k, w->k, w->u2);
+        mpz_submul(w->k, w->v2, w->c2);
+        if (mpz_cmp_ui(w->s, 1)) {
+            mpz_divexact(w->a1, w->a1, w->s);
+            mpz_divexact(w->a2, w->a2, w->s);
+            mpz_mul(w->c2, w->c2, w->s);
+        }
+        mpz_fdiv_r(w->k, w->k, w->a1);
+    }
+
+    if (mpz_cmp(w->a1, L) < 0) {
+        mpz_mul(w->t, w->a2, w->k);
+        mpz_mul(w->ca, w->a2, w->a1);
+        mpz_mul_2exp(w->cb, w->t, 1);
+        mpz_add(w->cb, w->cb, g->b);
+        mpz_add(w->cc, g->b, w->t);
+        mpz_mul(w->cc, w->cc, w->k);
+        mpz_add(w->cc, w->cc, w->c2);
+        mpz_divexact(w->cc, w->cc, w->a1);
+    }
+    else {
+        mpz_set(w->r2, w->a1);
+        mpz_set(w->r1, w->k);
+        qform_xgcd_partial(w, L);
+
+        /* m1 = (m*co1 + a2*r1)/a1, m2 = (ss*r1 - c2*co1)/a1 */
+        mpz_mul(w->t, w->a2, w->r1);
+        mpz_mul(w->m1, w->m, w->co1);
+        mpz_add(w->m1, w->m1, w->t);
+        mpz_divexact(w->m1, w->m1, w->a1);
+        mpz_mul(w->m2, w->ss, w->r1);
+        mpz_submul(w->m2, w->c2, w->co1);
+        mpz_divexact(w->m2, w->m2, w->a1);
+        qform_finish(w, g->b, D);
+    }
+    qform_reduce(w, w->ca, w->cb, w->cc);
+    mpz_swap(r->a, w->ca);
+    mpz_swap(r->b, w->cb);
+    mpz_swap(r->c, w->cc);
+}
+
+/* r = f*f with NUDUPL. r may be the same as f. */
+
+static void
+qform_nudupl(qform_work *w, qform_t *r, const qform_t *f,
+             mpz_srcptr D, mpz_srcptr L)
+{
+    mpz_set(w->a1, f->a);
+    mpz_set(w->c2, f->c);
+
+    /* s = gcd(b, a) = v2*b + u2*a and k = -v2*c mod a/s */
+    mpz_gcdext(w->s, w->v2, NULL, f->b, w->a1);
+    mpz_mul(w->k, w->v2, w->c2);
+    mpz_neg(w->k, w->k);
+    if (mpz_cmp_ui(w->s, 1)) {
+        mpz_divexact(w->a1, w->a1, w->s);
+        mpz_mul(w->c2, w->c2, w->s);
+    }
+    mpz_fdiv_r(w->k, w->k, w->a1);
+
+    if (mpz_cmp(w->a1, L) < 0) {
+        mpz_mul(w->t, w->a1, w->k);
+        mpz_mul(w->ca, w->a1, w->a1);
+        mpz_mul_2exp(w->cb, w->t, 1);
+        mpz_add(w->cb, w->cb, f->b);
+        mpz_add(w->cc, f->b, w->t);
+        mpz_mul(w->cc, w->cc, w->k);
+        mpz_add(w->cc, w->cc, w->c2);
+        mpz_divexact(w->cc, w->cc, w->a1);
+    }
+    else {
+        mpz_set(w->r2, w->a1);
+        mpz_set(w->r1, w->k);
+        qform_xgcd_partial(w, L);
+
+        /* m2 = (b*r1 - c*co1)/a, and NUCOMP's m1 is r1 */
+        mpz_mul(w->m2, f->b, w->r1);
+        mpz_submul(w->m2, w->c2, w->co1);
+        mpz_divexact(w->m2, w->m2, w->a1);
+        mpz_set(w->m1, w->r1);
+        mpz_mul(w->t, w->a1, w->r1);
+        qform_finish(w, f->b, D);
+    }
+    qform_reduce(w, w->ca, w->cb, w->cc);
+    mpz_swap(r->a, w->ca);
+    mpz_swap(r->b, w->cb);
+    mpz_swap(r->c, w->cc);
+}
+
+/* r = f**e for e > 0, using NUDUPL for the squarings and a sliding window
+ * of odd powers of f. f must be reduced. The GIL is released and pending
+ * signals are checked every QFORM_POW_CHUNK exponent bits. Returns -1 if
+ * an exception was raised.
+ */
+
+static int
+qform_pow(qform_t *r, const qform_t *f, mpz_srcptr e, mpz_srcptr D,
+          mpz_srcptr L, CTXT_Object *context)
+{
+    qform_work w;
+    qform_t table[32], sq;    /* table[i] = f**(2*i + 1) */
+    Py_ssize_t i, j, l, stop;
+    size_t nbits, val, n;
+    int win, started = 0, result = 0;
+
+    nbits = mpz_sizeinbase(e, 2);
+    win = nbits < 16 ? 1 : nbits < 64 ? 3 : nbits < 256 ? 4 : nbits < 1024 ? 5 : 6;
+    n = (size_t)1 << (win - 1);
+
+    qform_work_init(&w);
+    qform_init(&sq);
+    for (val = 0; val < n; val++) {
+        qform_init(&table[val]);
+    }
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    qform_set(&table[0], f);
+    if (n > 1) {
+        qform_nudupl(&w, &sq, f, D, L);
+        for (val = 1; val < n; val++) {
+            qform_nucomp(&w, &table[val], &table[val - 1], &sq, D, L);
+        }
+    }
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+
+    i = (Py_ssize_t)nbits - 1;
+    while (i >= 0) {
+        stop = i - QFORM_POW_CHUNK;
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        while (i >= 0 && i > stop) {
+            if (!mpz_tstbit(e, i)) {
+                qform_nudupl(&w, r, r, D, L);
+                i--;
+                continue;
+            }
+            /* The longest window e[i..j] of at most win bits ending in a 1. */
+            j = i - win + 1 < 0 ? 0 : i - win + 1;
+            while (!mpz_tstbit(e, j)) {
+                j++;
+            }
+            for (val = 0, l = i; l >= j; l--) {
+                val = 2 * val + mpz_tstbit(e, l);
+            }
+            if (started) {
+                for (l = j; l <= i; l++) {
+                    qform_nudupl(&w, r, r, D, L);
+                }
+                qform_nucomp(&w, r, r, &table[val >> 1], D, L);
+            }
+            else {
+                qform_set(r, &table[val >> 1]);
+                started = 1;
+            }
+            i = j - 1;
+        }
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+        if (PyErr_CheckSignals() < 0) {
+            result = -1;
+            break;
+        }
+    }
+
+    for (val = 0; val < n; val++) {
+        qform_clear(&table[val]);
+    }
+    qform_clear(&sq);
+    qform_work_clear(&w);
+    return result;
+}
+
+static QForm_Object *
+GMPy_QForm_New(void)
+{
+    QForm_Object *result;
+
+    if (GMPy_Ready_Type(&QForm_Type) < 0 ||
+        !(result = PyObject_New(QForm_Object, &QForm_Type))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    qform_init(&result->f);
+    mpz_init(result->D);
+    mpz_init(result->L);
+    result->hash_cache = -1;
+    return result;
+}
+
+/* Return a new form with the discriminant of like. */
+
+static QForm_Object *
+GMPy_QForm_New_Like(QForm_Object *like)
+{
+    QForm_Object *result;
+
+    if ((result = GMPy_QForm_New())) {
+        mpz_set(result->D, like->D);
+        mpz_set(result->L, like->L);
+    }
+    return result;
+}
+
+static void
+GMPy_QForm_Dealloc(QForm_Object *self)
+{
+    qform_clear(&self->f);
+    mpz_clear(self->D);
+    mpz_clear(self->L);
+    PyObject_Free(self);
+}
+
+static PyObject *
+GMPy_QForm_Mul_Slot(PyObject *x, PyObject *y)
+{
+    QForm_Object *f = (QForm_Object*)x, *g = (QForm_Object*)y, *result;
+    qform_work w;
+    CTXT_Object *context = NULL;
+
+    if (!QForm_Check(x) || !QForm_Check(y)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (mpz_cmp(f->D, g->D)) {
+        VALUE_ERROR("qform composition requires forms with the same discriminant");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = GMPy_QForm_New_Like(f))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    qform_work_init(&w);
+    qform_set(&result->f, &f->f);
+    qform_reduce(&w, result->f.a, result->f.b, result->f.c);
+    if (f == g || (!mpz_cmp(f->f.a, g->f.a) && !mpz_cmp(f->f.b, g->f.b) &&
+                   !mpz_cmp(f->f.c, g->f.c))) {
+        qform_nudupl(&w, &result->f, &result->f, f->D, f->L);
+    }
+    else if (qform_is_reduced(&g->f)) {
+        qform_nucomp(&w, &result->f, &result->f, &g->f, f->D, f->L);
+    }
+    else {
+        qform_t temp;
+
+        qform_init(&temp);
+        qform_set(&temp, &g->f);
+        qform_reduce(&w, temp.a, temp.b, temp.c);
+        qform_nucomp(&w, &result->f, &result->f, &temp, f->D, f->L);
+        qform_clear(&temp);
+    }
+    qform_work_clear(&w);
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_QForm_Pow_Slot(PyObject *base, PyObject *exp, PyObject *mod)
+{
+    QForm_Object *f = (QForm_Object*)base, *result;
+    MPZ_Object *e;
+    qform_work w;
+    qform_t b;
+    mpz_t n;
+    CTXT_Object *context = NULL;
+    int rc;
+
+    if (!QForm_Check(base) || !IS_INTEGER(exp)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    if (mod != Py_None) {
+        TYPE_ERROR("pow() of a qform does not accept a modulus");
+        return NULL;
+    }
+
+    CHECK_CONTEXT(context);
+
+    if (!(e = GMPy_MPZ_From_Integer(exp, context))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (!(result = GMPy_QForm_New_Like(f))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)e);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (mpz_sgn(e->z) == 0) {
+        qform_set_identity(&result->f, f->D);
+        Py_DECREF((PyObject*)e);
+        return (PyObject*)result;
+    }
+
+    /* The inverse of (a, b, c) is (a, -b, c). */
+    qform_init(&b);
+    qform_work_init(&w);
+    qform_set(&b, &f->f);
+    if (mpz_sgn(e->z) < 0) {
+        mpz_neg(b.b, b.b);
+    }
+    qform_reduce(&w, b.a, b.b, b.c);
+    qform_work_clear(&w);
+    mpz_init(n);
+    mpz_abs(n, e->z);
+    Py_DECREF((PyObject*)e);
+    rc = qform_pow(&result->f, &b, n, f->D, f->L, context);
+    mpz_clear(n);
+    qform_clear(&b);
+    if (rc < 0) {
+        Py_DECREF((PyObject*)result);
+        return NULL;
+    }
+    return (PyObject*)result;
+}
+
+static Py_hash_t
+GMPy_QForm_Hash_Slot(QForm_Object *self)
+{
+    Py_uhash_t ha, hb;
+
+    if (self->hash_cache != -1) {
+        return self->hash_cache;
+    }
+    ha = mpn_mod_1(self->f.a->_mp_d, (mp_size_t)mpz_size(self->f.a), PyHASH_MODULUS);
+    hb = mpz_size(self->f.b) ?
+         mpn_mod_1(self->f.b->_mp_d, (mp_size_t)mpz_size(self->f.b), PyHASH_MODULUS) : 0;
+    if (mpz_sgn(self->f.b) < 0) {
+        hb = -hb;
+    }
+    ha = ha * 1000003UL ^ hb;
+    if (ha == (Py_uhash_t)(-1)) {
+        ha = (Py_uhash_t)(-2);
+    }
+    return (self->hash_cache = (Py_hash_t)ha);
+}
+
+static PyObject *
+GMPy_QForm_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    QForm_Object *x = (QForm_Object*)a, *y = (QForm_Object*)b;
+    int eq;
+
+    if (!QForm_Check(a) || !QForm_Check(b) || (op != Py_EQ && op != Py_NE)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    eq = !mpz_cmp(x->f.a, y->f.a) && !mpz_cmp(x->f.b, y->f.b) &&
+         !mpz_cmp(x->f.c, y->f.c);
+    return PyBool_FromLong(op == Py_EQ ? eq : !eq);
+}
+
+static PyObject *
+GMPy_QForm_Attrib_Get(QForm_Object *self, void *closure)
+{
+    MPZ_Object *result;
+    mpz_srcptr src;
+
+    switch ((Py_intptr_t)closure) {
+        case 0: src = self->f.a; break;
+        case 1: src = self->f.b; break;
+        case 2: src = self->f.c; break;
+        default: src = self->D; break;
+    }
+    if ((result = GMPy_MPZ_New(NULL))) {
+        mpz_set(result->z, src);
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_qform_method_reduce,
+"x.reduce() -> qform\n\n"
+"Return the reduced form equivalent to x. A form (a, b, c) is reduced if\n"
+"-a < b <= a <= c and b >= 0 when a = c. Each class of forms contains\n"
+"exactly one reduced form.");
+
+static PyObject *
+GMPy_QForm_Method_Reduce(PyObject *self, PyObject *other)
+{
+    QForm_Object *result;
+    qform_work w;
+
+    if ((result = GMPy_QForm_New_Like((QForm_Object*)self))) {
+        qform_work_init(&w);
+        qform_set(&result->f, &((QForm_Object*)self)->f);
+        qform_reduce(&w, result->f.a, result->f.b, result->f.c);
+        qform_work_clear(&w);
+    }
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_qform_method_is_reduced,
+"x.is_reduced() -> bool\n\n"
+"Return True if x is a reduced form.");
+
+static PyObject *
+GMPy_QForm_Method_IsReduced(PyObject *self, PyObject *other)
+{
+    return PyBool_FromLong(qform_is_reduced(&((QForm_Object*)self)->f));
+}
+
+static PyObject *
+GMPy_QForm_Repr_Slot(QForm_Object *self)
+{
+    PyObject *a, *b = NULL, *c = NULL, *result = NULL;
+
+    if ((a = GMPy_QForm_Attrib_Get(self, (void*)0)) &&
+        (b = GMPy_QForm_Attrib_Get(self, (void*)1)) &&
+        (c = GMPy_QForm_Attrib_Get(self, (void*)2))) {
+        result = PyUnicode_FromFormat("qform(%S, %S, %S)", a, b, c);
+    }
+    Py_XDECREF(a);
+    Py_XDECREF(b);
+    Py_XDECREF(c);
+    return result;
+}
+
+static PyObject *
+GMPy_QForm_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    QForm_Object *result;
+    MPZ_Object *a = NULL, *b = NULL, *c = NULL;
+    PyObject *x, *y, *z;
+    static char *kwlist[] = {"", "", "", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OOO", kwlist, &x, &y, &z)) {
+        return NULL;
+    }
+    if (!(a = GMPy_MPZ_From_Integer(x, NULL)) ||
+        !(b = GMPy_MPZ_From_Integer(y, NULL)) ||
+        !(c = GMPy_MPZ_From_Integer(z, NULL))) {
+        Py_XDECREF((PyObject*)a);
+        Py_XDECREF((PyObject*)b);
+        TYPE_ERROR("qform() requires integer coefficients");
+        return NULL;
+    }
+    if ((result = GMPy_QForm_New())) {
+        mpz_set(result->f.a, a->z);
+        mpz_set(result->f.b, b->z);
+        mpz_set(result->f.c, c->z);
+        mpz_mul(result->D, result->f.b, result->f.b);
+        mpz_mul(result->L, result->f.a, result->f.c);
+        mpz_submul_ui(result->D, result->L, 4);
+        if (mpz_sgn(result->f.a) <= 0 || mpz_sgn(result->D) >= 0) {
+            VALUE_ERROR("qform() requires a > 0 and b**2 - 4*a*c < 0");
+            Py_DECREF((PyObject*)result);
+            result = NULL;
+        }
+        else {
+            mpz_neg(result->L, result->D);
+            mpz_fdiv_q_2exp(result->L, result->L, 2);
+            mpz_root(result->L, result->L, 4);
+        }
+    }
+    Py_DECREF((PyObject*)a);
+    Py_DECREF((PyObject*)b);
+    Py_DECREF((PyObject*)c);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_qform,
+"qform(a, b, c, /)\n\n"
+"Return the binary quadratic form a*x**2 + b*x*y + c*y**2. The form must\n"
+"be positive definite, i.e. a > 0 and the discriminant b**2 - 4*a*c must\n"
+"be negative.\n\n"
+"For primitive forms with the same discriminant, f * g is the reduced\n"
+"composition of f and g, and f ** n is the reduced form of the n-th power\n"
+"of f in the class group. f ** 0 is the principal form and f ** -1 is the\n"
+"inverse of f. Equal classes have equal reduced forms, so == compares the\n"
+"coefficients.");
+
+static PyNumberMethods GMPy_QForm_number_methods = {
+    .nb_multiply = (binaryfunc) GMPy_QForm_Mul_Slot,
+    .nb_power = (ternaryfunc) GMPy_QForm_Pow_Slot,
+};
+
+static PyGetSetDef GMPy_QForm_getseters[] = {
+    { "a", (getter)GMPy_QForm_Attrib_Get, NULL,
+        "the coefficient of x**2", (void*)0 },
+    { "b", (getter)GMPy_QForm_Attrib_Get, NULL,
+        "the coefficient of x*y", (void*)1 },
+    { "c", (getter)GMPy_QForm_Attrib_Get, NULL,
+        "the coefficient of y**2", (void*)2 },
+    { "discriminant", (getter)GMPy_QForm_Attrib_Get, NULL,
+        "the discriminant b**2 - 4*a*c", (void*)3 },
+    {NULL}
+};
+
+static PyMethodDef GMPy_QForm_methods[] = {
+    { "is_reduced", GMPy_QForm_Method_IsReduced, METH_NOARGS, GMPy_doc_qform_method_is_reduced },
+    { "reduce", GMPy_QForm_Method_Reduce, METH_NOARGS, GMPy_doc_qform_method_reduce },
+    { NULL }
+};
+
+static PyTypeObject QForm_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.qform",
+    .tp_basicsize = sizeof(QForm_Object),
+    .tp_dealloc = (destructor) GMPy_QForm_Dealloc,
+    .tp_repr = (reprfunc) GMPy_QForm_Repr_Slot,
+    .tp_as_number = &GMPy_QForm_number_methods,
+    .tp_hash = (hashfunc) GMPy_QForm_Hash_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_qform,
+    .tp_richcompare = (richcmpfunc) GMPy_QForm_RichCompare_Slot,
+    .tp_methods = GMPy_QForm_methods,
+    .tp_getset = GMPy_QForm_getseters,
+    .tp_new = GMPy_QForm_NewInit,
+};
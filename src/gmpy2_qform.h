@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_qform.h                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_QFORM_H
+#define GMPY_QFORM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The coefficients of the binary quadratic form a*x**2 + b*x*y + c*y**2. */
+
+typedef struct {
+    mpz_t a, b, c;
+} qform_t;
+
+typedef struct {
+    PyObject_HEAD
+    qform_t f;
+    mpz_t D;               /* discriminant b**2 - 4*a*c, always < 0 */
+    mpz_t L;               /* floor((|D|/4)**(1/4)), the bound used by NUCOMP */
+    Py_hash_t hash_cache;
+} QForm_Object;
+
+static PyTypeObject QForm_Type;
+#define QForm_Check(v) (((PyObject*)v)->ob_type == &QForm_Type)
+
+static PyObject * GMPy_QForm_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static void GMPy_QForm_Dealloc(QForm_Object *self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -27,9 +27,10 @@
 static RandomState_Object *
 GMPy_RandomState_New(void)
 {
-    RandomState_Object *result;
+    RandomState_Object *result = NULL;
 
-    if ((result = PyObject_New(RandomState_Object, &RandomState_Type))) {
+    if (GMPy_Ready_Type(&RandomState_Type) == 0 &&
+        (result = PyObject_New(RandomState_Object, &RandomState_Type))) {
         gmp_randinit_default(result->state);
     }
     return result;
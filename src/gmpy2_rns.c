@@ -0,0 +1,875 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_rns.c                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Residue number system vectors.
+ *
+ * An rns object holds a vector of integers, each one stored as its residues
+ * modulo a basis of pairwise coprime moduli less than 2**62. The residues
+ * for each modulus are kept in a contiguous array of uint64_t so the
+ * element-wise kernels are simple loops over a single modulus that the
+ * compiler can unroll and vectorize. Products are reduced using Barrett's
+ * method.
+ *
+ * Integers are converted to residues with a remainder tree and back with a
+ * CRT tree; both use the product tree stored in the shared basis. The GIL
+ * is released while the kernels and the conversions run.
+ */
+
+#define RNS_MAX_BITS 62
+
+/* Arithmetic on residues modulo m where m < 2**k and k <= RNS_MAX_BITS.
+ * With a 128-bit integer type, products are reduced with Barrett's method
+ * using mu = floor(2**(2*k) / m). Otherwise a slower shift and add method
+ * is used and mu is ignored.
+ */
+
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 rns_u128;
+
+static uint64_t
+rns_barrett_mu(uint64_t m, int k)
+{
+    return (uint64_t)((((rns_u128)1) << (2 * k)) / m);
+}
+
+/* Reduce x < 2**(2*k) modulo m. The estimated quotient is at most two
+ * less than the true quotient.
+ */
+
+static inline uint64_t
+rns_reduce(rns_u128 x, uint64_t m, uint64_t mu, int k)
+{
+    uint64_t q, r;
+
+    q = (uint64_t)(((rns_u128)(uint64_t)(x >> (k - 1)) * mu) >> (k + 1));
+    r = (uint64_t)x - q * m;
+    r = (r >= m) ? r - m : r;
+    r = (r >= m) ? r - m : r;
+    return r;
+}
+
+static inline uint64_t
+rns_mulmod(uint64_t a, uint64_t b, uint64_t m, uint64_t mu, int k)
+{
+    return rns_reduce((rns_u128)a * b, m, mu, k);
+}
+
+static inline uint64_t
+rns_fmamod(uint64_t a, uint64_t b, uint64_t c, uint64_t m, uint64_t mu, int k)
+{
+    return rns_reduce((rns_u128)a * b + c, m, mu, k);
+}
+
+#else
+
+static uint64_t
+rns_barrett_mu(uint64_t m, int k)
+{
+    return 0;
+}
+
+static inline uint64_t
+rns_mulmod(uint64_t a, uint64_t b, uint64_t m, uint64_t mu, int k)
+{
+    uint64_t r = 0;
+
+    /* a, b < m < 2**62 so the sums cannot overflow. */
+    while (b) {
+        if (b & 1) {
+            r += a;
+            r = (r >= m) ? r - m : r;
+        }
+        a += a;
+        a = (a >= m) ? a - m : a;
+        b >>= 1;
+    }
+    return r;
+}
+
+static inline uint64_t
+rns_fmamod(uint64_t a, uint64_t b, uint64_t c, uint64_t m, uint64_t mu, int k)
+{
+    uint64_t r = rns_mulmod(a, b, m, mu, k) + c;
+
+    return (r >= m) ? r - m : r;
+}
+
+#endif
+
+static inline uint64_t
+rns_addmod(uint64_t a, uint64_t b, uint64_t m)
+{
+    uint64_t r = a + b;
+
+    return (r >= m) ? r - m : r;
+}
+
+static inline uint64_t
+rns_submod(uint64_t a, uint64_t b, uint64_t m)
+{
+    return (a >= b) ? a - b : a + (m - b);
+}
+
+/* unsigned long may only be 32 bits so mpz_get_ui/mpz_set_ui can't be used
+ * for 64-bit values.
+ */
+
+static uint64_t
+rns_mpz_get_u64(const mpz_t z)
+{
+#if GMP_NUMB_BITS >= 64
+    return (uint64_t)mpz_getlimbn(z, 0);
+#else
+    return (uint64_t)mpz_getlimbn(z, 0) | ((uint64_t)mpz_getlimbn(z, 1) << 32);
+#endif
+}
+
+static void
+rns_mpz_set_u64(mpz_t z, uint64_t v)
+{
+    mpz_import(z, 1, -1, sizeof(uint64_t), 0, 0, &v);
+}
+
+/* Management of the shared basis. The reference count is only changed
+ * while holding the GIL.
+ */
+
+static void
+rns_basis_decref(rns_basis *b)
+{
+    Py_ssize_t i;
+
+    if (--b->refcount > 0) {
+        return;
+    }
+    for (i = 0; i < 4 * b->count; i++) {
+        mpz_clear(b->prod[i]);
+        mpz_clear(b->inv[i]);
+    }
+    PyMem_Free(b->prod);
+    PyMem_Free(b->inv);
+    PyMem_Free(b->mod);
+    PyMem_Free(b->mu);
+    PyMem_Free(b->bits);
+    PyMem_Free(b);
+}
+
+/* Build the product tree below node. Returns 0 if the moduli are pairwise
+ * coprime, otherwise -1. Two subtrees with coprime products and pairwise
+ * coprime moduli are themselves pairwise coprime, so it is sufficient to
+ * check that each inverse exists.
+ */
+
+static int
+rns_basis_build(rns_basis *b, Py_ssize_t node, Py_ssize_t lo, Py_ssize_t hi)
+{
+    Py_ssize_t mid = lo + (hi - lo) / 2;
+
+    if (hi - lo == 1) {
+        rns_mpz_set_u64(b->prod[node], b->mod[lo]);
+        return 0;
+    }
+    if (rns_basis_build(b, 2 * node, lo, mid) ||
+        rns_basis_build(b, 2 * node + 1, mid, hi)) {
+        return -1;
+    }
+    mpz_mul(b->prod[node], b->prod[2 * node], b->prod[2 * node + 1]);
+    if (!mpz_invert(b->inv[node], b->prod[2 * node], b->prod[2 * node + 1])) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Create a basis from count moduli that are already known to be in the
+ * range [2, 2**62). Raises ValueError if they are not pairwise coprime.
+ */
+
+static rns_basis *
+rns_basis_from_array(const uint64_t *mod, Py_ssize_t count)
+{
+    rns_basis *b;
+    Py_ssize_t i;
+
+    if (count > PY_SSIZE_T_MAX / (4 * (Py_ssize_t)sizeof(mpz_t)) ||
+        !(b = PyMem_Malloc(sizeof(rns_basis)))) {
+        /* LCOV_EXCL_START */
+        return (rns_basis*)PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    b->refcount = 1;
+    b->count = count;
+    b->mod = PyMem_Malloc(count * sizeof(uint64_t));
+    b->mu = PyMem_Malloc(count * sizeof(uint64_t));
+    b->bits = PyMem_Malloc(count * sizeof(int));
+    b->prod = PyMem_Malloc(4 * count * sizeof(mpz_t));
+    b->inv = PyMem_Malloc(4 * count * sizeof(mpz_t));
+    if (!b->mod || !b->mu || !b->bits || !b->prod || !b->inv) {
+        /* LCOV_EXCL_START */
+        PyMem_Free(b->mod);
+        PyMem_Free(b->mu);
+        PyMem_Free(b->bits);
+        PyMem_Free(b->prod);
+        PyMem_Free(b->inv);
+        PyMem_Free(b);
+        return (rns_basis*)PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < 4 * count; i++) {
+        mpz_init(b->prod[i]);
+        mpz_init(b->inv[i]);
+    }
+
+    for (i = 0; i < count; i++) {
+        b->mod[i] = mod[i];
+        b->bits[i] = 0;
+        while (b->bits[i] < 64 && (mod[i] >> b->bits[i])) {
+            b->bits[i]++;
+        }
+        b->mu[i] = rns_barrett_mu(b->mod[i], b->bits[i]);
+    }
+
+    if (rns_basis_build(b, 1, 0, count)) {
+        VALUE_ERROR("rns() moduli must be pairwise coprime");
+        rns_basis_decref(b);
+        return NULL;
+    }
+    return b;
+}
+
+static rns_basis *
+rns_basis_new(PyObject *moduli)
+{
+    rns_basis *b = NULL;
+    PyObject *seq;
+    MPZ_Object *temp;
+    uint64_t *mod;
+    Py_ssize_t i, count;
+
+    if (!(seq = PySequence_Fast(moduli, "rns() requires a sequence of moduli"))) {
+        return NULL;
+    }
+
+    count = PySequence_Fast_GET_SIZE(seq);
+    if (count == 0) {
+        VALUE_ERROR("rns() requires at least one modulus");
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    if (!(mod = PyMem_Malloc(count * sizeof(uint64_t)))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        return (rns_basis*)PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!(temp = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), NULL))) {
+            TYPE_ERROR("rns() moduli must be integers");
+            goto done;
+        }
+        if (mpz_cmp_ui(temp->z, 2) < 0 ||
+            mpz_sizeinbase(temp->z, 2) > RNS_MAX_BITS) {
+            Py_DECREF((PyObject*)temp);
+            VALUE_ERROR("rns() moduli must be in the range [2, 2**62)");
+            goto done;
+        }
+        mod[i] = rns_mpz_get_u64(temp->z);
+        Py_DECREF((PyObject*)temp);
+    }
+
+    b = rns_basis_from_array(mod, count);
+
+  done:
+    PyMem_Free(mod);
+    Py_DECREF(seq);
+    return b;
+}
+
+static int
+rns_same_basis(const rns_basis *a, const rns_basis *b)
+{
+    return a == b ||
+           (a->count == b->count &&
+            !memcmp(a->mod, b->mod, a->count * sizeof(uint64_t)));
+}
+
+/* Remainder tree: store the residues of v (0 <= v < prod[node]) modulo the
+ * moduli below node in res[lo*stride], ..., res[(hi-1)*stride].
+ */
+
+static void
+rns_tree_reduce(const rns_basis *b, uint64_t *res, Py_ssize_t stride,
+                Py_ssize_t node, Py_ssize_t lo, Py_ssize_t hi, const mpz_t v)
+{
+    Py_ssize_t mid = lo + (hi - lo) / 2;
+    mpz_t t;
+
+    if (hi - lo == 1) {
+        res[lo * stride] = rns_mpz_get_u64(v);
+        return;
+    }
+    mpz_init(t);
+    mpz_tdiv_r(t, v, b->prod[2 * node]);
+    rns_tree_reduce(b, res, stride, 2 * node, lo, mid, t);
+    mpz_tdiv_r(t, v, b->prod[2 * node + 1]);
+    rns_tree_reduce(b, res, stride, 2 * node + 1, mid, hi, t);
+    mpz_clear(t);
+}
+
+static void
+rns_from_mpz(const rns_basis *b, uint64_t *res, Py_ssize_t stride, const mpz_t v)
+{
+    Py_ssize_t j;
+    uint64_t x;
+    mpz_t t;
+
+    if (mpz_sgn(v) >= 0 && mpz_sizeinbase(v, 2) <= 64) {
+        x = rns_mpz_get_u64(v);
+        for (j = 0; j < b->count; j++) {
+            res[j * stride] = x % b->mod[j];
+        }
+        return;
+    }
+    mpz_init(t);
+    mpz_fdiv_r(t, v, b->prod[1]);
+    rns_tree_reduce(b, res, stride, 1, 0, b->count, t);
+    mpz_clear(t);
+}
+
+/* CRT tree: set out to the unique value in [0, prod[node]) with the
+ * residues res[lo*stride], ..., res[(hi-1)*stride].
+ */
+
+static void
+rns_tree_crt(const rns_basis *b, const uint64_t *res, Py_ssize_t stride,
+             Py_ssize_t node, Py_ssize_t lo, Py_ssize_t hi, mpz_t out)
+{
+    Py_ssize_t mid = lo + (hi - lo) / 2;
+    mpz_t t;
+
+    if (hi - lo == 1) {
+        rns_mpz_set_u64(out, res[lo * stride]);
+        return;
+    }
+    mpz_init(t);
+    rns_tree_crt(b, res, stride, 2 * node, lo, mid, out);
+    rns_tree_crt(b, res, stride, 2 * node + 1, mid, hi, t);
+    mpz_sub(t, t, out);
+    mpz_mul(t, t, b->inv[node]);
+    mpz_mod(t, t, b->prod[2 * node + 1]);
+    mpz_addmul(out, t, b->prod[2 * node]);
+    mpz_clear(t);
+}
+
+static void
+rns_to_mpz(const rns_basis *b, const uint64_t *res, Py_ssize_t stride, mpz_t out)
+{
+    rns_tree_crt(b, res, stride, 1, 0, b->count, out);
+}
+
+/* Element-wise kernels. An operand is either an rns vector or a scalar
+ * that is broadcast to every element (step == 0).
+ */
+
+enum { RNS_ADD, RNS_SUB, RNS_MUL, RNS_FMA, RNS_NEG };
+
+typedef struct {
+    const uint64_t *data;
+    Py_ssize_t row;        /* distance between moduli */
+    Py_ssize_t step;       /* distance between values */
+    uint64_t *scalar;      /* storage owned by a scalar operand */
+} rns_operand;
+
+static void
+rns_kernel(int op, const rns_basis *b, Py_ssize_t size, uint64_t *out,
+           const rns_operand *x, const rns_operand *y, const rns_operand *z)
+{
+    Py_ssize_t i, j;
+
+    for (j = 0; j < b->count; j++) {
+        const uint64_t m = b->mod[j], mu = b->mu[j];
+        const int k = b->bits[j];
+        const uint64_t *xp = x->data + j * x->row;
+        const uint64_t *yp = y ? y->data + j * y->row : NULL;
+        const uint64_t *zp = z ? z->data + j * z->row : NULL;
+        const Py_ssize_t xs = x->step;
+        const Py_ssize_t ys = y ? y->step : 0;
+        const Py_ssize_t zs = z ? z->step : 0;
+        uint64_t *rp = out + j * size;
+
+        switch (op) {
+        case RNS_ADD:
+            for (i = 0; i < size; i++) {
+                rp[i] = rns_addmod(xp[i * xs], yp[i * ys], m);
+            }
+            break;
+        case RNS_SUB:
+            for (i = 0; i < size; i++) {
+                rp[i] = rns_submod(xp[i * xs], yp[i * ys], m);
+            }
+            break;
+        case RNS_MUL:
+            for (i = 0; i < size; i++) {
+                rp[i] = rns_mulmod(xp[i * xs], yp[i * ys], m, mu, k);
+            }
+            break;
+        case RNS_FMA:
+            for (i = 0; i < size; i++) {
+                rp[i] = rns_fmamod(xp[i * xs], yp[i * ys], zp[i * zs], m, mu, k);
+            }
+            break;
+        default:
+            for (i = 0; i < size; i++) {
+                rp[i] = rns_submod(0, xp[i * xs], m);
+            }
+            break;
+        }
+    }
+}
+
+static RNS_Object *
+GMPy_RNS_New(rns_basis *b, Py_ssize_t size)
+{
+    RNS_Object *result;
+
+    if (size > PY_SSIZE_T_MAX / b->count / (Py_ssize_t)sizeof(uint64_t)) {
+        return (RNS_Object*)PyErr_NoMemory();
+    }
+    if (GMPy_Ready_Type(&RNS_Type) < 0 ||
+        !(result = PyObject_New(RNS_Object, &RNS_Type))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    b->refcount++;
+    result->basis = b;
+    result->size = size;
+    if (!(result->res = PyMem_Malloc((size ? size : 1) * b->count * sizeof(uint64_t)))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF((PyObject*)result);
+        return (RNS_Object*)PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    return result;
+}
+
+static void
+GMPy_RNS_Dealloc(RNS_Object *self)
+{
+    PyMem_Free(self->res);
+    rns_basis_decref(self->basis);
+    PyObject_Free(self);
+}
+
+/* Set up an operand for an operation with like. Returns 1 on success, 0 if
+ * obj is not a supported type, and -1 if an exception was raised.
+ */
+
+static int
+rns_operand_init(rns_operand *op, PyObject *obj, RNS_Object *like)
+{
+    MPZ_Object *temp;
+
+    op->scalar = NULL;
+    if (RNS_Check(obj)) {
+        RNS_Object *r = (RNS_Object*)obj;
+
+        if (!rns_same_basis(r->basis, like->basis)) {
+            VALUE_ERROR("rns operands must have the same moduli");
+            return -1;
+        }
+        if (r->size != like->size) {
+            VALUE_ERROR("rns operands must have the same length");
+            return -1;
+        }
+        op->data = r->res;
+        op->row = r->size;
+        op->step = 1;
+        return 1;
+    }
+    if (IS_INTEGER(obj)) {
+        if (!(temp = GMPy_MPZ_From_Integer(obj, NULL))) {
+            /* LCOV_EXCL_START */
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        if (!(op->scalar = PyMem_Malloc(like->basis->count * sizeof(uint64_t)))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF((PyObject*)temp);
+            PyErr_NoMemory();
+            return -1;
+            /* LCOV_EXCL_STOP */
+        }
+        rns_from_mpz(like->basis, op->scalar, 1, temp->z);
+        Py_DECREF((PyObject*)temp);
+        op->data = op->scalar;
+        op->row = 1;
+        op->step = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/* Apply op to the operands x, y, and z (y and z may be NULL). Returns
+ * Py_NotImplemented if an operand is not an rns vector or an integer.
+ */
+
+static PyObject *
+rns_apply(int op, PyObject *x, PyObject *y, PyObject *z)
+{
+    RNS_Object *like, *result = NULL;
+    rns_operand ox, oy, oz;
+    CTXT_Object *context = NULL;
+    int rc;
+
+    CHECK_CONTEXT(context);
+
+    if (RNS_Check(x))
+        like = (RNS_Object*)x;
+    else if (y && RNS_Check(y))
+        like = (RNS_Object*)y;
+    else
+        like = (RNS_Object*)z;
+
+    ox.scalar = oy.scalar = oz.scalar = NULL;
+    if ((rc = rns_operand_init(&ox, x, like)) != 1 ||
+        (y && (rc = rns_operand_init(&oy, y, like)) != 1) ||
+        (z && (rc = rns_operand_init(&oz, z, like)) != 1)) {
+        goto done;
+    }
+
+    if ((result = GMPy_RNS_New(like->basis, like->size))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        rns_kernel(op, like->basis, like->size, result->res, &ox,
+                   y ? &oy : NULL, z ? &oz : NULL);
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+    }
+
+  done:
+    PyMem_Free(ox.scalar);
+    PyMem_Free(oy.scalar);
+    PyMem_Free(oz.scalar);
+    if (rc == 0) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_RNS_Add_Slot(PyObject *x, PyObject *y)
+{
+    return rns_apply(RNS_ADD, x, y, NULL);
+}
+
+static PyObject *
+GMPy_RNS_Sub_Slot(PyObject *x, PyObject *y)
+{
+    return rns_apply(RNS_SUB, x, y, NULL);
+}
+
+static PyObject *
+GMPy_RNS_Mul_Slot(PyObject *x, PyObject *y)
+{
+    return rns_apply(RNS_MUL, x, y, NULL);
+}
+
+static PyObject *
+GMPy_RNS_Minus_Slot(PyObject *x)
+{
+    return rns_apply(RNS_NEG, x, NULL, NULL);
+}
+
+PyDoc_STRVAR(GMPy_doc_rns_method_fma,
+"x.fma(y, z, /) -> rns\n\n"
+"Return x*y + z computed element-wise. y and z may be rns vectors with\n"
+"the same moduli and length as x, or integers.");
+
+static PyObject *
+GMPy_RNS_Method_FMA(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *result;
+
+    if (nargs != 2) {
+        TYPE_ERROR("fma() requires 2 arguments");
+        return NULL;
+    }
+    result = rns_apply(RNS_FMA, self, args[0], args[1]);
+    if (result == Py_NotImplemented) {
+        Py_DECREF(result);
+        TYPE_ERROR("fma() requires rns or integer arguments");
+        return NULL;
+    }
+    return result;
+}
+
+/* Convert the residues to a list of mpz. */
+
+static PyObject *
+rns_to_list(RNS_Object *self)
+{
+    PyObject *result;
+    MPZ_Object *temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i;
+
+    CHECK_CONTEXT(context);
+
+    if (!(result = PyList_New(self->size))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < self->size; i++) {
+        if (!(temp = GMPy_MPZ_New(NULL))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        PyList_SET_ITEM(result, i, (PyObject*)temp);
+    }
+
+    GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+    for (i = 0; i < self->size; i++) {
+        temp = (MPZ_Object*)PyList_GET_ITEM(result, i);
+        rns_to_mpz(self->basis, self->res + i, self->size, temp->z);
+    }
+    GMPY_MAYBE_END_ALLOW_THREADS(context);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_rns_method_to_list,
+"x.to_list() -> list[mpz]\n\n"
+"Return the values of x as a list of mpz. Each value is reconstructed\n"
+"from its residues using a CRT tree and is in the range [0, x.modulus).");
+
+static PyObject *
+GMPy_RNS_Method_ToList(PyObject *self, PyObject *other)
+{
+    return rns_to_list((RNS_Object*)self);
+}
+
+static Py_ssize_t
+GMPy_RNS_Length_Slot(RNS_Object *self)
+{
+    return self->size;
+}
+
+static PyObject *
+GMPy_RNS_Item_Slot(RNS_Object *self, Py_ssize_t i)
+{
+    MPZ_Object *result;
+
+    if (i < 0 || i >= self->size) {
+        PyErr_SetString(PyExc_IndexError, "rns index out of range");
+        return NULL;
+    }
+    if ((result = GMPy_MPZ_New(NULL))) {
+        rns_to_mpz(self->basis, self->res + i, self->size, result->z);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_RNS_RichCompare_Slot(PyObject *a, PyObject *b, int op)
+{
+    RNS_Object *x = (RNS_Object*)a, *y = (RNS_Object*)b;
+    int eq;
+
+    if (!RNS_Check(a) || !RNS_Check(b) || (op != Py_EQ && op != Py_NE)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    eq = rns_same_basis(x->basis, y->basis) && x->size == y->size &&
+         !memcmp(x->res, y->res, x->size * x->basis->count * sizeof(uint64_t));
+    return PyBool_FromLong(op == Py_EQ ? eq : !eq);
+}
+
+static PyObject *
+GMPy_RNS_Attrib_GetModuli(RNS_Object *self, void *closure)
+{
+    PyObject *result;
+    MPZ_Object *temp;
+    Py_ssize_t j;
+
+    if (!(result = PyTuple_New(self->basis->count))) {
+        /* LCOV_EXCL_START */
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    for (j = 0; j < self->basis->count; j++) {
+        if (!(temp = GMPy_MPZ_New(NULL))) {
+            /* LCOV_EXCL_START */
+            Py_DECREF(result);
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+        rns_mpz_set_u64(temp->z, self->basis->mod[j]);
+        PyTuple_SET_ITEM(result, j, (PyObject*)temp);
+    }
+    return result;
+}
+
+static PyObject *
+GMPy_RNS_Attrib_GetModulus(RNS_Object *self, void *closure)
+{
+    MPZ_Object *result;
+
+    if ((result = GMPy_MPZ_New(NULL))) {
+        mpz_set(result->z, self->basis->prod[1]);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject *
+GMPy_RNS_Repr_Slot(RNS_Object *self)
+{
+    PyObject *values, *moduli, *result = NULL;
+
+    if (!(values = rns_to_list(self))) {
+        return NULL;
+    }
+    if ((moduli = GMPy_RNS_Attrib_GetModuli(self, NULL))) {
+        result = PyUnicode_FromFormat("rns(%R, %R)", values, moduli);
+        Py_DECREF(moduli);
+    }
+    Py_DECREF(values);
+    return result;
+}
+
+static PyObject *
+GMPy_RNS_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    RNS_Object *result = NULL;
+    rns_basis *b;
+    PyObject *values, *moduli, *seq;
+    MPZ_Object **temp;
+    CTXT_Object *context = NULL;
+    Py_ssize_t i, size;
+    static char *kwlist[] = {"", "", NULL};
+
+    CHECK_CONTEXT(context);
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO", kwlist, &values, &moduli)) {
+        return NULL;
+    }
+
+    if (RNS_Check(moduli)) {
+        b = ((RNS_Object*)moduli)->basis;
+        b->refcount++;
+    }
+    else if (!(b = rns_basis_new(moduli))) {
+        return NULL;
+    }
+
+    if (!(seq = PySequence_Fast(values, "rns() requires a sequence of integers"))) {
+        rns_basis_decref(b);
+        return NULL;
+    }
+    size = PySequence_Fast_GET_SIZE(seq);
+
+    if (!(temp = PyMem_Calloc(size ? size : 1, sizeof(MPZ_Object*)))) {
+        /* LCOV_EXCL_START */
+        Py_DECREF(seq);
+        rns_basis_decref(b);
+        return PyErr_NoMemory();
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < size; i++) {
+        if (!(temp[i] = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), NULL))) {
+            TYPE_ERROR("rns() requires a sequence of integers");
+            goto done;
+        }
+    }
+
+    if ((result = GMPy_RNS_New(b, size))) {
+        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
+        for (i = 0; i < size; i++) {
+            rns_from_mpz(b, result->res + i, size, temp[i]->z);
+        }
+        GMPY_MAYBE_END_ALLOW_THREADS(context);
+    }
+
+  done:
+    for (i = 0; i < size; i++) {
+        Py_XDECREF((PyObject*)temp[i]);
+    }
+    PyMem_Free(temp);
+    Py_DECREF(seq);
+    rns_basis_decref(b);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_rns,
+"rns(values, moduli, /)\n\n"
+"Return a residue number system vector holding the integers in values.\n"
+"Each integer is stored as its residues modulo the moduli, which must be\n"
+"pairwise coprime integers in the range [2, 2**62). moduli may also be\n"
+"an existing rns vector whose moduli are reused.\n\n"
+"The operators +, -, and * (with another rns vector or an integer) and\n"
+"the fma() method work element-wise modulo each of the moduli, i.e. modulo\n"
+"the product of the moduli. Values are converted back to mpz in the\n"
+"range [0, modulus) by indexing, iteration, or to_list().");
+
+static PyNumberMethods GMPy_RNS_number_methods = {
+    .nb_add = (binaryfunc) GMPy_RNS_Add_Slot,
+    .nb_subtract = (binaryfunc) GMPy_RNS_Sub_Slot,
+    .nb_multiply = (binaryfunc) GMPy_RNS_Mul_Slot,
+    .nb_negative = (unaryfunc) GMPy_RNS_Minus_Slot,
+};
+
+static PySequenceMethods GMPy_RNS_sequence_methods = {
+    .sq_length = (lenfunc) GMPy_RNS_Length_Slot,
+    .sq_item = (ssizeargfunc) GMPy_RNS_Item_Slot,
+};
+
+static PyGetSetDef GMPy_RNS_getseters[] = {
+    { "moduli", (getter)GMPy_RNS_Attrib_GetModuli, NULL,
+        "the moduli of the residue number system", NULL },
+    { "modulus", (getter)GMPy_RNS_Attrib_GetModulus, NULL,
+        "the product of the moduli", NULL },
+    {NULL}
+};
+
+static PyMethodDef GMPy_RNS_methods[] = {
+    { "fma", (PyCFunction)GMPy_RNS_Method_FMA, METH_FASTCALL, GMPy_doc_rns_method_fma },
+    { "to_list", GMPy_RNS_Method_ToList, METH_NOARGS, GMPy_doc_rns_method_to_list },
+    { NULL }
+};
+
+static PyTypeObject RNS_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.rns",
+    .tp_basicsize = sizeof(RNS_Object),
+    .tp_dealloc = (destructor) GMPy_RNS_Dealloc,
+    .tp_repr = (reprfunc) GMPy_RNS_Repr_Slot,
+    .tp_as_number = &GMPy_RNS_number_methods,
+    .tp_as_sequence = &GMPy_RNS_sequence_methods,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_rns,
+    .tp_richcompare = (richcmpfunc) GMPy_RNS_RichCompare_Slot,
+    .tp_methods = GMPy_RNS_methods,
+    .tp_getset = GMPy_RNS_getseters,
+    .tp_new = GMPy_RNS_NewInit,
+};
@@ -0,0 +1,64 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_rns.h                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_RNS_H
+#define GMPY_RNS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A basis of word-size moduli shared by all rns objects created from it.
+ * prod[] and inv[] form a product tree stored in heap order: node 1 covers
+ * all the moduli and node i has children 2*i and 2*i+1. For an internal
+ * node, inv[i] is prod[2*i]**-1 mod prod[2*i+1].
+ */
+
+typedef struct {
+    Py_ssize_t refcount;
+    Py_ssize_t count;      /* number of moduli */
+    uint64_t *mod;         /* the moduli, 2 <= m < 2**62 */
+    uint64_t *mu;          /* Barrett constants floor(2**(2*bits) / m) */
+    int *bits;             /* bit length of each modulus */
+    mpz_t *prod;
+    mpz_t *inv;
+} rns_basis;
+
+typedef struct {
+    PyObject_HEAD
+    rns_basis *basis;
+    Py_ssize_t size;       /* number of values */
+    uint64_t *res;         /* res[j*size + i] is value i modulo mod[j] */
+} RNS_Object;
+
+static PyTypeObject RNS_Type;
+#define RNS_Check(v) (((PyObject*)v)->ob_type == &RNS_Type)
+
+static PyObject * GMPy_RNS_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static void GMPy_RNS_Dealloc(RNS_Object *self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -88,6 +88,7 @@ typedef struct {
     int allow_complex;       /* if 1, allow mpfr functions to return an mpc */
     int rational_division;   /* if 1, mpz/mpz returns an mpq result */
     int allow_release_gil;   /* if 1, release GIL for mpz operations */
+    int threads;             /* maximum number of threads for one operation */
 } gmpy_context;
 
 typedef struct {
@@ -0,0 +1,462 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_vdf.c                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Helpers for verifiable delay functions of the form x**(2**t) mod n.
+ *
+ * repeated_square() calls mpz_powm() with the exponent 2**c for chunks of c
+ * squarings. For odd n, GMP keeps the value in Montgomery form within a
+ * chunk, and the chunks are long enough that the window table and the
+ * conversions cost little. The GIL is released during each chunk and
+ * pending signals are checked between chunks, so a long evaluation can be
+ * interrupted. Optionally every k-th value is kept for proof construction.
+ *
+ * wesolowski_prove() computes pi = x**floor(2**t / l) mod n from those
+ * checkpoints. With C[j] = x**(2**(j*k)) and q[j] the j-th k-bit digit of
+ * floor(2**t / l), pi is the product of the C[j]**q[j]. The digits are
+ * q[j] = floor((2**(t - j*k) mod l*2**k) / l), so floor(2**t / l) is never
+ * formed. For small k the checkpoints are collected into 2**k buckets by
+ * digit, and pi needs about t/k + 2**(k+1) multiplications. Otherwise each
+ * C[j]**q[j] is a separate exponentiation. The checkpoints are split
+ * between context.threads threads, which run without the GIL.
+ */
+
+#define VDF_MIN_CHUNK    64
+#define VDF_MAX_CHUNK    4096
+#define VDF_BUCKET_BITS  12
+#define VDF_BUCKET_LIMBS ((size_t)1 << 23)   /* 64 MiB of buckets per thread */
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_repeated_square,
+"repeated_square(x, t, n, /, k=0) -> mpz | tuple[mpz, list[mpz]]\n\n"
+"Return x**(2**t) mod n, computed by t modular squarings. If k > 0,\n"
+"return a 2-tuple (y, checkpoints) where checkpoints[i] is\n"
+"x**(2**(i*k)) mod n for 0 <= i*k < t. The checkpoints can be passed to\n"
+"`wesolowski_prove()`. The GIL is released and the computation can be\n"
+"interrupted with KeyboardInterrupt.");
+
+static PyObject *
+GMPy_MPZ_Function_RepeatedSquare(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *x, *n, *list = NULL, *result = NULL;
+    MPZ_Object *base = NULL, *mod = NULL, *y = NULL, *cp;
+    Py_ssize_t t, k = 0, done = 0, c, chunk;
+    unsigned long serial;
+    mpz_t e;
+    static char *kwlist[] = {"", "", "", "k", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OnO|n", kwlist,
+                                     &x, &t, &n, &k)) {
+        return NULL;
+    }
+    if (t < 0 || k < 0) {
+        VALUE_ERROR("repeated_square() requires t >= 0 and k >= 0");
+        return NULL;
+    }
+    if (!(base = GMPy_MPZ_From_Integer(x, NULL)) ||
+        !(mod = GMPy_MPZ_From_Integer(n, NULL))) {
+        TYPE_ERROR("repeated_square() requires integer arguments");
+        goto done;
+    }
+    if (mpz_sgn(mod->z) <= 0) {
+        VALUE_ERROR("repeated_square() requires n > 0");
+        goto done;
+    }
+    if (!(y = GMPy_MPZ_New(NULL)) ||
+        (k && !(list = PyList_New(0)))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_mod(y->z, base->z, mod->z);
+
+    chunk = ((Py_ssize_t)1 << 18) / (Py_ssize_t)mpz_size(mod->z);
+    chunk = chunk < VDF_MIN_CHUNK ? VDF_MIN_CHUNK : chunk;
+    chunk = chunk > VDF_MAX_CHUNK ? VDF_MAX_CHUNK : chunk;
+
+    mpz_init(e);
+    serial = gmpy_progress_begin("repeated_square", t);
+    while (done < t) {
+        if (k && done % k == 0) {
+            if (!(cp = GMPy_MPZ_New(NULL))) {
+                /* LCOV_EXCL_START */
+                break;
+                /* LCOV_EXCL_STOP */
+            }
+            mpz_set(cp->z, y->z);
+            if (PyList_Append(list, (PyObject*)cp) < 0) {
+                /* LCOV_EXCL_START */
+                Py_DECREF((PyObject*)cp);
+                break;
+                /* LCOV_EXCL_STOP */
+            }
+            Py_DECREF((PyObject*)cp);
+        }
+        c = t - done < chunk ? t - done : chunk;
+        if (k && c > k - done % k) {
+            c = k - done % k;
+        }
+        mpz_set_ui(e, 0);
+        mpz_setbit(e, (mp_bitcnt_t)c);
+        Py_BEGIN_ALLOW_THREADS;
+        mpz_powm(y->z, y->z, e, mod->z);
+        Py_END_ALLOW_THREADS;
+        done += c;
+        gmpy_progress_update(serial, done);
+        if (PyErr_CheckSignals() < 0) {
+            break;
+        }
+    }
+    gmpy_progress_end(serial);
+    mpz_clear(e);
+
+    if (done == t) {
+        if (k) {
+            result = PyTuple_Pack(2, (PyObject*)y, list);
+        }
+        else {
+            Py_INCREF((PyObject*)y);
+            result = (PyObject*)y;
+        }
+    }
+
+  done:
+    Py_XDECREF((PyObject*)base);
+    Py_XDECREF((PyObject*)mod);
+    Py_XDECREF((PyObject*)y);
+    Py_XDECREF(list);
+    return result;
+}
+
+/* The part of a proof computed by one thread: the product of cp[j]**q[j]
+ * mod n for lo <= j < hi.
+ */
+
+typedef struct {
+    mpz_srcptr *cp;
+    mpz_t *q;
+    mpz_srcptr n;
+    Py_ssize_t lo, hi;
+    int buckets;
+    int nomem;
+    mpz_t result;
+    PyThread_type_lock done;
+} vdf_part;
+
+static void
+vdf_mulmod(mpz_ptr r, mpz_srcptr a, mpz_srcptr b, mpz_srcptr n)
+{
+    mpz_mul(r, a, b);
+    mpz_mod(r, r, n);
+}
+
+static void
+vdf_prove_part(vdf_part *p)
+{
+    Py_ssize_t j;
+    size_t b, nb;
+    mpz_t *bucket, z;
+
+    mpz_set_ui(p->result, 1);
+    mpz_init(z);
+    if (!p->buckets) {
+        for (j = p->lo; j < p->hi; j++) {
+            mpz_powm(z, p->cp[j], p->q[j], p->n);
+            vdf_mulmod(p->result, p->result, z, p->n);
+        }
+        mpz_clear(z);
+        return;
+    }
+
+    /* result = prod(bucket[b]**b) = prod over b of prod(bucket[c], c >= b) */
+    nb = (size_t)1 << p->buckets;
+    if (!(bucket = PyMem_RawMalloc(nb * sizeof(mpz_t)))) {
+        /* LCOV_EXCL_START */
+        p->nomem = 1;
+        mpz_clear(z);
+        return;
+        /* LCOV_EXCL_STOP */
+    }
+    for (b = 0; b < nb; b++) {
+        mpz_init_set_ui(bucket[b], 1);
+    }
+    for (j = p->lo; j < p->hi; j++) {
+        if ((b = mpz_get_ui(p->q[j]))) {
+            vdf_mulmod(bucket[b], bucket[b], p->cp[j], p->n);
+        }
+    }
+    mpz_set_ui(z, 1);
+    for (b = nb - 1; b > 0; b--) {
+        if (mpz_cmp_ui(bucket[b], 1)) {
+            vdf_mulmod(z, z, bucket[b], p->n);
+        }
+        if (mpz_cmp_ui(z, 1)) {
+            vdf_mulmod(p->result, p->result, z, p->n);
+        }
+    }
+    for (b = 0; b < nb; b++) {
+        mpz_clear(bucket[b]);
+    }
+    PyMem_RawFree(bucket);
+    mpz_clear(z);
+}
+
+static void
+vdf_prove_thread(void *arg)
+{
+    vdf_part *p = (vdf_part*)arg;
+
+    vdf_prove_part(p);
+    PyThread_release_lock(p->done);
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_wesolowski_prove,
+"wesolowski_prove(checkpoints, k, t, n, l, /) -> mpz\n\n"
+"Return the Wesolowski proof x**(t2 // l) mod n, where t2 = 2**t and\n"
+"checkpoints is the list returned by repeated_square(x, t, n, k). l is\n"
+"the challenge prime. The work is divided between `context.threads`\n"
+"threads.");
+
+static PyObject *
+GMPy_MPZ_Function_WesolowskiProve(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *seq = NULL, *result = NULL;
+    MPZ_Object *mod = NULL, *ell = NULL, **items = NULL, *pi = NULL;
+    mpz_srcptr *cp = NULL;
+    mpz_t *q = NULL, m, r;
+    vdf_part *parts = NULL;
+    Py_ssize_t k, t, ncp = 0, i, j;
+    int nthreads, buckets = 0, nomem = 0;
+    CTXT_Object *context = NULL;
+
+    CHECK_CONTEXT(context);
+
+    if (nargs != 5) {
+        TYPE_ERROR("wesolowski_prove() requires 5 arguments");
+        return NULL;
+    }
+    if (((k = PyNumber_AsSsize_t(args[1], PyExc_OverflowError)) == -1 && PyErr_Occurred()) ||
+        ((t = PyNumber_AsSsize_t(args[2], PyExc_OverflowError)) == -1 && PyErr_Occurred())) {
+        return NULL;
+    }
+    if (k < 1 || t < 0) {
+        VALUE_ERROR("wesolowski_prove() requires k > 0 and t >= 0");
+        return NULL;
+    }
+    if (!(mod = GMPy_MPZ_From_Integer(args[3], NULL)) ||
+        !(ell = GMPy_MPZ_From_Integer(args[4], NULL))) {
+        TYPE_ERROR("wesolowski_prove() requires integer n and l");
+        goto done;
+    }
+    if (mpz_sgn(mod->z) <= 0 || mpz_cmp_ui(ell->z, 2) < 0) {
+        VALUE_ERROR("wesolowski_prove() requires n > 0 and l > 1");
+        goto done;
+    }
+    if (!(seq = PySequence_Fast(args[0], "wesolowski_prove() requires a sequence of checkpoints"))) {
+        goto done;
+    }
+    ncp = PySequence_Fast_GET_SIZE(seq);
+    if (ncp != (t + k - 1) / k) {
+        VALUE_ERROR("wesolowski_prove() requires ceil(t/k) checkpoints");
+        ncp = 0;
+        goto done;
+    }
+    if (!(pi = GMPy_MPZ_New(NULL))) {
+        /* LCOV_EXCL_START */
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_set_ui(pi->z, 1);
+    if (ncp == 0) {
+        mpz_mod(pi->z, pi->z, mod->z);
+        Py_INCREF((PyObject*)pi);
+        result = (PyObject*)pi;
+        goto done;
+    }
+
+    if (!(items = PyMem_New(MPZ_Object*, ncp)) ||
+        !(cp = PyMem_New(mpz_srcptr, ncp)) ||
+        !(q = PyMem_New(mpz_t, ncp))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        ncp = 0;
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    for (i = 0; i < ncp; i++) {
+        items[i] = NULL;
+        mpz_init(q[i]);
+    }
+    for (i = 0; i < ncp; i++) {
+        if (!(items[i] = GMPy_MPZ_From_Integer(PySequence_Fast_GET_ITEM(seq, i), NULL))) {
+            TYPE_ERROR("wesolowski_prove() requires integer checkpoints");
+            goto done;
+        }
+        cp[i] = items[i]->z;
+    }
+
+    nthreads = GET_THREADS(context);
+    if (nthreads > ncp) {
+        nthreads = (int)ncp;
+    }
+    if (k <= VDF_BUCKET_BITS &&
+        ((size_t)mpz_size(mod->z) << k) <= VDF_BUCKET_LIMBS) {
+        buckets = (int)k;
+    }
+    if (!(parts = PyMem_New(vdf_part, nthreads))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    Py_BEGIN_ALLOW_THREADS;
+    /* q[j] = floor((2**(t - j*k) mod l*2**k) / l), from the last j down. */
+    mpz_init(m);
+    mpz_init(r);
+    mpz_mul_2exp(m, ell->z, (mp_bitcnt_t)k);
+    mpz_set_ui(r, 2);
+    mpz_powm_ui(r, r, (unsigned long)(t - (ncp - 1) * k), m);
+    for (j = ncp - 1; j >= 0; j--) {
+        mpz_tdiv_q(q[j], r, ell->z);
+        mpz_mul_2exp(r, r, (mp_bitcnt_t)k);
+        mpz_mod(r, r, m);
+    }
+    mpz_clear(m);
+    mpz_clear(r);
+
+    for (i = 0; i < nthreads; i++) {
+        parts[i].cp = cp;
+        parts[i].q = q;
+        parts[i].n = mod->z;
+        parts[i].lo = ncp * i / nthreads;
+        parts[i].hi = ncp * (i + 1) / nthreads;
+        parts[i].buckets = buckets;
+        parts[i].nomem = 0;
+        parts[i].done = NULL;
+        mpz_init(parts[i].result);
+        if (i > 0 &&
+            (parts[i].done = PyThread_allocate_lock()) != NULL) {
+            PyThread_acquire_lock(parts[i].done, WAIT_LOCK);
+            if (PyThread_start_new_thread(vdf_prove_thread, &parts[i]) == PYTHREAD_INVALID_THREAD_ID) {
+                PyThread_free_lock(parts[i].done);
+                parts[i].done = NULL;
+            }
+        }
+    }
+    /* Parts whose thread could not be started are computed here. */
+    for (i = 0; i < nthreads; i++) {
+        if (!parts[i].done) {
+            vdf_prove_part(&parts[i]);
+        }
+    }
+    for (i = 0; i < nthreads; i++) {
+        if (parts[i].done) {
+            PyThread_acquire_lock(parts[i].done, WAIT_LOCK);
+            PyThread_free_lock(parts[i].done);
+        }
+        nomem |= parts[i].nomem;
+        vdf_mulmod(pi->z, pi->z, parts[i].result, mod->z);
+        mpz_clear(parts[i].result);
+    }
+    Py_END_ALLOW_THREADS;
+
+    if (nomem) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+    mpz_mod(pi->z, pi->z, mod->z);
+    Py_INCREF((PyObject*)pi);
+    result = (PyObject*)pi;
+
+  done:
+    if (q) {
+        for (i = 0; i < ncp; i++) {
+            mpz_clear(q[i]);
+        }
+    }
+    if (items) {
+        for (i = 0; i < ncp; i++) {
+            Py_XDECREF((PyObject*)items[i]);
+        }
+    }
+    PyMem_Free(parts);
+    PyMem_Free(q);
+    PyMem_Free(cp);
+    PyMem_Free(items);
+    Py_XDECREF(seq);
+    Py_XDECREF((PyObject*)pi);
+    Py_XDECREF((PyObject*)mod);
+    Py_XDECREF((PyObject*)ell);
+    return result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mpz_function_wesolowski_verify,
+"wesolowski_verify(x, y, pi, t, n, l, /) -> bool\n\n"
+"Return True if pi is a valid Wesolowski proof that y = x**(2**t) mod n\n"
+"for the challenge l, that is if pi**l * x**(2**t mod l) = y (mod n).");
+
+static PyObject *
+GMPy_MPZ_Function_WesolowskiVerify(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    MPZ_Object *v[6] = {NULL, NULL, NULL, NULL, NULL, NULL};
+    PyObject *result = NULL;
+    mpz_t r, a, b;
+    int i;
+
+    if (nargs != 6) {
+        TYPE_ERROR("wesolowski_verify() requires 6 arguments");
+        return NULL;
+    }
+    for (i = 0; i < 6; i++) {
+        if (!(v[i] = GMPy_MPZ_From_Integer(args[i], NULL))) {
+            TYPE_ERROR("wesolowski_verify() requires integer arguments");
+            goto done;
+        }
+    }
+    if (mpz_sgn(v[3]->z) < 0 || mpz_sgn(v[4]->z) <= 0 ||
+        mpz_cmp_ui(v[5]->z, 2) < 0) {
+        VALUE_ERROR("wesolowski_verify() requires t >= 0, n > 0 and l > 1");
+        goto done;
+    }
+
+    mpz_init_set_ui(r, 2);
+    mpz_init(a);
+    mpz_init(b);
+    mpz_powm(r, r, v[3]->z, v[5]->z);
+    mpz_powm(a, v[2]->z, v[5]->z, v[4]->z);
+    mpz_powm(b, v[0]->z, r, v[4]->z);
+    vdf_mulmod(a, a, b, v[4]->z);
+    mpz_mod(b, v[1]->z, v[4]->z);
+    result = PyBool_FromLong(mpz_cmp(a, b) == 0);
+    mpz_clear(r);
+    mpz_clear(a);
+    mpz_clear(b);
+
+  done:
+    for (i = 0; i < 6; i++) {
+        Py_XDECREF((PyObject*)v[i]);
+    }
+    return result;
+}
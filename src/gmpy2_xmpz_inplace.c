@@ -32,7 +32,7 @@
 /* Inplace xmpz addition. */
 
 static PyObject *
-GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
 {
     /* Try to make mpz + small_int faster */
 
@@ -57,9 +57,7 @@ GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
             mpz_add(MPZ(self), MPZ(self), tempz);
-            GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
         }
         Py_INCREF(self);
@@ -67,9 +65,7 @@ GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_add(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -81,7 +77,7 @@ GMPy_XMPZ_IAdd_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
 {
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
@@ -104,9 +100,7 @@ GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
             mpz_sub(MPZ(self), MPZ(self), tempz);
-            GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
         }
         Py_INCREF(self);
@@ -114,9 +108,7 @@ GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_sub(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -128,7 +120,7 @@ GMPy_XMPZ_ISub_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
 {
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
@@ -146,9 +138,7 @@ GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
             mpz_mul(MPZ(self), MPZ(self), tempz);
-            GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
         }
         Py_INCREF(self);
@@ -156,9 +146,7 @@ GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
     }
 
     if (IS_TYPE_MPZANY(ytype)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_mul(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -172,7 +160,7 @@ GMPy_XMPZ_IMul_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
 {
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
@@ -200,9 +188,7 @@ GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
             mpz_fdiv_q(MPZ(self), MPZ(self), tempz);
-            GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
         }
         Py_INCREF(self);
@@ -214,9 +200,7 @@ GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
             ZERO_ERROR("xmpz division by zero");
             return NULL;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_fdiv_q(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -228,7 +212,7 @@ GMPy_XMPZ_IFloorDiv_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
 {
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
@@ -255,9 +239,7 @@ GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
             mpz_t tempz;
             mpz_init(tempz);
             mpz_set_PyLong(tempz, other);
-            GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
             mpz_fdiv_r(MPZ(self), MPZ(self), tempz);
-            GMPY_MAYBE_END_ALLOW_THREADS(context);
             mpz_clear(tempz);
         }
         Py_INCREF(self);
@@ -269,9 +251,7 @@ GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
             ZERO_ERROR("xmpz modulo by zero");
             return NULL;
         }
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_fdiv_r(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -283,7 +263,7 @@ GMPy_XMPZ_IRem_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_IRshift_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IRshift_Slot(PyObject *self, PyObject *other)
 {
     mp_bitcnt_t shift = GMPy_Integer_AsMpBitCnt(other);
     if (shift == (mp_bitcnt_t)(-1) && PyErr_Occurred())
@@ -300,7 +280,7 @@ GMPy_XMPZ_IRshift_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_ILshift_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_ILshift_Slot(PyObject *self, PyObject *other)
 {
     mp_bitcnt_t shift = GMPy_Integer_AsMpBitCnt(other);
     if (shift == (mp_bitcnt_t)(-1) && PyErr_Occurred())
@@ -317,7 +297,7 @@ GMPy_XMPZ_ILshift_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
+_GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
 {
     unsigned long exp = GMPy_Integer_AsUnsignedLong(other);
     if (exp == (unsigned long)(-1) && PyErr_Occurred())
@@ -334,15 +314,13 @@ GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
  */
 
 static PyObject *
-GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
 {
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
     if (CHECK_MPZANY(other)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_and(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -351,9 +329,7 @@ GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
         mpz_t tempz;
         mpz_init(tempz);
         mpz_set_PyLong(tempz, other);
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_and(MPZ(self), MPZ(self), tempz);
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         mpz_clear(tempz);
         Py_INCREF(self);
         return self;
@@ -366,15 +342,13 @@ GMPy_XMPZ_IAnd_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
 {
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
     if(CHECK_MPZANY(other)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_xor(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -383,9 +357,7 @@ GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
         mpz_t tempz;
         mpz_init(tempz);
         mpz_set_PyLong(tempz, other);
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_xor(MPZ(self), MPZ(self), tempz);
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         mpz_clear(tempz);
         Py_INCREF(self);
         return self;
@@ -398,15 +370,13 @@ GMPy_XMPZ_IXor_Slot(PyObject *self, PyObject *other)
  */
 
 static PyObject *
-GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
+_GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
 {
     CTXT_Object *context = NULL;
     CHECK_CONTEXT(context);
 
     if(CHECK_MPZANY(other)) {
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_ior(MPZ(self), MPZ(self), MPZ(other));
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         Py_INCREF(self);
         return self;
     }
@@ -415,9 +385,7 @@ GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
         mpz_t tempz;
         mpz_init(tempz);
         mpz_set_PyLong(tempz, other);
-        GMPY_MAYBE_BEGIN_ALLOW_THREADS(context);
         mpz_ior(MPZ(self), MPZ(self), tempz);
-        GMPY_MAYBE_END_ALLOW_THREADS(context);
         mpz_clear(tempz);
         Py_INCREF(self);
         return self;
@@ -426,3 +394,41 @@ GMPy_XMPZ_IIor_Slot(PyObject *self, PyObject *other)
     Py_RETURN_NOTIMPLEMENTED;
 }
 
+/* The wrappers run each inplace operation inside a critical section, so
+ * that concurrent updates of the same xmpz are serialized in free-threaded
+ * builds. With the GIL, the GIL serializes them. The operations never
+ * detach the thread state, since that would release either one.
+ */
+
+#define GMPY_XMPZ_LOCKED_SLOT(NAME) \
+static PyObject * \
+GMPy_XMPZ_##NAME##_Slot(PyObject *self, PyObject *other) \
+{ \
+    PyObject *result; \
+    Py_BEGIN_CRITICAL_SECTION2(self, other); \
+    result = _GMPy_XMPZ_##NAME##_Slot(self, other); \
+    Py_END_CRITICAL_SECTION2(); \
+    return result; \
+}
+
+GMPY_XMPZ_LOCKED_SLOT(IAdd)
+GMPY_XMPZ_LOCKED_SLOT(ISub)
+GMPY_XMPZ_LOCKED_SLOT(IMul)
+GMPY_XMPZ_LOCKED_SLOT(IFloorDiv)
+GMPY_XMPZ_LOCKED_SLOT(IRem)
+GMPY_XMPZ_LOCKED_SLOT(IRshift)
+GMPY_XMPZ_LOCKED_SLOT(ILshift)
+GMPY_XMPZ_LOCKED_SLOT(IAnd)
+GMPY_XMPZ_LOCKED_SLOT(IXor)
+GMPY_XMPZ_LOCKED_SLOT(IIor)
+
+static PyObject *
+GMPy_XMPZ_IPow_Slot(PyObject *self, PyObject *other, PyObject *mod)
+{
+    PyObject *result;
+
+    Py_BEGIN_CRITICAL_SECTION(self);
+    result = _GMPy_XMPZ_IPow_Slot(self, other, mod);
+    Py_END_CRITICAL_SECTION();
+    return result;
+}
@@ -163,7 +163,7 @@ GMPy_XMPZ_Method_SubScript(XMPZ_Object* self, PyObject* item)
         return PyLong_FromLong(mpz_tstbit(self->z, i));
     }
     else if (PySlice_Check(item)) {
-        Py_ssize_t start, stop, step, slicelength, cur, i;
+        Py_ssize_t start, stop, step, slicelength;
         MPZ_Object *result;
 
         if (PySlice_GetIndicesEx(item,
@@ -180,14 +180,7 @@ GMPy_XMPZ_Method_SubScript(XMPZ_Object* self, PyObject* item)
             return NULL;
         }
 
-        mpz_set_ui(result->z, 0);
-        if (slicelength > 0) {
-            for (cur = start, i = 0; i < slicelength; cur += step, i++) {
-                if (mpz_tstbit(self->z, cur)) {
-                    mpz_setbit(result->z, i);
-                }
-            }
-        }
+        gmpy_mpz_gather_bits(result->z, self->z, start, step, slicelength);
         return (PyObject*)result;
     }
     else {
@@ -197,7 +190,7 @@ GMPy_XMPZ_Method_SubScript(XMPZ_Object* self, PyObject* item)
 }
 
 static int
-GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* value)
+_GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* value)
 {
     CTXT_Object *context = NULL;
 
@@ -234,7 +227,7 @@ GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* va
         }
     }
     else if (PySlice_Check(item)) {
-        Py_ssize_t cur, i, seq_len, start, stop, step, slicelength, temp;
+        Py_ssize_t seq_len, start, stop, step, slicelength, temp;
 
         seq_len = mpz_sizeinbase(self->z, 2);
         if (!Py_IsNone(((PySliceObject*)item)->stop)) {
@@ -267,34 +260,13 @@ GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* va
         }
 
         else {
-            int bit;
             MPZ_Object *tempx;
 
             if (!(tempx = GMPy_MPZ_From_Integer(value, context))) {
                 VALUE_ERROR("must specify bit sequence as an integer");
                 return -1;
             }
-            if (mpz_sgn(tempx->z) == 0) {
-                for (cur = start, i = 0; i < slicelength; cur += step, i++) {
-                    mpz_clrbit(self->z, cur);
-                }
-            }
-            else if (!(mpz_cmp_si(tempx->z, -1))) {
-                for (cur = start + (slicelength-1) * step, i = 0;
-                     i < slicelength;
-                     cur -= step, i++) {
-                    mpz_setbit(self->z, cur);
-                }
-            }
-            else {
-                for (cur = start, i = 0; i < slicelength; cur += step, i++) {
-                    bit = mpz_tstbit(tempx->z, i);
-                    if (bit)
-                        mpz_setbit(self->z, cur);
-                    else
-                        mpz_clrbit(self->z, cur);
-                }
-            }
+            gmpy_mpz_scatter_bits(self->z, start, step, slicelength, tempx->z);
             Py_DECREF((PyObject*)tempx);
         }
         return 0;
@@ -306,6 +278,19 @@ GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* va
     return -1;
 }
 
+/* Serialize concurrent bit assignments in free-threaded builds. */
+
+static int
+GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* value)
+{
+    int result;
+
+    Py_BEGIN_CRITICAL_SECTION(self);
+    result = _GMPy_XMPZ_Method_AssignSubScript(self, item, value);
+    Py_END_CRITICAL_SECTION();
+    return result;
+}
+
 /* Implement a multi-purpose iterator object that iterates over the bits in
  * an xmpz. Three different iterators can be created:
  *   1) xmpz.iter_bits(start=0, stop=-1) will return True/False for each bit
@@ -323,9 +308,10 @@ GMPy_XMPZ_Method_AssignSubScript(XMPZ_Object* self, PyObject* item, PyObject* va
 static GMPy_Iter_Object *
 GMPy_Iter_New(void)
 {
-    GMPy_Iter_Object *result;
+    GMPy_Iter_Object *result = NULL;
 
-    if ((result = PyObject_New(GMPy_Iter_Object,
+    if (GMPy_Ready_Type(&GMPy_Iter_Type) == 0 &&
+        (result = PyObject_New(GMPy_Iter_Object,
                                &GMPy_Iter_Type))) {
         result->bitmap = NULL;
         result->start = 0;
@@ -0,0 +1,763 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_xmpz_mmap.c                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Out-of-core integers.
+ *
+ * An mmap_xmpz keeps its limbs in a memory-mapped file instead of memory
+ * from malloc(), so GMP never reallocates or frees the storage. The
+ * kernels work on the limbs with the mpn functions one block at a time, in
+ * order, so the operating system only has to keep the blocks in use in
+ * memory. The file is mapped with the mmap module so the same code works
+ * on every platform.
+ */
+
+/* Number of limbs processed at a time by the linear kernels. */
+
+#define MMAP_XMPZ_BLOCK ((mp_size_t)1 << 18)
+
+/* Default memory, in bytes, for the blocks of mul(). */
+
+#define MMAP_XMPZ_MUL_MEMORY ((Py_ssize_t)1 << 30)
+
+#define MMAP_XMPZ_ORDER 0x0102030405060708ULL
+
+static int
+mmap_xmpz_check(MmapXMPZ_Object *self)
+{
+    if (!self->map) {
+        VALUE_ERROR("mmap_xmpz is closed");
+        return -1;
+    }
+    if (self->running) {
+        RUNTIME_ERROR("mmap_xmpz is in use by another thread");
+        return -1;
+    }
+    return 0;
+}
+
+/* Store the header for a value with size limbs (signed). */
+
+static void
+mmap_xmpz_set_size(MmapXMPZ_Object *self, mp_size_t size)
+{
+    char *h = (char*)self->view.buf;
+    unsigned long long limb = sizeof(mp_limb_t), order = MMAP_XMPZ_ORDER;
+    long long n = (long long)size;
+
+    memset(h, 0, MMAP_XMPZ_HEADER);
+    memcpy(h, MMAP_XMPZ_MAGIC, 8);
+    memcpy(h + 8, &limb, 8);
+    memcpy(h + 16, &order, 8);
+    memcpy(h + 24, &n, 8);
+    self->size = size;
+}
+
+/* Remove high zero limbs from a result with n limbs and store its size. */
+
+static void
+mmap_xmpz_finish(MmapXMPZ_Object *self, mp_size_t n, int negative)
+{
+    const mp_limb_t *p = MMAP_XMPZ_LIMBS(self);
+
+    while (n > 0 && p[n - 1] == 0) {
+        n--;
+    }
+    mmap_xmpz_set_size(self, negative ? -n : n);
+}
+
+/* Map the file and get a writable view of it. */
+
+static int
+mmap_xmpz_map(MmapXMPZ_Object *self)
+{
+    PyObject *mmap, *fd, *advice, *res;
+
+    if (!(mmap = PyImport_ImportModule("mmap"))) {
+        return -1;
+    }
+    if ((fd = PyObject_CallMethod(self->file, "fileno", NULL))) {
+        self->map = PyObject_CallMethod(mmap, "mmap", "Oi", fd, 0);
+        Py_DECREF(fd);
+    }
+    if (self->map) {
+        /* The kernels access the limbs in order. Not every platform
+         * supports madvise(), so errors are ignored.
+         */
+        if ((advice = PyObject_GetAttrString(mmap, "MADV_SEQUENTIAL")) &&
+            (res = PyObject_CallMethod(self->map, "madvise", "O", advice))) {
+            Py_DECREF(res);
+        }
+        Py_XDECREF(advice);
+        PyErr_Clear();
+    }
+    Py_DECREF(mmap);
+    if (!self->map) {
+        return -1;
+    }
+    if (PyObject_GetBuffer(self->map, &self->view, PyBUF_WRITABLE) < 0) {
+        /* LCOV_EXCL_START */
+        Py_CLEAR(self->map);
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    self->alloc = (mp_size_t)((self->view.len - MMAP_XMPZ_HEADER) / sizeof(mp_limb_t));
+    return 0;
+}
+
+static int
+mmap_xmpz_unmap(MmapXMPZ_Object *self)
+{
+    PyObject *res;
+
+    if (!self->map) {
+        return 0;
+    }
+    PyBuffer_Release(&self->view);
+    res = PyObject_CallMethod(self->map, "close", NULL);
+    Py_CLEAR(self->map);
+    if (!res) {
+        /* LCOV_EXCL_START */
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    Py_DECREF(res);
+    return 0;
+}
+
+/* Make room in the file for limbs limbs. The file is unmapped, extended
+ * (with zeros), and mapped again since not every platform can resize a
+ * mapping.
+ */
+
+static int
+mmap_xmpz_reserve(MmapXMPZ_Object *self, mp_size_t limbs)
+{
+    PyObject *res;
+
+    if (limbs <= self->alloc) {
+        return 0;
+    }
+    if ((size_t)limbs > (PY_SSIZE_T_MAX - MMAP_XMPZ_HEADER) / sizeof(mp_limb_t)) {
+        OVERFLOW_ERROR("mmap_xmpz too large");
+        return -1;
+    }
+    if (mmap_xmpz_unmap(self) < 0 ||
+        !(res = PyObject_CallMethod(self->file, "truncate", "n",
+                                    (Py_ssize_t)(MMAP_XMPZ_HEADER + limbs * sizeof(mp_limb_t))))) {
+        return -1;
+    }
+    Py_DECREF(res);
+    return mmap_xmpz_map(self);
+}
+
+/* Unmap and close the file. Any pending exception is preserved. */
+
+static void
+mmap_xmpz_close(MmapXMPZ_Object *self)
+{
+    PyObject *exc_type, *exc_value, *exc_tb, *res;
+
+    PyErr_Fetch(&exc_type, &exc_value, &exc_tb);
+    if (mmap_xmpz_unmap(self) < 0) {
+        /* LCOV_EXCL_START */
+        PyErr_Clear();
+        /* LCOV_EXCL_STOP */
+    }
+    if (self->file) {
+        if ((res = PyObject_CallMethod(self->file, "close", NULL))) {
+            Py_DECREF(res);
+        }
+        else {
+            /* LCOV_EXCL_START */
+            PyErr_Clear();
+            /* LCOV_EXCL_STOP */
+        }
+        Py_CLEAR(self->file);
+    }
+    PyErr_Restore(exc_type, exc_value, exc_tb);
+}
+
+/* An operand of a kernel: an mmap_xmpz or an integer converted to mpz. */
+
+typedef struct {
+    MmapXMPZ_Object *map;  /* marked as running, or NULL */
+    MPZ_Object *temp;
+} mmap_xmpz_operand;
+
+static int
+mmap_xmpz_operand_init(mmap_xmpz_operand *op, PyObject *obj,
+                       MmapXMPZ_Object *self, const char *name)
+{
+    op->map = NULL;
+    op->temp = NULL;
+    if (MmapXMPZ_Check(obj)) {
+        if (obj != (PyObject*)self) {
+            if (mmap_xmpz_check((MmapXMPZ_Object*)obj) < 0) {
+                return -1;
+            }
+            op->map = (MmapXMPZ_Object*)obj;
+            op->map->running = 1;
+        }
+        return 0;
+    }
+    if (IS_INTEGER(obj) && (op->temp = GMPy_MPZ_From_Integer(obj, NULL))) {
+        return 0;
+    }
+    PyErr_Format(PyExc_TypeError, "%s() requires integer or mmap_xmpz arguments", name);
+    return -1;
+}
+
+static void
+mmap_xmpz_operand_clear(mmap_xmpz_operand *op)
+{
+    if (op->map) {
+        op->map->running = 0;
+    }
+    Py_XDECREF((PyObject*)op->temp);
+}
+
+/* The limbs and signed size of obj, which was set up by
+ * mmap_xmpz_operand_init().
+ */
+
+static const mp_limb_t *
+mmap_xmpz_operand_limbs(mmap_xmpz_operand *op, PyObject *obj, mp_size_t *size)
+{
+    if (op->temp) {
+        *size = (mp_size_t)mpz_size(op->temp->z);
+        if (mpz_sgn(op->temp->z) < 0)
+            *size = -*size;
+        return mpz_limbs_read(op->temp->z);
+    }
+    *size = ((MmapXMPZ_Object*)obj)->size;
+    return MMAP_XMPZ_LIMBS((MmapXMPZ_Object*)obj);
+}
+
+/* Set x to x + y. x has room for max(|xs|, |ys|) + 1 limbs. Returns the
+ * number of limbs of the result and sets *negative to its sign. Progress
+ * is counted in blocks.
+ */
+
+static mp_size_t
+mmap_xmpz_add_kernel(mp_limb_t *xp, mp_size_t xs, const mp_limb_t *yp,
+                     mp_size_t ys, int *negative, unsigned long serial)
+{
+    mp_size_t xn = xs < 0 ? -xs : xs, yn = ys < 0 ? -ys : ys;
+    mp_size_t k, len, n;
+    mp_limb_t cy = 0, c;
+    int cmp;
+
+    if ((xs < 0) == (ys < 0) || xs == 0) {
+        /* Add the magnitudes. */
+        *negative = xs < 0 || ys < 0;
+        n = xn < yn ? xn : yn;
+        for (k = 0; k < n; k += len) {
+            len = n - k < MMAP_XMPZ_BLOCK ? n - k : MMAP_XMPZ_BLOCK;
+            c = mpn_add_n(xp + k, xp + k, yp + k, len);
+            if (cy)
+                c += mpn_add_1(xp + k, xp + k, len, cy);
+            cy = c;
+            gmpy_progress_update(serial, k / MMAP_XMPZ_BLOCK + 1);
+        }
+        for (k = n; k < yn; k += len) {
+            len = yn - k < MMAP_XMPZ_BLOCK ? yn - k : MMAP_XMPZ_BLOCK;
+            memcpy(xp + k, yp + k, len * sizeof(mp_limb_t));
+            if (cy)
+                cy = mpn_add_1(xp + k, xp + k, len, cy);
+        }
+        for (k = n; k < xn && cy; k += len) {
+            len = xn - k < MMAP_XMPZ_BLOCK ? xn - k : MMAP_XMPZ_BLOCK;
+            cy = mpn_add_1(xp + k, xp + k, len, cy);
+        }
+        n = xn > yn ? xn : yn;
+        xp[n] = cy;
+        return n + 1;
+    }
+
+    /* Subtract the smaller magnitude from the larger one. */
+    if (xn != yn)
+        cmp = xn > yn ? 1 : -1;
+    else
+        cmp = mpn_cmp(xp, yp, xn);
+    if (cmp == 0) {
+        *negative = 0;
+        return 0;
+    }
+    if (cmp > 0) {
+        *negative = xs < 0;
+        for (k = 0; k < yn; k += len) {
+            len = yn - k < MMAP_XMPZ_BLOCK ? yn - k : MMAP_XMPZ_BLOCK;
+            c = mpn_sub_n(xp + k, xp + k, yp + k, len);
+            if (cy)
+                c += mpn_sub_1(xp + k, xp + k, len, cy);
+            cy = c;
+            gmpy_progress_update(serial, k / MMAP_XMPZ_BLOCK + 1);
+        }
+        for (k = yn; k < xn && cy; k += len) {
+            len = xn - k < MMAP_XMPZ_BLOCK ? xn - k : MMAP_XMPZ_BLOCK;
+            cy = mpn_sub_1(xp + k, xp + k, len, cy);
+        }
+        return xn;
+    }
+    *negative = ys < 0;
+    for (k = 0; k < xn; k += len) {
+        len = xn - k < MMAP_XMPZ_BLOCK ? xn - k : MMAP_XMPZ_BLOCK;
+        c = mpn_sub_n(xp + k, yp + k, xp + k, len);
+        if (cy)
+            c += mpn_sub_1(xp + k, xp + k, len, cy);
+        cy = c;
+        gmpy_progress_update(serial, k / MMAP_XMPZ_BLOCK + 1);
+    }
+    for (k = xn; k < yn; k += len) {
+        len = yn - k < MMAP_XMPZ_BLOCK ? yn - k : MMAP_XMPZ_BLOCK;
+        memcpy(xp + k, yp + k, len * sizeof(mp_limb_t));
+        if (cy)
+            cy = mpn_sub_1(xp + k, xp + k, len, cy);
+    }
+    return yn;
+}
+
+/* Set r to |a| * |b| with a blocked schoolbook product: each pair of
+ * blocks of block limbs is multiplied in memory (where GMP uses its fast
+ * algorithms) and added to r. tp must have room for 2*block limbs and r
+ * must not overlap a or b. an >= 1 and bn >= 1.
+ */
+
+static void
+mmap_xmpz_mul_kernel(mp_limb_t *rp, const mp_limb_t *ap, mp_size_t an,
+                     const mp_limb_t *bp, mp_size_t bn, mp_limb_t *tp,
+                     mp_size_t block, unsigned long serial)
+{
+    mp_size_t rn = an + bn, i, j, la, lb, k;
+    Py_ssize_t done = 0;
+    mp_limb_t cy;
+
+    for (k = 0; k < rn; k += MMAP_XMPZ_BLOCK) {
+        memset(rp + k, 0, (rn - k < MMAP_XMPZ_BLOCK ? rn - k : MMAP_XMPZ_BLOCK) * sizeof(mp_limb_t));
+    }
+    for (i = 0; i < an; i += block) {
+        la = an - i < block ? an - i : block;
+        for (j = 0; j < bn; j += block) {
+            lb = bn - j < block ? bn - j : block;
+            if (la >= lb)
+                mpn_mul(tp, ap + i, la, bp + j, lb);
+            else
+                mpn_mul(tp, bp + j, lb, ap + i, la);
+            k = i + j + la + lb;
+            cy = mpn_add_n(rp + i + j, rp + i + j, tp, la + lb);
+            if (cy && k < rn)
+                mpn_add_1(rp + k, rp + k, rn - k, cy);
+            gmpy_progress_update(serial, ++done);
+        }
+    }
+}
+
+static PyObject *
+GMPy_MmapXMPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds)
+{
+    MmapXMPZ_Object *result;
+    MPZ_Object *value = NULL;
+    PyObject *path, *arg = NULL, *io, *res;
+    static char *kwlist[] = {"", "", NULL};
+    const char *h;
+    unsigned long long limb, order;
+    long long size;
+    mp_size_t n = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|O", kwlist, &path, &arg)) {
+        return NULL;
+    }
+    if (arg && arg != Py_None && !(value = GMPy_MPZ_From_Integer(arg, NULL))) {
+        TYPE_ERROR("mmap_xmpz() value must be an integer");
+        return NULL;
+    }
+    if (GMPy_Ready_Type(&MmapXMPZ_Type) < 0 ||
+        !(result = PyObject_New(MmapXMPZ_Object, &MmapXMPZ_Type))) {
+        /* LCOV_EXCL_START */
+        Py_XDECREF((PyObject*)value);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    Py_INCREF(path);
+    result->path = path;
+    result->file = NULL;
+    result->map = NULL;
+    result->size = 0;
+    result->alloc = 0;
+    result->running = 0;
+
+    if (!(io = PyImport_ImportModule("io"))) {
+        goto error;
+    }
+    result->file = PyObject_CallMethod(io, "open", "Os", path, value ? "w+b" : "r+b");
+    Py_DECREF(io);
+    if (!result->file) {
+        goto error;
+    }
+
+    if (value) {
+        n = (mp_size_t)mpz_size(value->z);
+        if (!(res = PyObject_CallMethod(result->file, "truncate", "n",
+                                        (Py_ssize_t)(MMAP_XMPZ_HEADER + n * sizeof(mp_limb_t))))) {
+            goto error;
+        }
+        Py_DECREF(res);
+        if (mmap_xmpz_map(result) < 0) {
+            goto error;
+        }
+        if (n) {
+            memcpy(MMAP_XMPZ_LIMBS(result), mpz_limbs_read(value->z), n * sizeof(mp_limb_t));
+        }
+        mmap_xmpz_set_size(result, mpz_sgn(value->z) < 0 ? -n : n);
+        Py_DECREF((PyObject*)value);
+        return (PyObject*)result;
+    }
+
+    /* Check the header of an existing file. */
+    if (mmap_xmpz_map(result) < 0) {
+        if (PyErr_ExceptionMatches(PyExc_ValueError)) {
+            /* mmap() can't map an empty file. */
+            PyErr_Clear();
+            VALUE_ERROR("not an mmap_xmpz file");
+        }
+        goto error;
+    }
+    h = (const char*)result->view.buf;
+    if (result->view.len < MMAP_XMPZ_HEADER || memcmp(h, MMAP_XMPZ_MAGIC, 8)) {
+        VALUE_ERROR("not an mmap_xmpz file");
+        goto error;
+    }
+    memcpy(&limb, h + 8, 8);
+    memcpy(&order, h + 16, 8);
+    memcpy(&size, h + 24, 8);
+    if (limb != sizeof(mp_limb_t) || order != MMAP_XMPZ_ORDER) {
+        VALUE_ERROR("mmap_xmpz file was written on an incompatible platform");
+        goto error;
+    }
+    if (size < -(long long)result->alloc || size > (long long)result->alloc) {
+        VALUE_ERROR("invalid mmap_xmpz file");
+        goto error;
+    }
+    result->size = (mp_size_t)size;
+    return (PyObject*)result;
+
+  error:
+    Py_XDECREF((PyObject*)value);
+    Py_DECREF((PyObject*)result);
+    return NULL;
+}
+
+static void
+GMPy_MmapXMPZ_Dealloc(MmapXMPZ_Object *self)
+{
+    mmap_xmpz_close(self);
+    Py_XDECREF(self->path);
+    PyObject_Free(self);
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz_method_add,
+"x.add(y, /) -> None\n\n"
+"Add the integer or mmap_xmpz y to x in place. The limbs are processed\n"
+"in blocks from the least significant end. Will always release the\n"
+"GIL.");
+
+static PyObject *
+GMPy_MmapXMPZ_Method_Add(PyObject *self, PyObject *other)
+{
+    MmapXMPZ_Object *x = (MmapXMPZ_Object*)self;
+    mmap_xmpz_operand op;
+    const mp_limb_t *yp;
+    mp_size_t xn, yn, ys, n;
+    unsigned long serial;
+    int negative;
+
+    if (mmap_xmpz_check(x) < 0 ||
+        mmap_xmpz_operand_init(&op, other, x, "add") < 0) {
+        return NULL;
+    }
+    mmap_xmpz_operand_limbs(&op, other, &ys);
+    xn = x->size < 0 ? -x->size : x->size;
+    yn = ys < 0 ? -ys : ys;
+    if (mmap_xmpz_reserve(x, (xn > yn ? xn : yn) + 1) < 0) {
+        mmap_xmpz_operand_clear(&op);
+        return NULL;
+    }
+    /* The operand may be x itself, so get its limbs after the resize. */
+    yp = mmap_xmpz_operand_limbs(&op, other, &ys);
+
+    x->running = 1;
+    serial = gmpy_progress_begin("mmap_xmpz.add",
+                                 (Py_ssize_t)((xn > yn ? xn : yn) / MMAP_XMPZ_BLOCK + 1));
+    Py_BEGIN_ALLOW_THREADS;
+    n = mmap_xmpz_add_kernel(MMAP_XMPZ_LIMBS(x), x->size, yp, ys, &negative, serial);
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+    x->running = 0;
+
+    mmap_xmpz_finish(x, n, negative);
+    mmap_xmpz_operand_clear(&op);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz_method_mul,
+"x.mul(a, b, /, memory=2**30) -> None\n\n"
+"Set x to a*b, where a and b are integers or mmap_xmpz objects other\n"
+"than x. The operands are split into blocks that fit in memory bytes;\n"
+"each pair of blocks is multiplied with GMP and added to x. Larger\n"
+"blocks are faster since GMP's algorithms are used for more of the work.\n"
+"Will always release the GIL.");
+
+static PyObject *
+GMPy_MmapXMPZ_Method_Mul(PyObject *self, PyObject *args, PyObject *keywds)
+{
+    MmapXMPZ_Object *x = (MmapXMPZ_Object*)self;
+    mmap_xmpz_operand opa, opb;
+    PyObject *a, *b;
+    const mp_limb_t *ap, *bp;
+    mp_limb_t *tp;
+    mp_size_t as, bs, an, bn, block;
+    Py_ssize_t memory = MMAP_XMPZ_MUL_MEMORY;
+    unsigned long serial;
+    static char *kwlist[] = {"", "", "memory", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO|n", kwlist, &a, &b, &memory)) {
+        return NULL;
+    }
+    if (mmap_xmpz_check(x) < 0) {
+        return NULL;
+    }
+    if (a == self || b == self) {
+        VALUE_ERROR("mul() operands must be different from the destination");
+        return NULL;
+    }
+    if (memory <= 0) {
+        VALUE_ERROR("mul() memory must be > 0");
+        return NULL;
+    }
+    if (mmap_xmpz_operand_init(&opa, a, x, "mul") < 0) {
+        return NULL;
+    }
+    if (a == b && MmapXMPZ_Check(a)) {
+        /* a is already marked as running. */
+        opb.map = NULL;
+        opb.temp = NULL;
+    }
+    else if (mmap_xmpz_operand_init(&opb, b, x, "mul") < 0) {
+        mmap_xmpz_operand_clear(&opa);
+        return NULL;
+    }
+    ap = mmap_xmpz_operand_limbs(&opa, a, &as);
+    bp = mmap_xmpz_operand_limbs(&opb, b, &bs);
+    an = as < 0 ? -as : as;
+    bn = bs < 0 ? -bs : bs;
+
+    /* Each product of two blocks needs 2*block limbs; leave the rest of
+     * the memory for GMP's temporary storage.
+     */
+    block = (mp_size_t)(memory / (8 * sizeof(mp_limb_t)));
+    if (block < 64) {
+        block = 64;
+    }
+    if (an == 0 || bn == 0) {
+        mmap_xmpz_set_size(x, 0);
+        goto done;
+    }
+    if (mmap_xmpz_reserve(x, an + bn) < 0) {
+        goto done;
+    }
+    if (!(tp = PyMem_Malloc(2 * block * sizeof(mp_limb_t)))) {
+        /* LCOV_EXCL_START */
+        PyErr_NoMemory();
+        goto done;
+        /* LCOV_EXCL_STOP */
+    }
+
+    x->running = 1;
+    serial = gmpy_progress_begin("mmap_xmpz.mul",
+                                 (Py_ssize_t)(((an + block - 1) / block) * ((bn + block - 1) / block)));
+    Py_BEGIN_ALLOW_THREADS;
+    mmap_xmpz_mul_kernel(MMAP_XMPZ_LIMBS(x), ap, an, bp, bn, tp, block, serial);
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+    x->running = 0;
+    PyMem_Free(tp);
+    mmap_xmpz_finish(x, an + bn, (as < 0) != (bs < 0));
+
+  done:
+    mmap_xmpz_operand_clear(&opa);
+    mmap_xmpz_operand_clear(&opb);
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz_method_set,
+"x.set(value, /) -> None\n\n"
+"Store the integer value in x.");
+
+static PyObject *
+GMPy_MmapXMPZ_Method_Set(PyObject *self, PyObject *other)
+{
+    MmapXMPZ_Object *x = (MmapXMPZ_Object*)self;
+    MPZ_Object *value;
+    mp_size_t n;
+
+    if (mmap_xmpz_check(x) < 0) {
+        return NULL;
+    }
+    if (!(value = GMPy_MPZ_From_Integer(other, NULL))) {
+        TYPE_ERROR("set() requires an integer argument");
+        return NULL;
+    }
+    n = (mp_size_t)mpz_size(value->z);
+    if (mmap_xmpz_reserve(x, n) < 0) {
+        Py_DECREF((PyObject*)value);
+        return NULL;
+    }
+    if (n) {
+        memcpy(MMAP_XMPZ_LIMBS(x), mpz_limbs_read(value->z), n * sizeof(mp_limb_t));
+    }
+    mmap_xmpz_set_size(x, mpz_sgn(value->z) < 0 ? -n : n);
+    Py_DECREF((PyObject*)value);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz_method_to_mpz,
+"x.to_mpz() -> mpz\n\n"
+"Return the value of x as an mpz in memory.");
+
+static PyObject *
+GMPy_MmapXMPZ_Method_ToMPZ(PyObject *self, PyObject *other)
+{
+    MmapXMPZ_Object *x = (MmapXMPZ_Object*)self;
+    MPZ_Object *result;
+    mp_size_t n = x->size < 0 ? -x->size : x->size;
+
+    if (mmap_xmpz_check(x) < 0 || !(result = GMPy_MPZ_New(NULL))) {
+        return NULL;
+    }
+    if (n) {
+        memcpy(mpz_limbs_write(result->z, n), MMAP_XMPZ_LIMBS(x), n * sizeof(mp_limb_t));
+    }
+    mpz_limbs_finish(result->z, x->size);
+    return (PyObject*)result;
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz_method_bit_length,
+"x.bit_length() -> int\n\n"
+"Return the number of significant bits in the absolute value of x.");
+
+static PyObject *
+GMPy_MmapXMPZ_Method_BitLength(PyObject *self, PyObject *other)
+{
+    MmapXMPZ_Object *x = (MmapXMPZ_Object*)self;
+    mp_size_t n = x->size < 0 ? -x->size : x->size;
+    mp_limb_t top;
+    int bits = 0;
+
+    if (mmap_xmpz_check(x) < 0) {
+        return NULL;
+    }
+    if (n == 0) {
+        return PyLong_FromLong(0);
+    }
+    for (top = MMAP_XMPZ_LIMBS(x)[n - 1]; top; top >>= 1) {
+        bits++;
+    }
+    return PyLong_FromUnsignedLongLong((unsigned long long)(n - 1) * GMP_NUMB_BITS + bits);
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz_method_flush,
+"x.flush() -> None\n\n"
+"Write the changes to x to the file.");
+
+static PyObject *
+GMPy_MmapXMPZ_Method_Flush(PyObject *self, PyObject *other)
+{
+    MmapXMPZ_Object *x = (MmapXMPZ_Object*)self;
+
+    if (mmap_xmpz_check(x) < 0) {
+        return NULL;
+    }
+    return PyObject_CallMethod(x->map, "flush", NULL);
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz_method_close,
+"x.close() -> None\n\n"
+"Unmap and close the file. x can't be used afterwards.");
+
+static PyObject *
+GMPy_MmapXMPZ_Method_Close(PyObject *self, PyObject *other)
+{
+    MmapXMPZ_Object *x = (MmapXMPZ_Object*)self;
+
+    if (x->running) {
+        RUNTIME_ERROR("mmap_xmpz is in use by another thread");
+        return NULL;
+    }
+    mmap_xmpz_close(x);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+GMPy_MmapXMPZ_Repr_Slot(MmapXMPZ_Object *self)
+{
+    return PyUnicode_FromFormat("mmap_xmpz(%R)", self->path);
+}
+
+PyDoc_STRVAR(GMPy_doc_mmap_xmpz,
+"mmap_xmpz(path, value=None, /)\n\n"
+"Return an integer whose limbs are stored in the memory-mapped file\n"
+"path, for values that are too large for memory. If value is given the\n"
+"file is created (or replaced) with that value, otherwise an existing\n"
+"file is opened. The file uses the native limb format and can only be\n"
+"read on the same kind of platform.\n\n"
+"The methods add(), mul(), and set() change x in place and to_mpz()\n"
+"loads the value into memory. The kernels process the limbs in blocks\n"
+"so the operating system only needs to keep part of the file in\n"
+"memory.");
+
+static PyMethodDef GMPy_MmapXMPZ_methods[] = {
+    { "add", GMPy_MmapXMPZ_Method_Add, METH_O, GMPy_doc_mmap_xmpz_method_add },
+    { "bit_length", GMPy_MmapXMPZ_Method_BitLength, METH_NOARGS, GMPy_doc_mmap_xmpz_method_bit_length },
+    { "close", GMPy_MmapXMPZ_Method_Close, METH_NOARGS, GMPy_doc_mmap_xmpz_method_close },
+    { "flush", GMPy_MmapXMPZ_Method_Flush, METH_NOARGS, GMPy_doc_mmap_xmpz_method_flush },
+    { "mul", (PyCFunction)GMPy_MmapXMPZ_Method_Mul, METH_VARARGS | METH_KEYWORDS, GMPy_doc_mmap_xmpz_method_mul },
+    { "set", GMPy_MmapXMPZ_Method_Set, METH_O, GMPy_doc_mmap_xmpz_method_set },
+    { "to_mpz", GMPy_MmapXMPZ_Method_ToMPZ, METH_NOARGS, GMPy_doc_mmap_xmpz_method_to_mpz },
+    { NULL }
+};
+
+static PyTypeObject MmapXMPZ_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "gmpy2.mmap_xmpz",
+    .tp_basicsize = sizeof(MmapXMPZ_Object),
+    .tp_dealloc = (destructor) GMPy_MmapXMPZ_Dealloc,
+    .tp_repr = (reprfunc) GMPy_MmapXMPZ_Repr_Slot,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = GMPy_doc_mmap_xmpz,
+    .tp_methods = GMPy_MmapXMPZ_methods,
+    .tp_new = GMPy_MmapXMPZ_NewInit,
+};
@@ -0,0 +1,64 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * gmpy2_xmpz_mmap.h                                                       *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Python interface to the GMP, MPFR, and MPC multiple precision           *
+ * libraries.                                                              *
+ *                                                                         *
+ * Copyright 2024 Case Van Horsen                                          *
+ *                                                                         *
+ * This file is part of GMPY2.                                             *
+ *                                                                         *
+ * GMPY2 is free software: you can redistribute it and/or modify it under  *
+ * the terms of the GNU Lesser General Public License as published by the  *
+ * Free Software Foundation, either version 3 of the License, or (at your  *
+ * option) any later version.                                              *
+ *                                                                         *
+ * GMPY2 is distributed in the hope that it will be useful, but WITHOUT    *
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or   *
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public    *
+ * License for more details.                                               *
+ *                                                                         *
+ * You should have received a copy of the GNU Lesser General Public        *
+ * License along with GMPY2; if not, see <http://www.gnu.org/licenses/>    *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GMPY_XMPZ_MMAP_H
+#define GMPY_XMPZ_MMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An integer whose limbs live in a memory-mapped file. The file starts
+ * with a header of MMAP_XMPZ_HEADER bytes: the magic string, the size of
+ * a limb, a byte order check, and the signed number of limbs. The limbs
+ * follow in native order, so a file can only be used on the platform that
+ * wrote it.
+ */
+
+#define MMAP_XMPZ_MAGIC "GMPY2MAP"
+#define MMAP_XMPZ_HEADER 64
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *path;
+    PyObject *file;       /* the open file, NULL after close() */
+    PyObject *map;        /* mmap.mmap object for the file */
+    Py_buffer view;       /* writable view of map */
+    mp_size_t size;       /* signed number of limbs, as in an mpz */
+    mp_size_t alloc;      /* number of limbs the file can hold */
+    int running;          /* a kernel is active in some thread */
+} MmapXMPZ_Object;
+
+#define MMAP_XMPZ_LIMBS(x) ((mp_limb_t*)((char*)(x)->view.buf + MMAP_XMPZ_HEADER))
+
+static PyTypeObject MmapXMPZ_Type;
+#define MmapXMPZ_Check(v) (((PyObject*)v)->ob_type == &MmapXMPZ_Type)
+
+static PyObject * GMPy_MmapXMPZ_NewInit(PyTypeObject *type, PyObject *args, PyObject *keywds);
+static void GMPy_MmapXMPZ_Dealloc(MmapXMPZ_Object *self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -103,6 +103,41 @@ GMPY_mpz_is_fermat_prp(PyObject *self, PyObject *args)
         goto cleanup;
     }
 
+    /* Use the special form test if n is large and n-1 or n+1 is a small
+     * multiple of a power of 2.
+     */
+    if (mpz_sizeinbase(n->z, 2) >= GMPY_KN_PRP_THRESHOLD) {
+        mp_bitcnt_t e;
+        int c, prp = 0, status;
+        unsigned long serial;
+
+        for (c = 1; c >= -1; c -= 2) {
+            if (c > 0)
+                mpz_sub_ui(nm1, n->z, 1);
+            else
+                mpz_add_ui(nm1, n->z, 1);
+            e = mpz_scan1(nm1, 0);
+            mpz_tdiv_q_2exp(nm1, nm1, e);
+            if (mpz_fits_ulong_p(nm1))
+                break;
+        }
+        if (c >= -1) {
+            serial = gmpy_progress_begin("is_fermat_prp", (Py_ssize_t)e);
+            Py_BEGIN_ALLOW_THREADS;
+            status = GMPY_mpz_kn_fermat(&prp, nm1, e, c, a->z, serial);
+            Py_END_ALLOW_THREADS;
+            gmpy_progress_end(serial);
+            /* LCOV_EXCL_START */
+            if (status < 0) {
+                RUNTIME_ERROR("is_fermat_prp() failed the error check repeatedly");
+                goto cleanup;
+            }
+            /* LCOV_EXCL_STOP */
+            result = prp ? Py_True : Py_False;
+            goto cleanup;
+        }
+    }
+
     mpz_set(nm1, n->z);
     mpz_sub_ui(nm1, nm1, 1);
     mpz_powm(res, a->z, nm1, n->z);
@@ -121,6 +156,326 @@ GMPY_mpz_is_fermat_prp(PyObject *self, PyObject *args)
     return result;
 }
 
+/* *************************************************************************
+ * Fermat probable prime test for numbers of the form N = k*2^n + c where
+ * c is +1 or -1 and k is small.
+ *
+ * With x0 = a^k, a^(k*2^n) is the chain of n squarings of x0. For c == +1
+ * that is a^(N-1) and N is a probable prime if it is 1; for c == -1 that is
+ * a^(N+1) and N is a probable prime if it is a^2.
+ *
+ * Each square is reduced with shifts instead of a division. Writing
+ * x = (q1*k + q0)*2^n + r with 0 <= r < 2^n and 0 <= q0 < k, and using
+ * k*2^n == -c (mod N), gives x == q0*2^n + r - c*q1 (mod N).
+ *
+ * The chain is protected by Gerbicz's error check. With u[i] the value
+ * after i*L squarings and d[j] = u[0]*u[1]*...*u[j], every correct chain
+ * satisfies d[j] == u[0] * d[j-1]^(2^L). The product is updated after each
+ * block of L squarings and the identity is verified after L blocks. A
+ * failed check rolls the computation back to the last verified state.
+ * *************************************************************************/
+
+typedef struct {
+    mpz_t N;
+    mpz_t k;
+    mp_bitcnt_t n;
+    int c;
+    mpz_t q;
+    mpz_t q0;
+    mpz_t r;
+} kn_modulus;
+
+/* Set x to x mod N. */
+
+static void
+kn_reduce(mpz_t x, kn_modulus *m)
+{
+    size_t limit = mpz_sizeinbase(m->N, 2) + 1;
+
+    while (mpz_sizeinbase(x, 2) > limit) {
+        mpz_fdiv_r_2exp(m->r, x, m->n);
+        mpz_fdiv_q_2exp(m->q, x, m->n);
+        if (mpz_fits_ulong_p(m->k)) {
+            mpz_set_ui(m->q0, mpz_fdiv_q_ui(m->q, m->q, mpz_get_ui(m->k)));
+        }
+        else {
+            mpz_fdiv_qr(m->q, m->q0, m->q, m->k);
+        }
+        mpz_mul_2exp(x, m->q0, m->n);
+        mpz_add(x, x, m->r);
+        if (m->c > 0)
+            mpz_sub(x, x, m->q);
+        else
+            mpz_add(x, x, m->q);
+    }
+    while (mpz_sgn(x) < 0)
+        mpz_add(x, x, m->N);
+    while (mpz_cmp(x, m->N) >= 0)
+        mpz_sub(x, x, m->N);
+}
+
+/* Square x the given number of times modulo N. */
+
+static void
+kn_square(mpz_t x, mp_bitcnt_t count, kn_modulus *m, unsigned long serial,
+          mp_bitcnt_t *done)
+{
+    mp_bitcnt_t i;
+
+    for (i = 0; i < count; i++) {
+        mpz_mul(x, x, x);
+        kn_reduce(x, m);
+        if (done && !((++*done) & GMPY_PROGRESS_MASK))
+            gmpy_progress_update(serial, (Py_ssize_t)*done);
+    }
+}
+
+/* Store in *result whether N = k*2^n + c is a Fermat probable prime to the
+ * base a. Requires k >= 1, n >= 1, c = +1 or -1, N > 1 and gcd(a,N) == 1.
+ * Returns -1 if the error check keeps failing and 0 otherwise. Does not use
+ * the Python API so it can be called with the GIL released.
+ */
+
+static int
+GMPY_mpz_kn_fermat(int *result, const mpz_t k, mp_bitcnt_t n, int c,
+                   const mpz_t a, unsigned long serial)
+{
+    kn_modulus m;
+    mpz_t x0, x, d, dprev, check, vx, vd, tail;
+    mp_bitcnt_t L, t = 0, vt = 0, done = 0;
+    unsigned long blocks = 0;
+    int failures = 0, status = 0;
+
+    mpz_init_set(m.k, k);
+    m.n = n;
+    m.c = c;
+    mpz_init(m.N);
+    mpz_init(m.q);
+    mpz_init(m.q0);
+    mpz_init(m.r);
+    mpz_mul_2exp(m.N, k, n);
+    if (c > 0)
+        mpz_add_ui(m.N, m.N, 1);
+    else
+        mpz_sub_ui(m.N, m.N, 1);
+
+    mpz_init(x0);
+    mpz_init(x);
+    mpz_init(d);
+    mpz_init(dprev);
+    mpz_init(check);
+    mpz_init(vx);
+    mpz_init(vd);
+    mpz_init(tail);
+
+    mpz_powm(x0, a, k, m.N);
+
+    /* Block length L, with a check every L blocks, keeps the overhead of
+     * the error check near 2*sqrt(n) multiplications.
+     */
+    for (L = 1; L * L < n; L++);
+
+    mpz_set(x, x0);
+    mpz_set(d, x0);
+    mpz_set(vx, x);
+    mpz_set(vd, d);
+
+    while (t + L <= n) {
+        kn_square(x, L, &m, serial, &done);
+        t += L;
+        mpz_set(dprev, d);
+        mpz_mul(d, d, x);
+        kn_reduce(d, &m);
+        blocks++;
+
+        if (blocks == L || t + L > n) {
+            mpz_set(check, dprev);
+            kn_square(check, L, &m, serial, NULL);
+            mpz_mul(check, check, x0);
+            kn_reduce(check, &m);
+            if (mpz_cmp(check, d) == 0) {
+                mpz_set(vx, x);
+                mpz_set(vd, d);
+                vt = t;
+                failures = 0;
+            }
+            /* LCOV_EXCL_START */
+            else {
+                if (++failures == GMPY_KN_PRP_RETRIES) {
+                    status = -1;
+                    goto cleanup;
+                }
+                mpz_set(x, vx);
+                mpz_set(d, vd);
+                t = done = vt;
+            }
+            /* LCOV_EXCL_STOP */
+            blocks = 0;
+        }
+    }
+
+    /* The remaining n - t < L squarings are not covered by the product, so
+     * they are computed twice.
+     */
+    failures = 0;
+    while (t < n) {
+        mpz_set(tail, x);
+        kn_square(tail, n - t, &m, serial, NULL);
+        kn_square(x, n - t, &m, serial, NULL);
+        if (mpz_cmp(tail, x) == 0) {
+            t = n;
+        }
+        /* LCOV_EXCL_START */
+        else {
+            if (++failures == GMPY_KN_PRP_RETRIES) {
+                status = -1;
+                goto cleanup;
+            }
+            mpz_set(x, vx);
+        }
+        /* LCOV_EXCL_STOP */
+    }
+
+    if (c > 0) {
+        *result = (mpz_cmp_ui(x, 1) == 0);
+    }
+    else {
+        mpz_mul(check, a, a);
+        mpz_mod(check, check, m.N);
+        *result = (mpz_cmp(x, check) == 0);
+    }
+
+  cleanup:
+    mpz_clear(m.N);
+    mpz_clear(m.k);
+    mpz_clear(m.q);
+    mpz_clear(m.q0);
+    mpz_clear(m.r);
+    mpz_clear(x0);
+    mpz_clear(x);
+    mpz_clear(d);
+    mpz_clear(dprev);
+    mpz_clear(check);
+    mpz_clear(vx);
+    mpz_clear(vd);
+    mpz_clear(tail);
+    return status;
+}
+
+PyDoc_STRVAR(doc_mpz_is_kn_prp,
+"is_kn_prp(k,n,c,a=3,/) -> bool\n\n"
+"Return `True` if N = k*2**n + c, where c is 1 or -1, is a Fermat\n"
+"probable prime to the base a.\n"
+"Assuming:\n\n"
+"    gcd(N,a) == 1\n\n"
+"Then a Fermat probable prime requires:\n\n"
+"    a**(N-1) == 1 (mod N)\n\n"
+"The test is a chain of n squarings reduced with shifts, which is\n"
+"faster than `is_fermat_prp()` when k is small. The chain is verified\n"
+"with Gerbicz's error check and recomputed from the last verified\n"
+"state if the check fails. The number of squarings completed is\n"
+"reported by `progress()`. Will always release the GIL.");
+
+static PyObject *
+GMPY_mpz_is_kn_prp(PyObject *self, PyObject *args)
+{
+    MPZ_Object *k = NULL, *a = NULL, *temp = NULL, *c = NULL;
+    PyObject *result = NULL;
+    mp_bitcnt_t n;
+    int prp = 0, status;
+    unsigned long serial;
+    mpz_t N, g;
+    Py_ssize_t nargs = PyTuple_Size(args);
+
+    if (nargs != 3 && nargs != 4) {
+        TYPE_ERROR("is_kn_prp() requires 3 or 4 integer arguments");
+        return NULL;
+    }
+
+    mpz_init(N);
+    mpz_init(g);
+
+    k = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 0), NULL);
+    temp = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 1), NULL);
+    c = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 2), NULL);
+    if (nargs == 4) {
+        a = GMPy_MPZ_From_Integer(PyTuple_GET_ITEM(args, 3), NULL);
+    }
+    else if ((a = GMPy_MPZ_New(NULL))) {
+        mpz_set_ui(a->z, 3);
+    }
+    if (!k || !temp || !c || !a) {
+        TYPE_ERROR("is_kn_prp() requires 3 or 4 integer arguments");
+        goto cleanup;
+    }
+
+    if (mpz_sgn(k->z) <= 0) {
+        VALUE_ERROR("is_kn_prp() requires 'k' be greater than 0");
+        goto cleanup;
+    }
+
+    if (mpz_sgn(temp->z) <= 0 || !mpz_fits_ulong_p(temp->z)) {
+        VALUE_ERROR("is_kn_prp() requires 'n' be greater than 0");
+        goto cleanup;
+    }
+    n = mpz_get_ui(temp->z);
+
+    if (mpz_cmpabs_ui(c->z, 1) != 0) {
+        VALUE_ERROR("is_kn_prp() requires 'c' be 1 or -1");
+        goto cleanup;
+    }
+
+    /* Require a >= 2. */
+    if (mpz_cmp_ui(a->z, 2) < 0) {
+        VALUE_ERROR("is_kn_prp() requires 'a' greater than or equal to 2");
+        goto cleanup;
+    }
+
+    mpz_mul_2exp(N, k->z, n);
+    if (mpz_sgn(c->z) > 0)
+        mpz_add_ui(N, N, 1);
+    else
+        mpz_sub_ui(N, N, 1);
+
+    /* Check for N == 1 */
+    if (mpz_cmp_ui(N, 1) == 0) {
+        result = Py_False;
+        goto cleanup;
+    }
+
+    /* Check gcd(a,N) */
+    mpz_gcd(g, N, a->z);
+    if (mpz_cmp_ui(g, 1) > 0) {
+        VALUE_ERROR("is_kn_prp() requires gcd(N,a) == 1");
+        goto cleanup;
+    }
+
+    serial = gmpy_progress_begin("is_kn_prp", (Py_ssize_t)n);
+    Py_BEGIN_ALLOW_THREADS;
+    status = GMPY_mpz_kn_fermat(&prp, k->z, n, mpz_sgn(c->z), a->z, serial);
+    Py_END_ALLOW_THREADS;
+    gmpy_progress_end(serial);
+
+    /* LCOV_EXCL_START */
+    if (status < 0) {
+        RUNTIME_ERROR("is_kn_prp() failed the error check repeatedly");
+        goto cleanup;
+    }
+    /* LCOV_EXCL_STOP */
+
+    result = prp ? Py_True : Py_False;
+
+  cleanup:
+    Py_XINCREF(result);
+    mpz_clear(N);
+    mpz_clear(g);
+    Py_XDECREF((PyObject*)k);
+    Py_XDECREF((PyObject*)a);
+    Py_XDECREF((PyObject*)c);
+    Py_XDECREF((PyObject*)temp);
+    return result;
+}
+
 /* *************************************************************************
  * mpz_euler_prp: (also called a Solovay-Strassen probable prime)
  * An "Euler probable prime" to the base a is an odd composite number n with,
@@ -29,7 +29,18 @@
 extern "C" {
 #endif
 
+/* Number of bits at which is_fermat_prp() switches to the special form
+ * test for a suitable n.
+ */
+#define GMPY_KN_PRP_THRESHOLD 1000
+
+/* Number of consecutive failed error checks before giving up. */
+#define GMPY_KN_PRP_RETRIES 3
+
 static PyObject * GMPY_mpz_is_fermat_prp(PyObject *self, PyObject *args);
+static PyObject * GMPY_mpz_is_kn_prp(PyObject *self, PyObject *args);
+static int GMPY_mpz_kn_fermat(int *result, const mpz_t k, mp_bitcnt_t n, int c,
+                              const mpz_t a, unsigned long serial);
 static PyObject * GMPY_mpz_is_euler_prp(PyObject *self, PyObject *args);
 static PyObject * GMPY_mpz_is_strong_prp(PyObject *self, PyObject *args);
 static PyObject * GMPY_mpz_is_fibonacci_prp(PyObject *self, PyObject *args);
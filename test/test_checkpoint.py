@@ -0,0 +1,95 @@
+import os
+import random
+import threading
+import time
+
+import pytest
+
+import gmpy2
+from gmpy2 import mpc, mpfr, mpq, mpz, powmod, powmod_state, xmpz
+
+
+def test_checkpoint(tmp_path):
+    path = tmp_path / 'state.ckp'
+    values = [mpz(12345)**50, -7, xmpz(3), mpq(2, 7), mpfr('1.5'),
+              mpc(1, 2), 0]
+    gmpy2.save_checkpoint(path, values)
+    assert os.listdir(tmp_path) == ['state.ckp']
+    result = gmpy2.load_checkpoint(str(path))
+    assert result == values
+    assert [type(v) for v in result] == [mpz, mpz, xmpz, mpq, mpfr, mpc, mpz]
+
+    gmpy2.save_checkpoint(path, ())
+    assert gmpy2.load_checkpoint(path) == []
+
+    # A failed save leaves the previous checkpoint alone.
+    gmpy2.save_checkpoint(path, [mpz(1)])
+    pytest.raises(TypeError, lambda: gmpy2.save_checkpoint(path, [1.5]))
+    pytest.raises(TypeError, lambda: gmpy2.save_checkpoint(path, 1))
+    pytest.raises(TypeError, lambda: gmpy2.save_checkpoint(path))
+    assert gmpy2.load_checkpoint(path) == [1]
+    assert os.listdir(tmp_path) == ['state.ckp']
+
+    data = path.read_bytes()
+    (tmp_path / 'short').write_bytes(data[:-1])
+    pytest.raises(ValueError, lambda: gmpy2.load_checkpoint(tmp_path / 'short'))
+    (tmp_path / 'bad').write_bytes(b'x' + data[1:])
+    pytest.raises(ValueError, lambda: gmpy2.load_checkpoint(tmp_path / 'bad'))
+    pytest.raises(OSError, lambda: gmpy2.load_checkpoint(tmp_path / 'none'))
+
+
+@pytest.mark.parametrize('b,e,m', [(-5, 0, 7), (5, 0, 1), (5, 3, -7),
+                                   (0, 5, 9), (2**70 + 3, 12345, 10**30 + 7),
+                                   (-3, 77, 2**64 + 13), (3, 2**200, -10**40)])
+def test_powmod_state(b, e, m):
+    s = powmod_state(b, e, m)
+    assert s.remaining == e.bit_length()
+    assert s.run() is True
+    assert s.remaining == 0
+    assert s.value == powmod(b, e, m)
+    assert s.run(5) is True
+
+
+def test_powmod_state_resume(tmp_path):
+    r = random.Random(42)
+    n = mpz(r.getrandbits(3000)) | 1
+    s = powmod_state(3, n - 1, n)
+    steps = 0
+    while not s.run(256):
+        assert s.value == powmod(3, (n - 1) >> s.remaining, n)
+        s.save(tmp_path / 'p.ckp')
+        s = powmod_state.load(tmp_path / 'p.ckp')
+        steps += 1
+    assert steps == (n - 1).bit_length() // 256
+    assert s.value == powmod(3, n - 1, n)
+
+    pytest.raises(ValueError, lambda: powmod_state(2, -1, 7))
+    pytest.raises(ValueError, lambda: powmod_state(2, 1, 0))
+    pytest.raises(TypeError, lambda: powmod_state(2, 1.0, 7))
+    pytest.raises(ValueError, lambda: s.run(-1))
+    gmpy2.save_checkpoint(tmp_path / 'p.ckp', [1, 2, 3])
+    pytest.raises(ValueError, lambda: powmod_state.load(tmp_path / 'p.ckp'))
+    gmpy2.save_checkpoint(tmp_path / 'p.ckp', [1, 2, 7, 9, 0])
+    pytest.raises(ValueError, lambda: powmod_state.load(tmp_path / 'p.ckp'))
+
+
+def test_powmod_state_running(tmp_path):
+    r = random.Random(7)
+    n = mpz(r.getrandbits(4096)) | 1
+    e = mpz(r.getrandbits(300000))
+    s = powmod_state(3, e, n)
+    t = threading.Thread(target=s.run)
+    t.start()
+    seen = False
+    while t.is_alive():
+        try:
+            s.value
+        except RuntimeError:
+            seen = True
+            pytest.raises(RuntimeError, lambda: s.save(tmp_path / 'p.ckp'))
+            pytest.raises(RuntimeError, lambda: s.run())
+        time.sleep(0.001)
+    t.join()
+    assert seen
+    assert s.remaining == 0
+    assert s.value == powmod(3, e, n)
@@ -1,9 +1,12 @@
+import contextvars
+import threading
 import warnings
 
 import pytest
 
 import gmpy2
 from gmpy2 import (context, get_context, ieee, local_context, mpc, mpfr, mpz,
+                   precision, rounding,
                    set_context)
 
 
@@ -177,6 +180,101 @@ def test_nested_context():
     r.append(get_context().precision)
     assert r == [53, 113, 237, 489, 237, 113, 53]
 
+    ctx = context(precision=100)
+    with ctx:
+        with ctx:
+            assert get_context().precision == 100
+            get_context().precision = 200
+        assert get_context().precision == 100
+    assert get_context().precision == 53
+    with pytest.raises(RuntimeError):
+        ctx.__exit__(None, None, None)
+    with ctx:
+        set_context(context(precision=300))
+    assert get_context().precision == 53
+
+
+def test_context_threads():
+    # Two threads enter the same context object and exit it in the order
+    # they entered, so the exits are not nested.
+    ctx = context(precision=100)
+    first_in, second_in, first_out = (threading.Event() for _ in range(3))
+    errors = []
+
+    def work(wait_in, done_in, wait_out, done_out):
+        try:
+            set_context(context())
+            if wait_in:
+                assert wait_in.wait(10)
+            with ctx:
+                done_in.set()
+                assert wait_out.wait(10)
+                assert get_context().precision == 100
+            if done_out:
+                done_out.set()
+            assert get_context().precision == 53
+        except BaseException as exc:
+            errors.append(exc)
+
+    threads = [threading.Thread(target=work,
+                                args=(None, first_in, second_in, first_out)),
+               threading.Thread(target=work,
+                                args=(first_in, second_in, first_out, None))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not errors
+
+
+def test_precision_rounding():
+    set_context(context())
+    outer = get_context()
+
+    r = [get_context().precision]
+    with precision(100) as ctx:
+        assert ctx is get_context() and ctx is not outer
+        r.append(get_context().precision)
+        with rounding(gmpy2.RoundUp):
+            r.append(get_context().precision)
+            assert get_context().round == gmpy2.RoundUp
+            up = mpfr(1)/3
+            with precision(20):
+                r.append(get_context().precision)
+            assert get_context().inexact
+        assert get_context().round == gmpy2.RoundToNearest
+        assert not get_context().inexact
+        with rounding(gmpy2.RoundDown):
+            assert mpfr(1)/3 < up
+        r.append(get_context().precision)
+    r.append(get_context().precision)
+    assert r == [53, 100, 100, 20, 100, 53]
+    assert get_context() is outer
+
+    with rounding(gmpy2.RoundAwayZero):
+        assert get_context().real_round == gmpy2.RoundToNearest
+
+    m = precision(70)
+    with pytest.raises(RuntimeError):
+        with m:
+            with m:
+                pass
+    with m:
+        assert get_context().precision == 70
+    assert get_context().precision == 53
+
+    def run():
+        with precision(200):
+            return get_context().precision
+    assert contextvars.copy_context().run(run) == 200
+    assert get_context().precision == 53
+
+    pytest.raises(ValueError, lambda: precision(0))
+    pytest.raises(ValueError, lambda: precision(-2**70))
+    pytest.raises(TypeError, lambda: precision(1.5))
+    pytest.raises(ValueError, lambda: rounding(7))
+    pytest.raises(TypeError, lambda: rounding('a'))
+
 
 @pytest.mark.filterwarnings("ignore:local_context().*:DeprecationWarning")
 def test_nested_local_context():
@@ -207,7 +305,7 @@ def test_context_repr():
         trap_invalid=False, invalid=False,\n        trap_erange=False,\
  erange=False,\n        trap_divzero=False, divzero=False,\n\
         allow_complex=False,\n        rational_division=False,\n\
-        allow_release_gil=False)"""
+        allow_release_gil=False,\n        threads=1)"""
 
     ctx.real_prec = 100
     ctx.imag_prec = 200
@@ -220,7 +318,7 @@ def test_context_repr():
         trap_invalid=False, invalid=False,\n        trap_erange=False,\
  erange=False,\n        trap_divzero=False, divzero=False,\n\
         allow_complex=False,\n        rational_division=False,\n\
-        allow_release_gil=False)"""
+        allow_release_gil=False,\n        threads=1)"""
     ctx.trap_invalid = True
     assert repr(ctx) == \
 """context(precision=53, real_prec=100, imag_prec=200,\n\
@@ -231,7 +329,7 @@ def test_context_repr():
         trap_invalid=True, invalid=False,\n        trap_erange=False,\
  erange=False,\n        trap_divzero=False, divzero=False,\n\
         allow_complex=False,\n        rational_division=False,\n\
-        allow_release_gil=False)"""
+        allow_release_gil=False,\n        threads=1)"""
     pytest.raises(gmpy2.InvalidOperationError, lambda: mpfr('nan') % 123)
     assert repr(ctx) == \
 """context(precision=53, real_prec=100, imag_prec=200,\n\
@@ -242,7 +340,7 @@ def test_context_repr():
         trap_invalid=True, invalid=True,\n        trap_erange=False,\
  erange=False,\n        trap_divzero=False, divzero=False,\n\
         allow_complex=False,\n        rational_division=False,\n\
-        allow_release_gil=False)"""
+        allow_release_gil=False,\n        threads=1)"""
     set_context(ieee(32))
     ctx = get_context()
     ctx.trap_underflow = True
@@ -257,7 +355,7 @@ def test_context_repr():
         trap_invalid=False, invalid=False,\n        trap_erange=False,\
  erange=False,\n        trap_divzero=False, divzero=False,\n\
         allow_complex=False,\n        rational_division=False,\n\
-        allow_release_gil=False)"""
+        allow_release_gil=False,\n        threads=1)"""
 
 
 def test_local_context_deprecated():
@@ -0,0 +1,38 @@
+import random
+
+import pytest
+
+from gmpy2 import divisor, mpz, xmpz
+
+
+DIVISORS = [1, -1, 2, -8, 3, -3, 2**64 - 1, -(2**64 + 1), 2**100 + 3,
+            -(2**700 + 1), 2**70000 + 12345, -(2**70001 + 99), 2**65536]
+
+
+def test_divisor_init():
+    d = divisor(7)
+    assert d.value == 7
+    assert isinstance(d.value, mpz)
+    assert repr(d) == 'divisor(mpz(7))'
+    assert divisor(xmpz(-5)).value == -5
+
+    pytest.raises(ZeroDivisionError, lambda: divisor(0))
+    pytest.raises(TypeError, lambda: divisor(1.5))
+    pytest.raises(TypeError, lambda: divisor())
+    pytest.raises(TypeError, lambda: d.div('a'))
+    pytest.raises(TypeError, lambda: d.divexact(1.0))
+
+
+@pytest.mark.parametrize('d', DIVISORS, ids=lambda d: str(d.bit_length()))
+def test_divisor_divmod(d):
+    r = random.Random(d % 1000)
+    D = divisor(d)
+    for bits in [1, 10, 100, 1000, 70000, 200000]:
+        x = mpz(r.getrandbits(bits)) * r.choice([1, -1])
+        for y in [x, x * d, x * d + 1, x * d - 1, 0]:
+            assert D.divmod(y) == divmod(y, d)
+            assert D.div(y) == y // d
+            assert D.mod(y) == y % d
+        assert D.divexact(x * d) == x
+    assert D.div(5) == 5 // d
+    assert type(D.mod(5)) is mpz
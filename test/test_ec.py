@@ -0,0 +1,305 @@
+import random
+
+import pytest
+
+from gmpy2 import ec_curve, ec_point, gcd, invert, powmod
+
+P127 = 2**127 - 1
+
+# RFC 7748, section 5.
+P25519 = 2**255 - 19
+
+
+def sqrt_mod(a, p):
+    # p = 3 mod 4
+    r = powmod(a, (p + 1)//4, p)
+    return r if r*r % p == a % p else None
+
+
+# Affine reference arithmetic, None is the point at infinity.
+
+def w_add(P, Q, a, p):
+    if P is None:
+        return Q
+    if Q is None:
+        return P
+    (x1, y1), (x2, y2) = P, Q
+    if x1 == x2:
+        if (y1 + y2) % p == 0:
+            return None
+        lam = (3*x1*x1 + a) * invert(2*y1, p) % p
+    else:
+        lam = (y2 - y1) * invert(x2 - x1, p) % p
+    x3 = (lam*lam - x1 - x2) % p
+    return (x3, (lam*(x1 - x3) - y1) % p)
+
+
+def m_add(P, Q, A, B, p):
+    if P is None:
+        return Q
+    if Q is None:
+        return P
+    (x1, y1), (x2, y2) = P, Q
+    if x1 == x2:
+        if (y1 + y2) % p == 0:
+            return None
+        lam = (3*x1*x1 + 2*A*x1 + 1) * invert(2*B*y1, p) % p
+    else:
+        lam = (y2 - y1) * invert(x2 - x1, p) % p
+    x3 = (B*lam*lam - A - x1 - x2) % p
+    return (x3, (lam*(x1 - x3) - y1) % p)
+
+
+def e_add(P, Q, a, d, p):
+    (x1, y1), (x2, y2) = P, Q
+    t = d*x1*x2*y1*y2
+    return ((x1*y2 + y1*x2) * invert(1 + t, p) % p,
+            (y1*y2 - a*x1*x2) * invert(1 - t, p) % p)
+
+
+def ref_mul(add, k, P, zero):
+    R = zero
+    for bit in bin(k)[2:]:
+        R = add(R, R)
+        if bit == '1':
+            R = add(R, P)
+    return R
+
+
+def random_point(model, a, b, p, rng):
+    while True:
+        x = rng.randrange(p)
+        if model == 'weierstrass':
+            y = sqrt_mod(x**3 + a*x + b, p)
+        elif model == 'montgomery':
+            y = sqrt_mod((x**3 + a*x*x + x) * invert(b, p), p)
+        else:
+            den = 1 - b*x*x
+            if den % p == 0:
+                continue
+            y = sqrt_mod((1 - a*x*x) * invert(den, p), p)
+        if y is not None:
+            return x, y
+
+
+curves = [('weierstrass', 2, 3), ('montgomery', 486662, 1),
+          ('edwards', -1, 7)]
+
+
+@pytest.mark.parametrize('p', [1000003, P127])
+@pytest.mark.parametrize('model,a,b', curves)
+def test_ec_mul(model, a, b, p):
+    rng = random.Random(42)
+    E = ec_curve(a, b, p, model=model)
+    assert E.model == model
+    assert E.modulus == p
+    a, b = E.a, E.b
+    if model == 'weierstrass':
+        add, zero = (lambda P, Q: w_add(P, Q, a, p)), None
+    elif model == 'montgomery':
+        add, zero = (lambda P, Q: m_add(P, Q, a, b, p)), None
+    else:
+        add, zero = (lambda P, Q: e_add(P, Q, a, b, p)), (0, 1)
+    for _ in range(10):
+        x, y = random_point(model, a, b, p, rng)
+        P = E.point(x, y)
+        for k in [1, 2, 3, 5, 16, 17, rng.randrange(2**20),
+                  rng.randrange(2**200), rng.randrange(2**1100)]:
+            R = ref_mul(add, k, (x, y), zero)
+            Q = k*P
+            assert Q == P*k
+            if R is None:
+                assert Q.is_identity()
+            elif model == 'montgomery':
+                assert Q.x == R[0]
+                assert Q == E.point(R[0])
+                assert P.mul_sec(k) == Q
+            else:
+                assert (Q.x, Q.y) == R
+                assert Q == E.point(*R)
+                assert -k*P == -Q
+                assert Q + P == (k + 1)*P
+                assert Q - P == (k - 1)*P
+        assert 0*P == E.identity()
+        assert P.double() == 2*P
+
+
+@pytest.mark.parametrize('model,a,b', [c for c in curves if c[0] != 'montgomery'])
+def test_ec_multi_mul(model, a, b):
+    rng = random.Random(1)
+    E = ec_curve(a, b, P127, model=model)
+    points = [E.point(*random_point(model, E.a, E.b, P127, rng)) for _ in range(5)]
+    scalars = [rng.randrange(-2**130, 2**130) for _ in range(5)]
+    expected = E.identity()
+    for P, k in zip(points, scalars):
+        expected += k*P
+    assert E.multi_mul(points, scalars) == expected
+    assert E.multi_mul(points[:1], [0]) == E.identity()
+    assert E.multi_mul([], []) == E.identity()
+    assert E.multi_mul(points[:2], [7, -7]) == 7*(points[0] - points[1])
+    with pytest.raises(ValueError):
+        E.multi_mul(points, scalars[1:])
+    with pytest.raises(TypeError):
+        E.multi_mul(points, [1.5]*5)
+    with pytest.raises(TypeError):
+        E.multi_mul([1], [1])
+
+
+@pytest.mark.parametrize('model,a,b', curves)
+def test_ec_normalize(model, a, b):
+    rng = random.Random(2)
+    E = ec_curve(a, b, P127, model=model)
+    P = E.point(*random_point(model, E.a, E.b, P127, rng))
+    points = [k*P for k in range(1, 20)] + [E.identity()]
+    normal = E.normalize(points)
+    assert normal == points
+    for Q in normal[:-1]:
+        assert Q.coords[2 if model != 'montgomery' else 1] == 1
+    assert normal[-1].is_identity()
+    for Q in points[:-1]:
+        assert Q.normalize().coords == E.normalize([Q])[0].coords
+    assert E.normalize([]) == []
+
+
+def test_ec_x25519():
+    E = ec_curve(486662, 1, P25519, model='montgomery')
+
+    def x25519(k, u):
+        k = bytearray(k)
+        k[0] &= 248
+        k[31] &= 127
+        k[31] |= 64
+        k = int.from_bytes(k, 'little')
+        u = int.from_bytes(u, 'little') & (2**255 - 1)
+        R = E.point(u).mul_sec(k)
+        assert R == k*E.point(u)
+        return int(R.x).to_bytes(32, 'little')
+
+    k = bytes.fromhex('a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4')
+    u = bytes.fromhex('e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c')
+    assert x25519(k, u).hex() == 'c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552'
+    nine = (9).to_bytes(32, 'little')
+    assert x25519(nine, nine).hex() == '422c8e7a6227d7bca1350b3e2bb7279f7897b87bb6854b783c60e80311ae3079'
+
+
+def test_ec_montgomery():
+    rng = random.Random(3)
+    E = ec_curve(486662, 1, P127, model='montgomery')
+    x, y = random_point('montgomery', E.a, E.b, P127, rng)
+    P = E.point(x, y)
+    assert E.point(x) == P
+    assert -P == P
+    Q = 5*P
+    assert Q.diff_add(P, 4*P) == 6*P
+    assert (3*P).diff_add(2*P, P) == Q
+    assert P.mul_sec(0).is_identity()
+    assert E.identity().mul_sec(5).is_identity()
+    for p in [P127, P25519]:
+        T = ec_curve(486662, 1, p, model='montgomery').point(0)
+        for k in range(-6, 7):
+            if k % 2:
+                assert k*T == T and T.mul_sec(k) == T
+            else:
+                assert (k*T).is_identity() and T.mul_sec(k).is_identity()
+        assert (2**300 + 1)*T == T
+    with pytest.raises(ValueError):
+        P + P
+    with pytest.raises(ValueError):
+        P.y
+    with pytest.raises(ValueError):
+        E.point(x, y + 1)
+    with pytest.raises(TypeError):
+        P.diff_add(P)
+    with pytest.raises(ValueError):
+        E.multi_mul([P], [1])
+    W = ec_curve(2, 3, P127)
+    with pytest.raises(ValueError):
+        W.identity().diff_add(W.identity(), W.identity())
+    with pytest.raises(ValueError):
+        W.identity().mul_sec(3)
+
+
+def test_ec_ecm():
+    # A curve modulo q1*q2 on which the point has order dividing k modulo q1
+    # but not modulo q2.
+    q1, q2 = 1009, 1013
+    n = q1*q2
+    rng = random.Random(4)
+    while True:
+        a, x, y = rng.randrange(n), rng.randrange(n), rng.randrange(n)
+        b = (y*y - x**3 - a*x) % n
+        if (4*a**3 + 27*b*b) % q1 == 0 or (4*a**3 + 27*b*b) % q2 == 0:
+            continue
+        P1, k = (x % q1, y % q1), 1
+        R = P1
+        while R is not None:
+            R = w_add(R, P1, a, q1)
+            k += 1
+        if ref_mul(lambda P, Q: w_add(P, Q, a, q2), k, (x % q2, y % q2), None) is not None:
+            break
+    E = ec_curve(a, b, n)
+    Q = k*E.point(x, y)
+    with pytest.raises(ZeroDivisionError):
+        Q.x
+    with pytest.raises(ZeroDivisionError):
+        Q.normalize()
+    with pytest.raises(ZeroDivisionError):
+        E.normalize([E.point(x, y), Q])
+    assert gcd(Q.coords[2], n) == q1
+    assert repr(Q).startswith('ec_point(')
+
+
+def test_ec_errors():
+    E = ec_curve(2, 3, 1000003)
+    assert E == ec_curve(2, 3 + 1000003, 1000003)
+    assert E != ec_curve(2, 3, 1000033)
+    assert repr(E) == "ec_curve(2, 3, 1000003, model='weierstrass')"
+    assert repr(E.identity()) == 'ec_point(infinity)'
+    x, y = random_point('weierstrass', 2, 3, 1000003, random.Random(5))
+    P = E.point(x, y)
+    assert repr(P) == 'ec_point(%d, %d)' % (x, y)
+    assert P.curve is E
+    assert P.coords == (x, y, 1)
+    assert P + E.identity() == P
+    assert P - P == E.identity()
+    assert P != E.point(x, -y)
+    assert P != ec_curve(2, 3, 1000033).identity()
+    assert P != 1
+    with pytest.raises(ValueError):
+        E.identity().x
+    with pytest.raises(ValueError):
+        P + ec_curve(2, 3, 1000033).identity()
+    with pytest.raises(ValueError):
+        E.point(x, y + 1)
+    with pytest.raises(TypeError):
+        E.point(x)
+    with pytest.raises(TypeError):
+        E.point(x, 1.5)
+    with pytest.raises(TypeError):
+        P * 1.5
+    with pytest.raises(TypeError):
+        P * P
+    with pytest.raises(TypeError):
+        hash(P)
+    with pytest.raises(TypeError):
+        ec_point()
+    with pytest.raises(TypeError):
+        E.normalize([P, 1])
+    with pytest.raises(ValueError):
+        ec_curve(0, 0, 1000003)
+    with pytest.raises(ValueError):
+        ec_curve(2, 3, 1000004)
+    with pytest.raises(ValueError):
+        ec_curve(2, 3, 3)
+    with pytest.raises(ValueError):
+        ec_curve(2, 1, 1000003, model='montgomery')
+    with pytest.raises(ValueError):
+        ec_curve(2, 2, 1000003, model='edwards')
+    with pytest.raises(ValueError):
+        ec_curve(2, 3, 1000003, model='hessian')
+    with pytest.raises(TypeError):
+        ec_curve(2, 3.0, 1000003)
+    Ed = ec_curve(-1, 7, 1000003, model='edwards')
+    assert Ed.identity() == Ed.point(0, 1)
+    assert repr(Ed.identity()) == 'ec_point(0, 1)'
+    assert Ed.identity().coords == (0, 1, 1, 0)
@@ -1,32 +1,47 @@
+import array
 import ctypes
+import itertools
+import math
+import random
+import signal
+import threading
+import time
 from fractions import Fraction
 
 import pytest
 
 import gmpy2
-from gmpy2 import (acos, acosh, asin, asinh, atan, atan2, atanh, bincoef,
+from gmpy2 import (acos, acosh, asin, asinh, atan, atan2, atanh, bincoef, bkz,
                    c_div, c_div_2exp, c_divmod, c_divmod_2exp, c_mod,
                    c_mod_2exp, can_round, check_range, comb, context,
                    copy_sign, cos, cosh, cot, coth, csc, csch, degrees,
-                   divexact, divm, double_fac, f2q, f_div, f_div_2exp,
+                   discrete_log,
+                   divexact, divm, divm_many, double_fac, f2q, f_div, f_div_2exp,
                    f_divmod, f_divmod_2exp, f_mod, f_mod_2exp, fac, fib, fib2,
-                   fma, fmma, fmms, fms, free_cache, from_binary, gcd, gcdext,
+                   fma, fmma, fmms, fms, free_cache, from_binary, from_numpy,
+                   gcd, gcdext,
+                   gcdext_many,
                    get_context, get_emax_max, get_emin_min, get_exp, ieee, inf,
                    invert, iroot, iroot_rem, is_bpsw_prp, is_euler_prp,
                    is_extra_strong_lucas_prp, is_fermat_prp, is_fibonacci_prp,
-                   is_finite, is_infinite, is_integer, is_lessgreater,
+                   is_finite, is_infinite, is_integer, is_kn_prp,
+                   is_lessgreater,
                    is_lucas_prp, is_nan, is_regular, is_selfridge_prp,
                    is_signed, is_strong_bpsw_prp, is_strong_lucas_prp,
                    is_strong_prp, is_strong_selfridge_prp, is_unordered,
                    is_zero, isqrt, isqrt_rem, jacobi, kronecker, lcm, legendre,
-                   lucas, lucas2, maxnum, minnum, mpc, mpfr,
+                   lll, lucas, lucas2, maxnum, minnum, mpc, mpfr,
                    mpfr_from_old_binary, mpq, mpq_from_old_binary, mpz,
                    mpz_from_old_binary, multi_fac, nan, next_prime, norm,
-                   phase, polar, powmod, powmod_sec, primorial, proj, radians,
-                   rect, remove, root, root_of_unity, rootn, sec, sech,
+                   phase, polar, poly_divmod, poly_eval, poly_mul, poly_sqr,
+                   powmod, powmod_sec, prime_certificate,
+                   primorial, proj, pslq, radians,
+                   rect, remove, repeated_square, root, root_of_unity, rootn, sec, sech,
                    set_context, set_exp, set_sign, sign, sin, sin_cos, sinh,
                    sinh_cosh, t_div, t_div_2exp, t_divmod, t_divmod_2exp,
-                   t_mod, t_mod_2exp, tan, tanh, zero)
+                   t_mod, t_mod_2exp, tan, tanh, to_numpy,
+                   verify_prime_certificate, wesolowski_prove,
+                   wesolowski_verify, zero)
 
 
 def test_exp():
@@ -284,6 +299,212 @@ def test_powmod():
     pytest.raises(TypeError, lambda: powmod(z1, q, 4))
 
 
+def test_powmod_threads():
+    r = random.Random(42)
+    m = mpz(r.getrandbits(262200)) | (1 << 262199) | 1
+    b = mpz(r.getrandbits(262300))
+    e = mpz(r.getrandbits(40))
+    expected = powmod(b, e, m)
+
+    # Only the parallel algorithm reports progress, and only for odd moduli.
+    def run(m):
+        seen = []
+        out = []
+
+        def work():
+            with gmpy2.context(threads=4):
+                out.append(powmod(b, e, m))
+
+        t = threading.Thread(target=work)
+        t.start()
+        while t.is_alive():
+            p = gmpy2.progress(t.ident)
+            if p:
+                seen.append(p)
+            time.sleep(0.001)
+        t.join()
+        return out[0], seen
+
+    result, seen = run(m)
+    assert result == expected
+    assert seen and all(p[0] == 'powmod' and p[2] == e.bit_length()
+                        for p in seen)
+    result, seen = run(m + 1)
+    assert result == powmod(b, e, m + 1)
+    assert not seen
+
+    with gmpy2.context(threads=4):
+        assert powmod(b, e, m) == expected
+        assert powmod(-b, e, -m) == pow(-b, e, -m) == powmod(-b, e, m) - m
+        assert pow(b, 0, m) == 1
+        assert pow(b, 1, m) == b % m
+        c = b
+        while gcd(c, m) != 1:
+            c += 1
+        assert pow(c, -e, m) == powmod(invert(c, m), e, m)
+
+    ctx = gmpy2.context(threads=4)
+    assert ctx.threads == 4
+    ctx.threads = 1
+    assert ctx.threads == 1
+    pytest.raises(ValueError, lambda: gmpy2.context(threads=0))
+    with pytest.raises(ValueError):
+        ctx.threads = 65
+    with pytest.raises(TypeError):
+        ctx.threads = 2.0
+
+
+def test_repeated_square():
+    r = random.Random(7)
+    n = mpz(r.getrandbits(512)) | 1
+    x = mpz(r.getrandbits(600))
+    for t in [0, 1, 63, 64, 65, 5000]:
+        assert repeated_square(x, t, n) == powmod(x, 2**t, n)
+    assert repeated_square(-x, 10, n + 1) == pow(-x, 2**10, n + 1)
+    assert repeated_square(x, 3, 1) == 0
+
+    y, cps = repeated_square(x, 100, n, k=7)
+    assert y == powmod(x, 2**100, n)
+    assert cps == [powmod(x, 2**(7*i), n) for i in range(15)]
+    assert repeated_square(x, 0, n, k=3) == (x % n, [])
+
+    pytest.raises(TypeError, lambda: repeated_square(x, 5))
+    pytest.raises(TypeError, lambda: repeated_square(1.5, 5, n))
+    pytest.raises(ValueError, lambda: repeated_square(x, -1, n))
+    pytest.raises(ValueError, lambda: repeated_square(x, 5, n, k=-1))
+    pytest.raises(ValueError, lambda: repeated_square(x, 5, 0))
+
+
+def test_wesolowski():
+    r = random.Random(11)
+    n = mpz(r.getrandbits(256)) | 1
+    x = mpz(r.getrandbits(256)) % n
+    l = next_prime(2**64 + r.getrandbits(60))
+    for k, t in [(1, 40), (5, 0), (5, 1), (5, 333), (13, 1000)]:
+        y, cps = repeated_square(x, t, n, k=k)
+        expected = powmod(x, 2**t // l, n)
+        for threads in [1, 3]:
+            with gmpy2.context(threads=threads):
+                pi = wesolowski_prove(cps, k, t, n, l)
+            assert pi == expected
+        assert wesolowski_verify(x, y, pi, t, n, l)
+        assert not wesolowski_verify(x, y + 1, pi, t, n, l)
+        assert not wesolowski_verify(x, y, pi + 1, t, n, l)
+
+    y, cps = repeated_square(x, 20, n, k=4)
+    pytest.raises(TypeError, lambda: wesolowski_prove(cps, 4, 20, n))
+    pytest.raises(ValueError, lambda: wesolowski_prove(cps, 4, 21, n, l))
+    pytest.raises(ValueError, lambda: wesolowski_prove(cps, 0, 20, n, l))
+    pytest.raises(ValueError, lambda: wesolowski_prove(cps, 4, 20, n, 1))
+    pytest.raises(TypeError, lambda: wesolowski_prove([1.5]*5, 4, 20, n, l))
+    pytest.raises(TypeError, lambda: wesolowski_verify(x, y, 1, 20, n))
+    pytest.raises(ValueError, lambda: wesolowski_verify(x, y, 1, -1, n, l))
+
+
+def _gso_norms(basis):
+    # Exact squared norms and coefficients of the Gram-Schmidt vectors.
+    ortho, mu = [], []
+    for v in basis:
+        v = [int(x) for x in v]
+        w = [Fraction(x) for x in v]
+        row = []
+        for u in ortho:
+            c = sum(a*b for a, b in zip(v, u)) / sum(b*b for b in u)
+            w = [a - c*b for a, b in zip(w, u)]
+            row.append(c)
+        ortho.append(w)
+        mu.append(row)
+    return [sum(x*x for x in w) for w in ortho], mu
+
+
+def _is_lll_reduced(basis, delta=Fraction(99, 100)):
+    norms, mu = _gso_norms(basis)
+    return (all(abs(c) <= Fraction(1, 2) for row in mu for c in row) and
+            all(norms[k] >= (delta - mu[k][k-1]**2)*norms[k-1]
+                for k in range(1, len(basis))))
+
+
+def test_lll():
+    r = random.Random(13)
+    for n, m, bits in [(1, 1, 10), (2, 2, 20), (5, 7, 30), (8, 8, 100), (4, 6, 1000)]:
+        basis = [[r.getrandbits(bits) - 2**(bits - 1) for _ in range(m)]
+                 for _ in range(n)]
+        det = _gso_norms(basis)[0]
+        for threads in [1, 3]:
+            with gmpy2.context(threads=threads):
+                reduced = lll(basis)
+            assert _is_lll_reduced(reduced)
+            assert math.prod(_gso_norms(reduced)[0]) == math.prod(det)
+        assert all(isinstance(x, mpz) for v in reduced for x in v)
+    reduced = lll(basis, delta=mpq(3, 4))
+    assert _is_lll_reduced(reduced, Fraction(3, 4))
+    assert lll([]) == []
+
+    # A knapsack with a unique short solution.
+    weights = [r.getrandbits(40) for _ in range(12)]
+    target = sum(w for w, s in zip(weights, range(12)) if s % 3 == 0)
+    basis = [[int(i == j) for j in range(12)] + [w] for i, w in enumerate(weights)]
+    basis.append([0]*12 + [-target])
+    assert [int(i % 3 == 0) for i in range(12)] + [0] in \
+           [[abs(x) for x in v] for v in lll(basis)]
+
+    pytest.raises(ValueError, lambda: lll([[1, 2], [2, 4]]))
+    pytest.raises(ValueError, lambda: lll([[1, 2, 3], [1, 2]]))
+    pytest.raises(ValueError, lambda: lll([[1, 2]], delta=0.25))
+    pytest.raises(ValueError, lambda: lll([[1, 2]], delta=1.5))
+    pytest.raises(TypeError, lambda: lll([[1, 2.5]]))
+    pytest.raises(TypeError, lambda: lll(5))
+    pytest.raises(TypeError, lambda: lll([[1]], delta='x'))
+
+
+def test_bkz():
+    r = random.Random(17)
+    for trial in range(6):
+        basis = [[r.randrange(-50, 50) for _ in range(5)] for _ in range(5)]
+        try:
+            reduced = lll(basis)
+        except ValueError:
+            continue
+        # With a single block, the first vector is a shortest vector.
+        first = bkz(basis, 5)[0]
+        shortest = min(sum(sum(c*v[j] for c, v in zip(cs, reduced))**2
+                           for j in range(5))
+                       for cs in itertools.product(range(-2, 3), repeat=5)
+                       if any(cs))
+        assert sum(x*x for x in first) == shortest
+    basis = [[int(i == j) for j in range(20)] + [r.getrandbits(50)] for i in range(20)]
+    for beta in [2, 6, 30]:
+        reduced = bkz(basis, beta)
+        assert _is_lll_reduced(reduced)
+        assert math.prod(_gso_norms(reduced)[0]) == math.prod(_gso_norms(basis)[0])
+    assert (sum(x*x for x in bkz(basis, 8)[0]) <=
+            sum(x*x for x in lll(basis)[0]))
+    pytest.raises(ValueError, lambda: bkz(basis, 1))
+    pytest.raises(ValueError, lambda: bkz([[1, 2], [2, 4]], 2))
+    pytest.raises(TypeError, lambda: bkz(basis))
+
+
+def test_pslq():
+    with gmpy2.context(precision=200):
+        phi = (1 + gmpy2.sqrt(5))/2
+        assert pslq([phi**2, phi, 1]) in ([1, -1, -1], [-1, 1, 1])
+        a = gmpy2.sqrt(2) + gmpy2.sqrt(3)
+        rel = pslq([a**k for k in range(5)], maxcoeff=10**6)
+        assert rel in ([1, 0, -10, 0, 1], [-1, 0, 10, 0, -1])
+        assert pslq([gmpy2.const_pi(), gmpy2.exp(1)], maxcoeff=10**6) is None
+        pi = gmpy2.const_pi()
+        rel = pslq([pi, pi*mpq(22, 7) - 1, 1], maxcoeff=100)
+        assert sum(c*x for c, x in zip(rel, [pi, pi*mpq(22, 7) - 1, 1])) < 2**-100
+    assert pslq([1.5, 3.0]) in ([2, -1], [-2, 1])
+    assert pslq([0.0, 1]) == [1, 0]
+    assert pslq([1, 2**0.5], maxsteps=1) is None
+    pytest.raises(ValueError, lambda: pslq([1]))
+    pytest.raises(ValueError, lambda: pslq([1, mpfr('inf')]))
+    pytest.raises(TypeError, lambda: pslq([1, 'a']))
+    pytest.raises(TypeError, lambda: pslq(5))
+    pytest.raises(TypeError, lambda: pslq([1, 2], maxcoeff=1.5))
+
+
 def test_powmod_sec():
     assert powmod_sec(3,3,7) == mpz(6)
     assert powmod_sec(-3,3,7) == mpz(1)
@@ -312,6 +533,41 @@ def test_is_fermat_prp():
     assert is_fermat_prp(mpz(12345),2) is False
     assert is_fermat_prp(113,mpz(2))
 
+    # Large n with n-1 or n+1 a small multiple of a power of 2.
+    assert is_fermat_prp(2**4423 - 1, 3)
+    assert is_fermat_prp(2**4423 + 1, 5) is False
+    assert is_fermat_prp(9*2**1305 + 1, 5)
+    assert is_fermat_prp(3*2**1274 - 1, 5)
+    assert is_fermat_prp(9*2**1307 + 1, 5) is False
+
+
+def test_is_kn_prp():
+    for k in range(1, 20):
+        for n in range(1, 20):
+            for c in (1, -1):
+                N = k*2**n + c
+                for a in (2, 3, 5):
+                    if N == 1:
+                        assert is_kn_prp(k, n, c, a) is False
+                    elif gcd(N, a) == 1:
+                        assert is_kn_prp(k, n, c, a) == (pow(a, N - 1, N) == 1)
+
+    assert is_kn_prp(1, 4423, -1)
+    assert is_kn_prp(13, 1000, 1)
+    assert is_kn_prp(3, 1274, -1, 5)
+    assert is_kn_prp(3, 1274, 1, 5) is False
+    N = (2**70 + 1)*2**2000 + 1
+    assert is_kn_prp(mpz(2**70 + 1), 2000, 1, 5) == (powmod(5, N - 1, N) == 1)
+
+    pytest.raises(TypeError, lambda: is_kn_prp(3, 10))
+    pytest.raises(TypeError, lambda: is_kn_prp(3, 10, 1, 3, 5))
+    pytest.raises(TypeError, lambda: is_kn_prp(3, 10, 'a'))
+    pytest.raises(ValueError, lambda: is_kn_prp(0, 10, 1))
+    pytest.raises(ValueError, lambda: is_kn_prp(3, 0, 1))
+    pytest.raises(ValueError, lambda: is_kn_prp(3, 10, 2))
+    pytest.raises(ValueError, lambda: is_kn_prp(3, 10, 1, 1))
+    pytest.raises(ValueError, lambda: is_kn_prp(1, 1, 1))
+
 
 def test_is_euler_prp():
     assert is_euler_prp(12345,2) is False
@@ -397,6 +653,191 @@ def test_is_strong_bpsw_prp():
     assert is_strong_bpsw_prp(113)
 
 
+def test_prime_certificate():
+    assert prime_certificate(2) == 2
+    assert prime_certificate(mpz(2**61 - 1)) == 2**61 - 1
+    assert verify_prime_certificate(2**61 - 1)
+    assert verify_prime_certificate(2**64 + 13) is False
+
+    for n in [2**89 - 1, 2**127 - 1, 2**521 - 1, 3*2**143 - 1]:
+        cert = prime_certificate(n)
+        assert cert[0] == n
+        assert cert[1] == 'n-1'
+        assert verify_prime_certificate(cert)
+
+    cert = prime_certificate(2**127 - 1)
+    assert verify_prime_certificate((cert[0] + 2,) + cert[1:]) is False
+    assert verify_prime_certificate(cert[:2] + (cert[2][:3],)) is False
+    assert verify_prime_certificate(cert[:2] + (cert[2][::-1],)) is False
+    assert verify_prime_certificate((mpz(7), 'n-1', ())) is False
+    assert verify_prime_certificate(('x',)) is False
+    assert verify_prime_certificate(1.5) is False
+
+    # n+1 is completely factored for n = 3*2**k - 1.
+    n = 3*mpz(2)**206 - 1
+    p = next(p for p in range(1, 100) if jacobi(p*p + 4, n) == -1)
+    cert = (n, 'n+1', mpz(p), mpz(-1), (mpz(2), mpz(3)))
+    assert verify_prime_certificate(cert)
+    assert verify_prime_certificate((n + 2,) + cert[1:]) is False
+    assert verify_prime_certificate(cert[:4] + ((mpz(3),),)) is False
+
+    # n-1 = 52*p**2*q: p comes off the factoring stack twice, and counting
+    # its power twice would stop the factoring before q is found.
+    p, q = mpz(792383497), 45*mpz(2)**200 + 1
+    n = 52*p*p*q + 1
+    cert = prime_certificate(n)
+    assert cert[1] == 'n-1'
+    assert verify_prime_certificate(cert)
+
+    # n-1 = 2*q1*q2 with two 50-bit primes and n+1 has no proof either;
+    # without ECPP, n is left unproven.
+    q1, q2 = mpz(627648021381767), mpz(631779682722847)
+    n = 2*q1*q2 + 1
+    assert is_strong_bpsw_prp(n)
+    assert prime_certificate(n) is None
+
+    pytest.raises(ValueError, lambda: prime_certificate(1))
+    pytest.raises(ValueError, lambda: prime_certificate(2**64 + 1))
+    pytest.raises(ValueError, lambda: prime_certificate(mpz(2)**128 + 1))
+    pytest.raises(TypeError, lambda: prime_certificate(1.0))
+
+
+def test_discrete_log():
+    p = 1000003
+    for g, x in [(2, 0), (2, 1), (5, 12345), (123456, 999999)]:
+        h = powmod(g, x, p)
+        r = discrete_log(g, h, p)
+        assert powmod(g, r, p) == h
+        assert isinstance(r, mpz)
+
+    # p-1 has a prime factor of 37 bits.
+    p = mpz(2)**127 - 1
+    x = mpz(2)**125 + 12345
+    assert discrete_log(3, powmod(3, x, p), p) == x
+
+    # p = 2*q + 1 with q above the baby-step giant-step limit.
+    q = mpz(68719477223)
+    p = 2*q + 1
+    x = mpz(12345678901)
+    assert discrete_log(4, powmod(4, x, p), p) == x
+
+    assert discrete_log(2, 8, 15, order=4) == 3
+    assert discrete_log(2, 1, 15, order=4) == 0
+    assert discrete_log(5, 5, 7) == 1
+    assert discrete_log(2, 1024 + 7*11, 7) == 1
+
+    pytest.raises(ValueError, lambda: discrete_log(2, 3, 15, order=4))
+    pytest.raises(ValueError, lambda: discrete_log(2, 3, 7))
+    pytest.raises(ValueError, lambda: discrete_log(3, 5, 7, order=-1))
+    pytest.raises(ValueError, lambda: discrete_log(3, 5, 7, order=4))
+    pytest.raises(ValueError, lambda: discrete_log(6, 3, 9, order=6))
+    pytest.raises(ValueError, lambda: discrete_log(2, 3, 16))
+    pytest.raises(ValueError, lambda: discrete_log(2, 3, 1))
+    pytest.raises(TypeError, lambda: discrete_log(2, 3.0, 7))
+    pytest.raises(TypeError, lambda: discrete_log(2, 3))
+
+
+@pytest.mark.skipif(not hasattr(signal, 'setitimer'), reason="no setitimer")
+def test_discrete_log_interrupt():
+    # Modulo n = P1*P2 with q dividing P1-1 and P2-1, g and h generate
+    # different subgroups of order q, so the rho walk runs for about q steps.
+    q = next_prime(mpz(2)**36)
+    P1, P2 = 6*q + 1, 86*q + 1
+    n = P1*P2
+    a1, a2 = powmod(2, 6, P1), powmod(2, 86, P2)
+    g = (a1*P2*invert(P2, P1) + P1*invert(P1, P2)) % n
+    h = (P2*invert(P2, P1) + a2*P1*invert(P1, P2)) % n
+
+    def handler(signum, frame):
+        raise KeyboardInterrupt
+    old = signal.signal(signal.SIGALRM, handler)
+    try:
+        signal.setitimer(signal.ITIMER_REAL, 0.2)
+        start = time.monotonic()
+        with pytest.raises(KeyboardInterrupt):
+            discrete_log(g, h, n, order=q)
+        assert time.monotonic() - start < 10
+    finally:
+        signal.setitimer(signal.ITIMER_REAL, 0)
+        signal.signal(signal.SIGALRM, old)
+
+
+def _poly_mul(a, b, m=None):
+    r = [0]*(len(a) + len(b) - 1) if a and b else []
+    for i, x in enumerate(a):
+        for j, y in enumerate(b):
+            r[i + j] += x*y
+    if m:
+        r = [c % m for c in r]
+    while r and not r[-1]:
+        r.pop()
+    return r
+
+
+def test_poly_mul():
+    assert poly_mul([1, 2], [3, 4]) == [3, 10, 8]
+    assert poly_mul([1, 1], [-1, 1]) == [-1, 0, 1]
+    assert poly_mul([1, 1], [1, 1], 2) == [1, 0, 1]
+    assert poly_mul([2], [3], modulus=6) == []
+    assert poly_mul([], [1, 2]) == []
+    assert poly_sqr([1, 1, 0, 0]) == [1, 2, 1]
+    assert poly_sqr([mpz(3), 2**70], modulus=5) == [4, 4, 1]
+
+    r = random.Random(42)
+    for n, bits in [(100, 10), (300, 200), (1000, 64), (64, 5000)]:
+        a = [r.randrange(-2**bits, 2**bits) for _ in range(n)]
+        b = [r.randrange(-2**bits, 2**bits) for _ in range(n + 7)]
+        assert poly_mul(a, b) == _poly_mul(a, b)
+        assert poly_sqr(a) == _poly_mul(a, a)
+        for m in [2, 2**61 - 1, 2**255 - 19]:
+            assert poly_mul(a, b, m) == _poly_mul(a, b, m)
+            assert poly_sqr(a, modulus=m) == _poly_mul(a, a, m)
+
+    pytest.raises(TypeError, lambda: poly_mul([1.5], [1]))
+    pytest.raises(TypeError, lambda: poly_mul(1, [1]))
+    pytest.raises(TypeError, lambda: poly_mul([1], [1], 'a'))
+    pytest.raises(ValueError, lambda: poly_mul([1], [1], 1))
+    pytest.raises(TypeError, lambda: poly_sqr())
+
+
+def test_poly_divmod():
+    assert poly_divmod([3, 0, 1], [1, 1], 5) == ([4, 1], [4])
+    assert poly_divmod([1, 2], [1, 2, 3], 7) == ([], [1, 2])
+    assert poly_divmod([0, 0, 6], [0, 3], 7) == ([0, 2], [])
+
+    p = 2**127 - 1
+    r = random.Random(7)
+    for na, nb in [(50, 10), (400, 100), (600, 20), (300, 299)]:
+        a = [r.randrange(p) for _ in range(na)]
+        b = [r.randrange(p) for _ in range(nb - 1)] + [r.randrange(1, p)]
+        q, rem = poly_divmod(a, b, p)
+        assert len(rem) < nb
+        qb = _poly_mul(q, b, p)
+        qb += [0]*(na - len(qb))
+        assert [(x + y) % p for x, y in zip(qb, rem + [0]*na)] == a
+
+    pytest.raises(ZeroDivisionError, lambda: poly_divmod([1], [0, 0], 7))
+    pytest.raises(ValueError, lambda: poly_divmod([1], [1, 2], 4))
+    pytest.raises(TypeError, lambda: poly_divmod([1], [1]))
+
+
+def test_poly_eval():
+    assert poly_eval([1, 2, 3], [0, 1, 2, 10], 1000) == [1, 6, 17, 321]
+    assert poly_eval([], [1, 2], 5) == [0, 0]
+    assert poly_eval([1, 2], [], 5) == []
+
+    p = 2**89 - 1
+    r = random.Random(3)
+    a = [r.randrange(p) for _ in range(150)]
+    xs = [0, 1] + [r.randrange(p) for _ in range(200)]
+    assert poly_eval(a, xs, p) == [sum(c*pow(x, i, p) for i, c in enumerate(a)) % p
+                                   for x in xs]
+
+    pytest.raises(TypeError, lambda: poly_eval([1], [1]))
+    pytest.raises(TypeError, lambda: poly_eval([1], [1.5], 7))
+    pytest.raises(ValueError, lambda: poly_eval([1], [1], 0))
+
+
 def test_mpz_from_old_binary():
     assert gmpy2.mpz_from_old_binary(b'\x15\xcd[\x07') == mpz(123456789)
     assert gmpy2.mpz_from_old_binary(b'\x15\xcd[\x07\xff') == mpz(-123456789)
@@ -1319,6 +1760,44 @@ def test_t_mod_2exp():
     assert t_mod_2exp(-a,16) == mpz(-57920)
 
 
+@pytest.mark.parametrize('mode', ['c', 'f', 't'])
+def test_divmod_many(mode):
+    div = getattr(gmpy2, mode + '_div')
+    mod = getattr(gmpy2, mode + '_mod')
+    div_many = getattr(gmpy2, mode + '_div_many')
+    mod_many = getattr(gmpy2, mode + '_mod_many')
+    divmod_many = getattr(gmpy2, mode + '_divmod_many')
+
+    r = random.Random(42)
+    values = [0, 1, -1, 2**63 - 1, -2**63, 2**64 - 1, -2**64 + 1, 2**200 + 1]
+    values += [r.randrange(-2**70, 2**70) for _ in range(50)]
+    i64 = [x for x in values if -2**63 <= x < 2**63]
+    u64 = [x for x in values if 0 <= x < 2**64]
+    sources = [values, i64, array.array('q', i64), array.array('Q', u64),
+               array.array('b', range(-128, 128)), memoryview(array.array('q', i64))[::-3]]
+
+    for d in [1, -1, 2, -2, 3, -7, 1024, -2**63, 2**64 - 1, -2**64 + 1,
+              2**64, 2**100 + 1, -(2**130 + 7)]:
+        for src in sources:
+            x = list(src)
+            q, m = divmod_many(src, d)
+            assert q == [div(v, d) for v in x]
+            assert m == [mod(v, d) for v in x]
+            assert div_many(src, d) == q
+            assert mod_many(src, d) == m
+            assert all(type(v) is mpz for v in q + m)
+
+    assert divmod_many([], 3) == ([], [])
+    assert div_many((gmpy2.xmpz(1), gmpy2.xmpz(5)), 3) == [div(1, 3), div(5, 3)]
+
+    pytest.raises(TypeError, lambda: div_many([1]))
+    pytest.raises(TypeError, lambda: div_many([1], 'a'))
+    pytest.raises(TypeError, lambda: div_many([1.5], 2))
+    pytest.raises(TypeError, lambda: div_many(array.array('d', [1.0]), 2))
+    pytest.raises(TypeError, lambda: div_many(1, 2))
+    pytest.raises(ZeroDivisionError, lambda: div_many([1], 0))
+
+
 def test_get_max_precision():
     assert gmpy2.get_max_precision() > 53
 
@@ -1384,6 +1863,102 @@ def test_divm():
     assert divm(4,8,20) == mpz(3)
 
 
+def test_gcdext_many():
+    a = [12, mpz(5), 0, -7, 2**200 + 1]
+    b = [18, 3, 0, 2**100, 3**90]
+    g, s, t = gcdext_many(a, b)
+    assert list(zip(g, s, t)) == [gcdext(x, y) for x, y in zip(a, b)]
+    assert gcdext_many([], []) == ([], [], [])
+
+    pytest.raises(TypeError, lambda: gcdext_many([1], [1.5]))
+    pytest.raises(TypeError, lambda: gcdext_many(1, [1]))
+    pytest.raises(TypeError, lambda: gcdext_many([1]))
+    pytest.raises(ValueError, lambda: gcdext_many([1], [1, 2]))
+
+
+def test_divm_many():
+    r = random.Random(5)
+    for m in [7, 2**127 - 1, 10**30 + 57, -13]:
+        a = [r.randrange(-10**40, 10**40) for _ in range(50)]
+        b = [r.randrange(1, 10**40) for _ in range(50)]
+        b = [x if gcd(x, m) == 1 else 1 for x in b]
+        assert divm_many(a, b, m) == [divm(x, y, m) for x, y in zip(a, b)]
+
+    assert divm_many([6, 1, 4, 0], [12, 3, 8, 1], 14) == [4, 5, 4, 0]
+    assert divm_many([], [], 5) == []
+
+    pytest.raises(ZeroDivisionError, lambda: divm_many([1, 1], [3, 2], 4))
+    pytest.raises(ZeroDivisionError, lambda: divm_many([1], [1], 0))
+    pytest.raises(ValueError, lambda: divm_many([1], [2, 3], 5))
+    pytest.raises(TypeError, lambda: divm_many([1], [2], 'a'))
+    pytest.raises(TypeError, lambda: divm_many([1], ['a'], 5))
+    pytest.raises(TypeError, lambda: divm_many([1], [2]))
+
+
+def test_from_numpy():
+    np = pytest.importorskip('numpy')
+    import array
+
+    a = np.array([-2**63, 5, 2**63 - 1])
+    assert from_numpy(a) == [mpz(-2**63), mpz(5), mpz(2**63 - 1)]
+    assert from_numpy(a, mpq)[1] == mpq(5)
+    assert from_numpy(np.array([0.1, 2.5]), mpfr) == [mpfr(0.1), mpfr(2.5)]
+    assert from_numpy(np.array([1.5, -2.5]), mpz) == [1, -2]
+    assert from_numpy(np.float32([0.1]), mpq) == [mpq(13421773, 134217728)]
+    assert from_numpy(np.uint8([255]), mpc) == [mpc(255)]
+    assert from_numpy(np.arange(6).reshape(2, 3)[:, ::2]) == [[0, 2], [3, 5]]
+    assert from_numpy(array.array('H', [1, 2])) == [1, 2]
+
+    nan, inf = float('nan'), float('inf')
+    res = from_numpy(np.array([1.5, nan, inf, -inf]))
+    assert res[0] == 1.5 and res[1].is_nan() and res[2] == inf
+    assert res[3] == -inf
+    res = from_numpy(np.array([nan, 1.0, inf, 2.0]))
+    assert res[0].is_nan() and res[1:] == [1, inf, 2]
+    assert all(x.precision == 53 for x in res)
+    assert len(set(map(id, res))) == 4
+    with gmpy2.context(precision=64):
+        for dtype in ('float32', 'float64', 'longdouble'):
+            res = from_numpy(np.array([1.0, 2.0, 3.0], dtype=dtype))
+            assert res == [1, 2, 3]
+            assert len(set(map(id, res))) == 3
+
+    res = from_numpy(np.array([1, Fraction(1, 3), 2.5, 1j], dtype=object))
+    assert [type(x) for x in res] == [mpz, mpq, mpfr, mpc]
+
+    pytest.raises(ValueError, lambda: from_numpy(np.array([float('nan')]), mpz))
+    pytest.raises(TypeError, lambda: from_numpy(np.array([1]), int))
+    pytest.raises(TypeError, lambda: from_numpy(np.array([1j])))
+    pytest.raises(TypeError, lambda: from_numpy(1))
+
+
+def test_to_numpy():
+    np = pytest.importorskip('numpy')
+
+    r = to_numpy([mpz(1), 2, 3])
+    assert r.dtype == np.int64 and r.tolist() == [1, 2, 3]
+    r = to_numpy([mpz(1), mpfr(2.5), mpq(1, 4)])
+    assert r.dtype == np.float64 and r.tolist() == [1.0, 2.5, 0.25]
+    r = to_numpy([mpz(2**70), mpc(1)])
+    assert r.dtype == object and r[0] == 2**70
+    assert to_numpy([255, 0], 'uint8').tolist() == [255, 0]
+    assert to_numpy([-128], np.int8).tolist() == [-128]
+    assert to_numpy([mpfr('0.1')], 'float32')[0] == np.float32(0.1)
+
+    x = np.random.default_rng(1).random(100)
+    assert (to_numpy(from_numpy(x)) == x).all()
+
+    pytest.raises(OverflowError, lambda: to_numpy([128], 'int8'))
+    pytest.raises(OverflowError, lambda: to_numpy([-1], 'uint64'))
+    with pytest.raises(OverflowError, match='negative value for unsigned'):
+        to_numpy([mpz(-1)], 'uint8')
+    with pytest.raises(OverflowError, match='too large'):
+        to_numpy([2**70], 'uint8')
+    pytest.raises(TypeError, lambda: to_numpy([1.5], 'int64'))
+    pytest.raises(TypeError, lambda: to_numpy([1j], 'float64'))
+    pytest.raises(TypeError, lambda: to_numpy([1], 'complex128'))
+
+
 def test_fac():
     pytest.raises(OverflowError, lambda: fac(-7))
     pytest.raises(TypeError, lambda: fac('a'))
@@ -1,4 +1,10 @@
+import gc
 import sys
+import threading
+import time
+import tracemalloc
+
+import pytest
 
 import gmpy2
 
@@ -20,3 +26,194 @@ def test_misc():
 def test_sizeof():
     assert sys.getsizeof(gmpy2.mpz(10)) > 0
     assert sys.getsizeof(gmpy2.mpfr('1.0')) > 0
+
+
+def test_progress():
+    assert gmpy2.progress() is None
+    assert gmpy2.fac(10) == 3628800
+    assert gmpy2.progress() is None
+
+    seen = []
+    x = list(range(2*10**6))
+    t = threading.Thread(target=gmpy2.f_div_many, args=(x, 7))
+    t.start()
+    while t.is_alive():
+        p = gmpy2.progress()
+        if p:
+            seen.append(p)
+        time.sleep(0.001)
+    t.join()
+    assert gmpy2.progress() is None
+    for stage, done, total in seen:
+        assert stage == 'f_div_many'
+        assert 0 <= done <= total == len(x)
+    assert [p[1] for p in seen] == sorted(p[1] for p in seen)
+
+    # Each thread has its own record.
+    seen = []
+    t = threading.Thread(target=gmpy2.f_div_many, args=(x, 7))
+    t.start()
+    while t.is_alive():
+        p = gmpy2.progress(t.ident)
+        if p:
+            seen.append(p)
+            assert gmpy2.progress(threading.get_ident()) is None
+            q = gmpy2.progress(None)
+            assert q is None or q[0] == 'f_div_many'
+        time.sleep(0.001)
+    t.join()
+    assert gmpy2.progress(t.ident) is None
+    assert all(p[0] == 'f_div_many' for p in seen)
+    pytest.raises(TypeError, lambda: gmpy2.progress(1, 2))
+    pytest.raises(TypeError, lambda: gmpy2.progress('a'))
+
+
+def test_lazy_attributes():
+    for name in ('DivisionByZeroError', 'InexactResultError',
+                 'InvalidOperationError', 'OverflowResultError',
+                 'UnderflowResultError', 'RangeError', 'divisor', 'ec_curve',
+                 'ec_point', 'mmap_xmpz', 'mpfr_array', 'powmod_state',
+                 'qform', 'rns'):
+        assert name in dir(gmpy2)
+        assert getattr(gmpy2, name) is getattr(gmpy2, name)
+    assert issubclass(gmpy2.DivisionByZeroError, ZeroDivisionError)
+    try:
+        gmpy2.no_such_name
+    except AttributeError:
+        pass
+    else:
+        raise AssertionError
+    namespace = {}
+    exec('from gmpy2 import *', namespace)
+    for name in ('DivisionByZeroError', 'InexactResultError',
+                 'InvalidOperationError', 'OverflowResultError',
+                 'UnderflowResultError', 'RangeError', 'mpz', 'rns', 'qform'):
+        assert namespace[name] is getattr(gmpy2, name)
+    assert not any(name.startswith('_') for name in namespace
+                   if name != '__builtins__')
+
+
+def test_subinterpreters():
+    # The types, caches and context variables are shared by the whole
+    # process, so only the main interpreter can import gmpy2.
+    code = 'import gmpy2'
+    try:
+        import _interpreters
+    except ImportError:
+        _interpreters = None
+    if _interpreters:
+        for kind in ('legacy', 'isolated'):
+            config = _interpreters.new_config(kind)
+            config.gil = 'shared'
+            interp = _interpreters.create(config)
+            try:
+                err = _interpreters.exec(interp, code)
+            finally:
+                _interpreters.destroy(interp)
+            assert 'subinterpreters' in err.msg
+    else:
+        try:
+            import _xxsubinterpreters as interpreters
+        except ImportError:
+            pytest.skip("no subinterpreter support")
+        for isolated in (False, True):
+            interp = interpreters.create(isolated=isolated)
+            try:
+                with pytest.raises(interpreters.RunFailedError,
+                                   match='subinterpreters'):
+                    interpreters.run_string(interp, code)
+            finally:
+                interpreters.destroy(interp)
+    with gmpy2.context(precision=200):
+        assert gmpy2.get_context().precision == 200
+    assert gmpy2.get_context().precision == 53
+    assert gmpy2.mpz(3)**2 == 9
+
+
+def test_threads():
+    x = gmpy2.xmpz(0)
+    ctx = gmpy2.context()
+
+    def work():
+        nonlocal x
+        for i in range(2000):
+            x += 1
+            x[200] = i & 1
+            y = gmpy2.mpz(i) * i + gmpy2.mpq(1, 3)
+            assert y.denominator == 3
+            ctx.trap_inexact = bool(i & 1)
+
+    threads = [threading.Thread(target=work) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert x & ((1 << 200) - 1) == 8000
+
+
+def test_threads_release_gil():
+    # Long operations detach the thread state, xmpz inplace operations on a
+    # shared object must not.  Run both while another thread collects
+    # garbage, which needs every other thread to be detached or waiting.
+    big = gmpy2.mpz(3)**20000
+    m = gmpy2.next_prime(gmpy2.mpz(2)**2000)
+    x = gmpy2.xmpz(0)
+    stop = threading.Event()
+    errors = []
+
+    def work(seed):
+        nonlocal x
+        try:
+            with gmpy2.context(allow_release_gil=True):
+                for i in range(50):
+                    y = big * (seed + i)
+                    assert y // big == seed + i
+                    assert gmpy2.powmod(seed + 2, m - 1, m) == 1
+                    x += big
+                    x -= big
+                    x += 1
+        except BaseException as exc:
+            errors.append(exc)
+
+    def collect():
+        while not stop.is_set():
+            gc.collect()
+
+    collector = threading.Thread(target=collect)
+    collector.start()
+    threads = [threading.Thread(target=work, args=(k,)) for k in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    stop.set()
+    collector.join()
+    assert not errors
+    assert x == 200
+
+
+def test_thread_caches():
+    # In free-threaded builds each thread has its own object caches, which
+    # must be emptied when the thread exits.
+    def work():
+        x = [gmpy2.mpz(i) for i in range(200)]
+        y = [gmpy2.mpfr(i) for i in range(200)]
+        z = [gmpy2.mpq(i, 7) for i in range(200)]
+        del x, y, z
+
+    def run(n):
+        for _ in range(n):
+            t = threading.Thread(target=work)
+            t.start()
+            t.join()
+
+    run(2)
+    tracemalloc.start()
+    try:
+        before = tracemalloc.get_traced_memory()[0]
+        run(50)
+        gc.collect()
+        after = tracemalloc.get_traced_memory()[0]
+    finally:
+        tracemalloc.stop()
+    assert after - before < 100000
@@ -116,6 +116,30 @@ def test_mpfr_conversion():
     assert str(float('5.656')) == '5.656'
 
 
+def test_mpfr_from_Decimal():
+    assert mpfr(Decimal('0.1')) == mpfr('0.1')
+    assert mpfr(Decimal('-1.5E-3'), 100) == mpfr('-1.5e-3', 100)
+    assert mpfr(Decimal('1E+400000000')) == mpfr('inf')
+    assert mpfr(Decimal('1E-400000000')) == 0
+    assert str(mpfr(Decimal('-0'))) == '-0.0'
+    assert is_nan(mpfr(Decimal('nan')))
+    assert mpfr(Decimal('-inf')) == mpfr('-inf')
+    assert mpc(Decimal('2.5')) == mpc(2.5)
+    assert mpc(1, Decimal('0.5')) == mpc(1, 0.5)
+    # Mixed arithmetic would round the Decimal to the context precision.
+    pytest.raises(TypeError, lambda: mpz(1) + Decimal('0.5'))
+    pytest.raises(TypeError, lambda: mpfr(1) * Decimal('2.5'))
+    pytest.raises(TypeError, lambda: Decimal('2.5') - mpfr(1))
+    pytest.raises(TypeError, lambda: mpc(1) + Decimal('0.5'))
+    pytest.raises(TypeError, lambda: gmpy2.sqrt(Decimal(2)))
+
+    with gmpy2.rounding(gmpy2.RoundDown):
+        x = mpfr(Decimal('0.1'))
+    with gmpy2.rounding(gmpy2.RoundUp):
+        y = mpfr(Decimal('0.1'))
+    assert x < y
+
+
 def test_mpfr_create():
     assert mpfr() == mpfr('0.0')
     assert mpfr(0) == mpfr('0.0')
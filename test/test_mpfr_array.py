@@ -0,0 +1,186 @@
+import pytest
+
+import gmpy2
+from gmpy2 import mpfr, mpfr_array, mpq, mpz
+
+
+def test_mpfr_array_init():
+    a = mpfr_array(3)
+    assert len(a) == 3
+    assert a.precision == gmpy2.get_context().precision
+    assert a.tolist() == [0, 0, 0]
+    assert mpfr_array(2, 100).precision == 100
+    assert mpfr_array(0).tolist() == []
+
+    a = mpfr_array([1, 2.5, mpz(3), mpq(1, 4), mpfr('1.5')], 10)
+    assert a.tolist() == [1, 2.5, 3, 0.25, 1.5]
+    assert all(isinstance(x, mpfr) and x.precision == 10 for x in a)
+    assert mpfr_array(range(4)).tolist() == [0, 1, 2, 3]
+    assert mpfr_array([mpq(1, 3)], 20)[0] == mpfr(mpq(1, 3), 20)
+    assert repr(mpfr_array([1, 2], 53)) == "mpfr_array([mpfr('1.0'), mpfr('2.0')], 53)"
+
+    with gmpy2.precision(30):
+        assert mpfr_array(1).precision == 30
+
+    pytest.raises(ValueError, lambda: mpfr_array(-1))
+    pytest.raises(ValueError, lambda: mpfr_array(1, -5))
+    pytest.raises(TypeError, lambda: mpfr_array(['a']))
+    pytest.raises(TypeError, lambda: mpfr_array(1.5))
+    pytest.raises(TypeError, lambda: hash(mpfr_array(1)))
+
+
+def test_mpfr_array_index():
+    a = mpfr_array(range(6))
+    assert a[0] == 0 and a[-1] == 5
+    pytest.raises(IndexError, lambda: a[6])
+    pytest.raises(IndexError, lambda: a[-7])
+    pytest.raises(TypeError, lambda: a['x'])
+
+    v = a[1:5]
+    assert v.tolist() == [1, 2, 3, 4]
+    assert a[::-2].tolist() == [5, 3, 1]
+    assert v[::-1][1:3].tolist() == [3, 2]
+    assert a[4:1].tolist() == []
+
+    v[0] = 10
+    assert a[1] == 10
+    a[-1] = mpq(1, 2)
+    assert a[5] == 0.5
+    a[::2] = 7
+    assert a.tolist() == [7, 10, 7, 3, 7, 0.5]
+    a[:3] = [1, 2, 3]
+    assert a.tolist() == [1, 2, 3, 3, 7, 0.5]
+
+    with pytest.raises(ValueError):
+        a[:2] = [1, 2, 3]
+    with pytest.raises(TypeError):
+        a[0] = 'x'
+    with pytest.raises(TypeError):
+        del a[0]
+
+    c = a.copy()
+    c[0] = 100
+    assert a[0] == 1
+
+
+def test_mpfr_array_overlap():
+    a = mpfr_array(range(6))
+    a[1:] = a[:-1]
+    assert a.tolist() == [0, 0, 1, 2, 3, 4]
+
+    a = mpfr_array(range(6))
+    a[:] = a[::-1]
+    assert a.tolist() == [5, 4, 3, 2, 1, 0]
+
+    a = mpfr_array(range(6))
+    v = a[:3]
+    v += a[3:]
+    assert a.tolist() == [3, 5, 7, 3, 4, 5]
+
+    a = mpfr_array(range(4))
+    a += a
+    assert a.tolist() == [0, 2, 4, 6]
+
+
+def test_mpfr_array_arithmetic():
+    a = mpfr_array([1, 2, 3, 4])
+    b = mpfr_array([4, 3, 2, 1], 100)
+    assert (a + b).tolist() == [5, 5, 5, 5]
+    assert (a + b).precision == 100
+    assert (a - b).tolist() == [-3, -1, 1, 3]
+    assert (a * b).tolist() == [4, 6, 6, 4]
+    with gmpy2.precision(100):
+        assert (a / b).tolist() == [mpfr(1) / 4, mpfr(2) / 3, 1.5, 4]
+    assert (a + 1).tolist() == [2, 3, 4, 5]
+    assert (1 - a).tolist() == [0, -1, -2, -3]
+    assert (2 * a).tolist() == [2, 4, 6, 8]
+    assert (mpq(1, 2) * a).tolist() == [0.5, 1, 1.5, 2]
+    assert (12 / a).tolist() == [12, 6, 4, 3]
+    assert (a / 0).tolist() == [mpfr('inf')] * 4
+    assert (-a).tolist() == [-1, -2, -3, -4]
+    assert abs(-a).tolist() == a.tolist()
+
+    c = a
+    c *= 2.5
+    assert c is a
+    assert a.tolist() == [2.5, 5, 7.5, 10]
+    a /= mpfr_array([5, 5, 5, 5])
+    assert a.tolist() == [0.5, 1, 1.5, 2]
+    a -= 0.5
+    assert a.precision == 53
+
+    pytest.raises(ValueError, lambda: a + mpfr_array(3))
+    pytest.raises(TypeError, lambda: a + 'x')
+    pytest.raises(TypeError, lambda: a + 1j)
+
+    x = mpfr_array([1, 3], 100)
+    with gmpy2.rounding(gmpy2.RoundUp):
+        y = 1 / x
+    with gmpy2.rounding(gmpy2.RoundDown):
+        z = 1 / x
+    assert y[1] > z[1]
+    assert y[0] == z[0]
+
+
+def test_mpfr_array_context():
+    a = mpfr_array([1e300, 2])
+    with gmpy2.context(emax=1000):
+        b = a * a
+        assert gmpy2.get_context().overflow
+    assert gmpy2.is_infinite(b[0]) and b[1] == 4
+
+    with gmpy2.context(emax=1000, trap_overflow=True):
+        pytest.raises(gmpy2.OverflowResultError, lambda: a * a)
+
+    with gmpy2.context(trap_inexact=True):
+        assert (a * 2).tolist() == [2e300, 4]
+        pytest.raises(gmpy2.InexactResultError, lambda: a + 1)
+    with gmpy2.context(trap_inexact=False):
+        gmpy2.get_context().clear_flags()
+        mpfr_array([1, 3]) / 3
+        assert gmpy2.get_context().inexact
+
+    with gmpy2.context(emin=-20, subnormalize=True, precision=10):
+        values = [mpfr('1.1', 10), mpfr('0.75', 10), mpfr('1.3', 10)]
+        x = mpfr_array(values) * mpfr(2)**-15
+        assert x.tolist() == [v * mpfr(2)**-15 for v in values]
+    with gmpy2.context(emin=-20, precision=10):
+        y = mpfr_array(values) * mpfr(2)**-15
+    assert x[0] != y[0]
+
+def test_mpfr_array_apply():
+    a = mpfr_array([0.5, 1, 2], 80)
+    for name in ['sin', 'cos', 'exp', 'log', 'sqrt', 'atan', 'gamma',
+                 'zeta', 'erf', 'j0', 'cbrt', 'log1p', 'li2', 'ai']:
+        func = getattr(gmpy2, name)
+        with gmpy2.precision(80):
+            expected = [func(x) for x in a]
+        assert a.apply(name).tolist() == expected
+        assert a.apply(func).tolist() == expected
+    assert a.apply('square').tolist() == [0.25, 1, 4]
+    assert a.apply('floor').tolist() == [0, 1, 2]
+    assert a.apply('ceil').tolist() == [1, 1, 2]
+    assert mpfr_array([-2.5, 2.5]).apply('round_away').tolist() == [-3, 3]
+    assert mpfr_array([-2.5, 2.5]).apply('trunc').tolist() == [-2, 2]
+    assert gmpy2.is_nan(mpfr_array([-1]).apply('sqrt')[0])
+
+    pytest.raises(ValueError, lambda: a.apply('sin_cos'))
+    pytest.raises(ValueError, lambda: a.apply(len))
+    pytest.raises(TypeError, lambda: a.apply(1))
+
+
+def test_mpfr_array_reductions():
+    a = mpfr_array([1e20, 1, -1e20, 2])
+    assert a.sum() == 3
+    assert mpfr_array(0).sum() == 0
+    b = mpfr_array([1, 2, 3, 4])
+    assert b.dot(b) == 30
+    assert a.dot(b) == 1e20 + 2 - 3e20 + 8
+    assert mpfr_array([3, 4]).norm() == 5
+    with gmpy2.precision(200):
+        assert mpfr_array([1, 1]).norm() == gmpy2.sqrt(2)
+        assert mpfr_array([1, 1]).norm().precision == 200
+    assert b[::-1].dot(b) == 20
+
+    pytest.raises(TypeError, lambda: b.dot([1, 2, 3, 4]))
+    pytest.raises(ValueError, lambda: b.dot(mpfr_array(3)))
@@ -43,6 +43,11 @@ def test_mpq_from_Decimal():
     assert mpq(Decimal(1)) == mpq(1)  # issue 327
     assert mpq(Decimal('0.6')) == mpq(3, 5)
     assert mpq.from_decimal(Decimal("5e-3")) == mpq(5, 1000)
+    assert mpq(Decimal('-1.25E+5')) == mpq(-125000)
+    assert mpq(Decimal('-0.000')) == 0
+    pytest.raises(TypeError, lambda: mpq(1, 3) + Decimal('0.5'))
+    pytest.raises(ValueError, lambda: mpq(Decimal('nan')))
+    pytest.raises(OverflowError, lambda: mpq(Decimal('inf')))
 
 
 def test_mpq_cmp():
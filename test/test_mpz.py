@@ -1,11 +1,12 @@
 import math
 import numbers
 import pickle
+from decimal import Decimal
 from fractions import Fraction
 
 from hypothesis import assume, example, given, settings
 from hypothesis.strategies import booleans, integers, sampled_from
-from pytest import mark, raises
+from pytest import importorskip, mark, raises
 from supportclasses import a, b, c, d, q, z
 
 import gmpy2
@@ -325,6 +326,33 @@ def test_mpz_conversion():
     assert int(mpz(11)) is int(mpz(11))
 
 
+def test_mpz_from_Decimal():
+    assert mpz(Decimal('123.9')) == 123
+    assert mpz(Decimal('-123.9')) == -123
+    assert mpz(Decimal('-1E+30')) == -10**30
+    assert mpz(Decimal('9E-100')) == 0
+    raises(ValueError, lambda: mpz(Decimal('nan')))
+    raises(OverflowError, lambda: mpz(Decimal('-inf')))
+
+
+def test_mpz_from_numpy():
+    np = importorskip('numpy')
+
+    for t in [np.int8, np.int16, np.int32, np.int64]:
+        info = np.iinfo(t)
+        assert mpz(t(info.min)) == int(info.min)
+        assert mpz(t(info.max)) == int(info.max)
+    for t in [np.uint8, np.uint16, np.uint32, np.uint64]:
+        assert mpz(t(np.iinfo(t).max)) == int(np.iinfo(t).max)
+    assert mpz(5) + np.int64(-7) == -2
+    assert is_prime(np.uint64(2**61 - 1))
+    assert mpq(np.int16(-3)) == -3
+    assert mpq(np.float32(0.1)) == mpq(13421773, 134217728)
+    x = np.longdouble(1) / 3
+    assert mpq(x) == mpq(*x.as_integer_ratio())
+    assert mpfr(x, 1).precision == np.finfo(np.longdouble).nmant + 1
+
+
 def test_mpz_create():
     assert mpz() == mpz(0)
     assert mpz(0) == mpz(0)
@@ -0,0 +1,153 @@
+import pytest
+from hypothesis import given, settings
+from hypothesis.strategies import integers
+
+import gmpy2
+from gmpy2 import gcdext, mpz, next_prime, powmod, qform
+
+
+def reduce(a, b, c):
+    def normalize(a, b, c):
+        r = (a - b) // (2*a)
+        return a, b + 2*a*r, c + r*(b + a*r)
+    a, b, c = normalize(a, b, c)
+    while a > c or (a == c and b < 0):
+        a, b, c = normalize(c, -b, a)
+    return a, b, c
+
+
+def compose(f, g):
+    # Dirichlet composition, see Cohen, Algorithm 5.4.7.
+    (a1, b1, c1), (a2, b2, c2) = f, g
+    D = b1*b1 - 4*a1*c1
+    s = (b1 + b2) // 2
+    d0, u0, v0 = gcdext(a1, a2)
+    d, x, y = gcdext(d0, s)
+    a3 = a1*a2 // (d*d)
+    b3 = (b2 + 2*(a2//d)*(x*v0*(s - b2) - y*c2)) % (2*a3)
+    return reduce(a3, b3, (b3*b3 - D) // (4*a3))
+
+
+def coeffs(f):
+    return (f.a, f.b, f.c)
+
+
+def prime_form(D, p):
+    # The form (p, b, c) of discriminant D, for a prime p = 3 mod 4 with
+    # (D/p) = 1.
+    b = powmod(D, (p + 1)//4, p)
+    if (b - D) % 2:
+        b = p - b
+    return qform(p, b, (b*b - D) // (4*p))
+
+
+def generator(D, start=1000):
+    p = next_prime(start)
+    while p % 4 != 3 or gmpy2.jacobi(D, p) != 1:
+        p = next_prime(p)
+    return prime_form(D, p)
+
+
+def test_qform_init():
+    f = qform(2, 1, 3)
+    assert (f.a, f.b, f.c) == (2, 1, 3)
+    assert all(isinstance(x, mpz) for x in coeffs(f))
+    assert f.discriminant == -23
+    assert repr(f) == 'qform(2, 1, 3)'
+    assert qform(mpz(5), gmpy2.xmpz(-7), 4).discriminant == -31
+
+    pytest.raises(TypeError, lambda: qform(1, 2))
+    pytest.raises(TypeError, lambda: qform(1.0, 1, 3))
+    pytest.raises(ValueError, lambda: qform(-2, 1, -3))
+    pytest.raises(ValueError, lambda: qform(1, 2, 1))
+    pytest.raises(ValueError, lambda: qform(1, 3, 1))
+
+
+def test_qform_reduce():
+    f = qform(2, 1, 3)
+    assert f.is_reduced()
+    assert f.reduce() == f
+    g = qform(3, -1, 2)
+    assert not g.is_reduced()
+    assert g.reduce() == qform(2, 1, 3)
+    assert not qform(2, -2, 3).is_reduced()
+    assert not qform(3, -1, 3).is_reduced()
+    assert qform(3, 1, 3).is_reduced()
+    h = qform(58, -21, 2)
+    assert h.discriminant == -23
+    assert h.reduce() == qform(2, 1, 3)
+
+
+def test_qform_compose():
+    D = -(mpz(2)**257 + 0x1234567)*4 + 1
+    f = generator(D)
+    g = generator(D, 5000)
+    assert f.is_reduced() and g.is_reduced()
+    h = f
+    for i in range(20):
+        assert coeffs(h * g) == compose(coeffs(h), coeffs(g))
+        assert coeffs(g * h) == coeffs(h * g)
+        assert coeffs(h * h) == compose(coeffs(h), coeffs(h))
+        h = h * f
+    one = f ** 0
+    assert coeffs(one) == (1, 1, (1 - D) // 4)
+    assert f * one == f
+    assert f * f ** -1 == one
+    assert f ** -3 * f ** 3 == one
+    assert qform(3, -1, 2) * qform(2, 1, 3) == qform(2, 1, 3) ** 2
+
+    pytest.raises(ValueError, lambda: f * qform(2, 1, 3))
+    pytest.raises(TypeError, lambda: f * 2)
+    pytest.raises(TypeError, lambda: f + f)
+
+
+def test_qform_pow():
+    D = -4 * (mpz(2)**200 + 235)
+    f = generator(D)
+    for e in [1, 2, 3, 17, 2**20 + 5, 3**200, 2**2000 + 1]:
+        expected = coeffs(f ** 0)
+        x, n = coeffs(f), e
+        while n:
+            if n & 1:
+                expected = compose(expected, x)
+            x = compose(x, x)
+            n >>= 1
+        assert coeffs(f ** e) == expected
+        assert coeffs(f ** mpz(e)) == expected
+        assert f ** -e * f ** e == f ** 0
+    e = mpz(-5)
+    assert f ** e == (f ** 5) ** -1
+    assert e == -5
+    assert f ** 1 == f
+
+    pytest.raises(TypeError, lambda: pow(f, 2, 5))
+    pytest.raises(TypeError, lambda: f ** 1.5)
+
+
+def test_qform_class_number():
+    # h(-23) = 3 and h(-4*5923) = 168.
+    f = qform(2, 1, 3)
+    assert f ** 3 == f ** 0 and f != f ** 0
+    g = generator(-4*5923, 3)
+    assert (g ** 168) == g ** 0
+
+
+def test_qform_hash():
+    f = qform(2, 1, 3)
+    assert hash(f) == hash(qform(2, 1, 3))
+    assert f == qform(2, 1, 3) and f != qform(2, -1, 3)
+    assert len({f, f ** 2, f ** 3, f ** 4}) == 3
+    assert (f == 1) is False
+
+
+@settings(max_examples=50)
+@given(integers(min_value=1, max_value=2**300), integers(min_value=-2**70,
+       max_value=2**70))
+def test_qform_hypothesis(n, e):
+    D = -4*n - 3
+    f = generator(D)
+    g = f ** 12345
+    assert coeffs(f * g) == compose(coeffs(f), coeffs(g))
+    assert f ** e * f ** -e == f ** 0
+    assert (f ** e).is_reduced()
+    assert (f ** e).discriminant == D
@@ -0,0 +1,66 @@
+import pytest
+from hypothesis import given
+from hypothesis.strategies import integers, lists
+
+from gmpy2 import mpz, rns, xmpz
+
+MODULI = [2**61 - 1, 2**62 - 57, 1000003, 3, 2]
+MODULUS = (2**61 - 1) * (2**62 - 57) * 1000003 * 3 * 2
+
+
+def test_rns_init():
+    x = rns([1, -1, mpz(2**130), xmpz(5)], MODULI)
+    assert len(x) == 4
+    assert x.moduli == tuple(map(mpz, MODULI))
+    assert x.modulus == MODULUS
+    assert x.to_list() == [1, MODULUS - 1, 2**130 % MODULUS, 5]
+    assert list(x) == x.to_list()
+    assert x[-1] == 5
+    assert isinstance(x[0], mpz)
+    assert repr(rns([1, 2], [5, 7])) == 'rns([mpz(1), mpz(2)], (mpz(5), mpz(7)))'
+    assert len(rns([], [3])) == 0
+
+    y = rns([4, 5], x)
+    assert y.moduli == x.moduli
+
+    pytest.raises(IndexError, lambda: x[4])
+    pytest.raises(TypeError, lambda: rns([1.5], MODULI))
+    pytest.raises(TypeError, lambda: rns(1, MODULI))
+    pytest.raises(TypeError, lambda: rns([1], ['a']))
+    pytest.raises(TypeError, lambda: rns([1], 5))
+    pytest.raises(ValueError, lambda: rns([1], []))
+    pytest.raises(ValueError, lambda: rns([1], [1]))
+    pytest.raises(ValueError, lambda: rns([1], [2**62]))
+    pytest.raises(ValueError, lambda: rns([1], [6, 35, 77]))
+
+
+def test_rns_arithmetic():
+    x = rns([1, 2, 3], MODULI)
+    y = rns([4, 5, 6], x)
+    assert (x + y).to_list() == [5, 7, 9]
+    assert (x - y).to_list() == [MODULUS - 3] * 3
+    assert (x * y).to_list() == [4, 10, 18]
+    assert (-x).to_list() == [MODULUS - 1, MODULUS - 2, MODULUS - 3]
+    assert (x * 2 + 1).to_list() == [3, 5, 7]
+    assert (10 - x).to_list() == [9, 8, 7]
+    assert (3 * x).to_list() == [3, 6, 9]
+    assert x.fma(y, 1).to_list() == [5, 11, 19]
+    assert x.fma(-1, y).to_list() == [3, 3, 3]
+    assert x * y == rns([4, 10, 18], MODULI)
+    assert x != y
+    assert x != rns([1, 2, 3], [5, 7])
+
+    pytest.raises(ValueError, lambda: x + rns([1, 2], x))
+    pytest.raises(ValueError, lambda: x + rns([1, 2, 3], [5, 7]))
+    pytest.raises(TypeError, lambda: x + 1.5)
+    pytest.raises(TypeError, lambda: x.fma(y))
+    pytest.raises(TypeError, lambda: x.fma(y, 'a'))
+
+
+@given(lists(integers(), min_size=1, max_size=20), integers(), integers())
+def test_rns_arithmetic_bulk(values, a, b):
+    x = rns(values, MODULI)
+    assert x.to_list() == [v % MODULUS for v in values]
+    assert (x * a + b).to_list() == [(v*a + b) % MODULUS for v in values]
+    assert x.fma(x, b).to_list() == [(v*v + b) % MODULUS for v in values]
+    assert (x - a).to_list() == [(v - a) % MODULUS for v in values]
@@ -137,6 +137,36 @@ def test_xmpz_subscripts():
     assert x == xmpz(16)
 
 
+
+def _bits_ref(x, positions):
+    return sum(((x >> p) & 1) << i for i, p in enumerate(positions))
+
+
+@settings(max_examples=1000)
+@given(integers(), integers(-300, 700), integers(-300, 700),
+       integers(-70, 70).filter(bool))
+@example(-2**200, 64, 192, 1)
+@example(-2**200 - 1, 3, 250, -3)
+@example(2**130 - 1, 1, None, 65)
+def test_xmpz_slices(x, start, stop, step):
+    s = slice(start, stop, step)
+    n = max(abs(x).bit_length(), 1)
+
+    expected = _bits_ref(x, range(*s.indices(n)))
+    assert mpz(x)[s] == expected
+    assert xmpz(x)[s] == expected
+
+    if stop is not None and stop > n:
+        n = stop
+    positions = range(*s.indices(n))
+    for v in (0, -1, 0x5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a, -12345):
+        y = xmpz(x)
+        y[s] = v
+        z = x
+        for i, p in enumerate(positions):
+            z = z | (1 << p) if (v >> i) & 1 else z & ~(1 << p)
+        assert y == z
+
 def test_xmpz_iterators():
     x = xmpz(16)
 
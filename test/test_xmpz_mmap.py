@@ -0,0 +1,68 @@
+import random
+
+import pytest
+
+from gmpy2 import mmap_xmpz, mpz, xmpz
+
+
+SIZES = [0, 1, 64, 65, 1000, 20000]
+
+
+def test_mmap_xmpz_init(tmp_path):
+    path = tmp_path / 'x.dat'
+    x = mmap_xmpz(path, 12345)
+    assert repr(x) == 'mmap_xmpz(%r)' % path
+    assert x.to_mpz() == 12345
+    assert isinstance(x.to_mpz(), mpz)
+    assert x.bit_length() == 14
+    x.set(xmpz(-2)**300)
+    x.flush()
+    x.close()
+    x.close()
+    pytest.raises(ValueError, lambda: x.to_mpz())
+    pytest.raises(ValueError, lambda: x.add(1))
+
+    y = mmap_xmpz(path)
+    assert y.to_mpz() == 2**300
+    assert mmap_xmpz(tmp_path / 'z.dat', 0).to_mpz() == 0
+
+    pytest.raises(FileNotFoundError, lambda: mmap_xmpz(tmp_path / 'none'))
+    (tmp_path / 'empty').write_bytes(b'')
+    pytest.raises(ValueError, lambda: mmap_xmpz(tmp_path / 'empty'))
+    (tmp_path / 'bad').write_bytes(b'x' * 100)
+    pytest.raises(ValueError, lambda: mmap_xmpz(tmp_path / 'bad'))
+    pytest.raises(TypeError, lambda: mmap_xmpz(path, 1.5))
+    pytest.raises(TypeError, lambda: y.add(1.5))
+    pytest.raises(TypeError, lambda: y.set('a'))
+    pytest.raises(ValueError, lambda: y.mul(y, 2))
+    pytest.raises(ValueError, lambda: y.mul(2, 3, memory=0))
+
+
+def test_mmap_xmpz_arith(tmp_path):
+    r = random.Random(1)
+    x = mmap_xmpz(tmp_path / 'x.dat', 0)
+    y = mmap_xmpz(tmp_path / 'y.dat', 0)
+    z = mmap_xmpz(tmp_path / 'z.dat', 0)
+    for _ in range(100):
+        a = r.getrandbits(r.choice(SIZES)) * r.choice([1, -1])
+        b = r.getrandbits(r.choice(SIZES)) * r.choice([1, -1])
+        x.set(a)
+        x.add(b)
+        assert x.to_mpz() == a + b
+        x.set(a)
+        y.set(b)
+        x.add(y)
+        assert x.to_mpz() == a + b
+        x.add(x)
+        assert x.to_mpz() == 2*(a + b)
+        x.set(b)
+        x.add(-b)
+        assert x.to_mpz() == 0
+        z.mul(a, b)
+        assert z.to_mpz() == a*b
+        x.set(a)
+        z.mul(x, y, memory=1024)
+        assert z.to_mpz() == a*b
+        z.mul(y, y, memory=700)
+        assert z.to_mpz() == b*b
+        assert z.bit_length() == (b*b).bit_length()
@@ -8,22 +8,6 @@ cdef extern from "Python.h":
 
     long Py_REFCNT(PyObject *)
 
-cdef extern from "gmp.h":
-    void mpz_init (mpz_t integer)
-    void mpz_clear (mpz_t integer)
-
-    void mpq_init (mpq_t dest_rational)
-    void mpq_clear (mpq_t rational_number)
-
-    void mpz_set_si(mpz_t, long)
-    void mpq_set_si(mpq_t, long, long)
-
-cdef extern from "mpfr.h":
-    void mpfr_init2 (mpfr_t x, mpfr_prec_t prec)
-    void mpfr_clear (mpfr_t x)
-
-    int mpfr_set_si (mpfr_t rop, long int op, mpfr_rnd_t rnd)
-
 cdef extern from "mpc.h":
     void mpc_init2 (mpc_ptr x, mpfr_prec_t rnd);
     void mpc_clear (mpc_ptr x)
@@ -86,6 +70,61 @@ def test_mpz():
     z = x + y + 1
     assert z == z and z == 6 and 6 == z
 
+def test_mpz_inline():
+    cdef mpz x = GMPy_MPZ_New(NULL)
+    cdef mpz y = GMPy_MPZ_New(NULL)
+    cdef mpz m = GMPy_MPZ_New(NULL)
+
+    mpz_set_si(x.z, -17)
+    mpz_set_si(y.z, 5)
+    mpz_set_si(m.z, 101)
+
+    cdef mpz z = GMPy_MPZ_Add(x, y)
+
+    # Check that the refcount is correct
+    assert Py_REFCNT(<PyObject *> z) == 1
+
+    assert z == -12
+    assert GMPy_MPZ_Sub(x, y) == -22
+    assert GMPy_MPZ_Mul(x, y) == -85
+    assert GMPy_MPZ_FloorDiv(x, y) == -17 // 5
+    assert GMPy_MPZ_Mod(x, y) == -17 % 5
+    assert GMPy_MPZ_Neg(x) == 17
+    assert GMPy_MPZ_Pow(y, 30) == 5**30
+    assert GMPy_MPZ_PowMod(x, y, m) == pow(-17, 5, 101)
+    assert GMPy_MPZ_PowMod(x, GMPy_MPZ_Neg(y), m) == pow(-17, -5, 101)
+    assert y == 5
+
+    mpz_set_si(m.z, 0)
+    try:
+        GMPy_MPZ_FloorDiv(x, m)
+    except ZeroDivisionError:
+        pass
+    else:
+        assert False
+
+def test_mpz_nogil():
+    cdef mpz_t a, b
+    mpz_init(a)
+    mpz_init(b)
+    with nogil:
+        mpz_set_ui(a, 3)
+        mpz_pow_ui(b, a, 100)
+        mpz_add_ui(b, b, 1)
+        mpz_fdiv_q_2exp(b, b, 1)
+    cdef mpz r = GMPy_MPZ_From_mpz(b)
+    mpz_clear(a)
+    mpz_clear(b)
+
+    assert r == (3**100 + 1) // 2
+
+def test_xmpz():
+    cdef xmpz x = GMPy_XMPZ_New(NULL)
+
+    mpz_set_si(x.z, 12)
+    assert XMPZ_Check(x) and not MPZ_Check(x)
+    assert x == 12
+
 def test_mpz_cmp():
     cdef mpz z = GMPy_MPZ_New(NULL)
 
@@ -186,6 +225,27 @@ def test_mpfr():
     assert y == y and y == 2742 and 2742 == y
     assert z == z and z == 2743 and 2743 == z
 
+def test_mpfr_inline():
+    cdef mpfr x = GMPy_MPFR_New(53, NULL)
+    cdef mpfr y = GMPy_MPFR_New(53, NULL)
+
+    mpfr_set_si(x.f, 2, MPFR_RNDN)
+    mpfr_set_si(y.f, 3, MPFR_RNDN)
+
+    cdef mpfr z = GMPy_MPFR_Div(x, y, 200)
+
+    # Check that the refcount is appropriate
+    assert Py_REFCNT(<PyObject *> z) == 1
+
+    assert z.precision == 200 and abs(z - mpfr(2) / 3) < 1e-15
+    assert GMPy_MPFR_Add(x, y) == 5
+    assert GMPy_MPFR_Sub(x, y) == -1
+    assert GMPy_MPFR_Mul(x, y) == 6
+    assert GMPy_MPFR_Fma(x, y, x) == 8
+    assert GMPy_MPFR_Sqrt(y) == mpfr(3) ** 0.5
+    assert GMPy_MPFR_Sqrt(y, 100).precision == 100
+    assert GMPy_MPFR_Div(x, y, 10, MPFR_RNDU).rc > 0
+
 def test_mpfr_cmp():
     cdef mpfr x = GMPy_MPFR_New(53, NULL)
 